@@ -18,73 +18,163 @@ extern "C" {
 #ifdef EFR32_PLATFORM
 #include "app/framework/include/af.h"
 
-/* Bien luu trang thai */
-static zw111_app_state_t s_state = ZW111_APP_IDLE;
+/* ----------------------------------------------------------- */
 
-/* Bien luu timing cho lenh phan hoi (lau qua se timeout) */
-static uint32_t s_state_enter_tick = 0;
+/**
+ * @brief Ham thuc hien phep gan trang thai hoat logic dong cua
+ * chuong trinh vao context `app->state` de chuong trinh biet
+ * can lam gi tiep theo
+ * Dong thoi gan thoi gian moi lan vao ham nay nham muc dich so sanh
+ * tre cho cac logic yeu cau timeout
+ *
+ * @param st Trang thai dau vao
+ */
+static inline void zw111_app_enter_state(zw111_app_t *app, zw111_app_state_t st){
+  app->state = st;
+  app->state_enter_tick = zw111_ll_get_ticks();
+}
 
-/* Bien luu so lan thu so khop */
-static uint8_t s_match_try = 0;
+/* ----------------------------------------------------------- */
 
-/* Bien luu so lan thu lai khi enroll van tay moi */
-static uint8_t s_enroll_try = 0;
+/**
+ * @brief Bao ket qua 1 lan lay anh (identify/enroll) cho lich poll `app->presence`
+ *
+ * @details
+ * Sau GetImage con GenChar/Search: MATCH_FAIL van la da chup duoc anh (co ngon tay),
+ * loi khac (anh xau, GenChar loi, timeout) dua ve ERROR -> presence vao burst, lan sau poll nhanh
+ */
+static inline void zw111_app_poll_record(zw111_app_t *app, zw111_status_t ret, uint32_t start){
+  zw111_status_t st = ret;
+  if(ret == ZW111_STATUS_MATCH_FAIL) st = ZW111_STATUS_OK;
+  else if(ret != ZW111_STATUS_OK && ret != ZW111_STATUS_NO_FINGER) st = ZW111_STATUS_ERROR;
+  (void)zw111_presence_record(&app->presence, st, start, zw111_ll_get_ticks());
+}
 
-/* Bien luu yeu cau cua USER (NONE/ENROLL/MATCH) */
-static volatile zw111_req_t s_req = ZW111_REQUEST_NONE;
+/* ----------------------------------------------------------- */
 
-/* Bien noi bo luu pageID (thay doi) de enroll - dung khi STORE_CHAR de biet se ghi template moi vao dau */
-static uint16_t s_enroll_page_id = 1;
+/**
+ * @brief Dong bo bitmap index cua driver (capacity + Index Table) va log bo cuc database
+ * @note Goi khi Probe, hoac khi bitmap chua valid (lan dong bo truoc loi)
+ */
+static zw111_status_t zw111_app_sync_index(zw111_app_t *app){
+  zw111_status_t ret = zw111_sync_index(&app->dev);
+  if(ret != ZW111_STATUS_OK) return ret;
 
-/* Dung khi MATCH theo kieu vet can (brute-force) - LOAD_CHAR tung page de xem ngon tay hien tai khop voi template nao */
-static uint16_t s_match_page_id = 0;
+  const zw111_index_t *idx = zw111_get_index(&app->dev);
+  emberAfCorePrintln("[ZW111] Index synced: %d/%d templates", zw111_index_count(idx), idx->capacity);
+  return ZW111_STATUS_OK;
+}
 
 /* ----------------------------------------------------------- */
 
 /**
- * @brief Ham thuc hien phep gan trang thai hoat logic dong cua
- * chuong trinh vao bien toan cuc `s_state` de chuong trinh biet
- * can lam gi tiep theo
- * Dong thoi gan thoi gian moi lan vao ham nay nham muc dich so sanh
- * tre cho cac logic yeu cau timeout
- *
- * @param st Trang thai dau vao
+ * @brief Khoi dong nhanh tu record metadata trong NotePad (`zw111_meta_load()`) thay vi doc lai Index Table
+ * @return false -> NotePad chua co record/record hong/template bi doi ngoai driver (so template khac) -> khoi dong lanh
  */
-static inline void zw111_app_enter_state(zw111_app_state_t st){
-  s_state = st;
-  s_state_enter_tick = zw111_ll_get_ticks();
+static bool zw111_app_warm_start(zw111_app_t *app){
+  uint16_t count;
+  if(zw111_meta_load(&app->dev, &app->meta) != ZW111_STATUS_OK) return false;
+
+  if(zw111_get_valid_template_count(&app->dev, &count) != ZW111_STATUS_OK || count != app->meta.template_count){
+      app->dev.index.valid = false;
+      return false;
+  }
+  emberAfCorePrintln("[ZW111] Warm start from NotePad: %d/%d templates, seq=%d, next PageID=%d", count,
+                     app->meta.capacity, app->meta.seq, app->meta.alloc_next);
+  return true;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_app_state_t zw111_app_uart_init(uint32_t baudrate, uint32_t timeout_ms, uint32_t password){
+/**
+ * @brief Yeu cau uu tien cao (Cancel, hoac Enroll khi dang Match) -> ve READY
+ * @details Chi gui CANCEL khi identify async con dang chay tren cam bien. Enroll va luc giua 2 lan poll
+ * khong co lenh nao dang chay (API blocking da return) -> doi state, khong ton 1 round trip CANCEL
+ * @return true neu da huy (READY xu ly tiep yeu cau Enroll ngay trong lan goi nay)
+ */
+static bool zw111_app_preempt(zw111_app_t *app){
+  bool matching = (app->state == ZW111_APP_WAIT_FINGER);
+  bool enrolling = (app->state == ZW111_APP_ENROLL_STEP1 || app->state == ZW111_APP_ENROLL_STEP2);
+
+  if(app->req == ZW111_REQUEST_CANCEL){
+      app->req = ZW111_REQUEST_NONE;
+      if(!matching && !enrolling) return false;
+  }else if(app->req != ZW111_REQUEST_ENROLL || !matching){
+      return false;
+  }
+
+  if(!app->id_op.done){
+      uint32_t start = zw111_ll_get_ticks();
+      zw111_status_t ret = zw111_cancel(&app->dev); // id_op ket thuc voi ZW111_STATUS_CANCELLED
+      emberAfCorePrintln("[ZW111] Preempt state=%d, CANCEL status=0x%02X in %d ms", app->state, ret,
+                         elapsed_ms(start, zw111_ll_get_ticks()));
+  }else{
+      emberAfCorePrintln("[ZW111] Preempt state=%d, nothing in flight", app->state);
+  }
+
+  app->match_try = 0;
+  app->enroll_try = 0;
+  zw111_app_enter_state(app, ZW111_APP_READY);
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_app_state_t zw111_app_uart_init(zw111_app_t *app, uint32_t baudrate, uint32_t timeout_ms, uint32_t password,
+                                      const void *port_cfg, uint32_t port_cfg_size){
+  if(app == NULL) return ZW111_APP_ERROR;
+
+  /* Trang thai FSM ban dau cua dau doc */
+  app->state = ZW111_APP_IDLE;
+  app->state_enter_tick = 0;
+  app->match_try = 0;
+  app->enroll_try = 0;
+  app->req = ZW111_REQUEST_NONE;
+  app->enroll_page_id = 0xFFFF;
+  app->id_op.done = true; // Chua co identify nao dang chay
+
+  /* Lich poll GetImage: backoff FAST -> MAX, burst FAST sau touch/anh loi */
+  zw111_presence_cfg_t poll_cfg = {
+    .idle_min_ms = ZW111_APP_POLL_FAST_MS,
+    .idle_max_ms = ZW111_APP_POLL_MAX_MS,
+    .backoff_pct = 200,
+    .burst_ms = ZW111_APP_POLL_FAST_MS,
+    .burst_hold_ms = ZW111_APP_POLL_BURST_HOLD_MS,
+  };
+  zw111_presence_init(&app->presence, &poll_cfg, zw111_ll_get_ticks());
 
 #ifdef USER_PORT_UART_INIT
 
   /* Thiet lap thong so phan cung UART qua struct rieng cua EFR32 */
-  zw111_port_efr32_cfg_t port_cfg;
-  zw111_port_efr32_default_cfg(&port_cfg);
+  zw111_port_efr32_cfg_t port_cfg_local;
+  zw111_port_efr32_default_cfg(&port_cfg_local);
+  if(port_cfg == NULL){
+      port_cfg = &port_cfg_local;
+      port_cfg_size = sizeof(port_cfg_local);
+  }
 
   /* Struct luu cau hinh phan cung cho giao thuc cua ZW111 sau khi da thiet lap ban dau theo dung Platform dang dung */
   zw111_cfg_t cfg = {
       .baud = baudrate,
       .timeout_ms = timeout_ms,
       .password = password,
-      .port_cfg = &port_cfg,
-      .port_cfg_size = sizeof(port_cfg)
+      .port_cfg = port_cfg,
+      .port_cfg_size = port_cfg_size
   };
 
-#endif // USER_PORT_UART_INIT
+#else
 
   zw111_cfg_t cfg = {
         .baud = baudrate,
         .timeout_ms = timeout_ms,
         .password = password,
-        .port_cfg = NULL, // EFR32 da duoc khoi tao boi he thong nen khong can USER cau hinh
-        .port_cfg_size = 0
+        .port_cfg = port_cfg, // NULL -> EFR32 da duoc khoi tao boi he thong (UARTDRV mac dinh)
+        .port_cfg_size = port_cfg_size
    };
 
-  if(zw111_uart_init(&cfg) != ZW111_STATUS_OK){
+#endif // USER_PORT_UART_INIT
+
+  if(zw111_uart_init(&app->dev, &cfg) != ZW111_STATUS_OK){
       emberAfCorePrintln("[ZW111] UART initialized for ZW111 failed...");
       return ZW111_APP_ERROR;
       EFM_ASSERT(false);
@@ -95,24 +185,25 @@ zw111_app_state_t zw111_app_uart_init(uint32_t baudrate, uint32_t timeout_ms, ui
 
 /* ----------------------------------------------------------- */
 
-void zw111_app_uart_deinit(void){
-  zw111_uart_deinit(NULL);
+void zw111_app_uart_deinit(zw111_app_t *app){
+  if(app == NULL) return;
+  zw111_uart_deinit(&app->dev, NULL);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_app_state_t zw111_app_get_state(void){
-  return s_state;
+zw111_app_state_t zw111_app_get_state(const zw111_app_t *app){
+  return (app != NULL) ? app->state : ZW111_APP_ERROR;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_app_state_t zw111_app_sensor_probe(void){
+zw111_app_state_t zw111_app_sensor_probe(zw111_app_t *app){
   /* Bien luu thong so cua cam bien khi Probe */
   zw111_sysinfo_t info;
 
   emberAfCorePrintln("[ZW111] Probing sensor...");
-  zw111_status_t ret = zw111_read_sysinfo(&info);
+  zw111_status_t ret = zw111_read_sysinfo(&app->dev, &info);
 
   if(ret != ZW111_STATUS_OK){
       emberAfCorePrintln("[ZW111] Probe FAILED, status=0x%02X", ret);
@@ -132,12 +223,16 @@ zw111_app_state_t zw111_app_sensor_probe(void){
 
 /* ----------------------------------------------------------- */
 
-zw111_app_state_t zw111_app_process(void){
+zw111_app_state_t zw111_app_process(zw111_app_t *app){
+  if(app == NULL) return ZW111_APP_ERROR;
+
   zw111_status_t ret; /* Bien luu ket qua tra ve API Application Layer cua cam bien （noi bo ham) */
   zw111_app_state_t ret_app; /* Bien luu ket qua tra ve API tai Zigbee AF */
   uint32_t now = zw111_ll_get_ticks();
 
-  switch(s_state){
+  (void)zw111_app_preempt(app);
+
+  switch(app->state){
 
     /* ===================== IDLE ===================== */
     case ZW111_APP_IDLE:
@@ -148,15 +243,23 @@ zw111_app_state_t zw111_app_process(void){
     /* ===================== PROBE ===================== */
     /* Kiem tra thong so Sensor */
     case ZW111_APP_PROBE:
-      zw111_ll_flush_uart(); // Xoa rac RX
+      zw111_ll_flush_uart(&app->dev); // Xoa rac RX
       zw111_port_delay_ms(200);
 
-      ret_app = zw111_app_sensor_probe();
+      ret_app = zw111_app_sensor_probe(app);
       if(ret_app != ZW111_APP_READY){
-          zw111_app_enter_state(ZW111_APP_ERROR);
+          zw111_app_enter_state(app, ZW111_APP_ERROR);
           break;
       }
-      zw111_app_enter_state(ret_app);
+
+      /* Nap bitmap index 1 lan (NotePad hoac Index Table), sau do driver tu cap nhat theo Store/Delete/Empty */
+      if(!zw111_app_warm_start(app)){
+          if(zw111_app_sync_index(app) != ZW111_STATUS_OK){
+              emberAfCorePrintln("[ZW111] Index sync failed, will retry before SEARCH/ENROLL");
+          }
+          zw111_meta_touch(&app->meta, now); // Ghi record moi o READY (giu `shadow` vua doc -> chi ghi trang khac)
+      }
+      zw111_app_enter_state(app, ret_app);
     break;
 
 
@@ -165,111 +268,124 @@ zw111_app_state_t zw111_app_process(void){
     case ZW111_APP_READY:
 
       /* Neu yeu cau Enroll van tay moi tu event */
-      if(s_req == ZW111_REQUEST_ENROLL){
-          s_req = ZW111_REQUEST_NONE;
-          zw111_app_enter_state(ZW111_APP_ENROLL_STEP1);
-      }
-
-      /* Neu yeu cau so khop van tay tu event */
-      else if(s_req == ZW111_REQUEST_MATCH){
-         s_req = ZW111_REQUEST_NONE;
-         zw111_app_enter_state(ZW111_APP_WAIT_FINGER);
-      }
-    break;
+      if(app->req == ZW111_REQUEST_ENROLL){
+          app->req = ZW111_REQUEST_NONE;
 
-    /* ===================== MATCH (XAC THUC VAN TAY) ===================== */
-    // Note: Flow nay dang dung cach Verify (so sanh voi 1 template trong FLASH, khong dung Search)
+          if(!zw111_get_index(&app->dev)->valid && zw111_app_sync_index(app) != ZW111_STATUS_OK){
+              emberAfCorePrintln("[ZW111] Index sync failed, cannot pick enroll slot");
+              zw111_app_enter_state(app, ZW111_APP_ERROR);
+              break;
+          }
 
-    /* ------- 1. WAIT FINGER: Cho USER dat ngon tay vao cam bien */
-    case ZW111_APP_WAIT_FINGER:
-      /* Timeout cho finger */
-      if(elapsed_ms(s_state_enter_tick, now) > ZW111_APP_TIMEOUT_GET_IMAGE_MS){
-          emberAfCorePrintln("[ZW111] WAIT FINGER timeout");
-          zw111_app_enter_state(ZW111_APP_WAIT_FINGER); /* Reset timer */
-          break;
+          /* Slot trong dau tien tu con tro cap phat (next-fit, het thi quay lai 0), khong ghi de template cu */
+          ret = zw111_index_find_first_free(zw111_get_index(&app->dev), app->meta.alloc_next, &app->enroll_page_id);
+          if(ret == ZW111_STATUS_DB_FULL && app->meta.alloc_next != 0){
+              ret = zw111_index_find_first_free(zw111_get_index(&app->dev), 0, &app->enroll_page_id);
+          }
+          if(ret != ZW111_STATUS_OK){
+              emberAfCorePrintln("[ZW111] No free PageID (status=0x%02X), database full", ret);
+              break; // O lai READY
+          }
+          (void)zw111_enroll_start(&app->dev, app->enroll_page_id); // Luu vi tri pageID cho instance driver
+          emberAfCorePrintln("[ZW111] ENROLL into free PageID=%d", app->enroll_page_id);
+          zw111_presence_kick(&app->presence, now);
+          zw111_app_enter_state(app, ZW111_APP_ENROLL_STEP1);
       }
 
-      /* Thuc hien lay Image tu ngon tay USER */
-      ret = zw111_get_image();
-      if(ret == ZW111_STATUS_OK){
-          emberAfCorePrintln("[ZW111] >>> GET IMAGE done, about to GEN CHAR... ");
-          zw111_app_enter_state(ZW111_APP_GEN_CHAR);
+      /* Neu yeu cau so khop van tay tu event */
+      else if(app->req == ZW111_REQUEST_MATCH){
+         app->req = ZW111_REQUEST_NONE;
+         zw111_presence_kick(&app->presence, now);
+         zw111_app_enter_state(app, ZW111_APP_WAIT_FINGER);
       }
 
-      else if(ret == ZW111_STATUS_NO_FINGER){
-          /* Cho tiep */
+      /* Ranh -> ghi gop metadata khi den han */
+      else if(zw111_meta_next_flush_ms(&app->meta, now) == 0){
+          ret = zw111_meta_flush(&app->dev, &app->meta, false);
+          if(ret != ZW111_STATUS_OK){
+              emberAfCorePrintln("[ZW111] NotePad metadata flush error=0x%02X, retry later", ret);
+              zw111_meta_defer(&app->meta, now);
+          }
       }
+    break;
 
-      else{
-          emberAfCorePrintln("[ZW111] GET_IMAGE error=0x%02X", ret);
-          zw111_app_enter_state(ZW111_APP_ERROR);
-      }
-     break;
+    /* ===================== MATCH (NHAN DANG VAN TAY 1:N) ===================== */
+    // Note: Flow nay dung PS_Search tren khoang PageID co template (khong LOAD_CHAR + MATCH tung page)
 
-    /* ------- 2. GEN CHAR: Thuc hien trich xuat dac trung van tay */
-    case ZW111_APP_GEN_CHAR:
-      ret = zw111_gen_char(ZW111_CHARBUFFER_1);
+    /* ------- WAIT FINGER: Cho USER dat ngon tay, co anh thi GenChar + Search ngay trong cung 1 thao tac */
+    case ZW111_APP_WAIT_FINGER:{
+      const zw111_identify_result_t *id = &app->id;
 
-      if(ret == ZW111_STATUS_OK){
-          emberAfCorePrintln("[ZW111] >>> GEN_CHAR OK");
-          s_match_page_id = 1;
-          zw111_app_enter_state(ZW111_APP_LOAD_CHAR);
-      }else{
-          emberAfCorePrintln("[ZW111] GEN_CHAR error=0x%02X", ret);
-          zw111_app_enter_state(ZW111_APP_ERROR);
-      }
-    break;
+      /* Khong co identify dang chay -> den han poll thi bat dau lan moi */
+      if(app->id_op.done){
+          /* Timeout cho finger */
+          if(elapsed_ms(app->state_enter_tick, now) > ZW111_APP_TIMEOUT_GET_IMAGE_MS){
+              emberAfCorePrintln("[ZW111] WAIT FINGER timeout");
+              zw111_app_enter_state(app, ZW111_APP_WAIT_FINGER); /* Reset timer */
+              break;
+          }
 
-    /* ------- 3. LOAD CHAR: Thuc hien tim kiem du lieu co trong database */
-    case ZW111_APP_LOAD_CHAR:
-      ret = zw111_load_char(ZW111_CHARBUFFER_2, s_match_page_id);
+          /* Chua den han poll -> nhuong CPU (`zw111_app_next_wakeup_ms()`) */
+          if(zw111_presence_next_ms(&app->presence, now) != 0) break;
+
+          /* Bitmap chua dong bo (Probe loi) -> dong bo truoc, khoang Search lay tu bitmap */
+          if(!zw111_get_index(&app->dev)->valid){
+              ret = zw111_app_sync_index(app);
+              if(ret != ZW111_STATUS_OK){
+                  emberAfCorePrintln("[ZW111] INDEX SYNC error=0x%02X", ret);
+                  zw111_app_match_state_on_zibgee(app, false, 0, 0);
+                  zw111_app_enter_state(app, ZW111_APP_ERROR);
+                  break;
+              }
+          }
 
-      if(ret == ZW111_STATUS_OK){
-          emberAfCorePrintln("[ZW111] >>> LOAD_CHAR from CHARBUFFER2 OK");
-          zw111_app_enter_state(ZW111_APP_MATCH);
-      }else{
-          s_match_page_id++;
-          if(s_match_page_id >= s_enroll_page_id){ // Neu pageID match khong khop nhieu hon so PageID enroll hien co
-              zw111_app_enter_state(ZW111_APP_READY);
-          }else{
-              /* Quay lai LOAD_CHAR tu pageID khac */
-              zw111_app_enter_state(ZW111_APP_LOAD_CHAR);
+          ret = zw111_identify_async(&app->dev, &app->id_op, 0, 0, &app->id, NULL, NULL);
+          if(ret != ZW111_STATUS_OK){
+              app->id_op.done = true; // Khong xep hang duoc -> khong co gi dang chay
+              emberAfCorePrintln("[ZW111] IDENTIFY submit error=0x%02X", ret);
+              zw111_app_match_state_on_zibgee(app, false, 0, 0);
+              zw111_app_enter_state(app, ZW111_APP_ERROR);
+              break;
           }
       }
-    break;
-
-    /* ------- 4. MATCH: Thuc hien so khop van tay voi du lieu co trong database */
-    case ZW111_APP_MATCH:{
-      uint16_t score = 0;
-      ret = zw111_match(&score);
 
-      if(ret == ZW111_STATUS_OK){
-          emberAfCorePrintln("[ZW111] >>> MATCH OK score=%d, found at PageID=%d", score, s_match_page_id);
-
-          if(score >= ZW111_APP_MATCH_SCORE_MIN){
-              emberAfCorePrintln("[ZW111] >>> ACCEPT ");
-              zw111_app_enter_state(ZW111_APP_DONE);
-
-              /* TODO: Them logic dong mo cua va gui lenh vao mang Zigbee */
-              zw111_app_match_state_on_zibgee(true, s_match_page_id, score);
-          }
-      }else if(ret == ZW111_STATUS_MATCH_FAIL){
-          emberAfCorePrintln("[ZW111] MATCH FAIL");
-          s_match_try++;
-
-          if(s_match_try >= 5){
-              s_match_try = 0;
-              emberAfCorePrintln("[ZW111] MATCH FAIL over 5 times, back to READY");
-              zw111_app_match_state_on_zibgee(false, 0, score);
-              zw111_app_enter_state(ZW111_APP_READY); /* Reset state ve READY */
+      /* Bom driver: chua xong -> return, lan goi sau bom tiep (preempt CANCEL duoc giua chung) */
+      (void)zw111_process(&app->dev);
+      if(!app->id_op.done) break;
+
+      ret = app->id_op.status;
+      // Loi sau buoc GetImage -> da co anh (ngon tay dang dat)
+      zw111_app_poll_record(app, (ret != ZW111_STATUS_NO_FINGER && id->stage != ZW111_ID_STAGE_GET_IMAGE) ? ZW111_STATUS_OK : ret,
+                            zw111_ll_get_ticks() - id->total_ms); // Moc gui GetImage
+      if(ret == ZW111_STATUS_NO_FINGER) break; /* Cho tiep, presence gian chu ky poll */
+
+      if(ret == ZW111_STATUS_OK && id->match_score >= ZW111_APP_MATCH_SCORE_MIN){
+          emberAfCorePrintln("[ZW111] >>> IDENTIFY OK score=%d, found at PageID=%d (img %d + gen %d + search %d ms)",
+                             id->match_score, id->page_id, id->stage_ms[ZW111_ID_STAGE_GET_IMAGE],
+                             id->stage_ms[ZW111_ID_STAGE_GEN_CHAR], id->stage_ms[ZW111_ID_STAGE_SEARCH]);
+          emberAfCorePrintln("[ZW111] >>> ACCEPT ");
+          app->match_try = 0;
+          zw111_meta_hit(&app->meta, id->page_id, now);
+          zw111_app_enter_state(app, ZW111_APP_DONE);
+
+          /* TODO: Them logic dong mo cua va gui lenh vao mang Zigbee */
+          zw111_app_match_state_on_zibgee(app, true, id->page_id, id->match_score);
+      }else if(ret == ZW111_STATUS_OK || ret == ZW111_STATUS_MATCH_FAIL){
+          emberAfCorePrintln("[ZW111] IDENTIFY NOT FOUND (score=%d)", id->match_score);
+          app->match_try++;
+
+          if(app->match_try >= 5 || id->stage == ZW111_ID_STAGE_GET_IMAGE){ // Database rong -> khong thu lai
+              app->match_try = 0;
+              emberAfCorePrintln("[ZW111] IDENTIFY FAIL, back to READY");
+              zw111_app_match_state_on_zibgee(app, false, 0, id->match_score);
+              zw111_app_enter_state(app, ZW111_APP_READY); /* Reset state ve READY */
           }else{
-              zw111_app_enter_state(ZW111_APP_LOAD_CHAR);
+              zw111_app_enter_state(app, ZW111_APP_WAIT_FINGER); /* Lay anh moi roi search lai */
           }
-
       }else{
-          emberAfCorePrintln("[ZW111] MATCH error=0x%02X", ret);
-          zw111_app_match_state_on_zibgee(false, 0, 0);
-          zw111_app_enter_state(ZW111_APP_ERROR);
+          emberAfCorePrintln("[ZW111] IDENTIFY error=0x%02X at stage %d", ret, id->stage);
+          zw111_app_match_state_on_zibgee(app, false, 0, 0);
+          zw111_app_enter_state(app, ZW111_APP_ERROR);
       }
     }
     break;
@@ -278,54 +394,62 @@ zw111_app_state_t zw111_app_process(void){
 
     /* ------- 1. ENROLL STEP 1: GetImage + GenChar(CharBuffer1) */
     case ZW111_APP_ENROLL_STEP1:
-      ret = zw111_enroll_step1(); // Trong API nay da co GetImage va GenChar roi
+      if(zw111_presence_next_ms(&app->presence, now) != 0) break;
+      ret = zw111_enroll_step1(&app->dev); // Trong API nay da co GetImage va GenChar roi
+      zw111_app_poll_record(app, ret, now);
 
       if(ret == ZW111_STATUS_OK){
-          s_enroll_try = 0;
+          app->enroll_try = 0;
           emberAfCorePrintln("[ZW111] ENROLL STEP1 OK");
-          zw111_app_enter_state(ZW111_APP_ENROLL_STEP2);
+          zw111_app_enter_state(app, ZW111_APP_ENROLL_STEP2);
 
-      }else if(ret == ZW111_STATUS_NO_FINGER) { /* Cho tiep */ }
+      }else if(ret == ZW111_STATUS_NO_FINGER) { /* Cho tiep (presence gian chu ky poll) */ }
 
       else{
-          s_enroll_try++;
-          if(s_enroll_try >= ZW111_APP_ENROLL_MAX_TRIES){
+          app->enroll_try++;
+          if(app->enroll_try >= ZW111_APP_ENROLL_MAX_TRIES){
               emberAfCorePrintln("[ZW111] ENROLL STEP1 failed (max tries), return last error=0x%02X", ret);
-              zw111_app_enter_state(ZW111_APP_ERROR);
+              zw111_app_enter_state(app, ZW111_APP_ERROR);
           }
       }
     break;
 
     /* ------- 2. ENROLL STEP 2: GetImage + GenChar(CharBuffer2) + RegModel */
     case ZW111_APP_ENROLL_STEP2:
-      ret = zw111_enroll_step2();
+      if(zw111_presence_next_ms(&app->presence, now) != 0) break;
+      ret = zw111_enroll_step2(&app->dev);
+      zw111_app_poll_record(app, ret, now);
 
       if(ret == ZW111_STATUS_OK){
-          s_enroll_try = 0;
+          app->enroll_try = 0;
           emberAfCorePrintln("[ZW111] ENROLL STEP2 OK");
-          zw111_app_enter_state(ZW111_APP_ENROLL_STORE);
+          zw111_app_enter_state(app, ZW111_APP_ENROLL_STORE);
       }
       else{
-          s_enroll_try++;
-          if(s_enroll_try >= ZW111_APP_ENROLL_MAX_TRIES){
+          app->enroll_try++;
+          if(app->enroll_try >= ZW111_APP_ENROLL_MAX_TRIES){
               emberAfCorePrintln("[ZW111] ENROLL STEP2 failed (max tries), return last error=0x%02X", ret);
-              zw111_app_enter_state(ZW111_APP_ERROR);
+              zw111_app_enter_state(app, ZW111_APP_ERROR);
           }
       }
     break;
 
     /* ------- 3. STORE ENROLLED Fingerprint: StoreChar(page_id) */
     case ZW111_APP_ENROLL_STORE:
-      ret = zw111_enroll_store();
+      ret = zw111_enroll_store(&app->dev);
 
       if(ret == ZW111_STATUS_OK){
-          emberAfCorePrintln("[ZW111] ENROLL STORED OK at pageID=%d, next pageID=%d", s_enroll_page_id, s_enroll_page_id + 1);
-          s_enroll_page_id++; /* Moi pageID tuong ung voi 1 lan enroll thanh cong */
-
-          zw111_app_enter_state(ZW111_APP_DONE);
+          /* Driver da danh dau PageID nay trong bitmap index -> lan Enroll sau tu chon slot trong khac */
+          emberAfCorePrintln("[ZW111] ENROLL STORED OK at pageID=%d (%d templates)", app->enroll_page_id,
+                             zw111_index_count(zw111_get_index(&app->dev)));
+
+          app->meta.alloc_next = (uint16_t)(app->enroll_page_id + 1u);
+          if(app->meta.alloc_next >= zw111_get_index(&app->dev)->capacity) app->meta.alloc_next = 0;
+          zw111_meta_touch(&app->meta, now);
+          zw111_app_enter_state(app, ZW111_APP_DONE);
       }else{
           emberAfCorePrintln("[ZW111] ENROLL STORE error=0x%02X", ret);
-          zw111_app_enter_state(ZW111_APP_ERROR);
+          zw111_app_enter_state(app, ZW111_APP_ERROR);
       }
     break;
 
@@ -334,7 +458,7 @@ zw111_app_state_t zw111_app_process(void){
       emberAfCorePrintln("[ZW111] APP DONE state...back to READY");
 
       /* Xu ly tac vu khac tai app.c (gui Zibgee, log, LED) */
-      zw111_app_enter_state(ZW111_APP_READY); // Quay lai READY de bat dau lai FSM
+      zw111_app_enter_state(app, ZW111_APP_READY); // Quay lai READY de bat dau lai FSM
     break;
 
     /* ===================== ERROR ===================== */
@@ -345,30 +469,74 @@ zw111_app_state_t zw111_app_process(void){
     break;
 
   }
-  return s_state;
+  return app->state;
 }
 
 /* ----------------------------------------------------------- */
 
-void zw111_app_start_probe(void){
-  if(s_state == ZW111_APP_IDLE) zw111_app_enter_state(ZW111_APP_PROBE);
+void zw111_app_start_probe(zw111_app_t *app){
+  if(app == NULL) return;
+  if(app->state == ZW111_APP_IDLE) zw111_app_enter_state(app, ZW111_APP_PROBE);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_app_request_match(zw111_app_t *app){
+  if(app == NULL) return;
+  app->match_try = 0;
+  app->enroll_try = 0;
+  app->req = ZW111_REQUEST_MATCH;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_app_request_enroll(zw111_app_t *app){
+  if(app == NULL) return;
+  app->enroll_try = 0;
+  app->match_try = 0;
+  app->req = ZW111_REQUEST_ENROLL; // PageID duoc chon tu bitmap index o READY
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_app_next_wakeup_ms(const zw111_app_t *app){
+  if(app == NULL) return ZW111_APP_WAKE_NEVER;
+  if(app->req != ZW111_REQUEST_NONE) return 0;
+
+  uint32_t now = zw111_ll_get_ticks();
+  switch(app->state){
+    case ZW111_APP_IDLE:
+    case ZW111_APP_ERROR:
+      return ZW111_APP_WAKE_NEVER;
+
+    case ZW111_APP_READY:
+      return zw111_meta_next_flush_ms(&app->meta, now); // ZW111_META_NEVER == ZW111_APP_WAKE_NEVER khi da ghi xong
+
+    case ZW111_APP_WAIT_FINGER:
+      if(!app->id_op.done) return 0; // Identify dang chay -> bom `zw111_process()`
+      return zw111_presence_next_ms(&app->presence, now);
+
+    case ZW111_APP_ENROLL_STEP1:
+    case ZW111_APP_ENROLL_STEP2:
+      return zw111_presence_next_ms(&app->presence, now);
+
+    default:
+      return 0; // PROBE/STORE/DONE: chay tiep ngay
+  }
 }
 
 /* ----------------------------------------------------------- */
 
-void zw111_app_request_match(void){
-  s_match_try = 0;
-  s_enroll_try = 0;
-  s_req = ZW111_REQUEST_MATCH;
+void zw111_app_notify_touch(zw111_app_t *app){
+  if(app == NULL) return;
+  zw111_presence_wake(&app->presence, zw111_ll_get_ticks());
 }
 
 /* ----------------------------------------------------------- */
 
-void zw111_app_request_enroll(void){
-  s_enroll_try = 0;
-  s_match_try = 0;
-  s_req = ZW111_REQUEST_ENROLL;
-  (void)zw111_enroll_start(s_enroll_page_id); // Luu vi tri pageID cho bien trong zw111.c
+void zw111_app_request_cancel(zw111_app_t *app){
+  if(app == NULL) return;
+  app->req = ZW111_REQUEST_CANCEL; // Xu ly o dau `zw111_app_process()` truoc lenh ke tiep
 }
 
 /* ----------------------------------------------------------- */
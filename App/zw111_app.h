@@ -35,6 +35,24 @@ extern "C" {
 #define ZW111_APP_MATCH_SCORE_MIN       50
 #endif // ZW111_APP_MATCH_SCORE_MIN
 
+/* Chu ky poll GetImage ngay sau khi cham (touch) / yeu cau moi */
+#ifndef ZW111_APP_POLL_FAST_MS
+#define ZW111_APP_POLL_FAST_MS          50
+#endif // ZW111_APP_POLL_FAST_MS
+
+/* Chu ky poll toi da khi khong co ngon tay (moi lan NO_FINGER nhan doi tu FAST den MAX) */
+#ifndef ZW111_APP_POLL_MAX_MS
+#define ZW111_APP_POLL_MAX_MS           400
+#endif // ZW111_APP_POLL_MAX_MS
+
+/* Giu chu ky FAST bao lau sau touch/anh loi truoc khi quay lai backoff */
+#ifndef ZW111_APP_POLL_BURST_HOLD_MS
+#define ZW111_APP_POLL_BURST_HOLD_MS    1000
+#endif // ZW111_APP_POLL_BURST_HOLD_MS
+
+/* `zw111_app_next_wakeup_ms()`: FSM khong can CPU cho den khi co request/touch moi */
+#define ZW111_APP_WAKE_NEVER            0xFFFFFFFFu
+
 /* Struct luu trang thai tra ve cua API o Application Layer cho cam bien */
 typedef enum ZW111_APP_STATE {
   /* Trang thai nhan roi cua he thong, chua thuc hien bat ky thao tac nao voi he thong */
@@ -52,30 +70,14 @@ typedef enum ZW111_APP_STATE {
    * chi thuc hien case tiep theo neu co yeu cau  */
   ZW111_APP_READY,
 
-  /* Finger - cho USER dat ngon tay len cam bien
-   * O trang thai nay, he thong lap lai:
-   *  - Gui lenh GetImage va kiem tra ACK tra ve
-   *
-   * Neu chua co ngon tay -> giu nguyen trang thai
-   * Khi da nhan duoc anh hop le -> Chuyen sang GEN_CHAR */
+  /* Finger - cho USER dat ngon tay len cam bien va nhan dang 1:N
+   * O trang thai nay, he thong lap lai `zw111_identify_async()` (GetImage -> GenChar -> Search trong 1 thao tac,
+   * bom bang `zw111_process()` qua cac lan goi FSM -> yeu cau uu tien cao CANCEL duoc giua chung):
+   *  - Chua co ngon tay -> giu nguyen trang thai
+   *  - Tim thay (score du nguong) -> DONE
+   *  - Khong tim thay -> lay anh moi (toi da 5 lan) roi ve READY */
   ZW111_APP_WAIT_FINGER,
 
-  /* Trich xuat dac trung van tay
-   * Thuc hien lenh GenChar (tao ra feature file tu ImageBuffer)
-   * Feature file duoc luu vao CharBuffer (CB1 hoac CB2)
-   *
-   * Neu thanh cong -> Chuyen sang MATCH
-   * Neu that bai -> chuyen sang ERROR */
-  ZW111_APP_GEN_CHAR,
-
-  /* Sau khi */
-  ZW111_APP_LOAD_CHAR,
-
-  /* So khop van tay
-   * Neu thanh cong -> DONE
-   * Neu that bai -> quay lai WAIT_FINGER */
-  ZW111_APP_MATCH,
-
   /* Hoan tat 1 chu ky xu ly van tay
    * Trang thai ket thuc cua 1 chu ky:
    *  - Nhan dien thanh cong hoac enroll (dang ky) thanh cong
@@ -99,9 +101,33 @@ typedef enum ZW111_APP_STATE {
 typedef enum ZW111_APP_REQUEST{
   ZW111_REQUEST_NONE = 0,
   ZW111_REQUEST_ENROLL,
-  ZW111_REQUEST_MATCH
+  ZW111_REQUEST_MATCH,
+  ZW111_REQUEST_CANCEL              /* Huy Match/Enroll dang chay (vi du su kien dong cua), ve READY */
 } zw111_req_t;
 
+/**
+ * @brief Context cua FSM cho 1 cam bien (1 dau doc)
+ *
+ * @details
+ * Moi dau doc (vi du 2 dau doc/lan cua cong xoay) co 1 context rieng: instance driver `dev`
+ * + trang thai FSM. Cac context duoc bom tu cung 1 scheduler bang `zw111_app_process()`
+ *
+ * @note USER cap phat (static/global) va memset 0 truoc khi goi `zw111_app_uart_init()`
+ */
+typedef struct ZW111_APP {
+  zw111_dev_t dev;                  /* Instance driver cua cam bien */
+  zw111_app_state_t state;          /* Trang thai FSM */
+  uint32_t state_enter_tick;        /* Thoi diem vao state (lau qua se timeout) */
+  uint8_t match_try;                /* So lan thu so khop */
+  uint8_t enroll_try;               /* So lan thu lai khi enroll van tay moi */
+  volatile zw111_req_t req;         /* Yeu cau cua USER (NONE/ENROLL/MATCH) */
+  uint16_t enroll_page_id;          /* PageID se ghi template moi khi STORE_CHAR (slot trong dau tien cua bitmap index) */
+  zw111_presence_t presence;        /* Lich poll GetImage (WAIT_FINGER/ENROLL) + thong ke poll */
+  zw111_meta_t meta;                /* Record metadata trong NotePad (warm start, con tro cap phat, bo dem hit) */
+  zw111_op_t id_op;                 /* Identify async cua WAIT_FINGER (`done` == false -> dang chay tren cam bien) */
+  zw111_identify_result_t id;       /* Ket qua cua `id_op` */
+} zw111_app_t;
+
 /* ----------------------------------------------------------- */
 
 /**
@@ -111,57 +137,91 @@ typedef enum ZW111_APP_REQUEST{
  * Ham nay se thiet lap giao thuc thong qua cac thong so noi bo dau vao duoc thiet lap tai ham (co the Override boi USER)
  * Sau do se dung API cap thap de khoi tao phan cung cho UART
  *
+ * @param app Context cua dau doc
  * @param[in] baudrate Toc do Baud mong muon
  * @param[in] timeout_ms Thoi gian cho khoi tao
  * @param[in] password Mat khau cho cam bien ZW111
+ * @param[in] port_cfg Cau hinh Port cua dau doc (EFR32: `zw111_port_efr32_cfg_t` chua handle UARTDRV)
+ * NULL -> dung UARTDRV mac dinh cua he thong (chi dung duoc cho 1 dau doc)
+ * @param[in] port_cfg_size Kich thuoc cau hinh Port
  */
-zw111_app_state_t zw111_app_uart_init(uint32_t baudrate, uint32_t timeout_ms, uint32_t password);
+zw111_app_state_t zw111_app_uart_init(zw111_app_t *app, uint32_t baudrate, uint32_t timeout_ms, uint32_t password,
+                                      const void *port_cfg, uint32_t port_cfg_size);
 
 /**
  * @brief Ham kiem tra và hien thi ra cac thong so hien tai cua cam bien
  * sau khi da duoc cau hinh (System state, sensor info, device addrress, ...)
  */
-zw111_app_state_t zw111_app_sensor_probe(void);
+zw111_app_state_t zw111_app_sensor_probe(zw111_app_t *app);
 
 /**
  * @brief API thuc hien FSM cho toan bo chuong trinh
  *
+ * @details
+ * Goi lai khi het `zw111_app_next_wakeup_ms()` (khong can goi lien tuc): state dang cho ngon tay chi gui
+ * GetImage khi den han, truoc han thi return ngay khong dung UART
+ *
  * @return Trang thai cua cac khoi xu ly (PROBE/ENROLL/MATCH/IDLE/ERROR/DONE)
  */
-zw111_app_state_t zw111_app_process(void);
+zw111_app_state_t zw111_app_process(zw111_app_t *app);
+
+/**
+ * @brief Thoi gian (ms) den lan FSM can CPU tiep theo, tinh tu bay gio
+ *
+ * @details
+ * Scheduler (event Zigbee, timer cua RTOS) hen lai `zw111_app_process()` sau khoang nay va cho MCU ngu.
+ * Nhieu dau doc -> lay nho nhat. Request/touch moi (`zw111_app_request_*()`, `zw111_app_notify_touch()`)
+ * dua ve 0, scheduler can hen lai ngay sau khi goi cac API nay
+ *
+ * @return 0 neu can chay ngay, ZW111_APP_WAKE_NEVER neu chi chay lai khi co request (IDLE/ERROR, READY khi metadata da ghi xong)
+ */
+uint32_t zw111_app_next_wakeup_ms(const zw111_app_t *app);
+
+/**
+ * @brief Bao co ngon tay cham (vi du ngat GPIO TOUCH_OUT cua cam bien): poll GetImage ngay roi giu chu ky nhanh
+ * trong ZW111_APP_POLL_BURST_HOLD_MS (`zw111_presence_wake()`)
+ */
+void zw111_app_notify_touch(zw111_app_t *app);
 
 /**
  * @brief Ham tra ve trang thai hien tai cua FSM
  */
-zw111_app_state_t zw111_app_get_state(void);
+zw111_app_state_t zw111_app_get_state(const zw111_app_t *app);
 
 /**
  * @brief
  */
-void zw111_app_uart_deinit(void);
+void zw111_app_uart_deinit(zw111_app_t *app);
 
 /**
  * @brief Ham chuyen state tu IDLE (khong lam gi) cua FSM sang PROBE de bat dau chuong trinh
  * `zw111_app_process()` se bat dau flow 1 chu ky cua chuong trinh
  *  sau khi chuyen tu `ZW111_APP_IDLE` sang `ZW111_APP_PROBE`
  */
-void zw111_app_start_probe(void);
+void zw111_app_start_probe(zw111_app_t *app);
 
 /**
  * @brief API bat dau qua trinh Enroll (dang ky) van tay moi
  */
-void zw111_app_request_enroll(void);
+void zw111_app_request_enroll(zw111_app_t *app);
 
 /**
  * @brief API yeu cau thuc hien so khop van tay khi nhan BTN1
  * (Ly do lam the nay vi khong muon sensor sau khi Probe di vao wait finger luon
  * ma phai co yeu cau tu USER)
  */
-void zw111_app_request_match(void);
+void zw111_app_request_match(zw111_app_t *app);
+
+/**
+ * @brief API huy Match/Enroll dang chay ngay lap tuc (gui CANCEL cho cam bien thay vi cho lenh hien tai timeout)
+ * @note Yeu cau Enroll den trong luc dang Match cung tu huy Match roi bat dau Enroll (uu tien cao hon)
+ */
+void zw111_app_request_cancel(zw111_app_t *app);
 
 /**
  * @brief API gui trang thai so khop van tay (thanh cong/that bai) den Zigbee stack cua app.c len USER
  *
+ * @param app Dau doc vua so khop (de app.c biet dau doc nao)
  * @param page_id
  * @param score
  *
@@ -169,7 +229,7 @@ void zw111_app_request_match(void);
  * Do thu vien khong chua cac API cua Zigbee stack nen ham chi khai bao o day
  * de goi tu FSM nhung lai duoc dinh nghia tai app.c
  */
-void zw111_app_match_state_on_zibgee(bool match_state, uint16_t page_id, uint16_t score);
+void zw111_app_match_state_on_zibgee(zw111_app_t *app, bool match_state, uint16_t page_id, uint16_t score);
 
 #ifdef __cplusplus
 }
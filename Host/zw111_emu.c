@@ -0,0 +1,999 @@
+/*
+ * @file zw111_emu.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Dinh nghia emulator hanh vi ZW111 tren pty (chi danh cho host Linux/POSIX)
+ *
+ * @note
+ * Build: gcc -D_GNU_SOURCE -IInc Host/zw111_emu.c Host/zw111_emu_main.c -lpthread
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_emu.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#define EMU_HEADER          0xEF01
+#define EMU_PID_COMMAND     0x01
+#define EMU_PID_DATA        0x02
+#define EMU_PID_ACK         0x07
+#define EMU_PID_END         0x08
+#define EMU_HDR_LEN         9u
+#define EMU_MAX_PAYLOAD     (256u + 2u)
+#define EMU_TEMPLATE_MAGIC  0x5A575431u /* "ZWT1" */
+
+/* Trang thai parser RX cua emulator */
+typedef enum {
+  EMU_RX_HDR0 = 0,
+  EMU_RX_HDR1,
+  EMU_RX_ADDR,
+  EMU_RX_PID,
+  EMU_RX_LEN,
+  EMU_RX_PAYLOAD
+} emu_rx_state_t;
+
+/* 1 chunk byte cho gui ra (1 frame hoac 1 phan frame neu bi split) */
+typedef struct {
+  uint64_t due_us;
+  uint16_t len;
+  uint8_t bytes[EMU_HDR_LEN + EMU_MAX_PAYLOAD + 8u];
+} emu_chunk_t;
+
+/* 1 CharBuffer trong RAM cua module */
+typedef struct {
+  bool valid;
+  uint8_t data[ZW111_EMU_TEMPLATE_SIZE];
+} emu_charbuf_t;
+
+struct ZW111_EMU {
+  zw111_emu_cfg_t cfg;
+  int master_fd;
+  char slave_path[64];
+
+  pthread_t thread;
+  bool thread_running;
+  volatile bool thread_stop;
+  pthread_mutex_t lock;
+
+  uint32_t rng;
+
+  /* ---- Parser RX ---- */
+  emu_rx_state_t rx_state;
+  uint8_t rx_hdr[EMU_HDR_LEN];
+  uint16_t rx_idx;
+  uint16_t rx_len;
+  uint8_t rx_payload[EMU_MAX_PAYLOAD];
+
+  /* ---- Hang doi TX ---- */
+  emu_chunk_t *txq;
+  uint32_t txq_head;
+  uint32_t txq_count;
+  uint32_t txq_cap;
+  uint64_t wire_free_us;
+
+  /* ---- Trang thai module ---- */
+  bool pwd_verified;
+  uint32_t finger_id;
+  zw111_emu_finger_quality_t finger_quality;
+  uint32_t image_finger;         /* Finger trong ImageBuffer (0 = khong co anh) */
+  zw111_emu_finger_quality_t image_quality;
+  emu_charbuf_t charbuf[2];
+  uint8_t *db;                   /* capacity * ZW111_EMU_TEMPLATE_SIZE */
+  uint8_t *db_used;              /* capacity */
+  uint8_t notepad[ZW111_EMU_NOTEPAD_PAGES][ZW111_EMU_NOTEPAD_PAGE_SIZE];
+
+  /* ---- Nhan DOWN_CHAR / DOWN_IMAGE ---- */
+  uint8_t down_cmd;              /* 0 = khong trong phien download */
+  uint8_t down_buf_id;
+  uint32_t down_len;
+
+  zw111_emu_latency_t latency[256];
+  zw111_emu_stats_t stats;
+};
+
+/* ----------------------------------------------------------- */
+
+static uint64_t emu_now_us(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u;
+}
+
+/* ----------------------------------------------------------- */
+
+static uint32_t emu_rand(zw111_emu_t *emu){
+  /* xorshift32 */
+  uint32_t x = emu->rng;
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  emu->rng = x;
+  return x;
+}
+
+/* ----------------------------------------------------------- */
+
+static bool emu_chance(zw111_emu_t *emu, uint16_t permille){
+  if(permille == 0) return false;
+  return (emu_rand(emu) % 1000u) < permille;
+}
+
+/* ----------------------------------------------------------- */
+
+static inline void emu_put_u16(uint8_t *b, uint16_t v){
+  b[0] = (uint8_t)(v >> 8);
+  b[1] = (uint8_t)v;
+}
+
+static inline void emu_put_u32(uint8_t *b, uint32_t v){
+  b[0] = (uint8_t)(v >> 24);
+  b[1] = (uint8_t)(v >> 16);
+  b[2] = (uint8_t)(v >> 8);
+  b[3] = (uint8_t)v;
+}
+
+static inline uint16_t emu_get_u16(const uint8_t *b){
+  return (uint16_t)((b[0] << 8) | b[1]);
+}
+
+static inline uint32_t emu_get_u32(const uint8_t *b){
+  return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+/* ----------------------------------------------------------- */
+
+static uint16_t emu_data_len(const zw111_emu_t *emu){
+  return (uint16_t)(32u << (emu->cfg.packet_size & 0x03));
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Latency xu ly cua 1 lenh (us) theo mo hinh base + per_unit * units + jitter
+ */
+static uint64_t emu_latency_us(zw111_emu_t *emu, uint8_t cmd, uint32_t units){
+  const zw111_emu_latency_t *l = &emu->latency[cmd];
+  uint64_t us = (uint64_t)l->base_ms * 1000u + (uint64_t)l->per_unit_us * units;
+  if(l->jitter_ms) us += (uint64_t)(emu_rand(emu) % ((uint32_t)l->jitter_ms * 1000u + 1u));
+  return us * emu->cfg.latency_scale_pct / 100u;
+}
+
+/* ----------------------------------------------------------- */
+
+static emu_chunk_t *emu_txq_push(zw111_emu_t *emu){
+  if(emu->txq_count == emu->txq_cap){
+      uint32_t ncap = emu->txq_cap ? emu->txq_cap * 2u : 64u;
+      emu_chunk_t *n = (emu_chunk_t *)malloc(sizeof(emu_chunk_t) * ncap);
+      if(n == NULL) return NULL;
+      for(uint32_t i = 0; i < emu->txq_count; i++){
+          n[i] = emu->txq[(emu->txq_head + i) % emu->txq_cap];
+      }
+      free(emu->txq);
+      emu->txq = n;
+      emu->txq_head = 0;
+      emu->txq_cap = ncap;
+  }
+  emu_chunk_t *c = &emu->txq[(emu->txq_head + emu->txq_count) % emu->txq_cap];
+  emu->txq_count++;
+  return c;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Dong goi 1 frame (ACK/DATA/END) va dua vao hang doi TX tai thoi diem `due_us`
+ * Inject loi (byte rac / sai checksum / split frame) duoc ap dung tai day
+ */
+static void emu_queue_frame(zw111_emu_t *emu, uint8_t pid, const uint8_t *payload, uint16_t payload_len, uint64_t due_us){
+  uint8_t frame[EMU_HDR_LEN + EMU_MAX_PAYLOAD + 8u];
+  uint16_t idx = 0;
+
+  /* Byte rac truoc frame (khong bao gio la 0xEF de test resync dung nghia) */
+  if(emu_chance(emu, emu->cfg.garbage_permille)){
+      uint8_t n = (uint8_t)(1u + emu_rand(emu) % 8u);
+      for(uint8_t i = 0; i < n; i++){
+          uint8_t b = (uint8_t)emu_rand(emu);
+          frame[idx++] = (b == 0xEF) ? 0x00 : b;
+      }
+      emu->stats.injected_garbage++;
+  }
+
+  uint16_t start = idx;
+  emu_put_u16(&frame[idx], EMU_HEADER); idx += 2;
+  emu_put_u32(&frame[idx], emu->cfg.address); idx += 4;
+  frame[idx++] = pid;
+  emu_put_u16(&frame[idx], (uint16_t)(payload_len + 2u)); idx += 2;
+  if(payload_len) memcpy(&frame[idx], payload, payload_len);
+  idx += payload_len;
+
+  uint32_t sum = 0;
+  for(uint16_t i = (uint16_t)(start + 6u); i < idx; i++) sum += frame[i];
+
+  bool unstable = emu->cfg.unstable_above_mult && emu->cfg.baud_mult > emu->cfg.unstable_above_mult
+                  && emu_chance(emu, emu->cfg.unstable_permille);
+  if(emu_chance(emu, emu->cfg.badsum_permille) || unstable){
+      sum ^= 0x5A5Au;
+      emu->stats.injected_badsum++;
+  }
+  emu_put_u16(&frame[idx], (uint16_t)sum); idx += 2;
+
+  /* Split frame: 2 chunk, chunk sau den cham split_gap_ms */
+  uint16_t cut = idx;
+  if(idx > 2u && emu_chance(emu, emu->cfg.split_permille)){
+      cut = (uint16_t)(1u + emu_rand(emu) % (idx - 1u));
+      emu->stats.injected_split++;
+  }
+
+  emu_chunk_t *c = emu_txq_push(emu);
+  if(c == NULL) return;
+  c->due_us = due_us;
+  c->len = cut;
+  memcpy(c->bytes, frame, cut);
+
+  if(cut < idx){
+      emu_chunk_t *c2 = emu_txq_push(emu);
+      if(c2 == NULL) return;
+      c2->due_us = due_us + (uint64_t)emu->cfg.split_gap_ms * 1000u;
+      c2->len = (uint16_t)(idx - cut);
+      memcpy(c2->bytes, &frame[cut], c2->len);
+  }
+  emu->stats.tx_frames++;
+}
+
+/* ----------------------------------------------------------- */
+
+static void emu_ack(zw111_emu_t *emu, zw111_ack_t code, const uint8_t *ret, uint16_t ret_len, uint64_t due_us){
+  uint8_t p[1 + EMU_MAX_PAYLOAD];
+  p[0] = (uint8_t)code;
+  if(ret_len) memcpy(&p[1], ret, ret_len);
+  emu_queue_frame(emu, EMU_PID_ACK, p, (uint16_t)(1u + ret_len), due_us);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Gui 1 khoi du lieu lon thanh chuoi DATA...END theo packet size hien tai
+ */
+static void emu_stream(zw111_emu_t *emu, const uint8_t *data, uint32_t len, uint64_t due_us){
+  uint16_t pkt = emu_data_len(emu);
+  uint32_t off = 0;
+  while(off < len){
+      uint16_t n = (uint16_t)((len - off) > pkt ? pkt : (len - off));
+      bool last = (off + n) >= len;
+      emu_queue_frame(emu, last ? EMU_PID_END : EMU_PID_DATA, &data[off], n, due_us);
+      off += n;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_make_template(uint32_t finger_id, uint8_t out[ZW111_EMU_TEMPLATE_SIZE]){
+  emu_put_u32(&out[0], EMU_TEMPLATE_MAGIC);
+  emu_put_u32(&out[4], finger_id);
+  uint32_t x = finger_id * 2654435761u + 1u;
+  for(uint32_t i = 8; i < ZW111_EMU_TEMPLATE_SIZE; i++){
+      x ^= x << 13; x ^= x >> 17; x ^= x << 5;
+      out[i] = (uint8_t)x;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Lay finger_id tu noi dung template (template tu DOWN_CHAR khong dung format -> hash noi dung)
+ */
+static uint32_t emu_template_finger(const uint8_t *t){
+  if(emu_get_u32(&t[0]) == EMU_TEMPLATE_MAGIC) return emu_get_u32(&t[4]);
+  uint32_t h = 2166136261u;
+  for(uint32_t i = 0; i < ZW111_EMU_TEMPLATE_SIZE; i++){ h ^= t[i]; h *= 16777619u; }
+  return h | 0x80000000u;
+}
+
+/* ----------------------------------------------------------- */
+
+static uint16_t emu_score(zw111_emu_t *emu){
+  return (uint16_t)(60u + emu_rand(emu) % 140u);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Sinh anh van tay gia lap (4-bit/pixel, 2 pixel/byte nhu qua UART) cho UP_IMAGE
+ * Anh "kho" co contrast thap, anh "uot" bi nhoe (gia tri dong deu hon)
+ */
+static void emu_make_image(const zw111_emu_t *emu, uint8_t *out, uint32_t out_len){
+  uint16_t w = emu->cfg.image_width, h = emu->cfg.image_height;
+  uint32_t f = emu->image_finger;
+  uint32_t idx = 0;
+  for(uint16_t y = 0; y < h && idx < out_len; y++){
+      for(uint16_t x = 0; x < w && idx < out_len; x += 2){
+          uint8_t px[2];
+          for(int k = 0; k < 2; k++){
+              uint32_t xx = (uint32_t)(x + k);
+              uint32_t phase = (xx * (3u + (f & 3u)) + (uint32_t)y * (2u + ((f >> 2) & 3u)) + ((xx * y) >> 7)) >> 2;
+              uint8_t v = (phase & 1u) ? 0x3u : 0xCu;
+              if(emu->image_quality == ZW111_EMU_FINGER_DRY) v = (phase & 1u) ? 0x7u : 0x9u;
+              else if(emu->image_quality == ZW111_EMU_FINGER_WET) v = (uint8_t)((v + 0x8u) / 2u);
+              px[k] = v;
+          }
+          out[idx++] = (uint8_t)((px[0] << 4) | px[1]);
+      }
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+static bool emu_page_in_range(const zw111_emu_t *emu, uint32_t page){
+  return page < emu->cfg.capacity;
+}
+
+/* ----------------------------------------------------------- */
+
+static emu_charbuf_t *emu_charbuf(zw111_emu_t *emu, uint8_t id){
+  if(id == ZW111_CHARBUFFER_1) return &emu->charbuf[0];
+  if(id == ZW111_CHARBUFFER_2) return &emu->charbuf[1];
+  return NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Thuc thi 1 Command Packet va xep ACK (+ data packets) vao hang doi TX
+ */
+static void emu_handle_command(zw111_emu_t *emu, const uint8_t *p, uint16_t n){
+  if(n < 1) return;
+  uint8_t cmd = p[0];
+  const uint8_t *a = &p[1];
+  uint16_t an = (uint16_t)(n - 1u);
+  uint8_t ret[64];
+  uint64_t now = emu_now_us();
+  uint64_t due = now + emu_latency_us(emu, cmd, 0);
+
+  emu->stats.cmd_count[cmd]++;
+
+  if(emu->cfg.password != 0 && !emu->pwd_verified && cmd != ZW111_CMD_VERIFY_PWD){
+      emu_ack(emu, ZW111_ACK_MUST_VERIFY_PASSWORD, NULL, 0, due);
+      return;
+  }
+
+  switch(cmd){
+    case ZW111_CMD_GET_IMAGE:
+      if(emu->finger_id == 0){
+          emu->image_finger = 0;
+          emu_ack(emu, ZW111_ACK_NO_FINGER, NULL, 0, due);
+      }else{
+          emu->image_finger = emu->finger_id;
+          emu->image_quality = emu->finger_quality;
+          emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+      }
+    break;
+
+    case ZW111_CMD_GEN_CHAR:{
+      emu_charbuf_t *cb = (an >= 1) ? emu_charbuf(emu, a[0]) : NULL;
+      if(cb == NULL){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      if(emu->image_finger == 0){ emu_ack(emu, ZW111_ACK_INVALID_ORINAL_IMG, NULL, 0, due); break; }
+      switch(emu->image_quality){
+        case ZW111_EMU_FINGER_DRY:     emu_ack(emu, ZW111_ACK_IMAGE_TOO_DRY, NULL, 0, due); break;
+        case ZW111_EMU_FINGER_WET:     emu_ack(emu, ZW111_ACK_IMAGE_TOO_WET, NULL, 0, due); break;
+        case ZW111_EMU_FINGER_PARTIAL: emu_ack(emu, ZW111_ACK_FEW_FEATURE, NULL, 0, due); break;
+        default:
+          zw111_emu_make_template(emu->image_finger, cb->data);
+          cb->valid = true;
+          emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+        break;
+      }
+    }
+    break;
+
+    case ZW111_CMD_MATCH:
+      if(!emu->charbuf[0].valid || !emu->charbuf[1].valid
+         || emu_template_finger(emu->charbuf[0].data) != emu_template_finger(emu->charbuf[1].data)){
+          emu_put_u16(ret, 0);
+          emu_ack(emu, ZW111_ACK_NOT_MATCH, ret, 2, due);
+      }else{
+          emu_put_u16(ret, emu_score(emu));
+          emu_ack(emu, ZW111_ACK_OK, ret, 2, due);
+      }
+    break;
+
+    case ZW111_CMD_SEARCH:{
+      if(an < 5){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      emu_charbuf_t *cb = emu_charbuf(emu, a[0]);
+      uint32_t start = emu_get_u16(&a[1]), count = emu_get_u16(&a[3]);
+      uint32_t end = start + count;
+      if(end > emu->cfg.capacity) end = emu->cfg.capacity;
+      due = now + emu_latency_us(emu, cmd, (end > start) ? (end - start) : 0);
+      emu_put_u16(&ret[0], 0);
+      emu_put_u16(&ret[2], 0);
+      if(cb == NULL || !cb->valid){ emu_ack(emu, ZW111_ACK_NOT_FOUND, ret, 4, due); break; }
+      uint32_t f = emu_template_finger(cb->data);
+      bool found = false;
+      for(uint32_t pg = start; pg < end; pg++){
+          if(emu->db_used[pg] && emu_template_finger(&emu->db[pg * ZW111_EMU_TEMPLATE_SIZE]) == f){
+              emu_put_u16(&ret[0], (uint16_t)pg);
+              emu_put_u16(&ret[2], emu_score(emu));
+              found = true;
+              break;
+          }
+      }
+      emu_ack(emu, found ? ZW111_ACK_OK : ZW111_ACK_NOT_FOUND, ret, 4, due);
+    }
+    break;
+
+    case ZW111_CMD_REG_MODEL:
+      if(!emu->charbuf[0].valid || !emu->charbuf[1].valid
+         || emu_template_finger(emu->charbuf[0].data) != emu_template_finger(emu->charbuf[1].data)){
+          emu_ack(emu, ZW111_ACK_MERGE_FAIL, NULL, 0, due);
+      }else{
+          emu->charbuf[1] = emu->charbuf[0];
+          emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+      }
+    break;
+
+    case ZW111_CMD_STORE_CHAR:{
+      if(an < 3){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      emu_charbuf_t *cb = emu_charbuf(emu, a[0]);
+      uint16_t pg = emu_get_u16(&a[1]);
+      if(!emu_page_in_range(emu, pg)){ emu_ack(emu, ZW111_ACK_PAGE_OUT_OF_RANGE, NULL, 0, due); break; }
+      if(cb == NULL || !cb->valid){ emu_ack(emu, ZW111_ACK_READ_WRITE_FLASH_ERROR, NULL, 0, due); break; }
+      memcpy(&emu->db[(uint32_t)pg * ZW111_EMU_TEMPLATE_SIZE], cb->data, ZW111_EMU_TEMPLATE_SIZE);
+      emu->db_used[pg] = 1;
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    }
+    break;
+
+    case ZW111_CMD_LOAD_CHAR:{
+      if(an < 3){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      emu_charbuf_t *cb = emu_charbuf(emu, a[0]);
+      uint16_t pg = emu_get_u16(&a[1]);
+      if(!emu_page_in_range(emu, pg)){ emu_ack(emu, ZW111_ACK_PAGE_OUT_OF_RANGE, NULL, 0, due); break; }
+      if(cb == NULL || !emu->db_used[pg]){ emu_ack(emu, ZW111_ACK_READ_TEMPLATE_FAIL, NULL, 0, due); break; }
+      memcpy(cb->data, &emu->db[(uint32_t)pg * ZW111_EMU_TEMPLATE_SIZE], ZW111_EMU_TEMPLATE_SIZE);
+      cb->valid = true;
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    }
+    break;
+
+    case ZW111_CMD_UP_CHAR:{
+      emu_charbuf_t *cb = (an >= 1) ? emu_charbuf(emu, a[0]) : NULL;
+      if(cb == NULL || !cb->valid){ emu_ack(emu, ZW111_ACK_UPLOAD_FAIL, NULL, 0, due); break; }
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+      emu_stream(emu, cb->data, ZW111_EMU_TEMPLATE_SIZE, due);
+    }
+    break;
+
+    case ZW111_CMD_DOWN_CHAR:{
+      emu_charbuf_t *cb = (an >= 1) ? emu_charbuf(emu, a[0]) : NULL;
+      if(cb == NULL){ emu_ack(emu, ZW111_ACK_CANNOT_RECEIVE, NULL, 0, due); break; }
+      emu->down_cmd = cmd;
+      emu->down_buf_id = a[0];
+      emu->down_len = 0;
+      memset(cb->data, 0, sizeof(cb->data));
+      cb->valid = false;
+      emu_ack(emu, emu->cfg.stream_ack ? ZW111_ACK_STREAM_CMD_ACCEPTED : ZW111_ACK_OK, NULL, 0, due);
+    }
+    break;
+
+    case ZW111_CMD_UP_IMAGE:{
+      if(emu->image_finger == 0){ emu_ack(emu, ZW111_ACK_INVALID_ORINAL_IMG, NULL, 0, due); break; }
+      uint32_t len = (uint32_t)emu->cfg.image_width * emu->cfg.image_height / 2u;
+      uint8_t *img = (uint8_t *)malloc(len);
+      if(img == NULL){ emu_ack(emu, ZW111_ACK_IMAGE_UPLOAD_FAIL, NULL, 0, due); break; }
+      emu_make_image(emu, img, len);
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+      emu_stream(emu, img, len, due);
+      free(img);
+    }
+    break;
+
+    case ZW111_CMD_DOWN_IMAGE:
+      emu->down_cmd = cmd;
+      emu->down_len = 0;
+      emu_ack(emu, emu->cfg.stream_ack ? ZW111_ACK_STREAM_CMD_ACCEPTED : ZW111_ACK_OK, NULL, 0, due);
+    break;
+
+    case ZW111_CMD_DELETE_CHAR:{
+      if(an < 4){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      uint32_t pg = emu_get_u16(&a[0]), cnt = emu_get_u16(&a[2]);
+      if(cnt == 0 || pg + cnt > emu->cfg.capacity){ emu_ack(emu, ZW111_ACK_DELETE_FAIL, NULL, 0, due); break; }
+      due = now + emu_latency_us(emu, cmd, cnt);
+      memset(&emu->db_used[pg], 0, cnt);
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    }
+    break;
+
+    case ZW111_CMD_EMPTY:{
+      uint32_t used = 0;
+      for(uint32_t i = 0; i < emu->cfg.capacity; i++) used += emu->db_used[i];
+      due = now + emu_latency_us(emu, cmd, used);
+      memset(emu->db_used, 0, emu->cfg.capacity);
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    }
+    break;
+
+    case ZW111_CMD_WRITE_REG:{
+      if(an < 2){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      zw111_ack_t code = ZW111_ACK_OK;
+      switch(a[0]){
+        case ZW111_REG_BAUDRATE:
+          if(a[1] == 0 || a[1] > 12) code = ZW111_ACK_REG_DISTR_WRONG_NUMBER;
+        break;
+        case ZW111_REG_MATCH_THRESHOLD:
+          if(a[1] < 1 || a[1] > 5) code = ZW111_ACK_REG_DISTR_WRONG_NUMBER;
+          else emu->cfg.security = a[1];
+        break;
+        case ZW111_REG_PKT_SIZE:
+          if(a[1] > ZW111_PKT_SIZE_256) code = ZW111_ACK_REG_DISTR_WRONG_NUMBER;
+          else emu->cfg.packet_size = a[1];
+        break;
+        default: code = ZW111_ACK_INVALID_REG_NUMBER; break;
+      }
+      emu_ack(emu, code, NULL, 0, due);
+      /* Baudrate moi chi co hieu luc sau khi ACK da ra khoi day (giong module that) */
+      if(code == ZW111_ACK_OK && a[0] == ZW111_REG_BAUDRATE) emu->cfg.baud_mult = a[1];
+    }
+    break;
+
+    case ZW111_CMD_READ_SYS_PARA:
+      emu_put_u16(&ret[0], 0);                       /* SSR */
+      emu_put_u16(&ret[2], emu->cfg.sensor_type);
+      emu_put_u16(&ret[4], emu->cfg.capacity);
+      emu_put_u16(&ret[6], emu->cfg.security);
+      emu_put_u32(&ret[8], emu->cfg.address);
+      emu_put_u16(&ret[12], emu->cfg.packet_size);
+      emu_put_u16(&ret[14], emu->cfg.baud_mult);
+      emu_ack(emu, ZW111_ACK_OK, ret, 16, due);
+    break;
+
+    case ZW111_CMD_SET_PWD:
+      if(an < 4){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      emu->cfg.password = emu_get_u32(a);
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    break;
+
+    case ZW111_CMD_VERIFY_PWD:
+      if(an < 4){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      emu->pwd_verified = (emu_get_u32(a) == emu->cfg.password);
+      emu_ack(emu, emu->pwd_verified ? ZW111_ACK_OK : ZW111_ACK_PASSWORD_ERROR, NULL, 0, due);
+    break;
+
+    case ZW111_CMD_GET_RANDOM_CODE:
+      emu_put_u32(ret, emu_rand(emu));
+      emu_ack(emu, ZW111_ACK_OK, ret, 4, due);
+    break;
+
+    case ZW111_CMD_SET_CHIP_ADR:
+      if(an < 4){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      emu->cfg.address = emu_get_u32(a); /* ACK da duoc tra bang dia chi moi */
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    break;
+
+    case ZW111_CMD_READ_INFO_PAGE:{
+      uint8_t info[512];
+      memset(info, 0, sizeof(info));
+      memcpy(info, "ZW111-EMU", 9);
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+      emu_stream(emu, info, sizeof(info), due);
+    }
+    break;
+
+    case ZW111_CMD_WRITE_NOTE_PAD:
+      if(an < 1 + ZW111_EMU_NOTEPAD_PAGE_SIZE || a[0] >= ZW111_EMU_NOTEPAD_PAGES){
+          emu_ack(emu, ZW111_ACK_NOTEPAD_APPOINT_ERROR, NULL, 0, due);
+          break;
+      }
+      memcpy(emu->notepad[a[0]], &a[1], ZW111_EMU_NOTEPAD_PAGE_SIZE);
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    break;
+
+    case ZW111_CMD_READ_NOTE_PAD:
+      if(an < 1 || a[0] >= ZW111_EMU_NOTEPAD_PAGES){
+          emu_ack(emu, ZW111_ACK_NOTEPAD_APPOINT_ERROR, NULL, 0, due);
+          break;
+      }
+      emu_ack(emu, ZW111_ACK_OK, emu->notepad[a[0]], ZW111_EMU_NOTEPAD_PAGE_SIZE, due);
+    break;
+
+    case ZW111_CMD_VALID_TEMPLATE:{
+      uint32_t used = 0;
+      for(uint32_t i = 0; i < emu->cfg.capacity; i++) used += emu->db_used[i];
+      emu_put_u16(ret, (uint16_t)used);
+      emu_ack(emu, ZW111_ACK_OK, ret, 2, due);
+    }
+    break;
+
+    case ZW111_CMD_READ_INDEX_TABLE:{
+      if(an < 1){ emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due); break; }
+      memset(ret, 0, 32);
+      uint32_t base = (uint32_t)a[0] * 256u;
+      for(uint32_t i = 0; i < 256u; i++){
+          uint32_t pg = base + i;
+          if(pg < emu->cfg.capacity && emu->db_used[pg]) ret[i >> 3] |= (uint8_t)(1u << (i & 7u));
+      }
+      emu_ack(emu, ZW111_ACK_OK, ret, 32, due);
+    }
+    break;
+
+    case ZW111_CMD_CANCEL:
+      /* Huy moi frame con cho gui (stream UP_CHAR/UP_IMAGE dang do) va phien download */
+      emu->txq_count = 0;
+      emu->down_cmd = 0;
+      emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+    break;
+
+    default:
+      emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, due);
+    break;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Nhan 1 Data/End Packet trong phien DOWN_CHAR/DOWN_IMAGE
+ */
+static void emu_handle_data(zw111_emu_t *emu, uint8_t pid, const uint8_t *d, uint16_t n){
+  uint64_t due = emu_now_us() + emu_latency_us(emu, emu->down_cmd, 0) / 4u;
+  if(emu->down_cmd == 0){
+      emu_ack(emu, ZW111_ACK_PACKET_FLAG_ERROR, NULL, 0, due);
+      return;
+  }
+
+  if(emu->down_cmd == ZW111_CMD_DOWN_CHAR){
+      emu_charbuf_t *cb = emu_charbuf(emu, emu->down_buf_id);
+      for(uint16_t i = 0; i < n && emu->down_len < ZW111_EMU_TEMPLATE_SIZE; i++){
+          cb->data[emu->down_len++] = d[i];
+      }
+      if(pid == EMU_PID_END) cb->valid = true;
+  }else{
+      emu->down_len += n;
+  }
+
+  if(pid == EMU_PID_END){
+      emu->down_cmd = 0;
+      if(emu->cfg.stream_ack) emu_ack(emu, ZW111_ACK_OK, NULL, 0, due);
+  }else if(emu->cfg.stream_ack){
+      emu_ack(emu, ZW111_ACK_STREAM_DATA_OK, NULL, 0, due);
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+static void emu_handle_frame(zw111_emu_t *emu){
+  uint32_t addr = emu_get_u32(&emu->rx_hdr[2]);
+  uint8_t pid = emu->rx_hdr[6];
+  uint16_t len = emu->rx_len;
+
+  uint32_t sum = pid + (uint8_t)(len >> 8) + (uint8_t)len;
+  for(uint16_t i = 0; i < len - 2u; i++) sum += emu->rx_payload[i];
+  bool sum_ok = ((uint16_t)sum == emu_get_u16(&emu->rx_payload[len - 2u]));
+
+  if(addr != emu->cfg.address) return; // Module khong tra loi frame khong dung dia chi
+
+  emu->stats.rx_frames++;
+  if(!sum_ok){
+      emu->stats.rx_bad_frames++;
+      emu_ack(emu, ZW111_ACK_PACKET_ERROR, NULL, 0, emu_now_us());
+      return;
+  }
+
+  if(pid == EMU_PID_COMMAND) emu_handle_command(emu, emu->rx_payload, (uint16_t)(len - 2u));
+  else if(pid == EMU_PID_DATA || pid == EMU_PID_END) emu_handle_data(emu, pid, emu->rx_payload, (uint16_t)(len - 2u));
+  else emu_ack(emu, ZW111_ACK_PACKET_FLAG_ERROR, NULL, 0, emu_now_us());
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Parser byte-by-byte, tu resync khi gap byte khong phai 0xEF01
+ */
+static void emu_rx_byte(zw111_emu_t *emu, uint8_t b){
+  switch(emu->rx_state){
+    case EMU_RX_HDR0:
+      if(b == 0xEF){ emu->rx_hdr[0] = b; emu->rx_state = EMU_RX_HDR1; }
+    break;
+    case EMU_RX_HDR1:
+      if(b == 0x01){ emu->rx_hdr[1] = b; emu->rx_idx = 2; emu->rx_state = EMU_RX_ADDR; }
+      else if(b != 0xEF) emu->rx_state = EMU_RX_HDR0;
+    break;
+    case EMU_RX_ADDR:
+      emu->rx_hdr[emu->rx_idx++] = b;
+      if(emu->rx_idx == 6) emu->rx_state = EMU_RX_PID;
+    break;
+    case EMU_RX_PID:
+      emu->rx_hdr[emu->rx_idx++] = b;
+      emu->rx_state = EMU_RX_LEN;
+    break;
+    case EMU_RX_LEN:
+      emu->rx_hdr[emu->rx_idx++] = b;
+      if(emu->rx_idx == EMU_HDR_LEN){
+          emu->rx_len = emu_get_u16(&emu->rx_hdr[7]);
+          if(emu->rx_len < 2u || emu->rx_len > EMU_MAX_PAYLOAD){
+              emu->stats.rx_bad_frames++;
+              emu->rx_state = EMU_RX_HDR0;
+          }else{
+              emu->rx_idx = 0;
+              emu->rx_state = EMU_RX_PAYLOAD;
+          }
+      }
+    break;
+    case EMU_RX_PAYLOAD:
+      emu->rx_payload[emu->rx_idx++] = b;
+      if(emu->rx_idx == emu->rx_len){
+          emu->rx_state = EMU_RX_HDR0;
+          emu_handle_frame(emu);
+      }
+    break;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Gui cac chunk da den han; tra ve thoi gian (us) cho den chunk ke tiep (UINT64_MAX neu rong)
+ */
+static uint64_t emu_flush_due(zw111_emu_t *emu){
+  while(emu->txq_count > 0){
+      emu_chunk_t *c = &emu->txq[emu->txq_head];
+      uint64_t now = emu_now_us();
+      uint64_t at = c->due_us;
+      if(emu->cfg.emulate_wire_time && emu->wire_free_us > at) at = emu->wire_free_us;
+      if(at > now) return at - now;
+
+      ssize_t w = write(emu->master_fd, c->bytes, c->len);
+      if(w < 0){
+          if(errno == EAGAIN || errno == EINTR) return 1000u;
+          return UINT64_MAX; // Slave da dong -> bo qua
+      }
+      emu->stats.tx_bytes += (uint64_t)w;
+      if(emu->cfg.emulate_wire_time){
+          uint32_t baud = 9600u * (emu->cfg.baud_mult ? emu->cfg.baud_mult : 6u);
+          emu->wire_free_us = now + (uint64_t)w * 10u * 1000000u / baud;
+      }
+      if((uint16_t)w < c->len){
+          memmove(c->bytes, &c->bytes[w], (size_t)(c->len - (uint16_t)w));
+          c->len = (uint16_t)(c->len - (uint16_t)w);
+          continue;
+      }
+      emu->txq_head = (emu->txq_head + 1u) % emu->txq_cap;
+      emu->txq_count--;
+  }
+  return UINT64_MAX;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_default_cfg(zw111_emu_cfg_t *cfg){
+  if(cfg == NULL) return;
+  memset(cfg, 0, sizeof(*cfg));
+  cfg->address = 0xFFFFFFFFu;
+  cfg->password = 0;
+  cfg->capacity = 300;
+  cfg->sensor_type = 0x0009;
+  cfg->baud_mult = 6;
+  cfg->packet_size = ZW111_PKT_SIZE_128;
+  cfg->security = 3;
+  cfg->image_width = 192;
+  cfg->image_height = 192;
+  cfg->stream_ack = true;
+  cfg->emulate_wire_time = false;
+  cfg->latency_scale_pct = 100;
+  cfg->split_gap_ms = 5;
+  cfg->seed = 0x1234567u;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Bang latency mac dinh (uoc luong tu module that)
+ */
+static void emu_default_latency(zw111_emu_t *emu){
+  for(uint32_t i = 0; i < 256u; i++) emu->latency[i] = (zw111_emu_latency_t){ 2, 0, 1 };
+  emu->latency[ZW111_CMD_GET_IMAGE]        = (zw111_emu_latency_t){ 45, 0, 10 };
+  emu->latency[ZW111_CMD_GEN_CHAR]         = (zw111_emu_latency_t){ 90, 0, 20 };
+  emu->latency[ZW111_CMD_MATCH]            = (zw111_emu_latency_t){ 25, 0, 5 };
+  emu->latency[ZW111_CMD_SEARCH]           = (zw111_emu_latency_t){ 15, 300, 5 };
+  emu->latency[ZW111_CMD_REG_MODEL]        = (zw111_emu_latency_t){ 40, 0, 10 };
+  emu->latency[ZW111_CMD_STORE_CHAR]       = (zw111_emu_latency_t){ 35, 0, 10 };
+  emu->latency[ZW111_CMD_LOAD_CHAR]        = (zw111_emu_latency_t){ 10, 0, 3 };
+  emu->latency[ZW111_CMD_DELETE_CHAR]      = (zw111_emu_latency_t){ 20, 800, 5 };
+  emu->latency[ZW111_CMD_EMPTY]            = (zw111_emu_latency_t){ 60, 800, 10 };
+  emu->latency[ZW111_CMD_WRITE_REG]        = (zw111_emu_latency_t){ 15, 0, 3 };
+  emu->latency[ZW111_CMD_WRITE_NOTE_PAD]   = (zw111_emu_latency_t){ 20, 0, 5 };
+  emu->latency[ZW111_CMD_UP_IMAGE]         = (zw111_emu_latency_t){ 10, 0, 2 };
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_emu_t *zw111_emu_create(const zw111_emu_cfg_t *cfg){
+  zw111_emu_t *emu = (zw111_emu_t *)calloc(1, sizeof(zw111_emu_t));
+  if(emu == NULL) return NULL;
+
+  if(cfg) emu->cfg = *cfg;
+  else zw111_emu_default_cfg(&emu->cfg);
+  if(emu->cfg.capacity == 0) emu->cfg.capacity = 1;
+
+  emu->rng = emu->cfg.seed ? emu->cfg.seed : 1u;
+  emu->master_fd = -1;
+  pthread_mutex_init(&emu->lock, NULL);
+  emu_default_latency(emu);
+
+  emu->db = (uint8_t *)calloc(emu->cfg.capacity, ZW111_EMU_TEMPLATE_SIZE);
+  emu->db_used = (uint8_t *)calloc(emu->cfg.capacity, 1);
+  if(emu->db == NULL || emu->db_used == NULL) goto fail;
+
+  emu->master_fd = posix_openpt(O_RDWR | O_NOCTTY);
+  if(emu->master_fd < 0) goto fail;
+  if(grantpt(emu->master_fd) != 0 || unlockpt(emu->master_fd) != 0) goto fail;
+  if(ptsname_r(emu->master_fd, emu->slave_path, sizeof(emu->slave_path)) != 0) goto fail;
+
+  /* Master o che do raw de khong bi line discipline bien doi byte */
+  struct termios tio;
+  if(tcgetattr(emu->master_fd, &tio) == 0){
+      cfmakeraw(&tio);
+      (void)tcsetattr(emu->master_fd, TCSANOW, &tio);
+  }
+  int fl = fcntl(emu->master_fd, F_GETFL, 0);
+  (void)fcntl(emu->master_fd, F_SETFL, fl | O_NONBLOCK);
+  return emu;
+
+  fail:
+    zw111_emu_destroy(emu);
+    return NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_destroy(zw111_emu_t *emu){
+  if(emu == NULL) return;
+  zw111_emu_stop(emu);
+  if(emu->master_fd >= 0) close(emu->master_fd);
+  pthread_mutex_destroy(&emu->lock);
+  free(emu->txq);
+  free(emu->db);
+  free(emu->db_used);
+  free(emu);
+}
+
+/* ----------------------------------------------------------- */
+
+const char *zw111_emu_slave_path(const zw111_emu_t *emu){
+  return emu ? emu->slave_path : NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_emu_service(zw111_emu_t *emu, uint32_t max_wait_ms){
+  if(emu == NULL || emu->master_fd < 0) return false;
+
+  pthread_mutex_lock(&emu->lock);
+  uint64_t wait_us = emu_flush_due(emu);
+  pthread_mutex_unlock(&emu->lock);
+
+  int timeout = (int)max_wait_ms;
+  if(wait_us != UINT64_MAX && wait_us / 1000u < (uint64_t)timeout) timeout = (int)(wait_us / 1000u);
+
+  struct pollfd pfd = { .fd = emu->master_fd, .events = POLLIN, .revents = 0 };
+  int pr = poll(&pfd, 1, timeout);
+  if(pr < 0 && errno != EINTR) return false;
+
+  pthread_mutex_lock(&emu->lock);
+  if(pr > 0 && (pfd.revents & POLLIN)){
+      uint8_t buf[512];
+      ssize_t n;
+      while((n = read(emu->master_fd, buf, sizeof(buf))) > 0){
+          emu->stats.rx_bytes += (uint64_t)n;
+          for(ssize_t i = 0; i < n; i++) emu_rx_byte(emu, buf[i]);
+      }
+  }else if(pr > 0 && (pfd.revents & POLLHUP)){
+      /* Slave chua mo hoac da dong: tranh spin */
+      pthread_mutex_unlock(&emu->lock);
+      usleep(1000);
+      pthread_mutex_lock(&emu->lock);
+  }
+  (void)emu_flush_due(emu);
+  pthread_mutex_unlock(&emu->lock);
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+static void *emu_thread_main(void *arg){
+  zw111_emu_t *emu = (zw111_emu_t *)arg;
+  while(!emu->thread_stop){
+      if(!zw111_emu_service(emu, 2)) usleep(1000);
+  }
+  return NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_emu_start(zw111_emu_t *emu){
+  if(emu == NULL || emu->thread_running) return false;
+  emu->thread_stop = false;
+  if(pthread_create(&emu->thread, NULL, emu_thread_main, emu) != 0) return false;
+  emu->thread_running = true;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_stop(zw111_emu_t *emu){
+  if(emu == NULL || !emu->thread_running) return;
+  emu->thread_stop = true;
+  pthread_join(emu->thread, NULL);
+  emu->thread_running = false;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_set_finger(zw111_emu_t *emu, uint32_t finger_id, zw111_emu_finger_quality_t quality){
+  if(emu == NULL) return;
+  pthread_mutex_lock(&emu->lock);
+  emu->finger_id = finger_id;
+  emu->finger_quality = quality;
+  pthread_mutex_unlock(&emu->lock);
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_emu_preload(zw111_emu_t *emu, uint16_t page_id, uint32_t finger_id){
+  if(emu == NULL || page_id >= emu->cfg.capacity) return false;
+  pthread_mutex_lock(&emu->lock);
+  zw111_emu_make_template(finger_id, &emu->db[(uint32_t)page_id * ZW111_EMU_TEMPLATE_SIZE]);
+  emu->db_used[page_id] = 1;
+  pthread_mutex_unlock(&emu->lock);
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_get_stats(zw111_emu_t *emu, zw111_emu_stats_t *stats){
+  if(emu == NULL || stats == NULL) return;
+  pthread_mutex_lock(&emu->lock);
+  *stats = emu->stats;
+  pthread_mutex_unlock(&emu->lock);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_set_faults(zw111_emu_t *emu, uint16_t garbage_permille, uint16_t split_permille, uint16_t badsum_permille){
+  if(emu == NULL) return;
+  pthread_mutex_lock(&emu->lock);
+  emu->cfg.garbage_permille = garbage_permille;
+  emu->cfg.split_permille = split_permille;
+  emu->cfg.badsum_permille = badsum_permille;
+  pthread_mutex_unlock(&emu->lock);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_emu_set_latency(zw111_emu_t *emu, zw111_cmd_t cmd, zw111_emu_latency_t lat){
+  if(emu == NULL) return;
+  pthread_mutex_lock(&emu->lock);
+  emu->latency[(uint8_t)cmd] = lat;
+  pthread_mutex_unlock(&emu->lock);
+}
+
+/* ----------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,184 @@
+/*
+ * @file zw111_emu.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Emulator hanh vi (behavioral) cua cam bien ZW111 chay tren pseudo-terminal (pty) cua host Linux
+ * - Noi chung dung packet format cua `zw111_lowlevel.h` (Header 0xEF01, Address, PID, Length, Checksum)
+ * - Thuc thi Instruction Set trong `zw111_cmd_t` voi template database trong RAM
+ * - Co mo hinh latency xu ly theo tung lenh va co che inject loi (byte rac, frame bi tach, sai checksum)
+ *
+ * @note
+ * Dung de load-test duong resync ACK cua `zw111_ll_receive_ack_packet_ver2` va benchmark throughput
+ * truoc khi co phan cung. Driver phia host mo `zw111_emu_slave_path()` qua port `LINUX_PLATFORM`
+ *
+ * @remark
+ * Emulator khong phu thuoc vao Port/LowLevel cua driver (chi dung lai dinh nghia trong `zw111_types.h`)
+ */
+
+#ifndef ZW111_LIB_HOST_ZW111_EMU_H_
+#define ZW111_LIB_HOST_ZW111_EMU_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdio.h"
+#include "stdint.h"
+#include "stdbool.h"
+#include "../Inc/zw111_types.h"
+
+/* Kich thuoc 1 template (bytes) tra ve qua UP_CHAR / nhan qua DOWN_CHAR */
+#ifndef ZW111_EMU_TEMPLATE_SIZE
+#define ZW111_EMU_TEMPLATE_SIZE     512u
+#endif // ZW111_EMU_TEMPLATE_SIZE
+
+/* So trang NotePad (moi trang 32 bytes) */
+#define ZW111_EMU_NOTEPAD_PAGES     16u
+#define ZW111_EMU_NOTEPAD_PAGE_SIZE 32u
+
+/* Chat luong ngon tay gia lap dat tren cam bien */
+typedef enum ZW111_EMU_FINGER_QUALITY {
+  ZW111_EMU_FINGER_GOOD = 0,   /* Anh tot, GEN_CHAR thanh cong */
+  ZW111_EMU_FINGER_DRY,        /* GEN_CHAR tra ve ZW111_ACK_IMAGE_TOO_DRY */
+  ZW111_EMU_FINGER_WET,        /* GEN_CHAR tra ve ZW111_ACK_IMAGE_TOO_WET */
+  ZW111_EMU_FINGER_PARTIAL     /* GEN_CHAR tra ve ZW111_ACK_FEW_FEATURE */
+} zw111_emu_finger_quality_t;
+
+/* Mo hinh latency xu ly cua 1 lenh: base + per_unit * so don vi (page/template) + jitter ngau nhien */
+typedef struct {
+  uint16_t base_ms;
+  uint16_t per_unit_us;
+  uint16_t jitter_ms;
+} zw111_emu_latency_t;
+
+/* Cau hinh emulator */
+typedef struct ZW111_EMU_CFG {
+  uint32_t address;             /* Dia chi chip (mac dinh 0xFFFFFFFF) */
+  uint32_t password;            /* Mat khau (0 = khong can verify) */
+  uint16_t capacity;            /* So template toi da (DataBaseSize) */
+  uint16_t sensor_type;
+  uint8_t baud_mult;            /* N -> 9600 * N */
+  uint8_t packet_size;          /* zw111_packet_size_t */
+  uint8_t security;             /* 1..5 */
+  uint16_t image_width;
+  uint16_t image_height;
+
+  /* ACK 0xF1/0xF0 cho tung Data Packet khi host DOWN_CHAR (true) hay chi ACK 0x00 o cuoi (false) */
+  bool stream_ack;
+
+  /* Gia lap thoi gian tren day (wire time) theo baudrate hien tai cua emulator */
+  bool emulate_wire_time;
+
+  /* Ti le latency (phan tram) ap dung cho toan bo bang latency (100 = nguyen ban, 0 = tra loi ngay) */
+  uint16_t latency_scale_pct;
+
+  /* Inject loi (don vi: phan nghin tren moi frame gui ra) */
+  uint16_t garbage_permille;    /* Chen 1..8 byte rac truoc frame */
+  uint16_t split_permille;      /* Tach frame lam 2 lan write, cach nhau split_gap_ms */
+  uint16_t badsum_permille;     /* Lam sai checksum cua frame */
+  uint16_t split_gap_ms;
+
+  /* Tu baud multiplier nay tro len, moi frame co the bi hong (gia lap cap/adapter khong on dinh) */
+  uint8_t unstable_above_mult;  /* 0 = tat */
+  uint16_t unstable_permille;
+
+  uint32_t seed;                /* Seed cho PRNG (tai lap duoc ket qua) */
+} zw111_emu_cfg_t;
+
+/* Thong ke cua emulator */
+typedef struct {
+  uint32_t rx_frames;
+  uint32_t rx_bad_frames;
+  uint32_t tx_frames;
+  uint64_t rx_bytes;
+  uint64_t tx_bytes;
+  uint32_t injected_garbage;
+  uint32_t injected_split;
+  uint32_t injected_badsum;
+  uint32_t cmd_count[256];
+} zw111_emu_stats_t;
+
+/* Context cua emulator (opaque) */
+typedef struct ZW111_EMU zw111_emu_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Dien cau hinh mac dinh (gan voi module that: 57600 baud, 128-byte packet, 300 template)
+ */
+void zw111_emu_default_cfg(zw111_emu_cfg_t *cfg);
+
+/**
+ * @brief Tao emulator moi va mo 1 cap pty (master giu boi emulator, slave cho driver)
+ * @return Con tro emulator hoac NULL neu loi
+ */
+zw111_emu_t *zw111_emu_create(const zw111_emu_cfg_t *cfg);
+
+/**
+ * @brief Dung thread (neu co), dong pty va giai phong emulator
+ */
+void zw111_emu_destroy(zw111_emu_t *emu);
+
+/**
+ * @brief Duong dan slave pty (vi du /dev/pts/5) de driver mo qua `zw111_port_linux_cfg_t.device`
+ */
+const char *zw111_emu_slave_path(const zw111_emu_t *emu);
+
+/**
+ * @brief Xu ly 1 vong: doc byte tu master, parse, thuc thi lenh va gui cac frame da den han
+ * @param max_wait_ms Thoi gian block toi da cho du lieu moi
+ * @return false neu pty loi khong the tiep tuc
+ */
+bool zw111_emu_service(zw111_emu_t *emu, uint32_t max_wait_ms);
+
+/**
+ * @brief Chay `zw111_emu_service()` trong 1 pthread rieng (driver blocking co the goi tu thread chinh)
+ */
+bool zw111_emu_start(zw111_emu_t *emu);
+
+/**
+ * @brief Dung thread da start boi `zw111_emu_start()`
+ */
+void zw111_emu_stop(zw111_emu_t *emu);
+
+/**
+ * @brief Dat/nhac ngon tay tren cam bien
+ * @param finger_id ID ngon tay (0 = khong co ngon tay)
+ * @param quality Chat luong anh khi GEN_CHAR
+ */
+void zw111_emu_set_finger(zw111_emu_t *emu, uint32_t finger_id, zw111_emu_finger_quality_t quality);
+
+/**
+ * @brief Nap san template cua `finger_id` vao page_id (khong can di qua enroll)
+ */
+bool zw111_emu_preload(zw111_emu_t *emu, uint16_t page_id, uint32_t finger_id);
+
+/**
+ * @brief Sinh noi dung template chuan cua 1 finger_id (giong het UP_CHAR sau GEN_CHAR + REG_MODEL)
+ */
+void zw111_emu_make_template(uint32_t finger_id, uint8_t out[ZW111_EMU_TEMPLATE_SIZE]);
+
+/**
+ * @brief Snapshot thong ke hien tai
+ */
+void zw111_emu_get_stats(zw111_emu_t *emu, zw111_emu_stats_t *stats);
+
+/**
+ * @brief Doi cau hinh inject loi khi dang chay (garbage/split/badsum - phan nghin)
+ */
+void zw111_emu_set_faults(zw111_emu_t *emu, uint16_t garbage_permille, uint16_t split_permille, uint16_t badsum_permille);
+
+/**
+ * @brief Thay latency model cua 1 lenh
+ */
+void zw111_emu_set_latency(zw111_emu_t *emu, zw111_cmd_t cmd, zw111_emu_latency_t lat);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_HOST_ZW111_EMU_H_ */
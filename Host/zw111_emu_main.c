@@ -0,0 +1,140 @@
+/*
+ * @file zw111_emu_main.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Chuong trinh CLI chay emulator ZW111 tren pty
+ * In ra duong dan slave pty, driver (LINUX_PLATFORM) mo duong dan nay nhu 1 cong serial
+ *
+ * @note
+ * Build: gcc -D_GNU_SOURCE -IInc Host/zw111_emu.c Host/zw111_emu_main.c -lpthread -o zw111_emu
+ *
+ * @code
+ * ./zw111_emu --capacity 500 --garbage 50 --split 50 --badsum 10 --finger 7 --preload 1:7
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#include "zw111_emu.h"
+
+#include <getopt.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
+static volatile sig_atomic_t s_stop = 0;
+
+/* ----------------------------------------------------------- */
+
+static void emu_main_on_signal(int sig){
+  (void)sig;
+  s_stop = 1;
+}
+
+/* ----------------------------------------------------------- */
+
+static void emu_main_usage(const char *prog){
+  printf("Usage: %s [options]\n"
+         "  --capacity N        So template toi da (mac dinh 300)\n"
+         "  --address HEX       Dia chi chip (mac dinh FFFFFFFF)\n"
+         "  --password HEX      Mat khau (mac dinh 0)\n"
+         "  --pkt-size 0..3     32/64/128/256 bytes\n"
+         "  --latency PCT       Ti le latency xu ly (100 = nguyen ban)\n"
+         "  --wire-time         Gia lap thoi gian truyen theo baudrate\n"
+         "  --no-stream-ack     Khong ACK tung Data Packet khi DOWN_CHAR\n"
+         "  --garbage PM        Ti le chen byte rac (phan nghin)\n"
+         "  --split PM          Ti le tach frame (phan nghin)\n"
+         "  --badsum PM         Ti le sai checksum (phan nghin)\n"
+         "  --finger ID         Dat ngon tay ID len cam bien ngay tu dau\n"
+         "  --preload PAGE:ID   Nap san template cua ngon tay ID vao PAGE (lap lai duoc)\n"
+         "  --seed N            Seed PRNG\n", prog);
+}
+
+/* ----------------------------------------------------------- */
+
+int main(int argc, char **argv){
+  zw111_emu_cfg_t cfg;
+  zw111_emu_default_cfg(&cfg);
+
+  uint32_t finger = 0;
+  uint32_t preload_page[64], preload_id[64];
+  uint32_t preload_n = 0;
+
+  static const struct option opts[] = {
+    { "capacity",      required_argument, 0, 'c' },
+    { "address",       required_argument, 0, 'a' },
+    { "password",      required_argument, 0, 'p' },
+    { "pkt-size",      required_argument, 0, 'k' },
+    { "latency",       required_argument, 0, 'l' },
+    { "wire-time",     no_argument,       0, 'w' },
+    { "no-stream-ack", no_argument,       0, 'n' },
+    { "garbage",       required_argument, 0, 'g' },
+    { "split",         required_argument, 0, 's' },
+    { "badsum",        required_argument, 0, 'b' },
+    { "finger",        required_argument, 0, 'f' },
+    { "preload",       required_argument, 0, 'P' },
+    { "seed",          required_argument, 0, 'S' },
+    { "help",          no_argument,       0, 'h' },
+    { 0, 0, 0, 0 }
+  };
+
+  int c;
+  while((c = getopt_long(argc, argv, "h", opts, NULL)) != -1){
+      switch(c){
+        case 'c': cfg.capacity = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'a': cfg.address = (uint32_t)strtoul(optarg, NULL, 16); break;
+        case 'p': cfg.password = (uint32_t)strtoul(optarg, NULL, 16); break;
+        case 'k': cfg.packet_size = (uint8_t)strtoul(optarg, NULL, 0); break;
+        case 'l': cfg.latency_scale_pct = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'w': cfg.emulate_wire_time = true; break;
+        case 'n': cfg.stream_ack = false; break;
+        case 'g': cfg.garbage_permille = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 's': cfg.split_permille = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'b': cfg.badsum_permille = (uint16_t)strtoul(optarg, NULL, 0); break;
+        case 'f': finger = (uint32_t)strtoul(optarg, NULL, 0); break;
+        case 'P':{
+          char *sep = strchr(optarg, ':');
+          if(sep == NULL || preload_n >= 64){ emu_main_usage(argv[0]); return 1; }
+          preload_page[preload_n] = (uint32_t)strtoul(optarg, NULL, 0);
+          preload_id[preload_n] = (uint32_t)strtoul(sep + 1, NULL, 0);
+          preload_n++;
+        }
+        break;
+        case 'S': cfg.seed = (uint32_t)strtoul(optarg, NULL, 0); break;
+        default: emu_main_usage(argv[0]); return (c == 'h') ? 0 : 1;
+      }
+  }
+
+  zw111_emu_t *emu = zw111_emu_create(&cfg);
+  if(emu == NULL){
+      fprintf(stderr, "[EMU] Create emulator failed\n");
+      return 1;
+  }
+
+  for(uint32_t i = 0; i < preload_n; i++) (void)zw111_emu_preload(emu, (uint16_t)preload_page[i], preload_id[i]);
+  if(finger) zw111_emu_set_finger(emu, finger, ZW111_EMU_FINGER_GOOD);
+
+  signal(SIGINT, emu_main_on_signal);
+  signal(SIGTERM, emu_main_on_signal);
+
+  printf("[EMU] ZW111 emulator ready on %s\n", zw111_emu_slave_path(emu));
+  fflush(stdout);
+
+  while(!s_stop){
+      if(!zw111_emu_service(emu, 50)) break;
+  }
+
+  zw111_emu_stats_t st;
+  zw111_emu_get_stats(emu, &st);
+  printf("[EMU] rx_frames=%u bad=%u tx_frames=%u rx_bytes=%llu tx_bytes=%llu garbage=%u split=%u badsum=%u\n",
+         st.rx_frames, st.rx_bad_frames, st.tx_frames,
+         (unsigned long long)st.rx_bytes, (unsigned long long)st.tx_bytes,
+         st.injected_garbage, st.injected_split, st.injected_badsum);
+
+  zw111_emu_destroy(emu);
+  return 0;
+}
@@ -0,0 +1,415 @@
+/*
+ * @file zw111_image.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Giai nen + metric anh goc ZW111 tren host (scalar / SSE2 / AVX2, chon luc runtime)
+ *
+ * @note
+ * Build: gcc -O2 -IInc Host/zw111_image.c ... -lm
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_image.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define ZW111_IMG_X86   1
+#include <immintrin.h>
+#else
+#define ZW111_IMG_X86   0
+#endif
+
+/* ==================== SCALAR (THAM CHIEU) ==================== */
+
+static void img_unpack_scalar(const uint8_t *packed, uint8_t *out, uint32_t pixels){
+  uint32_t n = pixels / 2u;
+  for(uint32_t i = 0; i < n; i++){
+      uint8_t b = packed[i];
+      out[2u * i]      = (uint8_t)((b >> 4) * 17u);   // Nibble cao = pixel trai
+      out[2u * i + 1u] = (uint8_t)((b & 0x0Fu) * 17u);
+  }
+  if(pixels & 1u) out[pixels - 1u] = (uint8_t)((packed[n] >> 4) * 17u);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Metric cua pixel [from, width) trong hang (row[width] da duoc lap bang pixel cuoi -> |dx| cuoi = 0)
+ */
+static void img_stats_scalar(const uint8_t *row, const uint8_t *prev, uint16_t from, uint16_t width, zw111_img_acc_t *acc){
+  uint64_t sum = 0, sq = 0, ridge = 0, grad = 0;
+  for(uint16_t x = from; x < width; x++){
+      uint32_t v = row[x];
+      sum += v;
+      sq += v * v;
+      ridge += (v < ZW111_IMG_RIDGE_THRESHOLD);
+      grad += (uint32_t)abs((int)row[x + 1u] - (int)v);
+      if(prev != NULL) grad += (uint32_t)abs((int)v - (int)prev[x]);
+  }
+  acc->sum += sum;
+  acc->sum_sq += sq;
+  acc->ridge += ridge;
+  acc->grad += grad;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Lap pixel cuoi vao vung du phong (lenh SIMD doc row[x + 1] khong ra ngoai hang)
+ */
+static inline void img_pad_row(uint8_t *row, uint16_t width){
+  memset(&row[width], row[width - 1u], ZW111_IMG_ROW_PAD);
+}
+
+/* ----------------------------------------------------------- */
+
+static void img_row_scalar(const uint8_t *packed, uint8_t *row, const uint8_t *prev, uint16_t width, zw111_img_acc_t *acc){
+  img_unpack_scalar(packed, row, width);
+  img_pad_row(row, width);
+  img_stats_scalar(row, prev, 0, width, acc);
+}
+
+#if ZW111_IMG_X86
+
+/* ==================== SSE2 ==================== */
+
+__attribute__((target("sse2")))
+static uint32_t img_unpack_sse2(const uint8_t *packed, uint8_t *out, uint32_t pixels){
+  const __m128i m0f = _mm_set1_epi8(0x0F);
+  uint32_t i = 0;
+  for(; i + 16u <= pixels / 2u; i += 16u){
+      __m128i b = _mm_loadu_si128((const __m128i *)&packed[i]);
+      __m128i hi = _mm_and_si128(_mm_srli_epi16(b, 4), m0f);
+      __m128i lo = _mm_and_si128(b, m0f);
+      __m128i p0 = _mm_unpacklo_epi8(hi, lo);                 // Pixel 0..15 (hi, lo xen ke)
+      __m128i p1 = _mm_unpackhi_epi8(hi, lo);                 // Pixel 16..31
+      p0 = _mm_or_si128(p0, _mm_slli_epi16(p0, 4));           // v * 17 = (v << 4) | v (v <= 15 nen khong tran sang byte ke)
+      p1 = _mm_or_si128(p1, _mm_slli_epi16(p1, 4));
+      _mm_storeu_si128((__m128i *)&out[2u * i], p0);
+      _mm_storeu_si128((__m128i *)&out[2u * i + 16u], p1);
+  }
+  return 2u * i; // So pixel da giai nen
+}
+
+/* ----------------------------------------------------------- */
+
+__attribute__((target("sse2")))
+static inline uint64_t img_hsum_epi64_sse2(__m128i v){
+  uint64_t lane[2];
+  _mm_storeu_si128((__m128i *)lane, v); // Khong dung _mm_cvtsi128_si64 (chi co tren x86_64)
+  return lane[0] + lane[1];
+}
+
+/* ----------------------------------------------------------- */
+
+__attribute__((target("sse2")))
+static void img_row_sse2(const uint8_t *packed, uint8_t *row, const uint8_t *prev, uint16_t width, zw111_img_acc_t *acc){
+  uint32_t done = img_unpack_sse2(packed, row, width);
+  img_unpack_scalar(&packed[done / 2u], &row[done], width - done);
+  img_pad_row(row, width);
+
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i thr = _mm_set1_epi8((char)(ZW111_IMG_RIDGE_THRESHOLD - 1u));
+  __m128i s_sum = zero, s_sq = zero, s_grad = zero;
+  uint64_t ridge = 0;
+
+  uint16_t x = 0;
+  for(; x + 16u <= width; x += 16u){
+      __m128i v = _mm_loadu_si128((const __m128i *)&row[x]);
+      __m128i n = _mm_loadu_si128((const __m128i *)&row[x + 1u]);
+
+      s_sum = _mm_add_epi64(s_sum, _mm_sad_epu8(v, zero));
+
+      __m128i w0 = _mm_unpacklo_epi8(v, zero);
+      __m128i w1 = _mm_unpackhi_epi8(v, zero);
+      s_sq = _mm_add_epi32(s_sq, _mm_add_epi32(_mm_madd_epi16(w0, w0), _mm_madd_epi16(w1, w1)));
+
+      /* v < thr <=> min(v, thr - 1) == v */
+      ridge += (uint32_t)__builtin_popcount((unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(v, thr), v)));
+
+      /* |a - b| cua u8 = subs(a, b) | subs(b, a), cong ngang bang SAD voi 0 */
+      __m128i dx = _mm_or_si128(_mm_subs_epu8(v, n), _mm_subs_epu8(n, v));
+      s_grad = _mm_add_epi64(s_grad, _mm_sad_epu8(dx, zero));
+      if(prev != NULL){
+          __m128i p = _mm_loadu_si128((const __m128i *)&prev[x]);
+          __m128i dy = _mm_or_si128(_mm_subs_epu8(v, p), _mm_subs_epu8(p, v));
+          s_grad = _mm_add_epi64(s_grad, _mm_sad_epu8(dy, zero));
+      }
+  }
+
+  /* Tong binh phuong: 4 lane 32-bit -> 64-bit (1 hang <= 512 pixel nen lane khong tran) */
+  __m128i sq64 = _mm_add_epi64(_mm_unpacklo_epi32(s_sq, zero), _mm_unpackhi_epi32(s_sq, zero));
+  acc->sum += img_hsum_epi64_sse2(s_sum);
+  acc->sum_sq += img_hsum_epi64_sse2(sq64);
+  acc->ridge += ridge;
+  acc->grad += img_hsum_epi64_sse2(s_grad);
+
+  img_stats_scalar(row, prev, x, width, acc);
+}
+
+/* ==================== AVX2 ==================== */
+
+__attribute__((target("avx2")))
+static uint32_t img_unpack_avx2(const uint8_t *packed, uint8_t *out, uint32_t pixels){
+  const __m256i m0f = _mm256_set1_epi8(0x0F);
+  uint32_t i = 0;
+  for(; i + 32u <= pixels / 2u; i += 32u){
+      __m256i b = _mm256_loadu_si256((const __m256i *)&packed[i]);
+      __m256i hi = _mm256_and_si256(_mm256_srli_epi16(b, 4), m0f);
+      __m256i lo = _mm256_and_si256(b, m0f);
+      /* unpack cua AVX2 chay rieng tung lane 128-bit -> ghep lai dung thu tu pixel */
+      __m256i a = _mm256_unpacklo_epi8(hi, lo);               // [px 0..15 | px 32..47]
+      __m256i c = _mm256_unpackhi_epi8(hi, lo);               // [px 16..31 | px 48..63]
+      __m256i p0 = _mm256_permute2x128_si256(a, c, 0x20);     // px 0..31
+      __m256i p1 = _mm256_permute2x128_si256(a, c, 0x31);     // px 32..63
+      p0 = _mm256_or_si256(p0, _mm256_slli_epi16(p0, 4));
+      p1 = _mm256_or_si256(p1, _mm256_slli_epi16(p1, 4));
+      _mm256_storeu_si256((__m256i *)&out[2u * i], p0);
+      _mm256_storeu_si256((__m256i *)&out[2u * i + 32u], p1);
+  }
+  return 2u * i;
+}
+
+/* ----------------------------------------------------------- */
+
+__attribute__((target("avx2")))
+static inline uint64_t img_hsum_epi64_avx2(__m256i v){
+  uint64_t lane[2];
+  _mm_storeu_si128((__m128i *)lane, _mm_add_epi64(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+  return lane[0] + lane[1];
+}
+
+/* ----------------------------------------------------------- */
+
+__attribute__((target("avx2")))
+static void img_row_avx2(const uint8_t *packed, uint8_t *row, const uint8_t *prev, uint16_t width, zw111_img_acc_t *acc){
+  uint32_t done = img_unpack_avx2(packed, row, width);
+  img_unpack_scalar(&packed[done / 2u], &row[done], width - done);
+  img_pad_row(row, width);
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i thr = _mm256_set1_epi8((char)(ZW111_IMG_RIDGE_THRESHOLD - 1u));
+  __m256i s_sum = zero, s_sq = zero, s_grad = zero;
+  uint64_t ridge = 0;
+
+  uint16_t x = 0;
+  for(; x + 32u <= width; x += 32u){
+      __m256i v = _mm256_loadu_si256((const __m256i *)&row[x]);
+      __m256i n = _mm256_loadu_si256((const __m256i *)&row[x + 1u]);
+
+      s_sum = _mm256_add_epi64(s_sum, _mm256_sad_epu8(v, zero));
+
+      __m256i w0 = _mm256_unpacklo_epi8(v, zero);
+      __m256i w1 = _mm256_unpackhi_epi8(v, zero);
+      s_sq = _mm256_add_epi32(s_sq, _mm256_add_epi32(_mm256_madd_epi16(w0, w0), _mm256_madd_epi16(w1, w1)));
+
+      ridge += (uint32_t)__builtin_popcount((unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(v, thr), v)));
+
+      __m256i dx = _mm256_or_si256(_mm256_subs_epu8(v, n), _mm256_subs_epu8(n, v));
+      s_grad = _mm256_add_epi64(s_grad, _mm256_sad_epu8(dx, zero));
+      if(prev != NULL){
+          __m256i p = _mm256_loadu_si256((const __m256i *)&prev[x]);
+          __m256i dy = _mm256_or_si256(_mm256_subs_epu8(v, p), _mm256_subs_epu8(p, v));
+          s_grad = _mm256_add_epi64(s_grad, _mm256_sad_epu8(dy, zero));
+      }
+  }
+
+  __m256i sq64 = _mm256_add_epi64(_mm256_unpacklo_epi32(s_sq, zero), _mm256_unpackhi_epi32(s_sq, zero));
+  acc->sum += img_hsum_epi64_avx2(s_sum);
+  acc->sum_sq += img_hsum_epi64_avx2(sq64);
+  acc->ridge += ridge;
+  acc->grad += img_hsum_epi64_avx2(s_grad);
+  _mm256_zeroupper(); // Tranh phat chuyen trang thai AVX -> SSE o code goi sau (memcpy, tail scalar)
+
+  img_stats_scalar(row, prev, x, width, acc);
+}
+
+#endif // ZW111_IMG_X86
+
+/* ==================== DISPATCH ==================== */
+
+/**
+ * @brief Resolve AUTO va kiem tra CPU ho tro ban duoc ep
+ * @return ZW111_IMG_IMPL_AUTO neu khong ho tro
+ */
+static zw111_img_impl_t img_resolve(zw111_img_impl_t impl){
+  if(impl == ZW111_IMG_IMPL_AUTO) return zw111_img_best_impl();
+  if(impl == ZW111_IMG_IMPL_SCALAR) return impl;
+#if ZW111_IMG_X86
+  __builtin_cpu_init();
+  if(impl == ZW111_IMG_IMPL_SSE2 && __builtin_cpu_supports("sse2")) return impl;
+  if(impl == ZW111_IMG_IMPL_AVX2 && __builtin_cpu_supports("avx2")) return impl;
+#endif // ZW111_IMG_X86
+  return ZW111_IMG_IMPL_AUTO;
+}
+
+/* ----------------------------------------------------------- */
+
+static zw111_img_row_fn_t img_row_fn(zw111_img_impl_t impl){
+  switch(impl){
+#if ZW111_IMG_X86
+    case ZW111_IMG_IMPL_SSE2: return img_row_sse2;
+    case ZW111_IMG_IMPL_AVX2: return img_row_avx2;
+#endif // ZW111_IMG_X86
+    default:                  return img_row_scalar;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief 1 hang packed day du -> giai nen + cong don metric (hang truoc van nam trong rows[cur ^ 1])
+ */
+static void img_process_row(zw111_img_analyzer_t *a, const uint8_t *packed){
+  uint8_t *row = a->rows[a->cur];
+  const uint8_t *prev = (a->height > 0) ? a->rows[a->cur ^ 1u] : NULL;
+  a->row_fn(packed, row, prev, a->width, &a->acc);
+
+  if(a->out != NULL && (uint32_t)(a->height + 1u) * a->width <= a->out_cap){
+      memcpy(&a->out[(uint32_t)a->height * a->width], row, a->width);
+  }
+  a->cur ^= 1u;
+  a->height++;
+}
+
+// =============== PROTOTYPE FUNCTION DEFINITION ===============
+
+zw111_img_impl_t zw111_img_best_impl(void){
+#if ZW111_IMG_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2")) return ZW111_IMG_IMPL_AVX2;
+  if(__builtin_cpu_supports("sse2")) return ZW111_IMG_IMPL_SSE2;
+#endif // ZW111_IMG_X86
+  return ZW111_IMG_IMPL_SCALAR;
+}
+
+/* ----------------------------------------------------------- */
+
+const char *zw111_img_impl_name(zw111_img_impl_t impl){
+  switch(impl){
+    case ZW111_IMG_IMPL_SCALAR: return "scalar";
+    case ZW111_IMG_IMPL_SSE2:   return "sse2";
+    case ZW111_IMG_IMPL_AVX2:   return "avx2";
+    default:                    return "auto";
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_img_init(zw111_img_analyzer_t *a, uint16_t width, zw111_img_impl_t impl){
+  if(a == NULL || width < 2u || (width & 1u) || width > ZW111_IMG_MAX_WIDTH) return false;
+
+  zw111_img_impl_t use = img_resolve(impl);
+  if(use == ZW111_IMG_IMPL_AUTO) return false;
+
+  memset(&a->acc, 0, sizeof(a->acc));
+  a->width = width;
+  a->height = 0;
+  a->impl = use;
+  a->row_fn = img_row_fn(use);
+  a->packed_len = 0;
+  a->cur = 0;
+  a->out = NULL;
+  a->out_cap = 0;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_img_set_output(zw111_img_analyzer_t *a, uint8_t *out, uint32_t cap){
+  if(a == NULL) return;
+  a->out = out;
+  a->out_cap = (out != NULL) ? cap : 0;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @note Hang nam tron trong `data` duoc xu ly tai cho (khong copy), chi phan vat qua bien Packet moi ghep vao `packed`
+ */
+void zw111_img_feed(zw111_img_analyzer_t *a, const uint8_t *data, uint32_t len){
+  if(a == NULL || data == NULL) return;
+  const uint16_t row_bytes = a->width / 2u;
+
+  /* Ghep not hang dang do tu Packet truoc */
+  if(a->packed_len != 0){
+      uint32_t take = row_bytes - a->packed_len;
+      if(take > len) take = len;
+      memcpy(&a->packed[a->packed_len], data, take);
+      a->packed_len += (uint16_t)take;
+      data += take;
+      len -= take;
+      if(a->packed_len < row_bytes) return;
+      img_process_row(a, a->packed);
+      a->packed_len = 0;
+  }
+
+  while(len >= row_bytes){
+      img_process_row(a, data);
+      data += row_bytes;
+      len -= row_bytes;
+  }
+
+  if(len != 0){
+      memcpy(a->packed, data, len);
+      a->packed_len = (uint16_t)len;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_img_sink(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  (void)last;
+  zw111_img_analyzer_t *a = (zw111_img_analyzer_t *)ctx;
+  if(a == NULL) return false;
+  zw111_img_feed(a, data, len);
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_img_finish(const zw111_img_analyzer_t *a, zw111_img_metrics_t *m){
+  if(a == NULL || m == NULL) return;
+  memset(m, 0, sizeof(*m));
+  m->width = a->width;
+  m->height = a->height;
+
+  uint64_t n = (uint64_t)a->width * a->height;
+  if(n == 0) return;
+
+  double mean = (double)a->acc.sum / (double)n;
+  double var = (double)a->acc.sum_sq / (double)n - mean * mean;
+  m->mean = (float)mean;
+  m->contrast = (float)sqrt(var > 0.0 ? var : 0.0);
+  m->ridge_ratio = (float)((double)a->acc.ridge / (double)n);
+  m->sharpness = (float)((double)a->acc.grad / (double)n);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_img_unpack(const uint8_t *packed, uint8_t *out, uint32_t pixels, zw111_img_impl_t impl){
+  if(packed == NULL || out == NULL) return;
+  uint32_t done = 0;
+#if ZW111_IMG_X86
+  switch(img_resolve(impl)){
+    case ZW111_IMG_IMPL_SSE2: done = img_unpack_sse2(packed, out, pixels); break;
+    case ZW111_IMG_IMPL_AVX2: done = img_unpack_avx2(packed, out, pixels); break;
+    default: break;
+  }
+#else
+  (void)impl;
+#endif // ZW111_IMG_X86
+  img_unpack_scalar(&packed[done / 2u], &out[done], pixels - done);
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
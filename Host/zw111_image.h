@@ -0,0 +1,134 @@
+/*
+ * @file zw111_image.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Phan tich anh goc upload tu cam bien (PS_UpImage) tren host (gateway Linux)
+ * - Giai nen 4 bit/pixel (2 pixel/byte) -> hang 8-bit bang SIMD (SSE2/AVX2 tren x86, scalar cho cac CPU khac)
+ * - Cung 1 luot duyet tinh: mean, contrast (do lech chuan), ti le dien tich van (ridge), do net (gradient)
+ *   => tim dau doc co kinh/quang hoc ban (contrast thap + gradient thap) tu hang tram cua moi phut
+ *
+ * @note
+ * Feed thang tu sink cua `zw111_upload_image()` (`zw111_img_sink`) hoac tu file anh da luu (`zw111_img_feed`)
+ * Moi hien thuc (scalar/SSE2/AVX2) cho ket qua giong het nhau (cong don so nguyen, chi chia o `zw111_img_finish`)
+ * Build: gcc -O2 -IInc Host/zw111_image.c ... (AVX2 chon luc runtime, khong can -mavx2)
+ */
+
+#ifndef ZW111_LIB_HOST_ZW111_IMAGE_H_
+#define ZW111_LIB_HOST_ZW111_IMAGE_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "../Inc/zw111_types.h"
+
+/* Chieu rong toi da ho tro (pixel) */
+#ifndef ZW111_IMG_MAX_WIDTH
+#define ZW111_IMG_MAX_WIDTH         512u
+#endif // ZW111_IMG_MAX_WIDTH
+
+/* Pixel (8-bit) nho hon nguong -> thuoc van (ridge toi tren anh quang hoc) */
+#define ZW111_IMG_RIDGE_THRESHOLD   128u
+
+/* Du phong cuoi hang cho lenh SIMD doc lo (pixel cuoi duoc lap lai) */
+#define ZW111_IMG_ROW_PAD           32u
+
+typedef enum ZW111_IMG_IMPL {
+  ZW111_IMG_IMPL_AUTO = 0,    /* Chon ban nhanh nhat CPU ho tro */
+  ZW111_IMG_IMPL_SCALAR,      /* Ban tham chieu */
+  ZW111_IMG_IMPL_SSE2,
+  ZW111_IMG_IMPL_AVX2
+} zw111_img_impl_t;
+
+/* Ket qua phan tich 1 anh */
+typedef struct ZW111_IMG_METRICS {
+  uint16_t width;
+  uint16_t height;            /* So hang day du da nhan */
+  float mean;                 /* Do sang trung binh (0 ~ 255) */
+  float contrast;             /* Do lech chuan cua pixel (RMS contrast), thap -> kinh ban/anh nhat */
+  float ridge_ratio;          /* Ti le pixel < ZW111_IMG_RIDGE_THRESHOLD (0 ~ 1) */
+  float sharpness;            /* Trung binh |dx| + |dy| giua pixel ke nhau, thap -> nhoe */
+} zw111_img_metrics_t;
+
+/* Tong cong don (so nguyen) cua 1 anh */
+typedef struct ZW111_IMG_ACC {
+  uint64_t sum;
+  uint64_t sum_sq;
+  uint64_t ridge;
+  uint64_t grad;              /* Tong |dx| (trong hang) + |dy| (voi hang truoc) */
+} zw111_img_acc_t;
+
+typedef void (*zw111_img_row_fn_t)(const uint8_t *packed, uint8_t *row, const uint8_t *prev, uint16_t width, zw111_img_acc_t *acc);
+
+/* Context phan tich stream (USER cap phat, ~1.3 KB) */
+typedef struct ZW111_IMG_ANALYZER {
+  uint16_t width;
+  uint16_t height;                                      /* So hang da xu ly */
+  zw111_img_impl_t impl;                                /* Ban dang dung (da resolve AUTO) */
+  zw111_img_row_fn_t row_fn;
+  zw111_img_acc_t acc;
+
+  uint8_t packed[ZW111_IMG_MAX_WIDTH / 2u];             /* Hang dang ghep tu cac Data Packet */
+  uint16_t packed_len;
+  uint8_t rows[2][ZW111_IMG_MAX_WIDTH + ZW111_IMG_ROW_PAD]; /* Hang hien tai + hang truoc (8-bit) */
+  uint8_t cur;
+
+  uint8_t *out;                                         /* (Tuy chon) anh 8-bit day du, NULL -> khong luu */
+  uint32_t out_cap;
+} zw111_img_analyzer_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Ban SIMD tot nhat CPU dang chay ho tro
+ */
+zw111_img_impl_t zw111_img_best_impl(void);
+
+/**
+ * @brief Ten hien thuc (in log/benchmark)
+ */
+const char *zw111_img_impl_name(zw111_img_impl_t impl);
+
+/**
+ * @brief Khoi tao context cho 1 anh moi
+ * @param width So pixel 1 hang (chan, <= ZW111_IMG_MAX_WIDTH), thuong la ZW111_IMAGE_WIDTH
+ * @param impl ZW111_IMG_IMPL_AUTO hoac ep 1 ban (ban CPU khong ho tro -> false)
+ */
+bool zw111_img_init(zw111_img_analyzer_t *a, uint16_t width, zw111_img_impl_t impl);
+
+/**
+ * @brief Luu them anh 8-bit day du vao `out` (width x height bytes), hang vuot `cap` bi bo qua
+ */
+void zw111_img_set_output(zw111_img_analyzer_t *a, uint8_t *out, uint32_t cap);
+
+/**
+ * @brief Dua them du lieu packed (bat ky do dai nao, khong can trung bien hang)
+ */
+void zw111_img_feed(zw111_img_analyzer_t *a, const uint8_t *data, uint32_t len);
+
+/**
+ * @brief Sink cho `zw111_upload_image()` (`ctx` la `zw111_img_analyzer_t *`)
+ */
+bool zw111_img_sink(void *ctx, const uint8_t *data, uint16_t len, bool last);
+
+/**
+ * @brief Tinh metric tu phan da nhan (hang chua day bi bo)
+ */
+void zw111_img_finish(const zw111_img_analyzer_t *a, zw111_img_metrics_t *m);
+
+/**
+ * @brief Chi giai nen (khong tinh metric): `pixels` pixel tu `packed` -> `out` (pixel v -> v * 17)
+ */
+void zw111_img_unpack(const uint8_t *packed, uint8_t *out, uint32_t pixels, zw111_img_impl_t impl);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_HOST_ZW111_IMAGE_H_ */
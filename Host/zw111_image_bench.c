@@ -0,0 +1,161 @@
+/*
+ * @file zw111_image_bench.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Benchmark giai nen + metric anh goc: scalar (tham chieu) vs SSE2 vs AVX2
+ * Moi ban phai cho ket qua cong don giong het ban scalar (sai -> exit 1)
+ *
+ * @note
+ * Build: gcc -O2 -IInc Host/zw111_image.c Host/zw111_image_bench.c -lm -o zw111_image_bench
+ *
+ * @code
+ * ./zw111_image_bench [so anh] [width] [height]    // mac dinh 2000 anh 192 x 192
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#include "zw111_image.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Kich thuoc 1 Data Packet khi feed (giong UP_IMAGE packet size 128) */
+#define BENCH_PACKET_BYTES    128u
+
+/* ----------------------------------------------------------- */
+
+static double bench_now_s(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Sinh anh packed gia lap: van cong + nhieu, `dirty` -> contrast thap va nhoe (kinh ban)
+ */
+static void bench_make_image(uint8_t *packed, uint16_t w, uint16_t h, uint32_t seed, int dirty){
+  uint32_t s = seed * 2654435761u + 1u;
+  uint32_t idx = 0;
+  for(uint16_t y = 0; y < h; y++){
+      for(uint16_t x = 0; x < w; x += 2){
+          uint8_t px[2];
+          for(int k = 0; k < 2; k++){
+              s ^= s << 13; s ^= s >> 17; s ^= s << 5;
+              uint32_t xx = (uint32_t)(x + k);
+              uint32_t phase = (xx * 5u + (uint32_t)y * 3u + ((xx * y) >> 6) + (seed & 7u)) >> 2;
+              int v = (phase & 1u) ? 3 : 12;
+              if(dirty) v = (v + 8) / 2;
+              v += (int)(s & 3u) - 1;
+              px[k] = (uint8_t)(v < 0 ? 0 : (v > 15 ? 15 : v));
+          }
+          packed[idx++] = (uint8_t)((px[0] << 4) | px[1]);
+      }
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Phan tich `n` anh bang 1 ban, feed theo tung Packet nhu luc stream tu cam bien
+ * @return Thoi gian (s), < 0 neu CPU khong ho tro ban nay
+ */
+static double bench_run(zw111_img_impl_t impl, const uint8_t *imgs, uint32_t img_bytes, uint32_t n,
+                        uint16_t w, zw111_img_acc_t *acc_out, zw111_img_metrics_t *m_out){
+  static zw111_img_analyzer_t a;
+  if(!zw111_img_init(&a, w, impl)) return -1.0;
+
+  zw111_img_acc_t total;
+  memset(&total, 0, sizeof(total));
+
+  double t0 = bench_now_s();
+  for(uint32_t i = 0; i < n; i++){
+      (void)zw111_img_init(&a, w, impl);
+      const uint8_t *img = &imgs[(size_t)(i % 16u) * img_bytes];
+      for(uint32_t off = 0; off < img_bytes; off += BENCH_PACKET_BYTES){
+          uint32_t len = img_bytes - off;
+          zw111_img_feed(&a, &img[off], len > BENCH_PACKET_BYTES ? BENCH_PACKET_BYTES : len);
+      }
+      total.sum += a.acc.sum;
+      total.sum_sq += a.acc.sum_sq;
+      total.ridge += a.acc.ridge;
+      total.grad += a.acc.grad;
+      if(i == 0) zw111_img_finish(&a, &m_out[0]);   // Anh sach
+      if(i == 1) zw111_img_finish(&a, &m_out[1]);   // Anh ban
+  }
+  double t = bench_now_s() - t0;
+  *acc_out = total;
+  return t;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief So sanh giai nen SIMD voi scalar tren cac do dai le (tail)
+ */
+static int bench_check_unpack(zw111_img_impl_t impl){
+  uint8_t packed[300], ref[600], out[600];
+  for(uint32_t i = 0; i < sizeof(packed); i++) packed[i] = (uint8_t)(i * 37u + 11u);
+  for(uint32_t px = 1; px <= 600; px += 7){
+      zw111_img_unpack(packed, ref, px, ZW111_IMG_IMPL_SCALAR);
+      zw111_img_unpack(packed, out, px, impl);
+      if(memcmp(ref, out, px) != 0) return 1;
+  }
+  return 0;
+}
+
+/* ----------------------------------------------------------- */
+
+int main(int argc, char **argv){
+  uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 2000u;
+  uint16_t w = (argc > 2) ? (uint16_t)strtoul(argv[2], NULL, 0) : (uint16_t)ZW111_IMAGE_WIDTH;
+  uint16_t h = (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 0) : 192u;
+  if(n < 2u) n = 2u;
+
+  uint32_t img_bytes = (uint32_t)w * h / 2u;
+  uint8_t *imgs = (uint8_t *)malloc((size_t)img_bytes * 16u);
+  if(imgs == NULL) return 1;
+  for(uint32_t i = 0; i < 16u; i++) bench_make_image(&imgs[(size_t)i * img_bytes], w, h, i, (int)(i & 1u)); // Le = ban
+
+  printf("%u images %ux%u (%u bytes packed), best=%s\n", n, w, h, img_bytes, zw111_img_impl_name(zw111_img_best_impl()));
+
+  static const zw111_img_impl_t impls[] = { ZW111_IMG_IMPL_SCALAR, ZW111_IMG_IMPL_SSE2, ZW111_IMG_IMPL_AVX2 };
+  zw111_img_acc_t ref;
+  double t_ref = 0.0;
+  int fail = 0;
+
+  for(uint32_t k = 0; k < sizeof(impls) / sizeof(impls[0]); k++){
+      zw111_img_acc_t acc;
+      zw111_img_metrics_t m[2];
+      double t = bench_run(impls[k], imgs, img_bytes, n, w, &acc, m);
+      if(t < 0.0){
+          printf("%-7s not supported\n", zw111_img_impl_name(impls[k]));
+          continue;
+      }
+
+      if(k == 0){
+          ref = acc;
+          t_ref = t;
+      }
+      int same = (memcmp(&acc, &ref, sizeof(acc)) == 0) && !bench_check_unpack(impls[k]);
+      fail |= !same;
+
+      printf("%-7s %8.1f img/s %8.1f MB/s  x%.2f  %s\n", zw111_img_impl_name(impls[k]), n / t,
+             (double)img_bytes * n / t / 1e6, t_ref / t, same ? "match" : "MISMATCH");
+      if(k == 0){
+          printf("        clean: mean=%.1f contrast=%.1f ridge=%.3f sharp=%.1f\n", m[0].mean, m[0].contrast, m[0].ridge_ratio, m[0].sharpness);
+          printf("        dirty: mean=%.1f contrast=%.1f ridge=%.3f sharp=%.1f\n", m[1].mean, m[1].contrast, m[1].ridge_ratio, m[1].sharpness);
+      }
+  }
+
+  free(imgs);
+  return fail;
+}
@@ -0,0 +1,208 @@
+/*
+ * @file zw111_presence_bench.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Benchmark chinh sach poll GetImage (`zw111_presence.h`): do tre phat hien <-> so lan poll/nang luong
+ * Chay bo lap lich that tren thoi gian ao (khong UART), mo hinh cam bien:
+ * - Ngon tay dat ngau nhien (khoang cach phan bo mu), moi lan giu `touch_ms` (+-50%)
+ * - BENCH_LANDING_MS dau tien ngon tay dang dat xuong -> GetImage tra anh loi (ZW111_STATUS_ERROR)
+ * - 1 lan GetImage ton BENCH_UART_MS (Command + ACK 12 bytes o 57600) + BENCH_CAPTURE_MS (cam bien chup)
+ * - Chinh sach "+wake" co ngat TOUCH_OUT: `zw111_presence_wake()` sau BENCH_IRQ_MS tu luc cham
+ * - Dong dien: BENCH_ACTIVE_MA khi dang poll (cam bien chup + MCU thuc cho UART), BENCH_IDLE_MA luc con lai
+ *
+ * @note
+ * So do dong dien la gia tri tham khao, thay bang so do thuc te cua board de so sanh nang luong tuyet doi
+ * Build: gcc -O2 -IInc Src/zw111_presence.c Host/zw111_presence_bench.c -lm -o zw111_presence_bench
+ *
+ * @code
+ * ./zw111_presence_bench [so gio] [khoang cach trung binh ms] [touch ms]   // mac dinh 24 h, 15000 ms, 800 ms
+ * @endcode
+ */
+
+#include "zw111_presence.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BENCH_UART_MS         4u      /* 24 bytes x 10 bit / 57600 */
+#define BENCH_CAPTURE_MS      45u     /* Cam bien chup + xu ly (giong latency GET_IMAGE cua emulator) */
+#define BENCH_LANDING_MS      120u    /* Ngon tay dang dat xuong -> anh loi */
+#define BENCH_IRQ_MS          1u      /* TOUCH_OUT -> MCU goi `zw111_presence_wake()` */
+#define BENCH_ACTIVE_MA       30.0    /* Cam bien chup (~25 mA) + MCU thuc (~5 mA) */
+#define BENCH_IDLE_MA         0.5     /* Cam bien standby + MCU ngu */
+
+typedef struct BENCH_TOUCH {
+  uint32_t start;
+  uint32_t end;
+  uint32_t delay;       /* Tu luc cham den khi co anh (ms) */
+  bool detected;
+  bool woke;
+} bench_touch_t;
+
+typedef struct BENCH_POLICY {
+  const char *name;
+  zw111_presence_cfg_t cfg;
+  bool wake;
+} bench_policy_t;
+
+/* Duong cong: co dinh (min = max), backoff voi tran tang dan, them burst, them ngat TOUCH_OUT */
+static const bench_policy_t s_policies[] = {
+  { "fixed-50",          {   50,   50, 100,  0,    0 }, false },
+  { "fixed-100",         {  100,  100, 100,  0,    0 }, false },
+  { "fixed-200",         {  200,  200, 100,  0,    0 }, false },
+  { "fixed-400",         {  400,  400, 100,  0,    0 }, false },
+  { "fixed-800",         {  800,  800, 100,  0,    0 }, false },
+  { "backoff-400",       {   50,  400, 200,  0,    0 }, false },
+  { "backoff-1600",      {   50, 1600, 200,  0,    0 }, false },
+  { "burst-400",         {   50,  400, 200, 30, 1000 }, false },
+  { "burst-1600",        {   50, 1600, 200, 30, 1000 }, false },
+  { "burst-3200",        {   50, 3200, 200, 30, 1000 }, false },
+  { "burst-3200+wake",   {   50, 3200, 200, 30, 1000 }, true  },
+  { "burst-10000+wake",  {   50, 10000, 200, 30, 1000 }, true },
+};
+
+/* ----------------------------------------------------------- */
+
+static uint32_t bench_rand(uint32_t *s){
+  *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+  return *s;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Sinh lich cham (khong chong lan, cach nhau it nhat 500 ms sau khi nhac tay)
+ * @return So lan cham
+ */
+static uint32_t bench_make_touches(bench_touch_t *t, uint32_t cap, uint32_t total_ms, uint32_t gap_ms, uint32_t touch_ms){
+  uint32_t seed = 0x2026u, n = 0;
+  double now = 0.0;
+  while(n < cap){
+      double u = ((double)(bench_rand(&seed) & 0xFFFFFFu) + 1.0) / 16777217.0;
+      now += 500.0 - log(u) * (double)gap_ms;
+      uint32_t hold = touch_ms / 2u + bench_rand(&seed) % (touch_ms + 1u);
+      if(now + hold >= (double)total_ms) break;
+
+      memset(&t[n], 0, sizeof(t[n]));
+      t[n].start = (uint32_t)now;
+      t[n].end = t[n].start + hold;
+      now = (double)t[n].end;
+      n++;
+  }
+  return n;
+}
+
+/* ----------------------------------------------------------- */
+
+static int bench_cmp_u32(const void *a, const void *b){
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return (x > y) - (x < y);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Chay 1 chinh sach tren toan bo lich cham
+ * @return 0 neu thong ke cua bo lap lich khop voi mo phong
+ */
+static int bench_run(const bench_policy_t *pol, bench_touch_t *t, uint32_t n, uint32_t total_ms, uint32_t *delays){
+  zw111_presence_t p;
+  uint32_t now = 0, k = 0, polls = 0;
+
+  for(uint32_t i = 0; i < n; i++){
+      t[i].detected = false;
+      t[i].woke = false;
+  }
+  zw111_presence_init(&p, &pol->cfg, now);
+
+  while(now < total_ms){
+      uint32_t next = now + zw111_presence_next_ms(&p, now);
+
+      /* Ngat TOUCH_OUT den truoc lan poll da hen */
+      if(pol->wake && k < n && !t[k].woke && t[k].start + BENCH_IRQ_MS <= next){
+          uint32_t irq = t[k].start + BENCH_IRQ_MS;
+          if(irq > now) now = irq;
+          t[k].woke = true;
+          zw111_presence_wake(&p, now);
+          continue;
+      }
+      now = next;
+
+      uint32_t cap = now + BENCH_UART_MS / 2u; // Cam bien chup ngay sau khi nhan Command Packet
+      while(k < n && t[k].end <= cap) k++;
+
+      zw111_status_t st = ZW111_STATUS_NO_FINGER;
+      if(k < n && cap >= t[k].start){
+          st = (cap < t[k].start + BENCH_LANDING_MS) ? ZW111_STATUS_ERROR : ZW111_STATUS_OK;
+      }
+
+      uint32_t end = now + BENCH_UART_MS + BENCH_CAPTURE_MS;
+      polls++;
+      if(zw111_presence_record(&p, st, now, end) == ZW111_PRESENCE_EV_DETECTED && k < n && !t[k].detected){
+          t[k].detected = true;
+          t[k].delay = end - t[k].start;
+      }
+      now = end;
+  }
+
+  uint32_t found = 0, missed = 0;
+  uint64_t sum = 0;
+  for(uint32_t i = 0; i < n; i++){
+      if(!t[i].detected){
+          missed++;
+          continue;
+      }
+      delays[found++] = t[i].delay;
+      sum += t[i].delay;
+  }
+  qsort(delays, found, sizeof(delays[0]), bench_cmp_u32);
+
+  double hours = (double)total_ms / 3600000.0;
+  double busy = (double)p.stats.busy_ms / (double)total_ms;
+  double ma = BENCH_IDLE_MA + (BENCH_ACTIVE_MA - BENCH_IDLE_MA) * busy;
+
+  printf("%-17s %9.1f %6.2f%% %7.3f %8.1f %7u %6u %6u %8u %6u\n", pol->name,
+         (double)p.stats.polls / (hours * 60.0), zw111_presence_uart_permille(&p, now) / 10.0, ma, ma * 24.0,
+         found ? (uint32_t)(sum / found) : 0u, found ? delays[(found * 95u) / 100u] : 0u, found ? delays[found - 1u] : 0u,
+         zw111_presence_avg_delay_ms(&p), missed);
+
+  /* Moi lan DETECTED phai ung voi dung 1 lan cham, moi lan poll phai vao thong ke */
+  return (p.stats.detections != found || p.stats.polls != polls) ? 1 : 0;
+}
+
+/* ----------------------------------------------------------- */
+
+int main(int argc, char **argv){
+  uint32_t hours = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 24u;
+  uint32_t gap_ms = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 15000u;
+  uint32_t touch_ms = (argc > 3) ? (uint32_t)strtoul(argv[3], NULL, 0) : 800u;
+  if(hours == 0u) hours = 1u;
+  if(touch_ms < BENCH_LANDING_MS) touch_ms = BENCH_LANDING_MS;
+
+  uint32_t total_ms = hours * 3600000u;
+  uint32_t cap = total_ms / 500u + 1u;
+  bench_touch_t *t = (bench_touch_t *)malloc(sizeof(bench_touch_t) * cap);
+  uint32_t *delays = (uint32_t *)malloc(sizeof(uint32_t) * cap);
+  if(t == NULL || delays == NULL) return 1;
+
+  uint32_t n = bench_make_touches(t, cap, total_ms, gap_ms, touch_ms);
+  printf("%u h, %u touches (gap ~%u ms, hold %u..%u ms), GetImage %u ms, %.1f mA active / %.1f mA idle\n",
+         hours, n, gap_ms, touch_ms / 2u, touch_ms / 2u + touch_ms, BENCH_UART_MS + BENCH_CAPTURE_MS,
+         BENCH_ACTIVE_MA, BENCH_IDLE_MA);
+  printf("%-17s %9s %7s %7s %8s %7s %6s %6s %8s %6s\n", "policy", "polls/min", "uart", "avg mA", "mAh/day",
+         "delay", "p95", "max", "bound", "missed");
+
+  int fail = 0;
+  for(uint32_t i = 0; i < sizeof(s_policies) / sizeof(s_policies[0]); i++){
+      fail |= bench_run(&s_policies[i], t, n, total_ms, delays);
+  }
+  if(fail) printf("presence stats MISMATCH\n");
+
+  free(t);
+  free(delays);
+  return fail;
+}
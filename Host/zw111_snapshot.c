@@ -0,0 +1,323 @@
+/*
+ * @file zw111_snapshot.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Backup/restore Template Database <-> file snapshot (mmap)
+ * Backup khong buffer template trong RAM: sink cua UpChar la vung mmap cua file dich,
+ * restore DownChar thang tu vung mmap cua file nguon (`zw111_source_mem`)
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#include "zw111_snapshot.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+_Static_assert(sizeof(zw111_snap_header_t) == 64, "zw111_snap_header_t phai dung 64 bytes");
+_Static_assert(sizeof(zw111_snap_entry_t) == 16, "zw111_snap_entry_t phai dung 16 bytes");
+
+/* Context cua sink so sanh template tren cam bien voi blob trong file */
+typedef struct {
+  const uint8_t *ref;
+  uint32_t len;
+  uint32_t off;
+  bool same;
+} zw_snap_cmp_t;
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief CRC cua header voi truong header_crc = 0
+ */
+static uint32_t zw_snap_header_crc(const zw111_snap_header_t *hdr){
+  zw111_snap_header_t tmp = *hdr;
+  tmp.header_crc = 0;
+  return zw111_crc32(0, (const uint8_t *)&tmp, sizeof(tmp));
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Sink UpChar: so sanh tung Data Packet voi blob (khong huy giua chung de link khong lech)
+ */
+static bool zw_snap_cmp_sink(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  (void)last;
+  zw_snap_cmp_t *c = (zw_snap_cmp_t *)ctx;
+  if(c->off + len > c->len || memcmp(&c->ref[c->off], data, len) != 0) c->same = false;
+  c->off += len;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_snap_backup(zw111_dev_t *dev, const char *path, zw111_snap_stats_t *stats){
+  if(dev == NULL || path == NULL) return ZW111_STATUS_ERROR;
+  if(stats != NULL) memset(stats, 0, sizeof(*stats));
+
+  uint32_t t0 = zw111_ll_get_ticks();
+  zw111_sysinfo_t info;
+  zw111_status_t ret = zw111_sync_index(dev);
+  if(ret == ZW111_STATUS_OK) ret = zw111_read_sysinfo(dev, &info);
+  if(ret != ZW111_STATUS_OK) return ret;
+
+  const zw111_index_t *idx = zw111_get_index(dev);
+  uint16_t count = zw111_index_count(idx);
+  uint32_t dir_offset = (uint32_t)sizeof(zw111_snap_header_t);
+  uint32_t blob_offset = dir_offset + (uint32_t)count * (uint32_t)sizeof(zw111_snap_entry_t);
+
+  char tmp_path[PATH_MAX];
+  if(snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path) >= (int)sizeof(tmp_path)){
+      errno = ENAMETOOLONG;
+      return ZW111_STATUS_ERROR;
+  }
+
+  zw111_port_linux_mmap_t m;
+  if(!zw111_port_linux_mmap_open(&m, tmp_path, blob_offset + (uint32_t)count * ZW111_SNAP_BLOB_MAX)) return ZW111_STATUS_ERROR;
+  m.len = blob_offset; // Sink ghi blob noi tiep sau directory
+
+  zw111_snap_header_t *hdr = (zw111_snap_header_t *)m.map;
+  zw111_snap_entry_t *dir = (zw111_snap_entry_t *)&m.map[dir_offset];
+
+  /* Duyet PageID tang dan -> directory da sap xep cho `zw111_snap_find()` */
+  uint16_t n = 0, cur = 0, start, len;
+  while(ret == ZW111_STATUS_OK && n < count && zw111_index_next_range(idx, &cur, &start, &len)){
+      for(uint16_t page = start; page < start + len && n < count; page++){
+          uint32_t off = m.len;
+          ret = zw111_load_char(dev, ZW111_CHARBUFFER_1, page);
+          if(ret == ZW111_STATUS_OK) ret = zw111_upload_char(dev, ZW111_CHARBUFFER_1, zw111_port_linux_mmap_sink, &m, NULL);
+          if(ret == ZW111_STATUS_OK && m.len - off > ZW111_SNAP_BLOB_MAX) ret = ZW111_STATUS_ERROR;
+          if(ret != ZW111_STATUS_OK) break;
+
+          dir[n].page_id = page;
+          dir[n].reserved = 0;
+          dir[n].offset = off;
+          dir[n].length = m.len - off;
+          dir[n].crc = zw111_crc32(0, &m.map[off], dir[n].length);
+          n++;
+      }
+  }
+
+  if(ret != ZW111_STATUS_OK){
+      int err = errno;
+      (void)zw111_port_linux_mmap_close(&m);
+      (void)unlink(tmp_path);
+      errno = err;
+      return ret;
+  }
+
+  memset(hdr, 0, sizeof(*hdr));
+  memcpy(hdr->magic, ZW111_SNAP_MAGIC, sizeof(hdr->magic));
+  hdr->version = ZW111_SNAP_VERSION;
+  hdr->header_size = (uint16_t)sizeof(zw111_snap_header_t);
+  hdr->file_size = m.len;
+  hdr->created_unix = (uint64_t)time(NULL);
+  hdr->device_address = info.device_address;
+  hdr->system_state = info.system_state;
+  hdr->sensor_type = info.sensor_type;
+  hdr->database_capacity = info.database_capacity;
+  hdr->baudrate_multiplier = info.baudrate_multipler;
+  hdr->security = (uint16_t)info.security;
+  hdr->packet_size = (uint16_t)info.packet_size;
+  hdr->dir_offset = dir_offset;
+  hdr->entry_count = n;
+  hdr->entry_size = (uint16_t)sizeof(zw111_snap_entry_t);
+  hdr->blob_offset = blob_offset;
+  hdr->blob_bytes = m.len - blob_offset;
+  hdr->header_crc = zw_snap_header_crc(hdr);
+
+  if(stats != NULL){
+      stats->templates = n;
+      stats->bytes = hdr->blob_bytes;
+  }
+
+  if(!zw111_port_linux_mmap_close(&m) || rename(tmp_path, path) != 0){
+      int err = errno;
+      (void)unlink(tmp_path);
+      errno = err;
+      return ZW111_STATUS_ERROR;
+  }
+
+  if(stats != NULL) stats->elapsed_ms = zw111_ll_get_ticks() - t0;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_snap_open(zw111_snap_t *snap, const char *path){
+  if(snap == NULL || path == NULL) return ZW111_STATUS_ERROR;
+  memset(snap, 0, sizeof(*snap));
+  snap->fd = -1;
+
+  int fd = open(path, O_RDONLY | O_CLOEXEC);
+  if(fd < 0) return ZW111_STATUS_ERROR;
+
+  struct stat sb;
+  if(fstat(fd, &sb) != 0 || sb.st_size < (off_t)sizeof(zw111_snap_header_t) || sb.st_size > (off_t)UINT32_MAX){
+      (void)close(fd);
+      return ZW111_STATUS_ERROR;
+  }
+
+  void *map = mmap(NULL, (size_t)sb.st_size, PROT_READ, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED){
+      (void)close(fd);
+      return ZW111_STATUS_ERROR;
+  }
+
+  snap->fd = fd;
+  snap->map = (const uint8_t *)map;
+  snap->size = (uint32_t)sb.st_size;
+  snap->hdr = (const zw111_snap_header_t *)map;
+
+  /* Header + directory phai nam trong file, blob nam trong vung blob */
+  const zw111_snap_header_t *h = snap->hdr;
+  bool ok = memcmp(h->magic, ZW111_SNAP_MAGIC, sizeof(h->magic)) == 0 &&
+            h->version == ZW111_SNAP_VERSION &&
+            h->header_size == sizeof(zw111_snap_header_t) &&
+            h->entry_size == sizeof(zw111_snap_entry_t) &&
+            h->header_crc == zw_snap_header_crc(h) &&
+            h->file_size == snap->size &&
+            h->dir_offset >= h->header_size && (h->dir_offset % 4u) == 0 &&
+            (uint64_t)h->dir_offset + (uint64_t)h->entry_count * h->entry_size <= h->blob_offset &&
+            (uint64_t)h->blob_offset + h->blob_bytes <= snap->size;
+
+  if(ok){
+      snap->dir = (const zw111_snap_entry_t *)&snap->map[h->dir_offset];
+      for(uint16_t i = 0; ok && i < h->entry_count; i++){
+          const zw111_snap_entry_t *e = &snap->dir[i];
+          ok = e->offset >= h->blob_offset &&
+               (uint64_t)e->offset + e->length <= (uint64_t)h->blob_offset + h->blob_bytes &&
+               (i == 0 || e->page_id > snap->dir[i - 1u].page_id);
+      }
+  }
+
+  if(!ok){
+      zw111_snap_close(snap);
+      errno = EINVAL;
+      return ZW111_STATUS_ERROR;
+  }
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_snap_close(zw111_snap_t *snap){
+  if(snap == NULL) return;
+  if(snap->map != NULL) (void)munmap((void *)snap->map, snap->size);
+  if(snap->fd >= 0) (void)close(snap->fd);
+  memset(snap, 0, sizeof(*snap));
+  snap->fd = -1;
+}
+
+/* ----------------------------------------------------------- */
+
+const zw111_snap_entry_t *zw111_snap_find(const zw111_snap_t *snap, uint16_t page_id){
+  if(snap == NULL || snap->dir == NULL) return NULL;
+
+  uint32_t lo = 0, hi = snap->hdr->entry_count;
+  while(lo < hi){
+      uint32_t mid = (lo + hi) / 2u;
+      uint16_t p = snap->dir[mid].page_id;
+      if(p == page_id) return &snap->dir[mid];
+      if(p < page_id) lo = mid + 1u;
+      else hi = mid;
+  }
+  return NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+const uint8_t *zw111_snap_blob(const zw111_snap_t *snap, const zw111_snap_entry_t *entry){
+  if(snap == NULL || entry == NULL) return NULL;
+  return &snap->map[entry->offset];
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_snap_verify(const zw111_snap_t *snap, const zw111_snap_entry_t *entry){
+  if(snap == NULL || entry == NULL) return false;
+  return zw111_crc32(0, zw111_snap_blob(snap, entry), entry->length) == entry->crc;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_snap_sysinfo(const zw111_snap_t *snap, zw111_sysinfo_t *info){
+  if(snap == NULL || snap->hdr == NULL || info == NULL) return;
+  const zw111_snap_header_t *h = snap->hdr;
+  info->device_address = h->device_address;
+  info->system_state = h->system_state;
+  info->sensor_type = h->sensor_type;
+  info->database_capacity = h->database_capacity;
+  info->baudrate_multipler = h->baudrate_multiplier;
+  info->security = (zw111_match_threshold_t)h->security;
+  info->packet_size = (zw111_packet_size_t)h->packet_size;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_snap_restore(zw111_dev_t *dev, const zw111_snap_t *snap, uint8_t flags, zw111_snap_stats_t *stats){
+  if(dev == NULL || snap == NULL || snap->hdr == NULL) return ZW111_STATUS_ERROR;
+
+  zw111_snap_stats_t local;
+  if(stats == NULL) stats = &local;
+  memset(stats, 0, sizeof(*stats));
+  stats->templates = snap->hdr->entry_count;
+
+  uint32_t t0 = zw111_ll_get_ticks();
+  zw111_status_t ret = zw111_sync_index(dev); // Capacity + PageID dang co template cua cam bien dich
+  if(ret != ZW111_STATUS_OK) return ret;
+  const zw111_index_t *idx = zw111_get_index(dev);
+
+  for(uint16_t i = 0; i < snap->hdr->entry_count; i++){
+      const zw111_snap_entry_t *e = &snap->dir[i];
+      const uint8_t *blob = zw111_snap_blob(snap, e);
+
+      if(!zw111_snap_verify(snap, e) || e->page_id >= idx->capacity){
+          stats->failed++;
+          continue;
+      }
+
+      /* PageID da co template -> UpChar so sanh, giong het thi khong ghi Flash lan nua */
+      if(!(flags & ZW111_SNAP_RESTORE_FORCE) && zw111_index_test(idx, e->page_id)){
+          zw_snap_cmp_t cmp = { .ref = blob, .len = e->length, .off = 0, .same = true };
+          ret = zw111_load_char(dev, ZW111_CHARBUFFER_1, e->page_id);
+          if(ret == ZW111_STATUS_OK) ret = zw111_upload_char(dev, ZW111_CHARBUFFER_1, zw_snap_cmp_sink, &cmp, NULL);
+          if(zw111_status_is_link_error(ret)) return ret;
+          if(ret == ZW111_STATUS_OK){
+              stats->bytes += cmp.off;
+              if(cmp.same && cmp.off == e->length){
+                  stats->skipped++;
+                  continue;
+              }
+          }
+      }
+
+      zw111_mem_source_t src = { .data = blob, .len = e->length, .off = 0 };
+      ret = zw111_download_char(dev, ZW111_CHARBUFFER_1, zw111_source_mem, &src, NULL);
+      if(ret == ZW111_STATUS_OK) ret = zw111_enroll_start(dev, e->page_id);
+      if(ret == ZW111_STATUS_OK) ret = zw111_enroll_store(dev); // StoreChar CB1 -> PageID (cap nhat bitmap index)
+      if(zw111_status_is_link_error(ret)) return ret;
+
+      if(ret == ZW111_STATUS_OK){
+          stats->written++;
+          stats->bytes += e->length;
+      }else{
+          stats->failed++;
+      }
+  }
+
+  stats->elapsed_ms = zw111_ll_get_ticks() - t0;
+  return (stats->failed == 0) ? ZW111_STATUS_OK : ZW111_STATUS_ERROR;
+}
@@ -0,0 +1,177 @@
+/*
+ * @file zw111_snapshot.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Sao luu/khoi phuc Template Database cua 1 cam bien ra 1 file nhi phan (gateway Linux)
+ * - Backup : ReadIndexTable (bitmap index) -> voi moi PageID co template: LoadChar + UpChar, Data Packet
+ *            ghi thang vao file da mmap (`zw111_port_linux_mmap_sink`), ghi ra `<path>.tmp` roi rename
+ * - Restore: voi moi template trong file: PageID da co template giong het (LoadChar + UpChar so sanh) -> bo qua,
+ *            nguoc lai DownChar + StoreChar. Khong xoa template chi co tren cam bien
+ *
+ * @note
+ * Dinh dang file (little-endian, moi truong can theo kich thuoc cua no => doc truc tiep tren vung mmap):
+ * @code
+ * [zw111_snap_header_t 64 B][zw111_snap_entry_t 16 B x entry_count, PageID tang dan][blob][blob]...
+ * @endcode
+ * Header co CRC-32 rieng, moi blob co CRC-32 trong entry. Blob nam lien nhau tu `blob_offset`
+ * Build: them Host/zw111_snapshot.c vao cung driver + Src/Port/zw111_port_linux.c (-DLINUX_PLATFORM)
+ */
+
+#ifndef ZW111_LIB_HOST_ZW111_SNAPSHOT_H_
+#define ZW111_LIB_HOST_ZW111_SNAPSHOT_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "../Inc/zw111.h"
+
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__)
+#error "zw111_snapshot: dinh dang file la little-endian, chua ho tro host big-endian"
+#endif
+
+#define ZW111_SNAP_MAGIC            "ZWSN"
+#define ZW111_SNAP_VERSION          1u
+
+/* Kich thuoc toi da 1 template (chi de cap vung mmap luc backup, file cat dung kich thuoc that) */
+#ifndef ZW111_SNAP_BLOB_MAX
+#define ZW111_SNAP_BLOB_MAX         4096u
+#endif // ZW111_SNAP_BLOB_MAX
+
+/* Co cho `zw111_snap_restore()` */
+#define ZW111_SNAP_RESTORE_FORCE    0x01u  /* Ghi lai moi template, khong so sanh voi cam bien */
+
+/* Header file (64 bytes) */
+typedef struct ZW111_SNAP_HEADER {
+  uint8_t  magic[4];                /* ZW111_SNAP_MAGIC */
+  uint16_t version;                 /* ZW111_SNAP_VERSION */
+  uint16_t header_size;             /* sizeof(zw111_snap_header_t) */
+  uint32_t file_size;
+  uint32_t header_crc;              /* CRC-32 cua header voi truong nay = 0 */
+  uint64_t created_unix;            /* Thoi diem backup (s) */
+
+  /* zw111_sysinfo_t cua cam bien luc backup */
+  uint32_t device_address;
+  uint16_t system_state;
+  uint16_t sensor_type;
+  uint16_t database_capacity;
+  uint16_t baudrate_multiplier;
+  uint16_t security;
+  uint16_t packet_size;
+
+  /* Page directory + vung blob */
+  uint32_t dir_offset;
+  uint16_t entry_count;
+  uint16_t entry_size;              /* sizeof(zw111_snap_entry_t) */
+  uint32_t blob_offset;
+  uint32_t blob_bytes;
+  uint8_t  reserved[8];
+} zw111_snap_header_t;
+
+/* 1 dong cua page directory (16 bytes) */
+typedef struct ZW111_SNAP_ENTRY {
+  uint16_t page_id;
+  uint16_t reserved;
+  uint32_t offset;                  /* Vi tri blob tinh tu dau file */
+  uint32_t length;                  /* So byte template (tong Data Packet cua UpChar) */
+  uint32_t crc;                     /* CRC-32 cua blob */
+} zw111_snap_entry_t;
+
+/* File snapshot da mmap (chi doc) */
+typedef struct ZW111_SNAP {
+  int fd;
+  const uint8_t *map;
+  uint32_t size;
+  const zw111_snap_header_t *hdr;
+  const zw111_snap_entry_t *dir;    /* hdr->entry_count dong, PageID tang dan */
+} zw111_snap_t;
+
+/* Ket qua backup/restore */
+typedef struct ZW111_SNAP_STATS {
+  uint16_t templates;               /* So template trong file */
+  uint16_t written;                 /* Restore: DownChar + StoreChar */
+  uint16_t skipped;                 /* Restore: cam bien da co template giong het */
+  uint16_t failed;                  /* Restore: blob sai CRC, PageID vuot capacity, cam bien tu choi */
+  uint32_t bytes;                   /* Tong byte template da truyen qua UART */
+  uint32_t elapsed_ms;
+} zw111_snap_stats_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief CRC-32 cua header/blob trong file snapshot, giu ten cu cho caller Host (= `zw111_crc32()`)
+ */
+__attribute__((always_inline)) static inline uint32_t zw111_snap_crc32(uint32_t crc, const uint8_t *data, uint32_t len){
+  return zw111_crc32(crc, data, len);
+}
+
+/**
+ * @brief Backup toan bo Template Database cua cam bien ra file `path`
+ *
+ * @details
+ * Dong bo bitmap index (`zw111_sync_index()`) + doc System Parameter, roi moi PageID co template
+ * LoadChar(CB1) + UpChar(CB1) thang vao vung mmap. File cu chi bi thay khi backup thanh cong
+ *
+ * @param[out] stats templates/bytes/elapsed_ms (co the NULL)
+ * @return
+ *  - ZW111_STATUS_OK on success
+ *  - ZW111_STATUS_ERROR neu khong tao/ghi duoc file (errno giu nguyen), template vuot ZW111_SNAP_BLOB_MAX
+ *  - Status cua lenh UART bi loi
+ */
+zw111_status_t zw111_snap_backup(zw111_dev_t *dev, const char *path, zw111_snap_stats_t *stats);
+
+/**
+ * @brief mmap file snapshot (chi doc) va kiem tra header + directory (CRC blob kiem tra rieng)
+ * @return ZW111_STATUS_ERROR neu khong mo duoc hoac sai dinh dang
+ */
+zw111_status_t zw111_snap_open(zw111_snap_t *snap, const char *path);
+
+/**
+ * @brief munmap + dong file
+ */
+void zw111_snap_close(zw111_snap_t *snap);
+
+/**
+ * @brief Tim template cua 1 PageID (tim nhi phan tren directory)
+ * @return NULL neu file khong co PageID nay
+ */
+const zw111_snap_entry_t *zw111_snap_find(const zw111_snap_t *snap, uint16_t page_id);
+
+/**
+ * @brief Con tro den noi dung template (nam tren vung mmap)
+ */
+const uint8_t *zw111_snap_blob(const zw111_snap_t *snap, const zw111_snap_entry_t *entry);
+
+/**
+ * @brief Kiem tra CRC-32 cua 1 blob
+ */
+bool zw111_snap_verify(const zw111_snap_t *snap, const zw111_snap_entry_t *entry);
+
+/**
+ * @brief System Parameter cua cam bien luc backup
+ */
+void zw111_snap_sysinfo(const zw111_snap_t *snap, zw111_sysinfo_t *info);
+
+/**
+ * @brief Ghi template tu snapshot vao cam bien (cam bien moi thay the hoac cam bien cu bi mat template)
+ *
+ * @param flags 0 hoac ZW111_SNAP_RESTORE_FORCE
+ * @param[out] stats written/skipped/failed/bytes/elapsed_ms (co the NULL)
+ * @return
+ *  - ZW111_STATUS_OK neu moi template da co tren cam bien
+ *  - ZW111_STATUS_ERROR neu co template loi (`stats->failed`), cac template khac van duoc ghi
+ *  - Status cua lenh UART neu duong truyen loi (dung ngay)
+ */
+zw111_status_t zw111_snap_restore(zw111_dev_t *dev, const zw111_snap_t *snap, uint8_t flags, zw111_snap_stats_t *stats);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_HOST_ZW111_SNAPSHOT_H_ */
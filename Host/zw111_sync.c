@@ -0,0 +1,422 @@
+/*
+ * @file zw111_sync.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Dong bo template nguon -> N dich
+ * Moi dich la 1 FSM: moi buoc submit 1 thao tac async, buoc ke tiep chay khi `op.done`
+ * => khi dich A dang cho ACK (Search Flash, StoreChar ghi Flash) thi dich B van truyen Data Packet
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#include "zw111_sync.h"
+
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Trang thai FSM cua 1 dich */
+enum {
+  ZW_SYNC_ST_START = 0,
+  ZW_SYNC_ST_INDEX,         /* ReadSysPara + ReadIndexTable */
+  ZW_SYNC_ST_LOAD,          /* LoadChar(CB1, page) */
+  ZW_SYNC_ST_UPLOAD,        /* UpChar(CB1) -> CRC-32 */
+  ZW_SYNC_ST_DOWNLOAD,      /* DownChar(CB1) tu nguon */
+  ZW_SYNC_ST_STORE,         /* StoreChar(CB1, page) */
+  ZW_SYNC_ST_DELETE,        /* DeletChar(start, count) (ZW111_SYNC_PRUNE) */
+  ZW_SYNC_ST_DONE
+};
+
+/* Buffer tang dan cho `zw111_sync_source_load()` */
+typedef struct {
+  uint8_t *buf;
+  uint32_t len;
+  uint32_t cap;
+} zw_sync_grow_t;
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Sink UpChar ghi noi vao buffer tang dan (realloc x2)
+ */
+static bool zw_sync_grow_sink(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  (void)last;
+  zw_sync_grow_t *g = (zw_sync_grow_t *)ctx;
+  if(g->len + len > g->cap){
+      uint32_t cap = g->cap ? g->cap : 4096u;
+      while(cap < g->len + len) cap *= 2u;
+      uint8_t *p = (uint8_t *)realloc(g->buf, cap);
+      if(p == NULL) return false;
+      g->buf = p;
+      g->cap = cap;
+  }
+  memcpy(&g->buf[g->len], data, len);
+  g->len += len;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Sink UpChar cua dich: chi tinh CRC-32, khong luu template
+ */
+static bool zw_sync_crc_sink(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  (void)last;
+  zw111_sync_target_t *t = (zw111_sync_target_t *)ctx;
+  t->crc = zw111_crc32(t->crc, data, len);
+  t->up_len += len;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Ghi/xoa digest cache cua 1 PageID
+ */
+static void zw_sync_cache(zw111_sync_target_t *t, uint16_t page, bool valid, uint32_t digest, uint32_t length){
+  if(page >= ZW111_INDEX_MAX_CAPACITY) return;
+  if(valid){
+      t->known[page >> 5] |= (1u << (page & 31u));
+      t->digest[page] = digest;
+      t->length[page] = length;
+  }else{
+      t->known[page >> 5] &= ~(1u << (page & 31u));
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+static bool zw_sync_cached(const zw111_sync_target_t *t, const zw111_sync_page_t *p){
+  return (t->known[p->page_id >> 5] & (1u << (p->page_id & 31u))) &&
+         t->digest[p->page_id] == p->digest && t->length[p->page_id] == p->length;
+}
+
+/* ----------------------------------------------------------- */
+
+static void zw_sync_finish(zw111_sync_target_t *t, zw111_status_t st){
+  t->status = st;
+  t->state = ZW_SYNC_ST_DONE;
+  t->stats.elapsed_ms = zw111_ll_get_ticks() - t->t0;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Chuyen state neu submit thanh cong, nguoc lai ket thuc dich voi loi submit
+ */
+static void zw_sync_submit(zw111_sync_target_t *t, zw111_status_t submit_ret, uint8_t next){
+  if(submit_ret != ZW111_STATUS_OK) zw_sync_finish(t, submit_ret);
+  else t->state = next;
+}
+
+/* ----------------------------------------------------------- */
+
+static void zw_sync_download(zw111_sync_target_t *t, const zw111_sync_page_t *p){
+  t->src.data = p->data;
+  t->src.len = p->length;
+  t->src.off = 0;
+  zw_sync_submit(t, zw111_download_char_async(t->dev, &t->op, ZW111_CHARBUFFER_1, zw111_source_mem, &t->src, NULL, NULL, NULL),
+                 ZW_SYNC_ST_DOWNLOAD);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Gui DeleteChar cho khoang PageID chi co o dich tiep theo, het thi ket thuc
+ */
+static void zw_sync_next_prune(zw111_sync_target_t *t){
+  uint16_t start, count;
+  if(zw111_index_next_delete_run(zw111_get_index(t->dev), t->prune, &t->cursor, &start, &count)){
+      t->run_start = start;
+      zw_sync_submit(t, zw111_delete_range_async(t->dev, &t->op, start, count, NULL, NULL), ZW_SYNC_ST_DELETE);
+      return;
+  }
+  zw_sync_finish(t, (t->stats.failed == 0) ? ZW111_STATUS_OK : ZW111_STATUS_ERROR);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Tim template nguon tiep theo can xu ly (cursor = vi tri trong nguon)
+ */
+static void zw_sync_next_page(zw111_sync_target_t *t, const zw111_sync_source_t *src, uint8_t flags){
+  const zw111_index_t *idx = zw111_get_index(t->dev);
+
+  for(; t->cursor < src->count; t->cursor++){
+      const zw111_sync_page_t *p = &src->pages[t->cursor];
+      if(p->page_id >= idx->capacity){
+          t->stats.failed++;
+          continue;
+      }
+
+      /* PageID trong -> DownChar luon */
+      if(!zw111_index_test(idx, p->page_id)){
+          t->replacing = false;
+          zw_sync_download(t, p);
+          return;
+      }
+
+      /* Digest da biet tu lan sync truoc (PageID van co template) -> khong can UpChar */
+      if(!(flags & ZW111_SYNC_VERIFY) && zw_sync_cached(t, p)){
+          t->stats.same++;
+          t->stats.cache_hits++;
+          continue;
+      }
+
+      zw_sync_submit(t, zw111_load_char_async(t->dev, &t->op, ZW111_CHARBUFFER_1, p->page_id, NULL, NULL), ZW_SYNC_ST_LOAD);
+      return;
+  }
+
+  if(flags & ZW111_SYNC_PRUNE){
+      /* Tap can xoa = bitmap dich tru PageID cua nguon */
+      memcpy(t->prune, idx->words, sizeof(t->prune));
+      for(uint16_t i = 0; i < src->count; i++){
+          uint16_t page = src->pages[i].page_id;
+          if(page < ZW111_INDEX_MAX_CAPACITY) t->prune[page >> 5] &= ~(1u << (page & 31u));
+      }
+      t->cursor = 0;
+      zw_sync_next_prune(t);
+  }else{
+      zw_sync_finish(t, (t->stats.failed == 0) ? ZW111_STATUS_OK : ZW111_STATUS_ERROR);
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Xu ly ket qua cua thao tac vua xong va submit buoc ke tiep
+ */
+static void zw_sync_advance(zw111_sync_target_t *t, const zw111_sync_source_t *src, uint8_t flags){
+  zw111_status_t st = t->op.status;
+  const zw111_sync_page_t *p = (t->cursor < src->count) ? &src->pages[t->cursor] : NULL;
+
+  if(t->state != ZW_SYNC_ST_START && zw111_status_is_link_error(st)){
+      zw_sync_finish(t, st);
+      return;
+  }
+
+  switch(t->state){
+    case ZW_SYNC_ST_START:
+      memset(&t->stats, 0, sizeof(t->stats));
+      t->stats.full_copy_bytes = src->bytes;
+      t->cursor = 0;
+      t->t0 = zw111_ll_get_ticks();
+      zw_sync_submit(t, zw111_sync_index_async(t->dev, &t->op, NULL, NULL), ZW_SYNC_ST_INDEX);
+      return;
+
+    case ZW_SYNC_ST_INDEX:
+      if(st != ZW111_STATUS_OK){
+          zw_sync_finish(t, st);
+          return;
+      }
+      /* PageID da trong (xoa/Empty tu ngoai) -> digest cu khong con dung */
+      for(uint16_t w = 0; w < ZW111_INDEX_WORDS; w++) t->known[w] &= zw111_get_index(t->dev)->words[w];
+    break;
+
+    case ZW_SYNC_ST_LOAD:
+      if(st == ZW111_STATUS_OK){
+          t->crc = 0;
+          t->up_len = 0;
+          zw_sync_submit(t, zw111_upload_char_async(t->dev, &t->op, ZW111_CHARBUFFER_1, zw_sync_crc_sink, t, NULL, NULL, NULL),
+                         ZW_SYNC_ST_UPLOAD);
+          return;
+      }
+      t->replacing = true; // Khong doc duoc template cu -> ghi de
+      zw_sync_download(t, p);
+    return;
+
+    case ZW_SYNC_ST_UPLOAD:
+      if(st == ZW111_STATUS_OK){
+          t->stats.bytes_up += t->up_len;
+          zw_sync_cache(t, p->page_id, true, t->crc, t->up_len);
+          if(t->crc == p->digest && t->up_len == p->length){
+              t->stats.same++;
+              t->cursor++;
+              break;
+          }
+      }
+      t->replacing = true;
+      zw_sync_download(t, p);
+    return;
+
+    case ZW_SYNC_ST_DOWNLOAD:
+      if(st == ZW111_STATUS_OK){
+          (void)zw111_enroll_start(t->dev, p->page_id);
+          zw_sync_submit(t, zw111_enroll_store_async(t->dev, &t->op, NULL, NULL), ZW_SYNC_ST_STORE);
+          return;
+      }
+      /* Cam bien con ket trong phien DownChar -> CANCEL truoc lenh ke tiep, khong duoc thi bo dich nay */
+      if(zw111_op_needs_cancel(&t->op)){
+          zw111_status_t cst = zw111_cancel(t->dev);
+          if(cst != ZW111_STATUS_OK){
+              zw_sync_finish(t, cst);
+              return;
+          }
+      }
+      t->stats.failed++;
+      t->cursor++;
+    break;
+
+    case ZW_SYNC_ST_STORE:
+      if(st == ZW111_STATUS_OK){
+          if(t->replacing) t->stats.replaced++;
+          else t->stats.added++;
+          t->stats.bytes_down += p->length;
+          zw_sync_cache(t, p->page_id, true, p->digest, p->length);
+      }else{
+          t->stats.failed++;
+          zw_sync_cache(t, p->page_id, false, 0, 0);
+      }
+      t->cursor++;
+    break;
+
+    case ZW_SYNC_ST_DELETE:
+      /* Khoang [run_start, cursor) co the gom ca slot trong, chi dem PageID trong tap prune */
+      for(uint16_t page = t->run_start; page < t->cursor; page++){
+          if(!(t->prune[page >> 5] & (1u << (page & 31u)))) continue;
+          if(st == ZW111_STATUS_OK){
+              t->stats.deleted++;
+              zw_sync_cache(t, page, false, 0, 0);
+          }else{
+              t->stats.failed++;
+          }
+      }
+      zw_sync_next_prune(t);
+    return;
+
+    default:
+    return;
+  }
+
+  zw_sync_next_page(t, src, flags);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_sync_source_load(zw111_dev_t *dev, zw111_sync_source_t *src){
+  if(dev == NULL || src == NULL) return ZW111_STATUS_ERROR;
+  memset(src, 0, sizeof(*src));
+
+  zw111_status_t ret = zw111_sync_index(dev);
+  if(ret != ZW111_STATUS_OK) return ret;
+
+  const zw111_index_t *idx = zw111_get_index(dev);
+  uint16_t count = zw111_index_count(idx);
+  src->pages = (zw111_sync_page_t *)calloc(count ? count : 1u, sizeof(zw111_sync_page_t));
+  if(src->pages == NULL) return ZW111_STATUS_ERROR;
+
+  zw_sync_grow_t g = { NULL, 0, 0 };
+  uint16_t cur = 0, start, len;
+  while(ret == ZW111_STATUS_OK && src->count < count && zw111_index_next_range(idx, &cur, &start, &len)){
+      for(uint16_t page = start; page < start + len && src->count < count; page++){
+          uint32_t off = g.len;
+          ret = zw111_load_char(dev, ZW111_CHARBUFFER_1, page);
+          if(ret == ZW111_STATUS_OK) ret = zw111_upload_char(dev, ZW111_CHARBUFFER_1, zw_sync_grow_sink, &g, NULL);
+          if(ret != ZW111_STATUS_OK) break;
+
+          zw111_sync_page_t *p = &src->pages[src->count++];
+          p->page_id = page;
+          p->length = g.len - off;
+          p->digest = zw111_crc32(0, &g.buf[off], p->length);
+          p->data = (const uint8_t *)(uintptr_t)off; // Offset, doi thanh con tro sau khi het realloc
+      }
+  }
+
+  src->blob = g.buf;
+  src->bytes = g.len;
+  if(ret != ZW111_STATUS_OK){
+      zw111_sync_source_free(src);
+      return ret;
+  }
+  for(uint16_t i = 0; i < src->count; i++) src->pages[i].data = &g.buf[(uintptr_t)src->pages[i].data];
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_sync_source_from_snap(const zw111_snap_t *snap, zw111_sync_source_t *src){
+  if(snap == NULL || snap->hdr == NULL || src == NULL) return ZW111_STATUS_ERROR;
+  memset(src, 0, sizeof(*src));
+
+  uint16_t count = snap->hdr->entry_count;
+  src->pages = (zw111_sync_page_t *)calloc(count ? count : 1u, sizeof(zw111_sync_page_t));
+  if(src->pages == NULL) return ZW111_STATUS_ERROR;
+
+  for(uint16_t i = 0; i < count; i++){
+      const zw111_snap_entry_t *e = &snap->dir[i];
+      if(!zw111_snap_verify(snap, e)){ // Khong phat tan blob hong ra ca fleet
+          zw111_sync_source_free(src);
+          return ZW111_STATUS_ERROR;
+      }
+      src->pages[i].page_id = e->page_id;
+      src->pages[i].length = e->length;
+      src->pages[i].digest = e->crc;
+      src->pages[i].data = zw111_snap_blob(snap, e);
+      src->bytes += e->length;
+  }
+  src->count = count;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_sync_source_free(zw111_sync_source_t *src){
+  if(src == NULL) return;
+  free(src->pages);
+  free(src->blob);
+  memset(src, 0, sizeof(*src));
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_sync_target_init(zw111_sync_target_t *t, zw111_dev_t *dev){
+  if(t == NULL) return;
+  memset(t, 0, sizeof(*t));
+  t->dev = dev;
+  t->state = ZW_SYNC_ST_DONE;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_sync_fleet(const zw111_sync_source_t *src, zw111_sync_target_t *targets, uint8_t n, uint8_t flags){
+  if(src == NULL || targets == NULL || n == 0 || n > ZW111_SYNC_MAX_TARGETS) return ZW111_STATUS_ERROR;
+  for(uint8_t i = 0; i < n; i++){
+      if(targets[i].dev == NULL) return ZW111_STATUS_ERROR;
+  }
+
+  for(uint8_t i = 0; i < n; i++){
+      targets[i].state = ZW_SYNC_ST_START;
+      zw_sync_advance(&targets[i], src, flags);
+  }
+
+  /* Bom tat ca dich trong 1 vong, ngu tren fd cua cac Port khi khong dich nao co viec */
+  struct pollfd pfd[ZW111_SYNC_MAX_TARGETS];
+  for(;;){
+      nfds_t nfds = 0;
+      for(uint8_t i = 0; i < n; i++){
+          zw111_sync_target_t *t = &targets[i];
+          if(t->state == ZW_SYNC_ST_DONE) continue;
+
+          (void)zw111_process(t->dev);
+          if(t->op.done) zw_sync_advance(t, src, flags);
+          if(t->state == ZW_SYNC_ST_DONE) continue;
+
+          pfd[nfds].fd = zw111_port_linux_get_fd(&t->dev->port);
+          pfd[nfds].events = POLLIN;
+          pfd[nfds].revents = 0;
+          nfds++;
+      }
+      if(nfds == 0) break;
+      (void)poll(pfd, nfds, 1); // 1 ms: timeout cua LowLevel van duoc kiem tra deu
+  }
+
+  zw111_status_t ret = ZW111_STATUS_OK;
+  for(uint8_t i = 0; i < n; i++){
+      if(targets[i].status != ZW111_STATUS_OK) ret = ZW111_STATUS_ERROR;
+  }
+  return ret;
+}
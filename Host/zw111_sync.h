@@ -0,0 +1,135 @@
+/*
+ * @file zw111_sync.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Dong bo template tu 1 cam bien nguon sang N cam bien dich (cac cua dung chung tap nguoi dung)
+ * - Nguon : tap template + digest CRC-32 (`zw111_sync_source_load()` tu cam bien, hoac tu file snapshot)
+ * - Dich  : bitmap index (ReadIndexTable) cho biet PageID thieu, PageID co ca 2 ben thi UpChar tinh CRC-32
+ *           de so voi digest nguon (digest da biet tu lan sync truoc duoc cache trong `zw111_sync_target_t`)
+ * - Chi DownChar + StoreChar PageID thieu/khac, tuy chon xoa PageID chi co o dich (ZW111_SYNC_PRUNE,
+ *   gop thanh it lenh DeleteChar nhat bang `zw111_index_next_delete_run()`)
+ * - N dich chay song song: moi dich 1 FSM tren API async, cung 1 vong `zw111_process()` + poll() tren fd cua cac Port
+ *
+ * @note
+ * Bao cao `bytes_down`/`bytes_up` so voi `full_copy_bytes` (DownChar toan bo nguon) cho tung dich
+ * Build: them Host/zw111_sync.c + Host/zw111_snapshot.c vao cung driver + Src/Port/zw111_port_linux.c (-DLINUX_PLATFORM)
+ */
+
+#ifndef ZW111_LIB_HOST_ZW111_SYNC_H_
+#define ZW111_LIB_HOST_ZW111_SYNC_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "../Inc/zw111.h"
+#include "zw111_snapshot.h"
+
+/* So dich toi da cua 1 lan `zw111_sync_fleet()` */
+#ifndef ZW111_SYNC_MAX_TARGETS
+#define ZW111_SYNC_MAX_TARGETS      16u
+#endif // ZW111_SYNC_MAX_TARGETS
+
+/* Co cho `zw111_sync_fleet()` */
+#define ZW111_SYNC_PRUNE            0x01u  /* Xoa PageID chi co o dich */
+#define ZW111_SYNC_VERIFY           0x02u  /* Bo qua digest cache, UpChar lai moi PageID co ca 2 ben */
+
+/* 1 template cua nguon */
+typedef struct ZW111_SYNC_PAGE {
+  uint16_t page_id;
+  uint32_t length;
+  uint32_t digest;                  /* CRC-32 (`zw111_crc32`) */
+  const uint8_t *data;
+} zw111_sync_page_t;
+
+/* Tap template nguon (PageID tang dan) */
+typedef struct ZW111_SYNC_SOURCE {
+  zw111_sync_page_t *pages;
+  uint16_t count;
+  uint32_t bytes;                   /* Tong byte template = 1 lan copy toan bo */
+  uint8_t *blob;                    /* Vung nho so huu (NULL khi tro vao snapshot) */
+} zw111_sync_source_t;
+
+/* Ket qua cua 1 dich */
+typedef struct ZW111_SYNC_STATS {
+  uint16_t same;                    /* PageID giong nguon, khong ghi */
+  uint16_t added;                   /* PageID thieu -> da ghi */
+  uint16_t replaced;                /* PageID khac noi dung -> da ghi de */
+  uint16_t deleted;                 /* ZW111_SYNC_PRUNE */
+  uint16_t failed;                  /* Cam bien tu choi / PageID vuot capacity */
+  uint16_t cache_hits;              /* So sanh bang digest cache, khong UpChar */
+  uint32_t bytes_down;              /* DownChar (host -> cam bien) */
+  uint32_t bytes_up;                /* UpChar de tinh digest (cam bien -> host) */
+  uint32_t full_copy_bytes;         /* DownChar toan bo nguon (de so sanh) */
+  uint32_t elapsed_ms;
+} zw111_sync_stats_t;
+
+/* 1 cam bien dich (USER cap phat, giu giua cac lan sync de dung digest cache) */
+typedef struct ZW111_SYNC_TARGET {
+  zw111_dev_t *dev;
+  zw111_status_t status;            /* Ket qua lan sync cuoi */
+  zw111_sync_stats_t stats;
+
+  /* Digest cache: bit = 1 -> digest[page] la CRC cua template dang nam o PageID nay */
+  uint32_t known[ZW111_INDEX_WORDS];
+  uint32_t digest[ZW111_INDEX_MAX_CAPACITY];
+  uint32_t length[ZW111_INDEX_MAX_CAPACITY];
+
+  /* FSM noi bo cua `zw111_sync_fleet()` */
+  zw111_op_t op;
+  uint8_t state;
+  uint16_t cursor;                  /* Vi tri trong nguon (hoac PageID khi prune) */
+  uint16_t run_start;               /* Dau khoang DeleteChar dang chay */
+  uint32_t prune[ZW111_INDEX_WORDS];/* PageID chi co o dich (ZW111_SYNC_PRUNE) */
+  bool replacing;
+  uint32_t crc;                     /* CRC dang tinh cua UpChar */
+  uint32_t up_len;
+  zw111_mem_source_t src;
+  uint32_t t0;
+} zw111_sync_target_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Doc toan bo template cua cam bien nguon vao RAM (LoadChar + UpChar moi PageID co template)
+ * @note Giai phong bang `zw111_sync_source_free()`
+ */
+zw111_status_t zw111_sync_source_load(zw111_dev_t *dev, zw111_sync_source_t *src);
+
+/**
+ * @brief Dung file snapshot (`zw111_snap_open()`) lam nguon: template tro thang vao vung mmap, digest lay tu directory
+ * @note `snap` phai mo den khi sync xong
+ */
+zw111_status_t zw111_sync_source_from_snap(const zw111_snap_t *snap, zw111_sync_source_t *src);
+
+/**
+ * @brief Giai phong nguon
+ */
+void zw111_sync_source_free(zw111_sync_source_t *src);
+
+/**
+ * @brief Gan cam bien cho dich va xoa digest cache (goi lai khi thay cam bien)
+ */
+void zw111_sync_target_init(zw111_sync_target_t *t, zw111_dev_t *dev);
+
+/**
+ * @brief Dong bo nguon sang `n` dich song song
+ *
+ * @param flags ZW111_SYNC_PRUNE | ZW111_SYNC_VERIFY
+ * @return
+ *  - ZW111_STATUS_OK neu moi dich da giong nguon
+ *  - ZW111_STATUS_ERROR neu co dich loi (xem `targets[i].status`/`targets[i].stats.failed`)
+ */
+zw111_status_t zw111_sync_fleet(const zw111_sync_source_t *src, zw111_sync_target_t *targets, uint8_t n, uint8_t flags);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_HOST_ZW111_SYNC_H_ */
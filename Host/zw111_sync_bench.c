@@ -0,0 +1,189 @@
+/*
+ * @file zw111_sync_bench.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Demo/benchmark dong bo template 1 nguon -> N dich (`zw111_sync.h`) tren cac emulator pty
+ * - Nguon: `so template` PageID chan, moi PageID 1 ngon tay rieng
+ * - Dich 0: cam bien moi (trong) -> bang 1 lan copy toan bo
+ * - Dich 1..N-1: ~60% PageID giong nguon, ~10% khac noi dung, con lai thieu + vai PageID le chi co o dich
+ * Lan 1: sync + PRUNE; lan 2: VERIFY (UpChar lai tat ca) phai khong con gi de ghi;
+ * lan 3: nguon them/sua vai template -> sync tang dan dung digest cache
+ *
+ * @note
+ * Dich nao sau lan 1 khong giong nguon -> exit 1
+ * Build: gcc -O2 -DLINUX_PLATFORM -IInc <driver Src + Src/Port/zw111_port_linux.c> Host/zw111_emu.c Host/zw111_snapshot.c
+ *        Host/zw111_sync.c Host/zw111_sync_bench.c -lpthread -o zw111_sync_bench
+ *
+ * @code
+ * ./zw111_sync_bench [so dich] [so template] [latency %]    // mac dinh 4 dich, 100 template, 10%
+ * @endcode
+ */
+
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif // _GNU_SOURCE
+
+#include "zw111_emu.h"
+#include "zw111_sync.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define BENCH_CAPACITY        300u
+#define BENCH_EXTRA_PAGES     4u      /* PageID le chi co o dich (bi PRUNE xoa) */
+
+typedef struct BENCH_NODE {
+  zw111_emu_t *emu;
+  zw111_dev_t dev;
+  zw111_cfg_t cfg;
+  zw111_port_linux_cfg_t port;
+} bench_node_t;
+
+static zw111_sync_target_t s_targets[ZW111_SYNC_MAX_TARGETS];
+static bench_node_t s_nodes[ZW111_SYNC_MAX_TARGETS + 1u];
+
+/* ----------------------------------------------------------- */
+
+static uint32_t bench_rand(uint32_t *s){
+  *s ^= *s << 13; *s ^= *s >> 17; *s ^= *s << 5;
+  return *s;
+}
+
+/* ----------------------------------------------------------- */
+
+static double bench_now_ms(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec * 1e3 + (double)ts.tv_nsec * 1e-6;
+}
+
+/* ----------------------------------------------------------- */
+
+static int bench_node_open(bench_node_t *n, uint16_t latency_pct){
+  zw111_emu_cfg_t ec;
+  zw111_emu_default_cfg(&ec);
+  ec.capacity = BENCH_CAPACITY;
+  ec.latency_scale_pct = latency_pct;
+
+  n->emu = zw111_emu_create(&ec);
+  if(n->emu == NULL || !zw111_emu_start(n->emu)) return -1;
+
+  zw111_port_linux_default_cfg(&n->port);
+  n->port.device = zw111_emu_slave_path(n->emu);
+  n->cfg = (zw111_cfg_t){ .baud = 57600, .port_cfg = &n->port, .port_cfg_size = sizeof(n->port) };
+  return (zw111_uart_init(&n->dev, &n->cfg) == ZW111_STATUS_OK) ? 0 : -1;
+}
+
+/* ----------------------------------------------------------- */
+
+static void bench_node_close(bench_node_t *n){
+  if(n->emu == NULL) return;
+  (void)zw111_uart_deinit(&n->dev, &n->cfg);
+  zw111_emu_destroy(n->emu);
+  n->emu = NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+static void bench_print(const char *title, uint8_t n, double wall_ms){
+  uint32_t sum_ms = 0;
+  printf("\n%s\n", title);
+  printf("%-6s %6s %5s %5s %5s %5s %5s %4s %9s %9s %9s %7s %7s\n", "target", "status", "same", "add", "repl",
+         "del", "fail", "hit", "down B", "up B", "full B", "moved", "ms");
+  for(uint8_t i = 0; i < n; i++){
+      const zw111_sync_stats_t *s = &s_targets[i].stats;
+      double moved = s->full_copy_bytes ? 100.0 * (double)(s->bytes_down + s->bytes_up) / (double)s->full_copy_bytes : 0.0;
+      printf("%-6u %6d %5u %5u %5u %5u %5u %4u %9u %9u %9u %6.1f%% %7u\n", i, (int)s_targets[i].status, s->same, s->added,
+             s->replaced, s->deleted, s->failed, s->cache_hits, s->bytes_down, s->bytes_up, s->full_copy_bytes, moved,
+             s->elapsed_ms);
+      sum_ms += s->elapsed_ms;
+  }
+  printf("wall %.0f ms (tong thoi gian tung dich %u ms)\n", wall_ms, sum_ms);
+}
+
+/* ----------------------------------------------------------- */
+
+static zw111_status_t bench_sync(const zw111_sync_source_t *src, uint8_t n, uint8_t flags, const char *title){
+  double t0 = bench_now_ms();
+  zw111_status_t ret = zw111_sync_fleet(src, s_targets, n, flags);
+  bench_print(title, n, bench_now_ms() - t0);
+  return ret;
+}
+
+/* ----------------------------------------------------------- */
+
+int main(int argc, char **argv){
+  uint32_t n = (argc > 1) ? (uint32_t)strtoul(argv[1], NULL, 0) : 4u;
+  uint32_t count = (argc > 2) ? (uint32_t)strtoul(argv[2], NULL, 0) : 100u;
+  uint16_t latency = (argc > 3) ? (uint16_t)strtoul(argv[3], NULL, 0) : 10u;
+  if(n == 0u) n = 1u;
+  if(n > ZW111_SYNC_MAX_TARGETS) n = ZW111_SYNC_MAX_TARGETS;
+  if(count > BENCH_CAPACITY / 2u - 3u) count = BENCH_CAPACITY / 2u - 3u;
+
+  int fail = 0;
+  for(uint32_t i = 0; i <= n && !fail; i++) fail = bench_node_open(&s_nodes[i], latency);
+  if(fail){
+      fprintf(stderr, "khong tao duoc emulator\n");
+      for(uint32_t i = 0; i <= n; i++) bench_node_close(&s_nodes[i]);
+      return 1;
+  }
+
+  /* Nguon = node 0, dich k = node k + 1 */
+  uint32_t seed = 0x5EEDu;
+  for(uint32_t i = 0; i < count; i++) (void)zw111_emu_preload(s_nodes[0].emu, (uint16_t)(i * 2u), 1000u + i);
+  for(uint32_t k = 1; k < n; k++){
+      zw111_emu_t *e = s_nodes[k + 1u].emu;
+      for(uint32_t i = 0; i < count; i++){
+          uint32_t r = bench_rand(&seed) % 100u;
+          if(r < 60u) (void)zw111_emu_preload(e, (uint16_t)(i * 2u), 1000u + i);
+          else if(r < 70u) (void)zw111_emu_preload(e, (uint16_t)(i * 2u), 5000u + i);
+      }
+      for(uint32_t x = 0; x < BENCH_EXTRA_PAGES; x++) (void)zw111_emu_preload(e, (uint16_t)(x * 16u + 1u), 9000u + x);
+  }
+  for(uint32_t k = 0; k < n; k++) zw111_sync_target_init(&s_targets[k], &s_nodes[k + 1u].dev);
+
+  zw111_sync_source_t src;
+  double t0 = bench_now_ms();
+  if(zw111_sync_source_load(&s_nodes[0].dev, &src) != ZW111_STATUS_OK){
+      fprintf(stderr, "khong doc duoc nguon\n");
+      fail = 1;
+      goto out;
+  }
+  printf("%u dich, nguon %u template / %u bytes (doc trong %.0f ms), latency %u%%\n", n, src.count, src.bytes,
+         bench_now_ms() - t0, latency);
+
+  /* Lan 1: dong bo day du */
+  if(bench_sync(&src, (uint8_t)n, ZW111_SYNC_PRUNE, "[1] sync + prune") != ZW111_STATUS_OK) fail = 1;
+
+  /* Lan 2: UpChar lai moi PageID, dich nao con khac nguon -> loi */
+  if(bench_sync(&src, (uint8_t)n, ZW111_SYNC_PRUNE | ZW111_SYNC_VERIFY, "[2] verify") != ZW111_STATUS_OK) fail = 1;
+  for(uint32_t k = 0; k < n; k++){
+      const zw111_sync_stats_t *s = &s_targets[k].stats;
+      if(s->same != src.count || s->added || s->replaced || s->deleted) fail = 1;
+  }
+
+  /* Lan 3: nguon them 2 template + sua 1 template -> chi 3 PageID di qua UART */
+  zw111_sync_source_free(&src);
+  (void)zw111_emu_preload(s_nodes[0].emu, (uint16_t)(count * 2u), 7000u);
+  (void)zw111_emu_preload(s_nodes[0].emu, (uint16_t)(count * 2u + 2u), 7001u);
+  (void)zw111_emu_preload(s_nodes[0].emu, 0u, 7002u);
+  if(zw111_sync_source_load(&s_nodes[0].dev, &src) != ZW111_STATUS_OK){
+      fail = 1;
+      goto out;
+  }
+  if(bench_sync(&src, (uint8_t)n, ZW111_SYNC_PRUNE, "[3] incremental (digest cache)") != ZW111_STATUS_OK) fail = 1;
+  for(uint32_t k = 0; k < n; k++){
+      const zw111_sync_stats_t *s = &s_targets[k].stats;
+      if(s->added != 2u || s->replaced != 1u || s->cache_hits + 1u != src.count - 2u) fail = 1;
+  }
+  zw111_sync_source_free(&src);
+
+out:
+  for(uint32_t i = 0; i <= n; i++) bench_node_close(&s_nodes[i]);
+  printf("\n%s\n", fail ? "sync MISMATCH" : "sync OK");
+  return fail;
+}
@@ -47,9 +47,13 @@ typedef struct {
  * @brief Ham de gan handle UARTDRV sau khi UARTDRV_Init khi dinh nghia xong o dau do (Optional API)
  * (Co the la app.c)
  *
+ * @param port Instance port cua cam bien
  * @param handle Bien luu cau truc phan cung UART
+ *
+ * @note Moi handle chi gan cho 1 instance (callback UARTDRV chi tra ve handle)
+ * So instance toi da: `ZW111_PORT_EFR32_MAX_INSTANCES`
  */
-EFR32_PLATFORM_TAG bool zw111_port_efr32_set_handle(UARTDRV_Handle_t uart_handle);
+EFR32_PLATFORM_TAG bool zw111_port_efr32_set_handle(zw111_port_t *port, UARTDRV_Handle_t uart_handle);
 
 #ifdef USER_PORT_UART_INIT
 /**
@@ -0,0 +1,85 @@
+/*
+ * @file zw111_port_linux.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * File local danh cho Platform/Port Linux (POSIX termios)
+ * Chua cac API rieng biet cua Platform do de xu ly khoi tao UART (USB-Serial/pty) tren host
+ */
+
+#ifndef ZW111_LIB_INC_PORT_ZW111_PORT_LINUX_H_
+#define ZW111_LIB_INC_PORT_ZW111_PORT_LINUX_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "../zw111_port.h"
+
+#if defined(LINUX_PLATFORM)
+
+/* Duong dan thiet bi mac dinh neu USER khong truyen cau hinh */
+#ifndef ZW111_PORT_LINUX_DEFAULT_DEVICE
+#define ZW111_PORT_LINUX_DEFAULT_DEVICE   "/dev/ttyUSB0"
+#endif // ZW111_PORT_LINUX_DEFAULT_DEVICE
+
+/* Struct config UART rieng cua Linux Platform */
+typedef struct {
+  /* Duong dan den tty (vi du: /dev/ttyUSB0 hoac /dev/pts/3 cua emulator) */
+  const char *device;
+
+  /* File descriptor da mo san tu ben ngoai (>= 0 thi bo qua `device`), -1 neu khong dung */
+  int fd;
+} zw111_port_linux_cfg_t;
+
+/* File dich duoc mmap cho sink upload (UP_IMAGE/UP_CHAR): Data Packet ghi thang vao page cache, khong qua write() */
+typedef struct {
+  int fd;
+  uint8_t *map;           /* Vung da mmap (MAP_SHARED) */
+  uint32_t cap;           /* Kich thuoc da mmap (byte toi da ghi duoc) */
+  uint32_t len;           /* So byte da ghi */
+} zw111_port_linux_mmap_t;
+
+// ============= SPECIFIC PORT/PLATFORM PROTOTYPE FUNCTION =============
+
+/**
+ * @brief Helper set default configuration (device mac dinh, khong dung fd ngoai)
+ * @param[in] cfg Con tro den cau truc cau hinh cua Linux port
+ */
+LINUX_PLATFORM_TAG void zw111_port_linux_default_cfg(zw111_port_linux_cfg_t *cfg);
+
+/**
+ * @brief Tra ve file descriptor dang dung cua port (-1 neu chua init)
+ * @param port Instance port cua cam bien
+ * @note Dung de `poll()`/`select()` chung voi event loop cua USER
+ */
+LINUX_PLATFORM_TAG int zw111_port_linux_get_fd(const zw111_port_t *port);
+
+/**
+ * @brief Tao/mo file `path`, noi rong len `cap` bytes va mmap de lam dich cho `zw111_port_linux_mmap_sink()`
+ * @param cap Kich thuoc toi da (vi du ZW111_IMAGE_WIDTH * so hang / 2 cho UP_IMAGE)
+ * @return false neu khong mo/mmap duoc (errno giu nguyen)
+ */
+LINUX_PLATFORM_TAG bool zw111_port_linux_mmap_open(zw111_port_linux_mmap_t *m, const char *path, uint32_t cap);
+
+/**
+ * @brief Sink ghi Data Packet vao file da mmap (`ctx` la `zw111_port_linux_mmap_t *`)
+ * @return false (huy upload) neu vuot qua `cap`
+ */
+LINUX_PLATFORM_TAG bool zw111_port_linux_mmap_sink(void *ctx, const uint8_t *data, uint16_t len, bool last);
+
+/**
+ * @brief msync, cat file dung bang so byte da ghi, munmap va dong file
+ */
+LINUX_PLATFORM_TAG bool zw111_port_linux_mmap_close(zw111_port_linux_mmap_t *m);
+
+#endif // LINUX_PLATFORM
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_PORT_ZW111_PORT_LINUX_H_ */
@@ -26,6 +26,20 @@ extern "C" {
 #include "stdio.h"
 #include "stdint.h"
 #include "zw111_lowlevel.h"
+#include "zw111_ringbuf.h"
+#include "zw111_presence.h"
+#include "zw111_meta.h"
+
+/* Cac he so baudrate (9600 * N) dam phan duoc, tang dan (mac dinh: baudrate chuan UART, EFR32 co the them 8, 10) */
+#ifndef ZW111_BAUD_LADDER
+#define ZW111_BAUD_LADDER           { 1u, 2u, 4u, 6u, 12u }
+#endif // ZW111_BAUD_LADDER
+
+#define ZW111_BAUD_MULT_MAX         12u    /* 115200 baud */
+#define ZW111_BAUD_VERIFY_ROUNDS    4u     /* So vong kiem tra sau moi lan doi baudrate */
+#define ZW111_BAUD_SETTLE_MS        20u    /* Cho UART 2 ben on dinh sau khi doi baudrate */
+
+#define ZW111_PKT_TUNE_ROUNDS       3u     /* So vong DownChar + UpChar do o moi packet size */
 
 /* Struct config chung cua giao thuc UART cho cac Platform/Port MCU khac cung co the dung duoc */
 typedef struct ZW111_UART_CONFIG {
@@ -39,6 +53,114 @@ typedef struct ZW111_UART_CONFIG {
   uint32_t port_cfg_size;
 } zw111_cfg_t;
 
+/* Loai thao tac async (quyet dinh cach decode ACK va cac buoc noi tiep) */
+typedef enum ZW111_OP_KIND {
+  ZW111_OP_SIMPLE = 0,      /* 1 lenh, ket qua chi la Confirm Code */
+  ZW111_OP_SEARCH,          /* PS_Search -> zw111_match_result_t */
+  ZW111_OP_MATCH,           /* PS_Match -> score */
+  ZW111_OP_ENROLL_STEP1,    /* GetImage -> GenChar(CB1) */
+  ZW111_OP_ENROLL_STEP2,    /* GetImage -> GenChar(CB2) -> RegModel */
+  ZW111_OP_ENROLL_STORE,    /* StoreChar(CB1, page enroll) */
+  ZW111_OP_INDEX_TABLE,     /* ReadIndexTable page 0 (-> page 1) */
+  ZW111_OP_TEMPLATE_COUNT,  /* ValidTempleteNum -> count */
+  ZW111_OP_SYSINFO,         /* ReadSysPara -> zw111_sysinfo_t */
+  ZW111_OP_SET_CHIP_ADDR,   /* SetChipAddr -> cap nhat dia chi cua LowLevel */
+  ZW111_OP_DELETE,          /* DeletChar(start, count) -> xoa khoang bit trong bitmap index */
+  ZW111_OP_EMPTY,           /* Empty -> xoa toan bo bitmap index */
+  ZW111_OP_INDEX_SYNC,      /* ReadSysPara (capacity) -> ReadIndexTable page 0..n -> bitmap index */
+  ZW111_OP_UPLOAD,          /* UpChar -> chuoi Data Packet vao sink -> zw111_xfer_stats_t */
+  ZW111_OP_DOWNLOAD,        /* DownChar -> chuoi Data Packet pull tu source -> zw111_xfer_stats_t */
+  ZW111_OP_UPLOAD_IMAGE,    /* UpImage -> chuoi Data Packet vao sink -> zw111_image_info_t (+ zw111_xfer_stats_t) */
+  ZW111_OP_SET_PKT_SIZE,    /* WriteReg(PKT_SIZE) -> cap nhat packet size cua LowLevel */
+  ZW111_OP_IDENTIFY,        /* GetImage -> GenChar(CB1) -> Search -> zw111_identify_result_t */
+  ZW111_OP_INDEX_PAGE,      /* ReadIndexTable trang n -> nap 1 trang vao bitmap index (lazy) */
+  ZW111_OP_NOTEPAD_READ     /* ReadNotePad trang n -> copy 32 bytes */
+} zw111_op_kind_t;
+
+/**
+ * @brief Noi nhan du lieu upload (template) tung Data Packet mot, xem `zw111_ll_data_sink_t`
+ * @return false -> huy upload
+ */
+typedef zw111_ll_data_sink_t zw111_data_sink_t;
+
+/**
+ * @brief Nguon du lieu download (template) tung Data Packet mot, xem `zw111_ll_data_source_t`
+ * @return So byte da ghi (khuc chua cuoi ngan hon `max` -> huy download)
+ */
+typedef zw111_ll_data_source_t zw111_data_source_t;
+
+/* Context cua `zw111_source_mem()`: template nam san trong RAM/Flash cua MCU */
+typedef struct ZW111_MEM_SOURCE {
+  const uint8_t *data;
+  uint32_t len;
+  uint32_t off;               /* Vi tri doc tiep theo (dat 0 truoc moi lan download) */
+} zw111_mem_source_t;
+
+/* Thong ke 1 lan truyen chuoi Data Packet (upload hoac download) */
+typedef struct ZW111_XFER_STATS {
+  uint32_t bytes;             /* Tong byte Data */
+  uint16_t packets;           /* So Data/End Packet */
+  uint32_t elapsed_ms;        /* ACK -> End Packet (download: den luc gui xong End Packet) */
+  uint32_t bytes_per_sec;     /* Thong luong (0 neu elapsed_ms = 0) */
+} zw111_xfer_stats_t;
+
+/* Cac buoc cua `zw111_identify()` */
+typedef enum ZW111_ID_STAGE {
+  ZW111_ID_STAGE_GET_IMAGE = 0,
+  ZW111_ID_STAGE_GEN_CHAR,
+  ZW111_ID_STAGE_SEARCH,
+  ZW111_ID_STAGE_COUNT
+} zw111_id_stage_t;
+
+/* Ket qua `zw111_identify()` */
+typedef struct ZW111_IDENTIFY_RESULT {
+  uint16_t page_id;
+  uint16_t match_score;
+  zw111_id_stage_t stage;                   /* Buoc cuoi da chay (buoc gay loi neu status != OK) */
+  uint32_t stage_ms[ZW111_ID_STAGE_COUNT];  /* Buoc truoc xong (hoac luc goi) -> ACK cua buoc nay, 0 = chua chay */
+  uint32_t total_ms;
+} zw111_identify_result_t;
+
+/* Ket qua `zw111_tune_packet_size()`, index theo zw111_packet_size_t */
+typedef struct ZW111_PKT_TUNE {
+  uint32_t bytes_per_sec[4];  /* Thong luong DownChar + UpChar (tinh ca Command/ACK), 0 = loi hoc bi bo qua */
+  uint8_t errors[4];          /* So vong loi: timeout, sai checksum, du lieu doc lai khac du lieu gui */
+  zw111_packet_size_t best;   /* Packet size dang dung sau khi tune */
+} zw111_pkt_tune_t;
+
+typedef struct ZW111_OP zw111_op_t;
+
+/**
+ * @brief Callback khi 1 thao tac async hoan tat
+ * @param op Thao tac vua xong
+ * @param status Ket qua da duoc map tu Confirm Code (giong gia tri tra ve cua API blocking)
+ * @param user Con tro USER truyen vao luc goi API async
+ */
+typedef void (*zw111_op_cb_t)(zw111_op_t *op, zw111_status_t status, void *user);
+
+/**
+ * @brief Doi tuong hoan tat (completion object) cua 1 thao tac async
+ *
+ * @note USER cap phat (static/trong context cua App) va giu cho den khi `done == true`
+ * Output (score, result, table,...) duoc ghi vao con tro USER truyen vao API async
+ * nen vung nho do cung phai ton tai den luc xong
+ */
+struct ZW111_OP {
+  zw111_dev_t *dev;           /* Instance cam bien thuc thi thao tac */
+  zw111_ll_txn_t txn;         /* Transaction dang chay cua thao tac */
+  zw111_op_kind_t kind;
+  uint8_t step;               /* Buoc hien tai cua thao tac nhieu lenh */
+  volatile bool done;         /* Poll duoc thay cho callback */
+  zw111_status_t status;      /* Ket qua (hop le khi done == true) */
+  zw111_op_cb_t cb;
+  void *user;
+  void *out;                  /* Con tro output cua USER */
+  uint16_t out_len;           /* Kich thuoc output (neu can) */
+  uint32_t arg;               /* Tham so phu (dia chi chip moi,...) */
+  void *out2;                 /* Output phu (thong ke truyen cua UpImage,...) */
+  uint32_t tick;              /* Moc thoi gian buoc truoc (do thoi gian tung buoc cua Identify) */
+};
+
 // ============= APPLICATION PROTOTYPE FUNCTION =============
 
 /**
@@ -53,18 +175,22 @@ typedef struct ZW111_UART_CONFIG {
  *　Chuc nang chinh cua ham nay chi Wrapper cua ham Flush UART RX (Xoa rac) + UART port init
  *　va chuan bi demo/transaction moi
  *
+ * @param dev Instance cam bien (USER cap phat, moi cam bien 1 instance). Moi API ben duoi deu nhan tham so nay
+ * @param cfg Cau hinh UART/Port cua instance
+ *
  * @return zw111_status_t
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_uart_init(const zw111_cfg_t *cfg);
+zw111_status_t zw111_uart_init(zw111_dev_t *dev, const zw111_cfg_t *cfg);
 
 /**
  *
+ * @param dev
  * @param cfg
  * @return
  */
-zw111_status_t zw111_uart_deinit(const zw111_cfg_t *cfg);
+zw111_status_t zw111_uart_deinit(zw111_dev_t *dev, const zw111_cfg_t *cfg);
 
 /**
  * @brief API xac thuc mat khau handshake voi ZW111
@@ -75,7 +201,7 @@ zw111_status_t zw111_uart_deinit(const zw111_cfg_t *cfg);
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_verify_password(uint32_t pwd);
+zw111_status_t zw111_verify_password(zw111_dev_t *dev, uint32_t pwd);
 
 /**
  * @brief API thay doi mat khau truy cap module ZW111
@@ -90,7 +216,7 @@ zw111_status_t zw111_verify_password(uint32_t pwd);
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_set_password(uint32_t new_pwd);
+zw111_status_t zw111_set_password(zw111_dev_t *dev, uint32_t new_pwd);
 
 /**
  * @brief Chup anh van tay va luu vao ImageBuffer trong module
@@ -100,7 +226,15 @@ zw111_status_t zw111_set_password(uint32_t new_pwd);
  *  - ZW111_STATUS_ERROR on failure
  *  - ZW111_STATUS_NO_FINGER neu khong co ngon tay
  */
-zw111_status_t zw111_get_image(void);
+zw111_status_t zw111_get_image(zw111_dev_t *dev);
+
+/**
+ * @brief Poll GetImage theo lich cua `p` (`zw111_presence.h`): chua den han thi return ngay khong dung UART,
+ * den han thi `zw111_get_image()` roi `zw111_presence_record()` (hen lan poll sau, cong don thong ke)
+ *
+ * @return ZW111_PRESENCE_EV_NONE neu chua den han, ZW111_PRESENCE_EV_DETECTED khi vua co ngon tay
+ */
+zw111_presence_event_t zw111_presence_poll(zw111_dev_t *dev, zw111_presence_t *p);
 
 /* --------- MATCH FLOW ---------  */
 
@@ -117,7 +251,7 @@ zw111_status_t zw111_get_image(void);
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_gen_char(zw111_charbuffer_t buf);
+zw111_status_t zw111_gen_char(zw111_dev_t *dev, zw111_charbuffer_t buf);
 
 /**
  * @brief Search CharBuffer trong Database
@@ -132,13 +266,13 @@ zw111_status_t zw111_gen_char(zw111_charbuffer_t buf);
  *  - ZW111_STATUS_ERROR on failure
  *  - ZW111_STATUS_MATCH_FAIL neu khong tim thay
  */
-zw111_status_t zw111_search(zw111_charbuffer_t buf, uint16_t start, uint16_t count, zw111_match_result_t *result);
+zw111_status_t zw111_search(zw111_dev_t *dev, zw111_charbuffer_t buf, uint16_t start, uint16_t count, zw111_match_result_t *result);
 
 /**
  * @brief API load char (dac tinh) van tay tu FLASH vao RAM de so khop (thay cho Search)
  * @return
  */
-zw111_status_t zw111_load_char(zw111_charbuffer_t buf, uint16_t page_id);
+zw111_status_t zw111_load_char(zw111_dev_t *dev, zw111_charbuffer_t buf, uint16_t page_id);
 
 /**
  * @brief API de so sanh diem tuong dong giua CharBuffer1 va CharBuffer2
@@ -149,7 +283,26 @@ zw111_status_t zw111_load_char(zw111_charbuffer_t buf, uint16_t page_id);
  *  - ZW111_STATUS_ERROR on failure
  *  - ZW111_STATUS_MATCH_FAIL neu khong khop
  */
-zw111_status_t zw111_match(uint16_t *score);
+zw111_status_t zw111_match(zw111_dev_t *dev, uint16_t *score);
+
+/**
+ * @brief Nhan dang 1:N trong 1 thao tac: GetImage -> GenChar(CharBuffer1) -> Search
+ *
+ * @details
+ * 3 lenh noi tiep nhau ngay trong callback ACK (params encode thang vao `op->txn`, lenh ke tiep kick TX
+ * ngay trong cung lan `zw111_process()`), khong qua 3 state FSM va 3 vong main loop nhu goi tung API.
+ * Lenh cua thao tac khac khong chen vao giua nen CharBuffer1 khong bi ghi de
+ *
+ * @param start PageID bat dau Search
+ * @param count So template can Search, 0 -> lay khoang PageID co template tu bitmap index (`zw111_sync_index()`)
+ * @param[out] result PageID, score, buoc cuoi da chay va thoi gian tung buoc
+ * @return
+ *  - ZW111_STATUS_OK: tim thay (`result->match_score` de App tu so nguong)
+ *  - ZW111_STATUS_NO_FINGER: chua co ngon tay (dung o GetImage, goi lai o vong sau)
+ *  - ZW111_STATUS_MATCH_FAIL: khong tim thay, hoac database rong (dung sau GetImage, khong Search)
+ *  - ZW111_STATUS_ERROR: count = 0 ma bitmap index chua dong bo, hoac loi cua buoc `result->stage`
+ */
+zw111_status_t zw111_identify(zw111_dev_t *dev, uint16_t start, uint16_t count, zw111_identify_result_t *result);
 
 /**
  *
@@ -157,7 +310,7 @@ zw111_status_t zw111_match(uint16_t *score);
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_sleep_mode(void);
+zw111_status_t zw111_sleep_mode(zw111_dev_t *dev);
 
 /* --------- ENROLL FLOW ---------  */
 
@@ -167,25 +320,25 @@ zw111_status_t zw111_sleep_mode(void);
  * @param[in] page_id PageID muon luu template
  * @return
  */
-zw111_status_t zw111_enroll_start(uint16_t page_id);
+zw111_status_t zw111_enroll_start(zw111_dev_t *dev, uint16_t page_id);
 
 /**
  *
  * @return
  */
-zw111_status_t zw111_enroll_step1(void);
+zw111_status_t zw111_enroll_step1(zw111_dev_t *dev);
 
 /**
  *
  * @return
  */
-zw111_status_t zw111_enroll_step2(void);
+zw111_status_t zw111_enroll_step2(zw111_dev_t *dev);
 
 /**
  *
  * @return
  */
-zw111_status_t zw111_enroll_store(void);
+zw111_status_t zw111_enroll_store(zw111_dev_t *dev);
 
 /* --------- DATABASE MANAGEMENT ---------  */
 
@@ -194,34 +347,245 @@ zw111_status_t zw111_enroll_store(void);
  * @param page_id
  * @return
  */
-zw111_status_t zw111_delete_template(uint16_t page_id);
+zw111_status_t zw111_delete_template(zw111_dev_t *dev, uint16_t page_id);
+
+/**
+ * @brief Xoa `count` template lien tiep tu `start` bang 1 lenh PS_DeleteChar (DeleteNum = count)
+ * @note Thanh cong -> xoa ca khoang trong bitmap index
+ */
+zw111_status_t zw111_delete_range(zw111_dev_t *dev, uint16_t start, uint16_t count);
+
+/**
+ * @brief Xoa 1 tap PageID bat ky voi it lenh PS_DeleteChar nhat
+ *
+ * @details
+ * Tap PageID duoc gop thanh cac khoang (start, count) bang `zw111_index_next_delete_run()`:
+ * PageID lien tiep gop chung, bitmap index valid thi PageID da trong duoc bo qua va slot trong
+ * giua 2 PageID can xoa duoc noi vao cung 1 lenh. Moi khoang 1 round trip + 1 lan xoa Flash
+ *
+ * @param pages Danh sach PageID (khong can sap xep, trung lap duoc)
+ * @param[out] runs So lenh PS_DeleteChar da gui (co the NULL)
+ * @return
+ *  - ZW111_STATUS_OK on success
+ *  - ZW111_STATUS_ERROR neu co PageID vuot capacity (chua gui lenh nao)
+ *  - Status cua lenh PS_DeleteChar loi dau tien (cac khoang truoc do da xoa, bitmap da cap nhat)
+ */
+zw111_status_t zw111_delete_set(zw111_dev_t *dev, const uint16_t *pages, uint16_t n, uint16_t *runs);
 
 /**
  *
  * @return
  */
-zw111_status_t zw111_clear_database(void);
+zw111_status_t zw111_clear_database(zw111_dev_t *dev);
 
 /**
  *
  * @param table
  * @param len
  * @return
+ * @note Chi doc trang 0 (va trang 1 neu len >= 64), module > 512 template dung `zw111_sync_index()`/`zw111_index_open()`
  */
-zw111_status_t zw111_read_index_table(uint8_t *table, uint8_t len);
+zw111_status_t zw111_read_index_table(zw111_dev_t *dev, uint8_t *table, uint8_t len);
 
 /**
+ * @brief Dong bo bitmap chiem dung (`dev->index`) voi cam bien
  *
- * @return
+ * @details
+ * Doc database_capacity (PS_ReadSysPara) roi doc du ceil(capacity / 256) trang Index Table
+ * Goi 1 lan khi Probe, sau do Store/Delete/Empty thanh cong qua driver tu cap nhat bitmap
+ * => Enroll (tim slot trong) va Search (khoang PageID) khong can doc lai Index Table
+ *
+ * @note Neu template bi thay doi ngoai driver (tool PC, lenh Auto Enroll,...) thi goi lai ham nay
+ */
+zw111_status_t zw111_sync_index(zw111_dev_t *dev);
+
+/**
+ * @brief Mo bitmap index o che do lazy: chi doc System Parameter (capacity, packet size), chua doc Index Table
+ *
+ * @details
+ * So trang Index Table = ceil(database_capacity / 256) (module dung luong lon > 2 trang)
+ * Moi trang 32 bytes chi doc khi can lan dau (`zw111_index_fetch()` hoac cac ham `*_lazy()` ben duoi)
+ * `valid` thanh true khi moi trang da duoc nap
+ */
+zw111_status_t zw111_index_open(zw111_dev_t *dev);
+
+/**
+ * @brief Doc 1 trang Index Table (PS_ReadIndexTable) vao bitmap index (doc lai neu da nap)
+ * @param page_no 0 .. ceil(capacity / 256) - 1
+ */
+zw111_status_t zw111_index_fetch(zw111_dev_t *dev, uint8_t page_no);
+
+/**
+ * @brief PageID co template khong (doc trang Index Table chua PageID neu chua nap)
+ */
+zw111_status_t zw111_index_test_lazy(zw111_dev_t *dev, uint16_t page_id, bool *used);
+
+/**
+ * @brief So template co PageID < `page_id` (`zw111_index_rank()`), doc cac trang 0 .. page_id / 256 chua nap
+ * @note VD: phan trang UI "trang thu may" cua 1 nguoi dung, tach Search thanh nhieu khoang deu nhau
  */
-zw111_status_t zw111_read_notepad(void);
+zw111_status_t zw111_index_rank_lazy(zw111_dev_t *dev, uint16_t page_id, uint16_t *rank);
+
+/**
+ * @brief PageID cua template thu `k` (`zw111_index_select()`), doc them trang Index Table cho den khi du k + 1 template
+ * @return ZW111_STATUS_ERROR neu database co it hon k + 1 template
+ */
+zw111_status_t zw111_index_select_lazy(zw111_dev_t *dev, uint16_t k, uint16_t *page_id);
+
+/**
+ * @brief Bitmap chiem dung cua cam bien (chi doc), dung voi cac ham `zw111_index_*()`
+ * @note Chi hop le (`valid == true`) sau khi `zw111_sync_index()` thanh cong (hoac da `zw111_index_fetch()` du moi trang)
+ */
+__attribute__((always_inline)) static inline const zw111_index_t *zw111_get_index(const zw111_dev_t *dev){
+  return &dev->index;
+}
+
+/**
+ * @brief Doc 1 trang NotePad (PS_ReadNotePad, 32 bytes FLASH danh cho USER)
+ * @param page_no 0 .. ZW111_META_PAGES - 1
+ * @param[out] content 32 bytes
+ */
+zw111_status_t zw111_read_notepad(zw111_dev_t *dev, uint8_t page_no, uint8_t *content);
+
+/**
+ * @brief Ghi 1 trang NotePad (PS_WriteNotePad)
+ * @note Ghi FLASH cua cam bien (~30 ms, co gioi han so lan ghi) -> metadata cua driver di qua `zw111_meta_flush()` (ghi gop)
+ */
+zw111_status_t zw111_write_notepad(zw111_dev_t *dev, uint8_t page_no, const uint8_t *content);
+
+/**
+ * @brief Khoi dong nhanh: doc record metadata (`zw111_meta.h`) tu NotePad thay vi ReadSysPara + ReadIndexTable
+ *
+ * @details
+ * Doc header (trang 0), kiem tra magic/version roi doc cac trang con lai va kiem tra CRC-32
+ * Hop le -> `dev->index` = bitmap trong record (valid), packet size cua LowLevel = packet size da ghi, bang hit duoc nap
+ * Ban sao `m->shadow` = noi dung NotePad vua doc -> lan `zw111_meta_flush()` sau chi ghi trang thay doi
+ *
+ * @code
+ * uint16_t n;
+ * if(zw111_meta_load(&dev, &meta) != ZW111_STATUS_OK ||
+ *    zw111_get_valid_template_count(&dev, &n) != ZW111_STATUS_OK || n != meta.template_count){
+ *     zw111_sync_index(&dev);             // Khoi dong lanh
+ *     zw111_meta_touch(&meta, now);       // Ghi record moi
+ * }
+ * @endcode
+ *
+ * @return ZW111_STATUS_ERROR neu NotePad chua co record/record hong (bitmap index khong valid)
+ * @note Baudrate trong record chi de tham khao: phai noi duoc voi cam bien (baud hien tai) moi doc duoc NotePad
+ * @note Template bi doi ngoai driver se khong co trong record -> nen so sanh voi PS_ValidTempleteNum nhu tren
+ */
+zw111_status_t zw111_meta_load(zw111_dev_t *dev, zw111_meta_t *m);
+
+/**
+ * @brief Ghi record metadata vao NotePad neu den han (`zw111_meta_next_flush_ms()`) hoac `force`
+ *
+ * @details
+ * Lay bitmap/so template tu `dev->index`, baudrate + packet size tu LowLevel, encode tung trang
+ * va chi gui PS_WriteNotePad cho trang khac voi `m->shadow`. Trang du lieu ghi truoc, header (seq + 1, CRC) ghi sau cung
+ * => mat nguon giua chung thi lan `zw111_meta_load()` sau thay CRC sai va khoi dong lanh
+ *
+ * @return ZW111_STATUS_ERROR neu bitmap index chua valid (khong ghi record sai)
+ */
+zw111_status_t zw111_meta_flush(zw111_dev_t *dev, zw111_meta_t *m, bool force);
 
 /**
  *
  * @param count
  * @return
  */
-zw111_status_t zw111_get_valid_template_count(uint16_t *count);
+zw111_status_t zw111_get_valid_template_count(zw111_dev_t *dev, uint16_t *count);
+
+/* --------- TEMPLATE TRANSFER ---------  */
+
+/**
+ * @brief Upload template trong CharBuffer ve HOST (PS_UpChar), stream tung Data Packet vao `sink`
+ *
+ * @details
+ * Moi Data Packet duoc dua cho sink ngay khi parser verify xong Checksum (con tro vao parser, khong copy),
+ * nen MCU khong can buffer chua ca template. Kich thuoc moi Packet theo `zw111_sysinfo_t.packet_size`
+ * (LowLevel biet sau `zw111_read_sysinfo()`/`zw111_sync_index()`, Packet dai hon -> ZW111_STATUS_PROTOCOL_ERR)
+ *
+ * @code
+ * zw111_xfer_stats_t st;
+ * zw111_load_char(&dev, ZW111_CHARBUFFER_1, page_id);
+ * zw111_upload_char(&dev, ZW111_CHARBUFFER_1, zw111_sink_ringbuf, &rb, &st);
+ * @endcode
+ *
+ * @param buf CharBuffer can upload
+ * @param sink Noi nhan (NULL -> chi doc bo, van do duoc thong luong)
+ * @param ctx Con tro truyen lai cho sink
+ * @param[out] stats Byte/Packet/thoi gian/bytes per second (co the NULL)
+ */
+zw111_status_t zw111_upload_char(zw111_dev_t *dev, zw111_charbuffer_t buf, zw111_data_sink_t sink, void *ctx, zw111_xfer_stats_t *stats);
+
+/**
+ * @brief Upload anh goc trong ImageBuffer ve HOST (PS_UpImage), stream tung Data Packet vao `sink`
+ *
+ * @details
+ * Anh vai chuc KB (192 x 192 x 4 bit = 18 KB) nen khong bao gio nam tron trong RAM cua MCU:
+ * moi Data Packet di thang tu parser sang sink (giong `zw111_upload_char()`), sink tu quyet dinh
+ * gui tiep qua Zigbee/ghi Flash/ghi file. Dung de chan doan anh chup hong (ACK TOO_DRY/TOO_WET,...)
+ * Dinh dang pixel: 4 bit/pixel, 2 pixel/byte (nibble cao truoc), quet tung hang `ZW111_IMAGE_WIDTH` pixel
+ *
+ * @code
+ * zw111_image_info_t info;
+ * if(zw111_get_image(&dev) == ZW111_STATUS_OK && zw111_gen_char(&dev, ZW111_CHARBUFFER_1) != ZW111_STATUS_OK){
+ *     zw111_upload_image(&dev, my_sink, &ctx, &info, NULL); // Anh khong tao duoc dac trung (qua kho/uot,...)
+ * }
+ * @endcode
+ *
+ * @param sink Noi nhan (NULL -> chi doc bo)
+ * @param ctx Con tro truyen lai cho sink
+ * @param[out] info size_bytes = tong byte nhan duoc, width = ZW111_IMAGE_WIDTH, height suy ra tu size_bytes (co the NULL)
+ * @param[out] stats Byte/Packet/thoi gian/bytes per second (co the NULL)
+ * @note Can GetImage truoc (ImageBuffer rong -> ACK loi tu cam bien)
+ */
+zw111_status_t zw111_upload_image(zw111_dev_t *dev, zw111_data_sink_t sink, void *ctx, zw111_image_info_t *info, zw111_xfer_stats_t *stats);
+
+/**
+ * @brief Sink ghi Data Packet vao ring buffer (`ctx` la `zw111_ringbuf_t *`)
+ * @return false (huy upload) neu ring khong du cho cho ca Packet
+ */
+bool zw111_sink_ringbuf(void *ctx, const uint8_t *data, uint16_t len, bool last);
+
+/**
+ * @brief Download template tu HOST vao CharBuffer (PS_DownChar), pull tung Data Packet tu `source`
+ *
+ * @details
+ * LowLevel giu 2 buffer Packet: trong luc DMA gui Packet N thi source ghi thang Data cua Packet N+1
+ * vao buffer con lai (header + Checksum dong goi tai cho), gui xong la kick ngay Packet ke tiep
+ * => duong truyen khong bi ngat giua cac Data Packet va End Packet.
+ * Kich thuoc moi Packet theo `zw111_sysinfo_t.packet_size` (128 bytes neu chua goi `zw111_read_sysinfo()`/`zw111_sync_index()`)
+ * Cam bien tra 0xF1 cho lenh -> ACK 0xF0 tung Packet duoc bo qua, ACK loi dung download, ACK cuoi sau End Packet la ket qua
+ *
+ * @code
+ * zw111_mem_source_t src = { .data = tpl, .len = sizeof(tpl), .off = 0 };
+ * zw111_download_char(&dev, ZW111_CHARBUFFER_1, zw111_source_mem, &src, NULL);
+ * zw111_enroll_start(&dev, page_id);   // StoreChar CB1 -> PageID
+ * zw111_enroll_store(&dev);
+ * @endcode
+ *
+ * @param buf CharBuffer dich
+ * @param source Nguon du lieu (bat buoc)
+ * @param ctx Con tro truyen lai cho source
+ * @param[out] stats Byte/Packet/thoi gian/bytes per second (co the NULL)
+ * @return ZW111_STATUS_ERROR neu source tra ve sai kich thuoc (da gui CANCEL de cam bien thoat phien download)
+ */
+zw111_status_t zw111_download_char(zw111_dev_t *dev, zw111_charbuffer_t buf, zw111_data_source_t source, void *ctx, zw111_xfer_stats_t *stats);
+
+/**
+ * @brief Download dung giua chung sau khi cam bien da nhan lenh (source tra sai kich thuoc, UART loi)
+ * -> cam bien van cho Data Packet, khong xu ly lenh moi
+ * @return true -> phai goi `zw111_cancel()` (ngoai callback) truoc lenh ke tiep. `zw111_download_char()` tu goi
+ */
+__attribute__((always_inline)) static inline bool zw111_op_needs_cancel(const zw111_op_t *op){
+  return op->done && op->txn.xfer_need_cancel;
+}
+
+/**
+ * @brief Source doc lien tiep tu vung nho (`ctx` la `zw111_mem_source_t *`)
+ */
+uint16_t zw111_source_mem(void *ctx, uint8_t *buf, uint16_t max, bool *last);
 
 /* --------- SYSTEM & CONFIG ---------  */
 
@@ -237,35 +601,35 @@ zw111_status_t zw111_get_valid_template_count(uint16_t *count);
  * @param info Con tro tro den cac tham so tra ve cua he thong module
  * @return
  */
-zw111_status_t zw111_read_sysinfo(zw111_sysinfo_t *info);
+zw111_status_t zw111_read_sysinfo(zw111_dev_t *dev, zw111_sysinfo_t *info);
 
 /**
  * @brief
  * @param multiplier
  * @return
  */
-zw111_status_t zw111_set_baudrate(uint16_t multiplier);
+zw111_status_t zw111_set_baudrate(zw111_dev_t *dev, uint16_t multiplier);
 
 /**
  *
  * @param newAddr
  * @return
  */
-zw111_status_t zw111_set_new_chip_addr(uint32_t newAddr);
+zw111_status_t zw111_set_new_chip_addr(zw111_dev_t *dev, uint32_t newAddr);
 
 /**
- *
- * @param size
- * @return
+ * @brief Ghi thanh ghi packet size (luu trong FLASH cua cam bien), ACK OK -> LowLevel dung ngay kich thuoc moi
+ * @param size 32/64/128/256 bytes
+ * @return ZW111_STATUS_ERROR neu kich thuoc vuot ZW111_MAX_DATA_LEN (buffer RX/TX khong chua duoc)
  */
-zw111_status_t zw111_set_packet_size(zw111_packet_size_t size);
+zw111_status_t zw111_set_packet_size(zw111_dev_t *dev, zw111_packet_size_t size);
 
 /**
  *
  * @param level
  * @return
  */
-zw111_status_t zw111_set_security_level(zw111_match_threshold_t level);
+zw111_status_t zw111_set_security_level(zw111_dev_t *dev, zw111_match_threshold_t level);
 
 /**
  *
@@ -273,7 +637,150 @@ zw111_status_t zw111_set_security_level(zw111_match_threshold_t level);
  * @param content Gia tri cau hinh co the thay doi cho thanh ghi
  * @return
  */
-zw111_status_t zw111_write_reg_1byte(zw111_reg_t reg_no, uint8_t content);
+zw111_status_t zw111_write_reg_1byte(zw111_dev_t *dev, zw111_reg_t reg_no, uint8_t content);
+
+/* --------- LINK TUNING ---------  */
+
+/**
+ * @brief Dam phan baudrate nhanh nhat ma duong truyen van on dinh (blocking)
+ *
+ * @details
+ * Di len lan luot theo ZW111_BAUD_LADDER tu baudrate hien tai, moi buoc:
+ *  1. Bo qua he so ma Port cua HOST khong ho tro (thu doi roi tra lai ngay, chua gui gi cho cam bien)
+ *  2. PS_WriteReg(BAUDRATE) o baud cu -> ACK OK -> doi UART cua HOST sang 9600 * N
+ *  3. Kiem tra ZW111_BAUD_VERIFY_ROUNDS vong: READ_SYS_PARA (he so phai khop) + ReadIndexTable + UpChar
+ *     (chuoi Data Packet co Checksum, CharBuffer rong -> ACK loi van la frame hop le)
+ *  4. Loi duong truyen (timeout/sai checksum) -> ra lenh quay ve he so tot truoc do ngay tren duong truyen kem,
+ *     doi HOST ve va kiem tra lai, dung dam phan
+ * Gia tri tot nhat duoc cam bien luu trong Parameter Table (FLASH) nen giu qua cac lan mat nguon:
+ * luc khoi dong goi `zw111_probe_baud()` de tim lai (hoac App luu `best_mult` vao NVM)
+ *
+ * @param max_mult Gioi han tren (0 -> ZW111_BAUD_MULT_MAX)
+ * @param[out] best_mult He so dang dung sau khi dam phan (co the NULL)
+ * @return
+ *  - ZW111_STATUS_OK: dang chay o he so tot nhat tim duoc (ke ca khi da phai lui ve)
+ *  - Loi khac: duong truyen o baud ban dau da khong on dinh, hoac khong lui ve duoc
+ * @note Hang doi transaction phai rong, khong goi giua Enroll (UpChar dung CharBuffer1)
+ */
+zw111_status_t zw111_negotiate_baud(zw111_dev_t *dev, uint8_t max_mult, uint8_t *best_mult);
+
+/**
+ * @brief Tim baudrate cam bien dang dung (da dam phan tu truoc) bang READ_SYS_PARA, thu tu he so cao xuong thap
+ * @param[out] mult He so tim duoc (co the NULL), UART cua HOST duoc de o baudrate nay
+ * @return ZW111_STATUS_TIMEOUT neu khong he so nao tra loi
+ */
+zw111_status_t zw111_probe_baud(zw111_dev_t *dev, uint8_t *mult);
+
+/**
+ * @brief Chon packet size co thong luong cao nhat ma khong loi tren duong truyen hien tai (blocking)
+ *
+ * @details
+ * Voi moi packet size ma buffer chua duoc (<= ZW111_MAX_DATA_LEN), chay ZW111_PKT_TUNE_ROUNDS vong:
+ * DownChar `tpl` vao CharBuffer1 roi UpChar doc lai, so sanh tung byte voi `tpl`
+ * Thong luong = byte 2 chieu / thoi gian ca vong (gom ca Command + ACK cua moi Packet), packet size co
+ * vong loi bi loai. Packet nho ton ~11 bytes header/checksum + 1 lan ACK cho moi 32 bytes nen thuong cham hon ro
+ *
+ * @param tpl Template mau (vi du template da upload tu truoc), CharBuffer1 chua dung template nay sau khi xong
+ * @param tpl_len Kich thuoc template cua cam bien
+ * @param[out] result Thong luong/so loi theo tung packet size (co the NULL)
+ * @return
+ *  - ZW111_STATUS_OK: cam bien + LowLevel dang dung packet size tot nhat (luu trong FLASH cua cam bien)
+ *  - ZW111_STATUS_PROTOCOL_ERR: khong packet size nao chay sach
+ * @note Hang doi transaction phai rong, khong goi giua Enroll
+ */
+zw111_status_t zw111_tune_packet_size(zw111_dev_t *dev, const uint8_t *tpl, uint16_t tpl_len, zw111_pkt_tune_t *result);
+
+/* --------- ASYNC API ---------  */
+
+/**
+ * @brief Bom (pump) driver: day hang doi transaction va goi callback cua cac thao tac da xong
+ *
+ * @details
+ * Ham khong block. Goi tu main loop hoac tu event cua Zigbee stack (vi du moi 1-5 ms)
+ * Tat ca API `*_async()` chi xep hang transaction va tra ve ngay, ket qua den qua callback
+ * hoac poll `op->done` sau cac lan goi ham nay
+ *
+ * @param dev Instance cam bien (moi instance co hang doi rieng, can bom tung instance)
+ * @return true neu van con transaction dang cho xu ly
+ */
+bool zw111_process(zw111_dev_t *dev);
+
+/**
+ * @brief Huy thao tac dang chay (GET_IMAGE dang poll, SEARCH dai, upload/download do dang) bang lenh CANCEL
+ *
+ * @details
+ * Dung khi co yeu cau uu tien cao hon (Enroll tu admin, su kien dong cua) thay vi cho lenh hien tai timeout.
+ * Moi thao tac async dang xep hang ket thuc voi ZW111_STATUS_CANCELLED, cam bien ve idle sau toi da
+ * 1 Packet dang gui + timeout cua CANCEL (bang profile, 300 ms). Thoi gian CANCEL -> ACK nam o slot
+ * ZW111_CMD_CANCEL cua histogram latency (`ZW111_LL_STATS`)
+ *
+ * @return ZW111_STATUS_OK neu cam bien da ACK lenh CANCEL (hang doi luon rong sau khi return)
+ * @warning Goi tu cung context voi `zw111_process()`, khong goi tu ISR hay callback cua thao tac async
+ */
+zw111_status_t zw111_cancel(zw111_dev_t *dev);
+
+/**
+ * @brief Chay `zw111_process()` cho den khi `op` xong (nen tang cua cac API blocking)
+ * @warning Khong goi tu ben trong callback cua thao tac async
+ * @return op->status
+ */
+zw111_status_t zw111_op_wait(zw111_op_t *op);
+
+/**
+ * @brief Kiem tra thao tac da xong chua (completion object poll)
+ */
+__attribute__((always_inline)) static inline bool zw111_op_is_done(const zw111_op_t *op){
+  return (op != NULL) && op->done;
+}
+
+/**
+ * @brief Ban async cua cac API blocking cung ten (bo hau to `_async`)
+ *
+ * @details
+ * Tham so va output giong API blocking, them:
+ *  - `dev` Instance cam bien (giong API blocking)
+ *  - `op` Completion object (USER cap phat)
+ *  - `cb` Callback khi xong (co the NULL neu chi poll `op->done`)
+ *  - `user` Con tro tuy y truyen lai cho callback
+ *
+ * @return ZW111_STATUS_OK neu da xep hang thanh cong (ket qua that nam trong callback/op->status)
+ */
+zw111_status_t zw111_verify_password_async(zw111_dev_t *dev, zw111_op_t *op, uint32_t pwd, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_set_password_async(zw111_dev_t *dev, zw111_op_t *op, uint32_t new_pwd, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_get_image_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_gen_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_search_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, uint16_t start, uint16_t count,
+                                  zw111_match_result_t *result, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_load_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, uint16_t page_id, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_match_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t *score, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_identify_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t start, uint16_t count,
+                                    zw111_identify_result_t *result, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_enroll_step1_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_enroll_step2_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_enroll_store_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_delete_template_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t page_id, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_delete_range_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t start, uint16_t count, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_clear_database_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_read_index_table_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t *table, uint8_t len, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_sync_index_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_index_open_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_index_fetch_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t page_no, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_read_notepad_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t page_no, uint8_t *content, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_write_notepad_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t page_no, const uint8_t *content, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_get_valid_template_count_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t *count, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_upload_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, zw111_data_sink_t sink, void *ctx,
+                                       zw111_xfer_stats_t *stats, zw111_op_cb_t cb, void *user);
+/* Download loi giua chung: kiem tra `zw111_op_needs_cancel()` sau khi done, true -> `zw111_cancel()` */
+zw111_status_t zw111_download_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, zw111_data_source_t source, void *ctx,
+                                         zw111_xfer_stats_t *stats, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_upload_image_async(zw111_dev_t *dev, zw111_op_t *op, zw111_data_sink_t sink, void *ctx,
+                                        zw111_image_info_t *info, zw111_xfer_stats_t *stats, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_read_sysinfo_async(zw111_dev_t *dev, zw111_op_t *op, zw111_sysinfo_t *info, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_set_new_chip_addr_async(zw111_dev_t *dev, zw111_op_t *op, uint32_t newAddr, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_write_reg_1byte_async(zw111_dev_t *dev, zw111_op_t *op, zw111_reg_t reg_no, uint8_t content, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_set_baudrate_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t multiplier, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_set_packet_size_async(zw111_dev_t *dev, zw111_op_t *op, zw111_packet_size_t size, zw111_op_cb_t cb, void *user);
+zw111_status_t zw111_set_security_level_async(zw111_dev_t *dev, zw111_op_t *op, zw111_match_threshold_t level, zw111_op_cb_t cb, void *user);
 
 /* --------------- HELPER FUNCTION --------------- */
 
@@ -0,0 +1,223 @@
+/*
+ * @file zw111_cmd_table.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Bang mo ta (descriptor) cua toan bo Instruction Set trong `zw111_cmd_t` dang X-macro
+ * Moi lenh khai bao 1 lan: bo cuc Params, bo cuc Return Params, co Data Packet di kem hay khong, profile timeout
+ * Tu bang nay compiler sinh ra:
+ * - ZW111_CMD_PARAM_LEN_<CMD> / ZW111_CMD_RET_LEN_<CMD> : so byte Params / Return Params (hang so compile-time)
+ * - zw111_cmd_enc_<cmd>(out, ...)                       : ghi Params (Big-Endian) thang vao buffer dich, tra ve so byte
+ * - zw111_cmd_dec_<cmd>(in, len, ...)                   : doc Return Params tu ACK, false neu ACK ngan hon bo cuc
+ * - Bang `zw111_ll_cmd_desc()` trong LowLevel (param_len, ret_len, xfer, profile timeout)
+ *
+ * @note
+ * Them 1 lenh moi = 1 dong trong ZW111_CMD_TABLE + 2 dong ZW111_CMD_PARAMS_<CMD>/ZW111_CMD_RETS_<CMD>
+ * Kieu truong: U8, U16, U32 (Big-Endian theo datasheet), B32 (32 bytes tho)
+ * Truong B32 trong Return Params duoc decode thanh con tro vao buffer ACK (khong copy)
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_CMD_TABLE_H_
+#define ZW111_LIB_INC_ZW111_CMD_TABLE_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "string.h"
+#include "zw111_types.h"
+
+/* Data Packet di kem sau ACK cua Command */
+typedef enum ZW111_CMD_XFER {
+  ZW111_XFER_NONE = 0,  /* Chi Command -> ACK */
+  ZW111_XFER_UP,        /* Cam bien gui Data Packet len HOST sau ACK (UpChar/UpImage/ReadInfoPage) */
+  ZW111_XFER_DOWN       /* HOST gui Data Packet xuong cam bien sau ACK (DownChar/DownImage) */
+} zw111_cmd_xfer_t;
+
+/**
+ * @brief Profile latency cua 1 lenh (tinh tu luc TX xong -> nhan ACK)
+ *
+ * @details
+ * timeout = timeout_ms + per_page_us * (so PageID lenh phai duyet) / 1000
+ * So PageID: PageNum cua SEARCH, DeleteNum cua DELETE_CHAR, capacity database cua EMPTY
+ */
+typedef struct ZW111_CMD_PROFILE {
+  uint16_t expected_ms;   /* Latency dien hinh (tham khao/log) */
+  uint16_t timeout_ms;    /* Timeout ACK co dinh (chua tinh phan theo PageID) */
+  uint16_t per_page_us;   /* Thoi gian cong them cho moi PageID (0 = khong phu thuoc database) */
+} zw111_cmd_profile_t;
+
+/* Descriptor cua 1 lenh (sinh tu ZW111_CMD_TABLE) */
+typedef struct ZW111_CMD_DESC {
+  uint8_t param_len;              /* So byte Params cua Command Packet */
+  uint8_t ret_len;                /* So byte Return Params toi thieu cua ACK OK */
+  zw111_cmd_xfer_t xfer;          /* Data Packet di kem */
+  zw111_cmd_profile_t profile;    /* Timeout */
+} zw111_cmd_desc_t;
+
+/**
+ * @brief Bang lenh (profile uoc luong tu module that, du phong rong cho truong hop xau nhat)
+ * X(CMD, ten_ham, xfer, expected_ms, timeout_ms, per_page_us)
+ */
+#define ZW111_CMD_TABLE(X) \
+  X(GET_IMAGE,        get_image,        ZW111_XFER_NONE,    60,  1000,     0) \
+  X(GEN_CHAR,         gen_char,         ZW111_XFER_NONE,   120,  1000,     0) \
+  X(MATCH,            match,            ZW111_XFER_NONE,    30,   500,     0) \
+  X(SEARCH,           search,           ZW111_XFER_NONE,    30,   500,  1000) \
+  X(REG_MODEL,        reg_model,        ZW111_XFER_NONE,    60,  1000,     0) \
+  X(STORE_CHAR,       store_char,       ZW111_XFER_NONE,    50,  1000,     0) \
+  X(LOAD_CHAR,        load_char,        ZW111_XFER_NONE,    15,   500,     0) \
+  X(UP_CHAR,          up_char,          ZW111_XFER_UP,      15,   500,     0) \
+  X(DOWN_CHAR,        down_char,        ZW111_XFER_DOWN,    15,   500,     0) \
+  X(UP_IMAGE,         up_image,         ZW111_XFER_UP,      15,   500,     0) \
+  X(DOWN_IMAGE,       down_image,       ZW111_XFER_DOWN,    15,   500,     0) \
+  X(DELETE_CHAR,      delete_char,      ZW111_XFER_NONE,    25,   500,  2000) \
+  X(EMPTY,            empty,            ZW111_XFER_NONE,   100,  1000,  1500) \
+  X(WRITE_REG,        write_reg,        ZW111_XFER_NONE,    20,   500,     0) \
+  X(READ_SYS_PARA,    read_sys_para,    ZW111_XFER_NONE,     5,   300,     0) \
+  X(SET_PWD,          set_pwd,          ZW111_XFER_NONE,    30,  1000,     0) \
+  X(VERIFY_PWD,       verify_pwd,       ZW111_XFER_NONE,     5,   300,     0) \
+  X(GET_RANDOM_CODE,  get_random_code,  ZW111_XFER_NONE,     5,   300,     0) \
+  X(SET_CHIP_ADR,     set_chip_adr,     ZW111_XFER_NONE,    30,  1000,     0) \
+  X(READ_INFO_PAGE,   read_info_page,   ZW111_XFER_UP,      20,   500,     0) \
+  X(WRITE_NOTE_PAD,   write_note_pad,   ZW111_XFER_NONE,    30,  1000,     0) \
+  X(READ_NOTE_PAD,    read_note_pad,    ZW111_XFER_NONE,     5,   300,     0) \
+  X(VALID_TEMPLATE,   valid_template,   ZW111_XFER_NONE,     5,   300,     0) \
+  X(READ_INDEX_TABLE, read_index_table, ZW111_XFER_NONE,     5,   300,     0) \
+  X(CANCEL,           cancel,           ZW111_XFER_NONE,     5,   300,     0)
+
+/* Bo cuc Params cua Command Packet: F(kieu, ten) theo dung thu tu tren day */
+#define ZW111_CMD_PARAMS_GET_IMAGE(F)
+#define ZW111_CMD_PARAMS_GEN_CHAR(F)          F(U8, buf_id)
+#define ZW111_CMD_PARAMS_MATCH(F)
+#define ZW111_CMD_PARAMS_SEARCH(F)            F(U8, buf_id) F(U16, start_page) F(U16, page_num)
+#define ZW111_CMD_PARAMS_REG_MODEL(F)
+#define ZW111_CMD_PARAMS_STORE_CHAR(F)        F(U8, buf_id) F(U16, page_id)
+#define ZW111_CMD_PARAMS_LOAD_CHAR(F)         F(U8, buf_id) F(U16, page_id)
+#define ZW111_CMD_PARAMS_UP_CHAR(F)           F(U8, buf_id)
+#define ZW111_CMD_PARAMS_DOWN_CHAR(F)         F(U8, buf_id)
+#define ZW111_CMD_PARAMS_UP_IMAGE(F)
+#define ZW111_CMD_PARAMS_DOWN_IMAGE(F)
+#define ZW111_CMD_PARAMS_DELETE_CHAR(F)       F(U16, page_id) F(U16, count)
+#define ZW111_CMD_PARAMS_EMPTY(F)
+#define ZW111_CMD_PARAMS_WRITE_REG(F)         F(U8, reg_no) F(U8, content)
+#define ZW111_CMD_PARAMS_READ_SYS_PARA(F)
+#define ZW111_CMD_PARAMS_SET_PWD(F)           F(U32, password)
+#define ZW111_CMD_PARAMS_VERIFY_PWD(F)        F(U32, password)
+#define ZW111_CMD_PARAMS_GET_RANDOM_CODE(F)
+#define ZW111_CMD_PARAMS_SET_CHIP_ADR(F)      F(U32, address)
+#define ZW111_CMD_PARAMS_READ_INFO_PAGE(F)
+#define ZW111_CMD_PARAMS_WRITE_NOTE_PAD(F)    F(U8, page_no) F(B32, content)
+#define ZW111_CMD_PARAMS_READ_NOTE_PAD(F)     F(U8, page_no)
+#define ZW111_CMD_PARAMS_VALID_TEMPLATE(F)
+#define ZW111_CMD_PARAMS_READ_INDEX_TABLE(F)  F(U8, page_no)
+#define ZW111_CMD_PARAMS_CANCEL(F)
+
+/* Bo cuc Return Params cua ACK (sau Confirm Code) */
+#define ZW111_CMD_RETS_GET_IMAGE(F)
+#define ZW111_CMD_RETS_GEN_CHAR(F)
+#define ZW111_CMD_RETS_MATCH(F)               F(U16, score)
+#define ZW111_CMD_RETS_SEARCH(F)              F(U16, page_id) F(U16, score)
+#define ZW111_CMD_RETS_REG_MODEL(F)
+#define ZW111_CMD_RETS_STORE_CHAR(F)
+#define ZW111_CMD_RETS_LOAD_CHAR(F)
+#define ZW111_CMD_RETS_UP_CHAR(F)
+#define ZW111_CMD_RETS_DOWN_CHAR(F)
+#define ZW111_CMD_RETS_UP_IMAGE(F)
+#define ZW111_CMD_RETS_DOWN_IMAGE(F)
+#define ZW111_CMD_RETS_DELETE_CHAR(F)
+#define ZW111_CMD_RETS_EMPTY(F)
+#define ZW111_CMD_RETS_WRITE_REG(F)
+#define ZW111_CMD_RETS_READ_SYS_PARA(F)       F(U16, system_state) F(U16, sensor_type) F(U16, capacity) F(U16, security) \
+                                              F(U32, address) F(U16, packet_size) F(U16, baud_mult)
+#define ZW111_CMD_RETS_SET_PWD(F)
+#define ZW111_CMD_RETS_VERIFY_PWD(F)
+#define ZW111_CMD_RETS_GET_RANDOM_CODE(F)     F(U32, random)
+#define ZW111_CMD_RETS_SET_CHIP_ADR(F)
+#define ZW111_CMD_RETS_READ_INFO_PAGE(F)
+#define ZW111_CMD_RETS_WRITE_NOTE_PAD(F)
+#define ZW111_CMD_RETS_READ_NOTE_PAD(F)       F(B32, content)
+#define ZW111_CMD_RETS_VALID_TEMPLATE(F)      F(U16, count)
+#define ZW111_CMD_RETS_READ_INDEX_TABLE(F)    F(B32, table)
+#define ZW111_CMD_RETS_CANCEL(F)
+
+/* --------------- KIEU TRUONG --------------- */
+
+#define ZW111_FT_SIZE_U8              1u
+#define ZW111_FT_SIZE_U16             2u
+#define ZW111_FT_SIZE_U32             4u
+#define ZW111_FT_SIZE_B32             32u
+
+#define ZW111_FT_ARG_U8               uint8_t
+#define ZW111_FT_ARG_U16              uint16_t
+#define ZW111_FT_ARG_U32              uint32_t
+#define ZW111_FT_ARG_B32              const uint8_t *
+
+#define ZW111_FT_OUT_U8               uint8_t *
+#define ZW111_FT_OUT_U16              uint16_t *
+#define ZW111_FT_OUT_U32              uint32_t *
+#define ZW111_FT_OUT_B32              const uint8_t **
+
+#define ZW111_FT_PUT_U8(p, v)         do { (p)[0] = (uint8_t)(v); } while(0)
+#define ZW111_FT_PUT_U16(p, v)        do { (p)[0] = (uint8_t)((v) >> 8); (p)[1] = (uint8_t)(v); } while(0)
+#define ZW111_FT_PUT_U32(p, v)        do { (p)[0] = (uint8_t)((v) >> 24); (p)[1] = (uint8_t)((v) >> 16); \
+                                           (p)[2] = (uint8_t)((v) >> 8);  (p)[3] = (uint8_t)(v); } while(0)
+#define ZW111_FT_PUT_B32(p, v)        memcpy((p), (v), ZW111_FT_SIZE_B32)
+
+#define ZW111_FT_GET_U8(p, o)         (*(o) = (p)[0])
+#define ZW111_FT_GET_U16(p, o)        (*(o) = (uint16_t)(((uint16_t)(p)[0] << 8) | (p)[1]))
+#define ZW111_FT_GET_U32(p, o)        (*(o) = ((uint32_t)(p)[0] << 24) | ((uint32_t)(p)[1] << 16) | \
+                                              ((uint32_t)(p)[2] << 8)  | (uint32_t)(p)[3])
+#define ZW111_FT_GET_B32(p, o)        (*(o) = (p))
+
+/* Cac phep sinh code tren 1 truong F(kieu, ten) */
+#define ZW111_F_LEN(T, n)             + ZW111_FT_SIZE_##T
+#define ZW111_F_ARG(T, n)             , ZW111_FT_ARG_##T n
+#define ZW111_F_OUT(T, n)             , ZW111_FT_OUT_##T n
+#define ZW111_F_ENC(T, n)             ZW111_FT_PUT_##T(p, n); p += ZW111_FT_SIZE_##T;
+#define ZW111_F_DEC(T, n)             ZW111_FT_GET_##T(p, n); p += ZW111_FT_SIZE_##T;
+
+/* --------------- SINH CODE --------------- */
+
+/* Do dai Params/Return Params cua tung lenh */
+#define ZW111_CMD_GEN_LEN(CMD, name, xfer, exp_ms, tmo_ms, page_us) \
+  ZW111_CMD_PARAM_LEN_##CMD = 0 ZW111_CMD_PARAMS_##CMD(ZW111_F_LEN), \
+  ZW111_CMD_RET_LEN_##CMD = 0 ZW111_CMD_RETS_##CMD(ZW111_F_LEN),
+
+enum ZW111_CMD_LEN {
+  ZW111_CMD_TABLE(ZW111_CMD_GEN_LEN)
+};
+
+/**
+ * Encoder: zw111_cmd_enc_<cmd>(out, tham so...) -> so byte Params da ghi vao `out`
+ * Decoder: zw111_cmd_dec_<cmd>(in, len, con tro ket qua...) -> false neu `len` < ZW111_CMD_RET_LEN_<CMD>
+ * (moi con tro ket qua phai khac NULL)
+ */
+#define ZW111_CMD_GEN_CODEC(CMD, name, xfer, exp_ms, tmo_ms, page_us) \
+  __attribute__((unused)) static inline uint8_t zw111_cmd_enc_##name(uint8_t *out ZW111_CMD_PARAMS_##CMD(ZW111_F_ARG)){ \
+    uint8_t *p = out; \
+    (void)p; \
+    ZW111_CMD_PARAMS_##CMD(ZW111_F_ENC) \
+    return (uint8_t)ZW111_CMD_PARAM_LEN_##CMD; \
+  } \
+  __attribute__((unused)) static inline bool zw111_cmd_dec_##name(const uint8_t *in, uint16_t len ZW111_CMD_RETS_##CMD(ZW111_F_OUT)){ \
+    const uint8_t *p = in; \
+    const uint16_t need = (uint16_t)ZW111_CMD_RET_LEN_##CMD; \
+    (void)p; \
+    if(len < need) return false; \
+    ZW111_CMD_RETS_##CMD(ZW111_F_DEC) \
+    return true; \
+  }
+
+ZW111_CMD_TABLE(ZW111_CMD_GEN_CODEC)
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_CMD_TABLE_H_ */
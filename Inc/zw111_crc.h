@@ -0,0 +1,37 @@
+/*
+ * @file zw111_crc.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * CRC-32 dung chung cua thu vien (IEEE 802.3, giong zlib)
+ * - Record metadata NotePad (`zw111_meta`), file snapshot va digest template cua sync (Host)
+ *
+ * @note
+ * Tinh tung bit, khong bang tra (it FLASH). Chi thao tac RAM, khong phu thuoc Port
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_CRC_H_
+#define ZW111_LIB_INC_ZW111_CRC_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief CRC-32 cua `len` bytes
+ * @param crc 0 o lan goi dau, ket qua lan truoc de tinh tiep (chia nhieu doan)
+ */
+uint32_t zw111_crc32(uint32_t crc, const uint8_t *data, uint32_t len);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_CRC_H_ */
@@ -0,0 +1,182 @@
+/*
+ * @file zw111_index.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Bitmap chiem dung (occupancy) cua Template Database, cache tai MCU
+ * - Nap 1 lan tu Index Table (PS_ReadIndexTable) khi Probe, sau do tu cap nhat theo Store/Delete/Empty
+ * - Tim slot trong dau tien va duyet cac khoang PageID co template bang ctz/popcount tren tu 32-bit
+ * => Enroll/Search khong can round trip UART chi de biet bo cuc database
+ *
+ * @note
+ * Bit i cua byte j trong Index Table <-> PageID (j * 8 + i) (LSB truoc) theo datasheet
+ * Trong bitmap: PageID p nam o bit (p & 31) cua words[p >> 5]
+ * Ham o day chi thao tac RAM, khong goi UART (dong bo voi cam bien bang `zw111_sync_index()` trong zw111.h)
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_INDEX_H_
+#define ZW111_LIB_INC_ZW111_INDEX_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "zw111_types.h"
+
+/* So PageID toi da ma bitmap quan ly (boi so cua 256 = 1 trang Index Table) */
+#ifndef ZW111_INDEX_MAX_CAPACITY
+#define ZW111_INDEX_MAX_CAPACITY    2048u
+#endif // ZW111_INDEX_MAX_CAPACITY
+
+#define ZW111_INDEX_PAGE_BITS       256u   /* So PageID trong 1 trang Index Table */
+#define ZW111_INDEX_PAGE_BYTES      32u    /* So byte tra ve cua 1 lan PS_ReadIndexTable */
+#define ZW111_INDEX_WORDS           ((ZW111_INDEX_MAX_CAPACITY + 31u) / 32u)
+#define ZW111_INDEX_PAGES           ((ZW111_INDEX_MAX_CAPACITY + ZW111_INDEX_PAGE_BITS - 1u) / ZW111_INDEX_PAGE_BITS)
+#define ZW111_INDEX_PAGE_WORDS      (ZW111_INDEX_PAGE_BITS / 32u)
+
+#if (ZW111_INDEX_PAGES > 32u)
+#error "ZW111_INDEX_MAX_CAPACITY toi da 8192 (mask `loaded` 32-bit, 1 bit / trang Index Table)"
+#endif
+
+/* So PageID trong toi da duoc noi vao giua 1 lan DeleteChar (`zw111_index_next_delete_run()`)
+ * Xoa slot trong khong doi gi tren cam bien, nhung ton them thoi gian xoa Flash theo DeleteNum */
+#ifndef ZW111_INDEX_DELETE_MAX_GAP
+#define ZW111_INDEX_DELETE_MAX_GAP  16u
+#endif // ZW111_INDEX_DELETE_MAX_GAP
+
+typedef struct ZW111_INDEX {
+  uint32_t words[ZW111_INDEX_WORDS];  /* Bit = 1 -> PageID da co template */
+  uint16_t page_used[ZW111_INDEX_PAGES]; /* So template trong tung trang Index Table (rank/select nhay theo trang) */
+  uint32_t loaded;                    /* Bit n = 1 -> trang Index Table n da doc tu cam bien */
+  uint16_t capacity;                  /* database_capacity (da cat theo ZW111_INDEX_MAX_CAPACITY) */
+  uint16_t count;                     /* So template (popcount, cap nhat tang dan) */
+  bool valid;                         /* false -> chua doc du moi trang Index Table */
+} zw111_index_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Xoa bitmap va dat dung luong (chua valid cho den khi nap xong cac trang Index Table)
+ * @param capacity database_capacity doc tu System Parameter
+ */
+void zw111_index_reset(zw111_index_t *idx, uint16_t capacity);
+
+/**
+ * @brief Nap 1 trang Index Table (32 bytes = 256 PageID) vao bitmap
+ * @param page_no So trang (0, 1, 2, ...)
+ * @param table 32 bytes tra ve tu PS_ReadIndexTable
+ */
+void zw111_index_load_page(zw111_index_t *idx, uint8_t page_no, const uint8_t *table);
+
+/**
+ * @brief So trang Index Table can doc de phu het `capacity`
+ */
+uint8_t zw111_index_page_count(const zw111_index_t *idx);
+
+/**
+ * @brief Trang Index Table `page_no` da nap vao bitmap chua (doc lazy bang `zw111_index_fetch()` trong zw111.h)
+ */
+bool zw111_index_page_loaded(const zw111_index_t *idx, uint8_t page_no);
+
+/**
+ * @brief Danh dau PageID co/khong co template (sau Store/Delete thanh cong)
+ */
+void zw111_index_set(zw111_index_t *idx, uint16_t page_id, bool used);
+
+/**
+ * @brief Danh dau `count` PageID lien tiep tu `start` (sau DeleteChar nhieu template, theo tu 32-bit)
+ */
+void zw111_index_set_range(zw111_index_t *idx, uint16_t start, uint16_t count, bool used);
+
+/**
+ * @brief Kiem tra PageID da co template hay chua
+ */
+bool zw111_index_test(const zw111_index_t *idx, uint16_t page_id);
+
+/**
+ * @brief Danh dau toan bo database rong (sau PS_Empty thanh cong)
+ */
+void zw111_index_clear_all(zw111_index_t *idx);
+
+/**
+ * @brief Tim PageID trong dau tien tu `from` tro di (O(1) moi tu 32-bit)
+ *
+ * @param[out] page_id PageID trong
+ * @return
+ *  - ZW111_STATUS_OK neu tim thay
+ *  - ZW111_STATUS_DB_FULL neu khong con slot trong
+ *  - ZW111_STATUS_ERROR neu bitmap chua valid
+ */
+zw111_status_t zw111_index_find_first_free(const zw111_index_t *idx, uint16_t from, uint16_t *page_id);
+
+/**
+ * @brief Duyet lan luot cac khoang PageID lien tiep co template
+ *
+ * @code
+ * uint16_t cur = 0, start, count;
+ * while(zw111_index_next_range(&dev.index, &cur, &start, &count)){ ... }
+ * @endcode
+ *
+ * @param[in,out] cursor Vi tri bat dau tim (0 o lan goi dau), duoc cap nhat sau moi khoang
+ * @param[out] start PageID dau khoang
+ * @param[out] count So PageID lien tiep trong khoang
+ * @return false khi het khoang
+ */
+bool zw111_index_next_range(const zw111_index_t *idx, uint16_t *cursor, uint16_t *start, uint16_t *count);
+
+/**
+ * @brief Gop tap PageID can xoa thanh it lan DeleteChar (start, count) nhat
+ *
+ * @details
+ * - Bitmap valid: PageID can xoa nhung da trong -> bo qua. 1 lan xoa duoc keo qua slot trong
+ *   (toi da ZW111_INDEX_DELETE_MAX_GAP lien tiep), dung lai truoc PageID co template khong nam trong tap
+ * - Bitmap chua valid: chi gop cac PageID lien tiep trong tap
+ *
+ * @code
+ * uint16_t cur = 0, start, count;
+ * while(zw111_index_next_delete_run(&dev.index, req, &cur, &start, &count)){ DeleteChar(start, count) }
+ * @endcode
+ *
+ * @param req Bitmap PageID can xoa (ZW111_INDEX_WORDS tu, cung bo cuc voi `words`)
+ * @param[in,out] cursor 0 o lan goi dau
+ * @return false khi het
+ */
+bool zw111_index_next_delete_run(const zw111_index_t *idx, const uint32_t *req, uint16_t *cursor, uint16_t *start, uint16_t *count);
+
+/**
+ * @brief Khoang bao (PageID nho nhat -> lon nhat co template) dung cho 1 lan PS_Search
+ * @return false neu database rong hoac bitmap chua valid
+ */
+bool zw111_index_span(const zw111_index_t *idx, uint16_t *start, uint16_t *count);
+
+/**
+ * @brief Rank: so template co PageID < `page_id`
+ * @note Chi dung khi cac trang Index Table 0 .. (page_id / 256) da nap (`zw111_index_rank_lazy()` tu nap)
+ *       Cong `page_used` cua cac trang truoc + popcount toi da 8 tu 32-bit, khong duyet tung PageID
+ */
+uint16_t zw111_index_rank(const zw111_index_t *idx, uint16_t page_id);
+
+/**
+ * @brief Select: PageID cua template thu `k` (dem tu 0, theo PageID tang dan)
+ * @note Chi dung khi cac trang Index Table chua template do da nap
+ * @return false neu k >= so template da nap
+ */
+bool zw111_index_select(const zw111_index_t *idx, uint16_t k, uint16_t *page_id);
+
+/**
+ * @brief So template dang co (cache, khong can PS_ValidTempleteNum)
+ */
+__attribute__((unused)) static inline uint16_t zw111_index_count(const zw111_index_t *idx){
+  return idx->count;
+}
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_INDEX_H_ */
@@ -29,6 +29,9 @@ extern "C" {
 #include "zw111_types.h"
 #include "zw111_port.h"
 #include "zw111_port_select.h"
+#include "zw111_index.h"
+#include "zw111_stats.h"
+#include "zw111_cmd_table.h"
 
 #define ZW111_PKT_HEADER            0xEF01     /* Packet Header */
 #define ZW111_DEFAULT_ADDRESS       0xFFFFFFFF /* 4 bytes (32-bit) - 2 Word */
@@ -54,16 +57,207 @@ extern "C" {
 
 #define ZW111_FLUSH_TOTAL_MS        50
 #define ZW111_FLUSH_BYTE_TO         1
-#define ZW111_RX_TIMEOUT_MS         1000
+#define ZW111_RX_TIMEOUT_MS         1000   /* Timeout ACK du phong cho lenh khong co trong bang profile */
+
+/* Kich thuoc toi da cua Payload (khong tinh Checksum) ma parser chap nhan = Data Packet lon nhat ma buffer RX/TX chua duoc
+ * Mac dinh 256 (moi packet size). Khi packet size cua cam bien da co dinh (`zw111_tune_packet_size()`) co the build
+ * voi 128 hoac 64 de giam RAM cua parser + double buffer DownChar (~3 x 192 bytes voi 64) */
+#ifndef ZW111_MAX_DATA_LEN
+#define ZW111_MAX_DATA_LEN          256u
+#endif // ZW111_MAX_DATA_LEN
+
+#if (ZW111_MAX_DATA_LEN != 64u) && (ZW111_MAX_DATA_LEN != 128u) && (ZW111_MAX_DATA_LEN != 256u)
+#error "ZW111_MAX_DATA_LEN phai la 64, 128 hoac 256 (ACK Packet dai nhat can > 32 bytes)"
+#endif
+
+#define ZW111_PKT_SIZE_BYTES(size)  (32u << (size))  /* zw111_packet_size_t -> so byte Data cua 1 Packet */
+#define ZW111_RX_STAGE_SIZE         64u    /* Kich thuoc buffer trung gian doc tu ring buffer cua Port */
+
+/**
+ * @brief Frame hoan chinh do parser tach ra tu dong byte RX
+ * @note `data` khong chua 2 bytes Checksum (da duoc verify)
+ */
+typedef struct ZW111_LL_FRAME {
+  uint8_t pid;                          /* Packet Flag (ACK/DATA/END/COMMAND) */
+  uint32_t addr;                        /* Chip Address trong frame */
+  uint16_t data_len;                    /* So byte Payload (= Packet Length - 2) */
+  uint8_t data[ZW111_MAX_DATA_LEN];     /* Payload (Confirm Code + Return Params hoac Data) */
+} zw111_ll_frame_t;
+
+#define ZW111_TXN_MAX_PARAMS        40u    /* So byte Parameter toi da cua 1 Command trong transaction async */
+#define ZW111_TXN_MAX_RET           40u    /* So byte Return Params toi da luu lai trong transaction async */
+#define ZW111_TX_GUARD_MS           20u    /* Du phong cong them vao thoi gian truyen 1 Packet theo baud */
+#define ZW111_DATA_GAP_MS           100u   /* Khoang lang toi da giua 2 Data Packet lien tiep (ngoai thoi gian truyen) */
+#define ZW111_CANCEL_DRAIN_MS       50u    /* Cho ACK cua CANCEL sau ACK tre cua lenh bi huy */
+#define ZW111_DATA_FRAME_MAX        (ZW111_HDR_LEN + ZW111_MAX_DATA_LEN + ZW111_CHECKSUM_SIZE_BYTES) /* 1 Data Packet day */
+
+/* Hoc timeout theo latency do duoc (1 = bat, 0 = chi dung bang profile co dinh) */
+#ifndef ZW111_ADAPTIVE_TIMEOUT
+#define ZW111_ADAPTIVE_TIMEOUT      1
+#endif // ZW111_ADAPTIVE_TIMEOUT
+
+#define ZW111_ADAPT_MIN_SAMPLES     8u     /* So mau toi thieu truoc khi dung timeout hoc duoc */
+#define ZW111_ADAPT_MIN_TIMEOUT_MS  50u    /* Timeout hoc duoc khong nho hon gia tri nay */
+
+/**
+ * @brief Uoc luong latency thuc te cua 1 lenh (Jacobson/Karels, fixed-point)
+ * timeout hoc duoc = srtt + 4 * rttvar (~ percentile cao cua latency do duoc)
+ */
+typedef struct ZW111_LL_LAT_EST {
+  uint16_t srtt_x8;       /* Latency trung binh (ms * 8) */
+  uint16_t rttvar_x4;     /* Do lech trung binh (ms * 4) */
+  uint16_t samples;       /* So mau da hoc (bao hoa) */
+} zw111_ll_lat_est_t;
+
+/**
+ * @brief Trang thai cua state machine tach frame
+ */
+typedef enum ZW111_LL_PARSER_STATE {
+  ZW111_PARSER_WAIT_HDR_HI = 0,  /* Cho byte 0xEF */
+  ZW111_PARSER_WAIT_HDR_LO,      /* Cho byte 0x01 */
+  ZW111_PARSER_ADDR,             /* 4 bytes Chip Address */
+  ZW111_PARSER_PID,              /* Packet Flag */
+  ZW111_PARSER_LEN,              /* 2 bytes Packet Length */
+  ZW111_PARSER_DATA,             /* Payload */
+  ZW111_PARSER_SUM               /* 2 bytes Checksum */
+} zw111_ll_parser_state_t;
+
+/**
+ * @brief Ket qua moi lan feed 1 byte vao parser
+ */
+typedef enum ZW111_PARSE_RESULT {
+  ZW111_PARSE_NEED_MORE = 0,     /* Frame chua xong, feed tiep */
+  ZW111_PARSE_FRAME,             /* Vua nhan du 1 frame hop le (doc tai parser->frame) */
+  ZW111_PARSE_ERROR              /* Frame loi (PID/Length/Checksum) - parser da tu resync */
+} zw111_parse_result_t;
+
+/**
+ * @brief Context cua parser (byte-driven), checksum duoc cong don theo tung byte
+ */
+typedef struct ZW111_LL_PARSER {
+  zw111_ll_parser_state_t state;
+  uint16_t idx;                  /* Vi tri byte trong field hien tai */
+  uint16_t len_field;            /* Gia tri Packet Length (gom ca 2 bytes Checksum) */
+  uint16_t sum;                  /* Checksum cong don tu PID -> byte Payload cuoi */
+  uint16_t sum_rx;               /* Checksum doc duoc o cuoi frame */
+  zw111_ll_frame_t frame;
+  uint32_t resync_bytes;         /* So byte rac bi bo qua khi tim Header */
+  uint32_t bad_checksum;         /* So frame sai Checksum */
+  uint32_t bad_length;           /* So frame co PID/Packet Length khong hop le */
+} zw111_ll_parser_t;
+
+typedef struct ZW111_LL_TXN zw111_ll_txn_t;
+
+/**
+ * @brief Instance (device handle) cua 1 cam bien ZW111
+ *
+ * @details
+ * Gom toan bo trang thai truoc day nam trong bien static cua tung file (Port, LowLevel, API cap cao)
+ * de 1 firmware co the dieu khien nhieu cam bien cung luc (vi du dau doc vao/ra cua cong xoay)
+ * Moi API cua LowLevel/API cap cao deu nhan con tro nay lam tham so dau tien
+ *
+ * @note Bo nho do USER cap phat (static/global), khoi tao bang `zw111_uart_init()`
+ * Khong copy struct nay sau khi init (Port EFR32 luu con tro de tra callback ve dung instance)
+ */
+typedef struct ZW111_DEV {
+  zw111_port_t port;                        /* Trang thai UART cua Port (handle/fd, RX always-on) */
+  uint32_t chip_addr;                       /* Dia chi chip dang dung (mac dinh ZW111_DEFAULT_ADDRESS) */
+  uint32_t baud;                            /* Baudrate UART (tinh thoi gian TX cua 1 Packet) */
+  uint32_t rx_timeout_ms;                   /* Timeout RX cua lenh vua gui qua `zw111_ll_send_command_packet()` */
+  uint16_t pkt_bytes;                       /* So byte Data toi da cua 1 Data Packet (0 = chua biet, chua doc sysinfo) */
+
+#if ZW111_ADAPTIVE_TIMEOUT
+  zw111_ll_lat_est_t lat[ZW111_CMD_SLOTS]; /* Latency hoc duoc theo tung lenh */
+#endif // ZW111_ADAPTIVE_TIMEOUT
+
+#if ZW111_LL_STATS
+  zw111_stats_t *stats;                     /* Histogram latency (USER cap phat, NULL = khong do) */
+  zw111_stats_stamp_t stamp;                /* Moc thoi gian cua lenh dang chay */
+#endif // ZW111_LL_STATS
+
+  /* Parser tach frame tu dong byte RX (always-on) */
+  zw111_ll_parser_t parser;
+
+  /* Buffer trung gian doc tu ring cua Port, giu lai byte con du sau 1 frame cho lan goi sau */
+  uint8_t rx_stage[ZW111_RX_STAGE_SIZE];
+  uint16_t rx_stage_pos;
+  uint16_t rx_stage_len;
+
+  /* Hang doi transaction async (FIFO, danh sach lien ket qua `next`) */
+  zw111_ll_txn_t *txn_head;
+  zw111_ll_txn_t *txn_tail;
+
+  /* Double buffer Data Packet gui xuong (DownChar): build Packet N+1 trong luc DMA gui Packet N
+   * (hang doi chi chay 1 transaction tai 1 thoi diem nen 1 cap buffer cho ca instance) */
+  uint8_t dl_frame[2][ZW111_DATA_FRAME_MAX];
+  uint16_t dl_len[2];                       /* So byte cua Packet trong slot (0 = slot trong) */
+  uint8_t dl_cur;                           /* Slot DMA dang gui */
+  bool dl_end_built;                        /* Da build End Packet (khong pull source nua) */
+
+  /* Trang thai cua API cap cao: PageID cua lan Enroll dang chay */
+  uint16_t enroll_page_id;
+
+  /* Bitmap chiem dung Template Database (nap bang `zw111_sync_index()`, tu cap nhat theo Store/Delete/Empty) */
+  zw111_index_t index;
+} zw111_dev_t;
 
 // =============== PROTOTYPE FUNCTION ===============
 
+/**
+ * @brief Dua trang thai LowLevel cua instance ve mac dinh (parser, hang doi, dia chi chip)
+ * @note Khong dung den phan Port (do `zw111_port_uart_init()` tu khoi tao)
+ * @param dev Instance cam bien
+ */
+void zw111_ll_dev_init(zw111_dev_t *dev);
+
+#if ZW111_LL_STATS
+/**
+ * @brief Gan bo nho thong ke latency cho instance (xoa ve 0), NULL = ngung do
+ * @note Doc ket qua bang `zw111_stats_get()`/`zw111_stats_percentile()` tren chinh con tro nay
+ */
+void zw111_ll_stats_attach(zw111_dev_t *dev, zw111_stats_t *stats);
+#else
+__attribute__((unused)) static inline void zw111_ll_stats_attach(zw111_dev_t *dev, zw111_stats_t *stats){ (void)dev; (void)stats; }
+#endif // ZW111_LL_STATS
+
+/**
+ * @brief Descriptor cua lenh (bo cuc Params/Return Params, Data Packet, profile timeout) sinh tu ZW111_CMD_TABLE
+ * @return NULL neu lenh khong co trong bang
+ */
+const zw111_cmd_desc_t *zw111_ll_cmd_desc(zw111_cmd_t cmd);
+
+/**
+ * @brief Profile latency co dinh cua lenh
+ * @return NULL neu lenh khong co trong bang (dung ZW111_RX_TIMEOUT_MS)
+ */
+const zw111_cmd_profile_t *zw111_ll_cmd_profile(zw111_cmd_t cmd);
+
+/**
+ * @brief Timeout cho ACK cua 1 lenh cu the
+ *
+ * @details
+ * - Lenh co phan theo PageID (SEARCH/DELETE/EMPTY): timeout_ms + per_page_us * so PageID (doc tu params)
+ * - Lenh con lai: timeout hoc duoc (neu da du ZW111_ADAPT_MIN_SAMPLES mau), khong vuot timeout_ms cua bang
+ * - Lenh khong co trong bang: ZW111_RX_TIMEOUT_MS
+ *
+ * @param params Tham so cua Command (giong luc gui)
+ * @return Timeout (ms)
+ */
+uint32_t zw111_ll_cmd_timeout(const zw111_dev_t *dev, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len);
+
+/**
+ * @brief Ghi nhan latency do duoc (TX xong -> ACK) de hoc timeout cua lenh
+ * @note Goi tu dong boi hang doi transaction, khong can goi tu App
+ */
+void zw111_ll_cmd_latency_sample(zw111_dev_t *dev, zw111_cmd_t cmd, uint32_t latency_ms);
+
 /**
  * @brief API de gui goi lenh (Command packet) den device
  *
  * @remark Packet Format:
  *   [Header][Address][PID][Length][Instruction][Params...][Checksum]
  *
+ * @param dev Instance cam bien
  * @param cmd Command (Instruction ID) can gui den device
  * @param params Con tro den buffer Paramter (1...n) (co the NULL)
  * @param param_len Chieu dai cua buffer Paramter (0 neu khong co tham so)
@@ -72,7 +266,7 @@ extern "C" {
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_ll_send_command_packet(zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len);
+zw111_status_t zw111_ll_send_command_packet(zw111_dev_t *dev, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len);
 
 /**
  * @brief API nhan va parse ACK packet tu device cam bien (ver1)
@@ -83,6 +277,7 @@ zw111_status_t zw111_ll_send_command_packet(zw111_cmd_t cmd, const uint8_t *para
  * @note Ham nay se phan tach ACK packet thanh `Confirm code` va `Optional Return Code`
  * Sau moi lan gui Data Packet hay Command Packet, phai can ACK packet phan hoi lai
  *
+ * @param dev Instance cam bien
  * @param ack Con tro luu Confirm Code cua ACK Packet
  * @param ret_params Buffer luu tham so tra ve (Return parameters) (Can truyen buffer vao de gia tri co the tra ve)
  * @param ret_param_len Con tro luu chieu dai cua tham so tra ve (Return Parameters)
@@ -99,7 +294,7 @@ zw111_status_t zw111_ll_send_command_packet(zw111_cmd_t cmd, const uint8_t *para
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-__attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len);
+__attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_dev_t *dev, zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len);
 
 /**
  * @brief API nhan va parse ACK packet tu device cam bien (ver2)
@@ -107,6 +302,7 @@ __attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_ac
  * @note Do han che cua ver1 la co 1 khoang gap giua 2 lan transaction nen
  * gay ra lech frame khien cho payload khong nhan du -> TImeout
  *
+ * @param dev Instance cam bien
  * @param ack Con tro luu Confirm Code cua ACK Packet
  * @param ret_params Buffer luu tham so tra ve (Return parameters) (Can truyen buffer vao de gia tri co the tra ve)
  * @param ret_param_len Con tro luu chieu dai cua tham so tra ve (Return Parameters)
@@ -115,7 +311,53 @@ __attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_ac
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len);
+__attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_dev_t *dev, zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len);
+
+/**
+ * @brief API nhan va parse ACK packet tu device cam bien (ver3)
+ *
+ * @details
+ * RX luon bat (always-on ring buffer cua Port) + parser byte-driven nen:
+ *  - Khong con arm/abort 1 transaction RX cho moi lenh
+ *  - Khong mat byte den giua 2 lenh
+ *  - Byte rac/frame loi bi bo qua va parser tu resync o Header 0xEF01 tiep theo
+ * Data/End Packet den trong luc cho ACK se bi bo qua
+ *
+ * @param dev Instance cam bien
+ * @param ack Con tro luu Confirm Code cua ACK Packet
+ * @param ret_params Buffer luu tham so tra ve (Return parameters) (co the NULL), toi thieu ZW111_TXN_MAX_RET bytes
+ * @param ret_param_len Con tro luu chieu dai cua tham so tra ve (Return Parameters) (co the NULL),
+ * cat o ZW111_TXN_MAX_RET (giong transaction async), API cap cao tu kiem tra do dai theo lenh
+ *
+ * @return zw111_status_t
+ *  - ZW111_STATUS_OK on success
+ *  - ZW111_STATUS_TIMEOUT neu khong co ACK hop le trong timeout cua lenh vua gui (`dev->rx_timeout_ms`)
+ */
+zw111_status_t zw111_ll_receive_ack_packet_ver3(zw111_dev_t *dev, zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len);
+
+/**
+ * @brief Nhan frame hop le tiep theo (bat ky PID nao) tu dong byte RX
+ *
+ * @param dev Instance cam bien
+ * @param[out] frame Con tro nhan dia chi frame (thuoc ve parser cua instance, hop le den lan goi tiep theo)
+ * @param timeout_ms Thoi gian cho toi da (ms)
+ *
+ * @return zw111_status_t
+ *  - ZW111_STATUS_OK khi co frame
+ *  - ZW111_STATUS_TIMEOUT khi het thoi gian
+ */
+zw111_status_t zw111_ll_receive_frame(zw111_dev_t *dev, const zw111_ll_frame_t **frame, uint32_t timeout_ms);
+
+/**
+ * @brief Dua parser ve trang thai cho Header (giu nguyen cac bien dem loi)
+ */
+void zw111_ll_parser_reset(zw111_ll_parser_t *p);
+
+/**
+ * @brief Feed 1 byte vao parser
+ * @return zw111_parse_result_t (FRAME -> frame hop le nam o `p->frame`)
+ */
+zw111_parse_result_t zw111_ll_parser_feed(zw111_ll_parser_t *p, uint8_t byte);
 
 /**
  * @brief API gui Data packet den device cam bien
@@ -123,6 +365,7 @@ zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_p
  * @remark Packet Format:
  *   [Header][Address][PID][Length][Data][Checksum]
  *
+ * @param dev Instance cam bien
  * @param data Buffer tro den data can gui
  * @param data_len Chieu dai buffer data can gui
  * @param is_last De la 1 neu la Data Packet cuoi cung
@@ -131,13 +374,15 @@ zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_p
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-zw111_status_t zw111_ll_send_data_packet(const uint8_t *data, uint16_t data_len, uint8_t is_last);
+zw111_status_t zw111_ll_send_data_packet(zw111_dev_t *dev, const uint8_t *data, uint16_t data_len, uint8_t is_last);
 
 /**
  * @brief API de nhan va parse Data packet tu device cam bien
  *
- * @note Dung khi can download image hay feature data
+ * @note Dung khi can download image hay feature data (chi 1 Packet, block)
+ * Ca chuoi DATA...END khong block: transaction + sink (`zw111_ll_txn_set_sink()`)
  *
+ * @param dev Instance cam bien
  * @param buf Buffer luu data nhan duoc (Can truyen Buffer vao de gia tri co the tra ve)
  * @param buf_len Chieu dai cho buffer luu nhan duoc
  * @param recv_len Con tro tro den chieu dai data nhan duoc
@@ -146,7 +391,7 @@ zw111_status_t zw111_ll_send_data_packet(const uint8_t *data, uint16_t data_len,
  *  - ZW111_STATUS_OK on success
  *  - ZW111_STATUS_ERROR on failure
  */
-__attribute__((unused)) zw111_status_t zw111_ll_receive_data_packet(uint8_t *buf, uint16_t buf_len, uint16_t *recv_len);
+__attribute__((unused)) zw111_status_t zw111_ll_receive_data_packet(zw111_dev_t *dev, uint8_t *buf, uint16_t buf_len, uint16_t *recv_len);
 
 /**
  * @brief API de tinh checksum cua moi Packet
@@ -177,6 +422,7 @@ uint16_t zw111_ll_calc_checksum(const uint8_t *buf, uint16_t len);
  *  - ACK hop le, tra ve OK
  *  - Het thoi gian timeout -> tra ve TIMEOUT
  *
+ * @param dev Instance cam bien
  * @param[out] ack Con tro luu Payload cua ACK Packet nhan duoc
  * @param[in] timeout Thoi gian cho toi da (ms)
  * @return zw111_status_t
@@ -186,7 +432,7 @@ uint16_t zw111_ll_calc_checksum(const uint8_t *buf, uint16_t len);
  * @note Ham nay chi cho ACK, khong gui them bat ky Packet nao
  * Viec gui Command/Data phai duoc thuc hien truoc do
  */
-zw111_status_t zw111_ll_wait_ack(zw111_ack_t *ack, uint32_t timeout);
+zw111_status_t zw111_ll_wait_ack(zw111_dev_t *dev, zw111_ack_t *ack, uint32_t timeout);
 
 /**
  * @brief Gui Command Packet va cho ACK phan hoi tu module cam bien
@@ -202,6 +448,7 @@ zw111_status_t zw111_ll_wait_ack(zw111_ack_t *ack, uint32_t timeout);
  * zw111_ll_cmd_with_ack(ZW111_CMD_GET_IMAGE, NULL, 0, &ack);
  * @endcode
  *
+ * @param dev Instance cam bien
  * @param cmd Command/Instruction ID) can gui toi ZW111
  * @param params Con tro den buffer chua cac tham so Command (NULL neu khong co tham so)
  * @param param_len Do dai (byte) cua buffer tham so (0 neu khong co tham so)
@@ -215,7 +462,7 @@ zw111_status_t zw111_ll_wait_ack(zw111_ack_t *ack, uint32_t timeout);
  * Voi cac lenh yeu cau upload/download du lieu (image, feature)
  * Can su dung them cac API gui/nhan Data Packet
  */
-zw111_status_t zw111_ll_cmd_with_ack(zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len, zw111_ack_t *ack);
+zw111_status_t zw111_ll_cmd_with_ack(zw111_dev_t *dev, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len, zw111_ack_t *ack);
 
 /**
  * @brief Xoa (Flush) toan bo du lieu con ton dong trong UART RX Buffer
@@ -235,16 +482,23 @@ zw111_status_t zw111_ll_cmd_with_ack(zw111_cmd_t cmd, const uint8_t *params, uin
  *
  * @note Ham nay chi thao tac tren UART RX buffer tu phia MCU
  */
-zw111_status_t zw111_ll_flush_uart(void);
+zw111_status_t zw111_ll_flush_uart(zw111_dev_t *dev);
 
 /**
  * @brief API cho phep set dia chi moi cho chip cam bien
- * bang cach gan gia tri truyen vao cho bien toan cuc cua file
- * Bien toan cuc ay chi duoc dung noi bo trong file `zw111_lowlevel.c`
+ * bang cach gan gia tri truyen vao cho instance (`dev->chip_addr`)
+ * Cac Packet dong goi sau do cua instance se dung dia chi nay
  *
+ * @param dev Instance cam bien
  * @param addr Dia chi (32-bit) dau vao
  */
-void zw111_ll_set_chip_address(uint32_t addr);
+void zw111_ll_set_chip_address(zw111_dev_t *dev, uint32_t addr);
+
+/**
+ * @brief Gan kich thuoc Data Packet ma cam bien dang dung (doc tu `zw111_sysinfo_t.packet_size` hoac sau `zw111_set_packet_size()`)
+ * @note Data Packet nhan ve dai hon kich thuoc nay bi coi la loi giao thuc
+ */
+void zw111_ll_set_packet_size(zw111_dev_t *dev, zw111_packet_size_t size);
 
 /**
  * @brief Ham wrapper cho API get ticks da co san cua Port
@@ -254,6 +508,174 @@ void zw111_ll_set_chip_address(uint32_t addr);
  */
 uint32_t zw111_ll_get_ticks(void);
 
+/* ------------- ASYNC TRANSACTION (COMMAND -> ACK) ------------- */
+
+/**
+ * @brief Trang thai cua 1 transaction async
+ */
+typedef enum ZW111_TXN_STATE {
+  ZW111_TXN_IDLE = 0,   /* Chua submit hoac da lay ket qua */
+  ZW111_TXN_QUEUED,     /* Dang xep hang cho TX */
+  ZW111_TXN_TX,         /* Dang gui Command Packet */
+  ZW111_TXN_WAIT_ACK,   /* Da gui xong, dang cho ACK Packet */
+  ZW111_TXN_DATA_RX,    /* ACK OK, dang nhan chuoi Data Packet ... End Packet (lenh co ZW111_XFER_UP) */
+  ZW111_TXN_DATA_TX,    /* ACK OK, dang gui chuoi Data Packet ... End Packet (lenh co ZW111_XFER_DOWN) */
+  ZW111_TXN_DONE        /* Da xong (xem `status`) */
+} zw111_txn_state_t;
+
+/**
+ * @brief Callback khi transaction ket thuc (goi trong `zw111_ll_txn_process()`, khong phai ISR)
+ */
+typedef void (*zw111_ll_txn_cb_t)(zw111_ll_txn_t *txn);
+
+/**
+ * @brief Nhan 1 Data Packet da verify Checksum (goi trong `zw111_ll_txn_process()`)
+ *
+ * @param ctx Con tro USER gan bang `zw111_ll_txn_set_sink()`
+ * @param data Data cua Packet (tro thang vao parser, chi hop le trong callback)
+ * @param len So byte Data
+ * @param last true voi End Packet
+ * @return false -> huy (LowLevel van doc het chuoi den End Packet de link khong lech, txn ket thuc voi ZW111_STATUS_ERROR)
+ */
+typedef bool (*zw111_ll_data_sink_t)(void *ctx, const uint8_t *data, uint16_t len, bool last);
+
+/**
+ * @brief Nguon du lieu dang pull cho Data Packet gui xuong (goi trong `zw111_ll_txn_process()`)
+ *
+ * @param ctx Con tro USER gan bang `zw111_ll_txn_set_source()`
+ * @param buf Ghi Data thang vao day (vi tri Data cua Packet trong double buffer, khong copy lai)
+ * @param max So byte cua 1 Packet day (packet size cua cam bien)
+ * @param[out] last Dat true neu day la khuc cuoi (-> End Packet)
+ * @return So byte da ghi: phai bang `max` tru khuc cuoi. Khuc chua cuoi ngan hon `max` -> huy (ZW111_STATUS_ERROR)
+ */
+typedef uint16_t (*zw111_ll_data_source_t)(void *ctx, uint8_t *buf, uint16_t max, bool *last);
+
+/**
+ * @brief 1 transaction Command -> ACK khong block
+ *
+ * @note Bo nho do USER cap phat (static/stack) va phai ton tai cho den khi DONE
+ * Queue la danh sach lien ket qua con tro `next` nen khong can heap
+ */
+struct ZW111_LL_TXN {
+  /* Input */
+  zw111_cmd_t cmd;
+  uint8_t params[ZW111_TXN_MAX_PARAMS];
+  uint8_t param_len;
+  uint32_t timeout_ms;                     /* Thoi gian cho ACK (0 = tinh tu bang profile luc submit) */
+  zw111_ll_txn_cb_t cb;                    /* Co the NULL (chi poll `state`) */
+  void *user;                              /* Con tro tuy y cua USER */
+
+  /* Output */
+  volatile zw111_txn_state_t state;
+  zw111_status_t status;                   /* Trang thai giao thuc (OK/TIMEOUT/ERROR) - chua map ACK */
+  zw111_ack_t ack;                         /* Confirm Code */
+  uint8_t ret_params[ZW111_TXN_MAX_RET];
+  uint16_t ret_len;
+
+  /* Data Packet sau ACK (lenh co ZW111_XFER_UP/ZW111_XFER_DOWN) */
+  zw111_ll_data_sink_t sink;               /* UP: NULL -> doc bo Data Packet */
+  void *sink_ctx;
+  zw111_ll_data_source_t source;           /* DOWN: bat buoc */
+  void *source_ctx;
+  bool xfer_stream_ack;                    /* DOWN: cam bien tra 0xF1 -> ACK 0xF0 moi Packet, ACK cuoi sau End Packet */
+  uint32_t xfer_bytes;                     /* Tong byte Data da nhan */
+  uint16_t xfer_packets;                   /* So Data/End Packet da nhan */
+  uint32_t xfer_start_tick;                /* Thoi diem nhan ACK */
+  uint32_t xfer_end_tick;                  /* Thoi diem nhan End Packet */
+  bool xfer_abort;                         /* Sink da huy, chi doc bo den End Packet */
+  bool xfer_final_ack;                     /* DOWN stream: ACK cuoi da den truoc khi End Packet gui xong */
+  bool xfer_need_cancel;                   /* DOWN dung giua chung (source/UART loi) sau khi cam bien da nhan lenh -> cam bien van cho Data Packet */
+
+  /* Noi bo */
+  zw111_dev_t *dev;                        /* Instance ma transaction duoc submit vao */
+  uint8_t tx_frame[ZW111_HDR_LEN + ZW111_INSTRUCTION_BYTES + ZW111_TXN_MAX_PARAMS + ZW111_CHECKSUM_SIZE_BYTES];
+  uint16_t tx_len;
+  uint32_t start_tick;
+  zw111_ll_txn_t *next;
+};
+
+/**
+ * @brief Khoi tao 1 transaction truoc khi submit
+ *
+ * @param txn Transaction (USER cap phat)
+ * @param cmd Command can gui
+ * @param params Tham so (co the NULL, hoac chinh `txn->params` da duoc encoder ghi san -> khong copy)
+ * @param param_len So byte tham so (<= ZW111_TXN_MAX_PARAMS)
+ * @param cb Callback khi xong (co the NULL)
+ * @param user Con tro tuy y truyen lai trong callback
+ *
+ * @return ZW111_STATUS_ERROR neu tham so khong hop le
+ */
+zw111_status_t zw111_ll_txn_init(zw111_ll_txn_t *txn, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len,
+                                 zw111_ll_txn_cb_t cb, void *user);
+
+/**
+ * @brief Gan noi nhan Data Packet cho transaction (goi sau `zw111_ll_txn_init()`, truoc khi submit)
+ * @note Chi co tac dung voi lenh co Data Packet gui len (ZW111_XFER_UP trong ZW111_CMD_TABLE)
+ */
+void zw111_ll_txn_set_sink(zw111_ll_txn_t *txn, zw111_ll_data_sink_t sink, void *ctx);
+
+/**
+ * @brief Gan nguon du lieu cho transaction gui Data Packet xuong (ZW111_XFER_DOWN trong ZW111_CMD_TABLE)
+ * @note Kich thuoc moi Packet = `dev->pkt_bytes` (128 neu chua doc sysinfo - mac dinh cua module)
+ */
+void zw111_ll_txn_set_source(zw111_ll_txn_t *txn, zw111_ll_data_source_t source, void *ctx);
+
+/**
+ * @brief Dua transaction vao hang doi (FIFO) cua instance, tra ve ngay
+ * @note Moi instance co hang doi rieng, 2 cam bien khac nhau chay song song duoc
+ * @return ZW111_STATUS_ERROR neu transaction dang nam trong hang doi
+ */
+zw111_status_t zw111_ll_txn_submit(zw111_dev_t *dev, zw111_ll_txn_t *txn);
+
+/**
+ * @brief Dua transaction vao ngay sau transaction dang chay (dau hang doi)
+ * @note Dung khi noi tiep cac buoc cua 1 thao tac nhieu lenh (GetImage -> GenChar -> RegModel)
+ * de lenh cua thao tac khac khong chen vao giua lam hong CharBuffer
+ */
+zw111_status_t zw111_ll_txn_submit_next(zw111_dev_t *dev, zw111_ll_txn_t *txn);
+
+/**
+ * @brief Bom (pump) hang doi transaction: kick TX, doc byte RX co san, xu ly timeout
+ *
+ * @details
+ * Ham khong bao gio block, chi lam phan viec co the lam ngay roi tra ve
+ * Goi tu main loop/event cua Zigbee stack (hoac `zw111_ll_txn_wait()` cho API blocking)
+ * Callback cua transaction duoc goi tu ben trong ham nay. Transaction xong ma lenh ke tiep
+ * (vi du buoc noi cua thao tac nhieu lenh submit trong callback) dang cho thi kick TX ngay trong cung lan goi
+ *
+ * @return true neu con transaction dang cho xu ly
+ */
+bool zw111_ll_txn_process(zw111_dev_t *dev);
+
+/**
+ * @brief Chay `zw111_ll_txn_process()` cua instance da submit `txn` cho den khi DONE (dung cho API blocking)
+ * @warning Khong goi tu ben trong callback cua transaction
+ * @return txn->status
+ */
+zw111_status_t zw111_ll_txn_wait(zw111_ll_txn_t *txn);
+
+/**
+ * @brief Kiem tra hang doi con transaction hay khong
+ */
+bool zw111_ll_txn_busy(const zw111_dev_t *dev);
+
+/**
+ * @brief Huy moi transaction trong hang doi va dua cam bien ve idle bang lenh CANCEL (blocking, co gioi han thoi gian)
+ *
+ * @details
+ *  1. Packet dang nam tren DMA TX duoc gui not (cat giua frame thi cam bien doc CANCEL thanh rac)
+ *  2. Tach ca hang doi ra, gui CANCEL nhu 1 transaction thuong (latency vao slot CANCEL cua histogram)
+ *  3. Lenh bi huy da gui ma chua co ACK -> ACK dau tien co the la ACK tre cua no: cho them 1 ACK
+ *     toi da ZW111_CANCEL_DRAIN_MS roi bo het (ACK den muon hon bi bo truoc lenh ke tiep)
+ *  4. Xoa parser + RX cua Port, cac transaction bi tach ket thuc voi ZW111_STATUS_CANCELLED
+ *     (callback co the submit viec moi, chay sau CANCEL)
+ *
+ * @return Ket qua cua lenh CANCEL (ZW111_STATUS_TIMEOUT neu cam bien khong tra loi trong timeout cua CANCEL)
+ * @warning Khong goi tu ISR hay tu ben trong callback cua transaction
+ */
+zw111_status_t zw111_ll_cancel(zw111_dev_t *dev);
+
 /* --------------- HELPER FUNCTION --------------- */
 
 /**
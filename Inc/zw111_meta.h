@@ -0,0 +1,182 @@
+/*
+ * @file zw111_meta.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Metadata cua driver luu trong NotePad cua cam bien (16 trang x 32 bytes FLASH) de khoi dong nhanh (warm start)
+ * - Trang 0      : header (magic, version, so trang, seq, CRC-32) + capacity, so template, occupancy digest,
+ *                  he so baudrate + packet size da dam phan, con tro cap phat PageID (allocator)
+ * - Trang 1..n   : bitmap chiem dung, 1 trang NotePad = 1 trang Index Table (256 PageID)
+ * - Trang sau do : bo dem so lan nhan dang (hit) cua cac PageID hay dung nhat (8 dong / trang)
+ * => Khi khoi dong chi doc record nay (+ ValidTempleteNum de kiem tra), khong ReadSysPara/ReadIndexTable/dam phan lai
+ *
+ * @note
+ * Ham o day chi thao tac RAM (encode/decode, dem hit, lich ghi). Doc/ghi cam bien: `zw111_meta_load()`/`zw111_meta_flush()` (zw111.h)
+ * Ghi gop: moi thay doi chi danh dau dirty, `zw111_meta_flush()` chi gui WriteNotePad cho trang khac voi ban da ghi
+ * (ban sao `shadow`), trang du lieu truoc, header sau cung => mat nguon giua chung -> CRC sai -> khoi dong lanh, khong dung record hong
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_META_H_
+#define ZW111_LIB_INC_ZW111_META_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "zw111_types.h"
+#include "zw111_index.h"
+#include "zw111_crc.h"
+
+#define ZW111_META_MAGIC            "ZWMD"
+#define ZW111_META_VERSION          1u
+#define ZW111_META_PAGES            16u    /* So trang NotePad */
+#define ZW111_META_PAGE_SIZE        32u    /* 1 lan PS_WriteNotePad/PS_ReadNotePad */
+#define ZW111_META_HOT_PER_PAGE     (ZW111_META_PAGE_SIZE / 4u)
+
+/* So PageID duoc dem hit (space-saving: day thi thay dong it hit nhat) */
+#ifndef ZW111_META_HOT_MAX
+#define ZW111_META_HOT_MAX          32u
+#endif // ZW111_META_HOT_MAX
+
+#if (1u + ZW111_INDEX_PAGES + (ZW111_META_HOT_MAX + ZW111_META_HOT_PER_PAGE - 1u) / ZW111_META_HOT_PER_PAGE) > ZW111_META_PAGES
+#error "ZW111_META_HOT_MAX qua lon: header + bitmap + bang hit vuot 16 trang NotePad"
+#endif
+
+/* Thay doi trang thai (bitmap, baud, packet size, allocator) -> ghi sau ZW111_META_FLUSH_DELAY_MS (gop enroll lien tiep) */
+#ifndef ZW111_META_FLUSH_DELAY_MS
+#define ZW111_META_FLUSH_DELAY_MS   10000u
+#endif // ZW111_META_FLUSH_DELAY_MS
+
+/* Chi doi bo dem hit -> ghi toi da 1 lan / ZW111_META_HITS_FLUSH_MS */
+#ifndef ZW111_META_HITS_FLUSH_MS
+#define ZW111_META_HITS_FLUSH_MS    3600000u
+#endif // ZW111_META_HITS_FLUSH_MS
+
+#define ZW111_META_NEVER            0xFFFFFFFFu
+
+/* Co dirty */
+#define ZW111_META_DIRTY_STATE      0x01u
+#define ZW111_META_DIRTY_HITS       0x02u
+
+/* 1 dong bo dem hit */
+typedef struct ZW111_META_HOT {
+  uint16_t page_id;
+  uint16_t hits;                    /* Bao hoa o 0xFFFF */
+} zw111_meta_hot_t;
+
+/* Thong ke ghi (do do mon FLASH) */
+typedef struct ZW111_META_STATS {
+  uint32_t flushes;                 /* Lan flush co ghi it nhat 1 trang */
+  uint32_t pages_written;           /* So lenh PS_WriteNotePad da gui */
+  uint32_t pages_skipped;           /* Trang khong doi so voi ban da ghi -> khong gui */
+  uint32_t changes;                 /* So lan touch/hit (duoc gop vao cac lan flush) */
+} zw111_meta_stats_t;
+
+/* Record metadata (USER cap phat, memset 0 hoac `zw111_meta_init()`) */
+typedef struct ZW111_META {
+  /* Noi dung record (bitmap lay tu `zw111_index_t` luc ghi) */
+  uint16_t seq;                     /* Tang moi lan ghi header */
+  uint16_t capacity;
+  uint16_t template_count;
+  uint32_t occupancy_digest;        /* `zw111_meta_occupancy_digest()` luc ghi/doc */
+  uint8_t baud_mult;                /* 9600 * N dang dung */
+  uint8_t packet_size;              /* zw111_packet_size_t dang dung */
+  uint16_t alloc_next;              /* PageID bat dau tim slot trong cho lan Enroll sau (next-fit) */
+  uint8_t hot_count;
+  zw111_meta_hot_t hot[ZW111_META_HOT_MAX];
+
+  /* Ghi gop */
+  uint8_t shadow[ZW111_META_PAGES][ZW111_META_PAGE_SIZE]; /* Noi dung NotePad da doc/ghi lan cuoi */
+  uint16_t shadow_valid;            /* Bit n = 1 -> shadow[n] khop voi cam bien */
+  uint8_t dirty;                    /* ZW111_META_DIRTY_* */
+  uint32_t state_tick;              /* Thay doi trang thai dau tien chua ghi */
+  uint32_t hits_tick;               /* Thay doi hit dau tien chua ghi */
+  zw111_meta_stats_t stats;
+} zw111_meta_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Xoa record (chua co ban sao NotePad, chua dirty)
+ */
+void zw111_meta_init(zw111_meta_t *m);
+
+/**
+ * @brief Digest bitmap chiem dung: CRC-32 cac tu 32-bit (little-endian) phu `capacity`
+ * @note 2 cam bien/2 lan khoi dong co cung digest + so template -> cung bo cuc database
+ */
+uint32_t zw111_meta_occupancy_digest(const zw111_index_t *idx);
+
+/**
+ * @brief Danh dau trang thai da doi (Store/Delete, baud, packet size, `alloc_next`), ghi sau ZW111_META_FLUSH_DELAY_MS
+ */
+void zw111_meta_touch(zw111_meta_t *m, uint32_t now);
+
+/**
+ * @brief `zw111_meta_flush()` loi -> thu lai sau ZW111_META_FLUSH_DELAY_MS (khong goi lai lien tuc khi cam bien khong tra loi)
+ */
+void zw111_meta_defer(zw111_meta_t *m, uint32_t now);
+
+/**
+ * @brief Dem 1 lan nhan dang trung PageID
+ */
+void zw111_meta_hit(zw111_meta_t *m, uint16_t page_id, uint32_t now);
+
+/**
+ * @brief So hit cua PageID (0 neu khong nam trong bang)
+ */
+uint16_t zw111_meta_hits(const zw111_meta_t *m, uint16_t page_id);
+
+/**
+ * @brief Thoi gian (ms) den lan `zw111_meta_flush()` can ghi
+ * @return 0 neu den han, ZW111_META_NEVER neu khong co gi de ghi
+ */
+uint32_t zw111_meta_next_flush_ms(const zw111_meta_t *m, uint32_t now);
+
+/**
+ * @brief So trang NotePad ma record dung voi bitmap `idx` va bang hit hien tai
+ */
+uint8_t zw111_meta_page_count(const zw111_meta_t *m, const zw111_index_t *idx);
+
+/**
+ * @brief Encode trang du lieu `page_no` (>= 1): bitmap hoac bang hit
+ */
+void zw111_meta_encode_page(const zw111_meta_t *m, const zw111_index_t *idx, uint8_t page_no, uint8_t out[ZW111_META_PAGE_SIZE]);
+
+/**
+ * @brief Encode header (trang 0)
+ * @param crc CRC-32 cua cac trang du lieu (chua gom header, ham tu cong phan header)
+ */
+void zw111_meta_encode_header(const zw111_meta_t *m, uint8_t page_count, uint32_t crc, uint8_t out[ZW111_META_PAGE_SIZE]);
+
+/**
+ * @brief Decode header: magic/version/so trang hop le -> ghi cac truong vao `m`
+ * @param[out] crc CRC-32 luu trong header
+ */
+bool zw111_meta_decode_header(zw111_meta_t *m, const uint8_t in[ZW111_META_PAGE_SIZE], uint8_t *page_count, uint32_t *crc);
+
+/**
+ * @brief Decode trang du lieu `page_no` vao bitmap `idx` (da `zw111_index_reset(idx, m->capacity)`) hoac bang hit
+ */
+void zw111_meta_decode_page(zw111_meta_t *m, zw111_index_t *idx, uint8_t page_no, const uint8_t in[ZW111_META_PAGE_SIZE]);
+
+/**
+ * @brief CRC-32 cua record = CRC cac trang du lieu tiep tuc qua phan header sau truong CRC
+ */
+uint32_t zw111_meta_header_crc(uint32_t crc, const uint8_t header[ZW111_META_PAGE_SIZE]);
+
+/**
+ * @brief Bo cac dong hit cua PageID khong con template (truoc khi ghi)
+ */
+void zw111_meta_prune_hot(zw111_meta_t *m, const zw111_index_t *idx);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_META_H_ */
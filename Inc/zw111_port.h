@@ -31,6 +31,7 @@ extern "C" {
 #include "stdbool.h"
 #include "stdarg.h"
 #include "zw111_types.h"
+#include "zw111_ringbuf.h"
 
 /* Prefix giup de doc function noi bo cua Platform */
 #if defined(EFR32_PLATFORM)
@@ -38,6 +39,8 @@ extern "C" {
 #include "sl_udelay.h"
 #include "sl_sleeptimer.h"
 #include "ecode.h"
+#include "em_core.h"
+#include "em_usart.h"
 #include "../../autogen/sl_uartdrv_instances.h"
 #include "../../config/sl_uartdrv_usart_USART_UART2_config.h"
 #define EFR32_PLATFORM_TAG
@@ -48,6 +51,9 @@ extern "C" {
 #elif defined(ESP32_PLATFORM)
 #define STM32_PLATFORM_TAG
 
+#elif defined(LINUX_PLATFORM)
+#define LINUX_PLATFORM_TAG
+
 #else
 #endif // PLATFORM_CONFIG
 
@@ -87,6 +93,67 @@ typedef enum ZW111_PORT_UART_STATE {
   UART_ABORT_OK
 } zw111_port_uart_state_t;
 
+#if defined(EFR32_PLATFORM)
+
+#ifndef ZW111_PORT_RX_RING_SIZE
+#define ZW111_PORT_RX_RING_SIZE   1024u /* Luy thua cua 2, du cho >= 3 frame 256 bytes */
+#endif // ZW111_PORT_RX_RING_SIZE
+
+#ifndef ZW111_PORT_RX_CHUNK_SIZE
+#define ZW111_PORT_RX_CHUNK_SIZE  32u
+#endif // ZW111_PORT_RX_CHUNK_SIZE
+
+#endif // EFR32_PLATFORM
+
+/**
+ * @brief Trang thai cua 1 instance UART (1 cam bien) tai Port
+ *
+ * @details
+ * Thay cho cac bien static cua tung file Port de 1 firmware co the dieu khien nhieu cam bien
+ * (vi du 2 dau doc/lan cua cong xoay). Moi `zw111_dev_t` chua 1 struct nay
+ * Phan chung (state TX/RX, RX always-on) o tren, phan rieng cua Platform nam trong #if
+ */
+typedef struct ZW111_PORT {
+  /* Co trang thai de biet TX/RX da xong hay chua */
+  volatile zw111_port_uart_state_t tx_state;
+  volatile zw111_port_uart_state_t rx_state;
+
+  /* Phuc vu cho viec Poll timeout done hay chua (danh dau thoi diem bat dau transaction) */
+  volatile uint32_t tx_start_kick;
+  volatile uint32_t rx_start_kick;
+
+  /* Bien bao neu rx nhan du N bytes thi DONE som (0 = disable early-done) */
+  volatile uint16_t rx_need_bytes;
+
+  /* RX always-on dang bat hay khong */
+  volatile bool rx_stream_on;
+
+#if defined(EFR32_PLATFORM)
+  /* Handle UARTDRV cua instance (NULL = chua init) */
+  UARTDRV_Handle_t handle;
+
+  /* Luu trang thai tra ve tu Callback */
+  volatile Ecode_t tx_status;
+  volatile Ecode_t rx_status;
+
+  /* Ring buffer RX always-on + 2 chunk DMA luan phien (ping-pong) */
+  zw111_ringbuf_t rx_ring;
+  uint8_t rx_ring_storage[ZW111_PORT_RX_RING_SIZE];
+  uint8_t rx_chunk[2][ZW111_PORT_RX_CHUNK_SIZE];
+  volatile uint16_t rx_chunk_taken[2];
+
+#elif defined(LINUX_PLATFORM)
+  /* File descriptor cua tty (-1 = chua init) va co danh dau fd do port tu mo */
+  int fd;
+  bool fd_owned;
+
+  /* Buffer RX dang duoc fill (tuong tu buffer da kick cho UARTDRV_Receive) */
+  uint8_t *rx_buf;
+  uint16_t rx_len;
+  uint16_t rx_count;
+#endif // PLATFORM
+} zw111_port_t;
+
 // ============= COMMON PORT/PLATFORM PROTOTYPE FUNCTION =============
 
 /**
@@ -96,13 +163,14 @@ typedef enum ZW111_PORT_UART_STATE {
  * Ham nay cau hinh phan cung cho UART/USART (Baudrate, pin route, enable clock,...)
  * Phu thuoc vao Platform/MCU ma Implement khac nhau (do API duoc cung cap khac nhau)
  *
+ * @param port Instance UART cua cam bien (thuoc `zw111_dev_t`), moi primitive ben duoi deu nhan tham so nay
  * @param[in] baudrate Toc do Baud yeu cau (toi thieu la 56700 -> 115200,...)
  * @param port_cfg Con tro tro den cau hinh Platform can dung (EFR32/STM32/ESP32)
  * @param port_cfg_size Kich thuoc cau truc cua platform/port do
  *
  * @return true neu init thanh cong - false neu that bai (UART chua san sang/init loi)
  */
-bool zw111_port_uart_init(uint32_t baudrate, const void *port_cfg, uint32_t port_cfg_size);
+bool zw111_port_uart_init(zw111_port_t *port, uint32_t baudrate, const void *port_cfg, uint32_t port_cfg_size);
 
 /**
  * @brief Huy khoi tao phan cung UART o muc Platform/port
@@ -113,18 +181,28 @@ bool zw111_port_uart_init(uint32_t baudrate, const void *port_cfg, uint32_t port
  *
  * @return true neu deinit thanh cong; false neu that bai hoac chua init
  */
-bool zw111_port_uart_deinit(void);
+bool zw111_port_uart_deinit(zw111_port_t *port);
+
+/**
+ * @brief Doi baudrate cua UART dang chay (dam phan baudrate voi cam bien)
+ *
+ * @note Chi goi khi khong co transfer TX nao dang chay (hang doi transaction rong)
+ * RX stream van giu nguyen, byte rac luc chuyen baud do parser tu resync
+ *
+ * @return false neu Platform khong ho tro baudrate nay (UART giu nguyen baudrate cu)
+ */
+bool zw111_port_uart_set_baud(zw111_port_t *port, uint32_t baudrate);
 
 /**
  * @brief Primitive function de gui 1 buffer data qua UART
  *
  * @details
  * - O che do @c UART_BLOCKING_MODE: ham se BLOCK cho den khi nhan du `len` byte
- * sau do cap nhat @c s_rx_state = UART_DONE ngay trong ham
+ * sau do cap nhat @c port->rx_state = UART_DONE ngay trong ham
  *
  * - O che do @c UART_NON_BLOCKING_MODE: Ham chi "kick" UARTDRV de nhan `len` byte
  * va tra ve ngay. Trang thai hoan tat duoc cap nhat trong Callback UARTDRV
- * (thuong la @c s_rx_state = UART_DONE khi nhan du byte)
+ * (thuong la @c port->rx_state = UART_DONE khi nhan du byte)
  *
  * Non-blocking mode Recommended:
  *  - Ham chi kick transaction va tra ve ngay
@@ -140,18 +218,18 @@ bool zw111_port_uart_deinit(void);
  *
  * @return true neu da kick TX thanh cong; false neu UART chua san sang hoac dang BUSY
  */
-bool zw111_port_uart_tx(const uint8_t *buf, uint16_t len);
+bool zw111_port_uart_tx(zw111_port_t *port, const uint8_t *buf, uint16_t len);
 
 /**
  * @brief Primitive function de nhan data 1 luong byte qua UART
  *
  * @details
  * - O che do @c UART_BLOCKING_MODE: ham se BLOCK cho den khi nhan du `len` byte
- * sau do cap nhat @c s_rx_state = UART_DONE ngay trong ham
+ * sau do cap nhat @c port->rx_state = UART_DONE ngay trong ham
  *
  * - O che do @c UART_NON_BLOCKING_MODE: Ham chi "kick" UARTDRV de nhan `len` byte
  * va tra ve ngay. Trang thai hoan tat duoc cap nhat trong Callback UARTDRV
- * (thuong la @c s_rx_state = UART_DONE khi nhan du byte)
+ * (thuong la @c port->rx_state = UART_DONE khi nhan du byte)
  *
  * Non-blocking mode Recommended:
  *  - Ham chi kick transaction va tra ve ngay
@@ -170,7 +248,7 @@ bool zw111_port_uart_tx(const uint8_t *buf, uint16_t len);
  *
  * @return true neu da kick RX thanh cong; false neu UART chua san sang hoac dang BUSY
  */
-bool zw111_port_uart_rx(uint8_t *buf, uint16_t len, uint32_t timeout_ms);
+bool zw111_port_uart_rx(zw111_port_t *port, uint8_t *buf, uint16_t len, uint32_t timeout_ms);
 
 /**
  * @brief Primitive function thoi gian cho - delay (ms)
@@ -193,7 +271,7 @@ uint32_t zw111_port_get_ticks(void);
  *
  * @return true - Neu
  */
-bool zw111_port_uart_flush(void);
+bool zw111_port_uart_flush(zw111_port_t *port);
 
 /**
  * @brief Kiem tra UART da san sang su dung hay chua (handle da duoc gan hay chua)
@@ -201,7 +279,7 @@ bool zw111_port_uart_flush(void);
  *
  * @return true neu san sang, false neu chua
  */
-bool zw111_port_uart_ready(void);
+bool zw111_port_uart_ready(const zw111_port_t *port);
 
 /* Chi transaction non-blocking moi dung cai nay */
 #if defined(UART_NON_BLOCKING_MODE)
@@ -212,7 +290,7 @@ bool zw111_port_uart_ready(void);
  * @param timeout_ms Thoi gian quyet dinh timeout khi poll
  * @return Trang thai TX (IDLE/BUSY/DONE/ERROR/TIMEOUT)
  */
-zw111_port_uart_state_t zw111_port_uart_tx_poll(uint32_t timeout_ms);
+zw111_port_uart_state_t zw111_port_uart_tx_poll(zw111_port_t *port, uint32_t timeout_ms);
 
 /**
  * @brief Poll trang thai RX hien tai va xu ly timeout
@@ -228,13 +306,13 @@ zw111_port_uart_state_t zw111_port_uart_tx_poll(uint32_t timeout_ms);
  * UART la byte stream: du lieu co the den rai rac. DONE chi xay ra khi dung so byte len da yeu cau
  * Ham nay dung UARTDRV_GetReceiveStatus() de biet rxRemaining (so byte con lai), tranh phu thuoc vao callback
  * De doc packet theo kieu stream (header roi payload luon) trong 1 transaction dai, ham co ho tro kiem tra
- * trang thai transaction RX xem co nhan du bytes khong thong qua 1 bien noi bo `s_rx_need_bytes`
+ * trang thai transaction RX xem co nhan du bytes khong thong qua truong `port->rx_need_bytes`
  * Neu nhan du bytes thi return `DONE` de tiep tuc doc tiep cho den khi transaction duoc ABORT boi 1 API khac
  *
  * @param timeout_ms Thoi gian quyet dinh timeout khi poll
  * @return Trang thai TX (IDLE/BUSY/DONE/ERROR/TIMEOUT)
  */
-zw111_port_uart_state_t zw111_port_uart_rx_poll(uint32_t timeout_ms);
+zw111_port_uart_state_t zw111_port_uart_rx_poll(zw111_port_t *port, uint32_t timeout_ms);
 
 /**
  * @brief[wrapper] Chờ cho đến khi transaction RX hiện tại nhận đủ ít nhất @p need_bytes byte
@@ -253,7 +331,7 @@ zw111_port_uart_state_t zw111_port_uart_rx_poll(uint32_t timeout_ms);
  * @note Ham nay khong duoc set ABORT_OK ma chi Poll va tra ve DONE cho den khi doc du N bytes
  * Abort transaction chi duoc lam 1 lan cuoi duy nhat bang 1 ham `zw111_`
  */
-zw111_status_t zw111_port_uart_wait_rx_reach(uint16_t need_bytes, uint32_t timeout_ms);
+zw111_status_t zw111_port_uart_wait_rx_reach(zw111_port_t *port, uint16_t need_bytes, uint32_t timeout_ms);
 
 /**
  * @brief Ham cho phep Abort (huy) 1 transaction RX sau khi doc du bytes cua packet
@@ -269,10 +347,49 @@ zw111_status_t zw111_port_uart_wait_rx_reach(uint16_t need_bytes, uint32_t timeo
  * @param timeout_ms Thoi gian de tranh abort ok treo vo han
  * @return
  */
-zw111_status_t zw111_port_uart_abort_rx_ok(uint32_t timeout_ms);
+zw111_status_t zw111_port_uart_abort_rx_ok(zw111_port_t *port, uint32_t timeout_ms);
 
 #endif // UART_NON_BLOCKING_MODE
 
+/* ------------- ALWAYS-ON RX (RING BUFFER) ------------- */
+
+/**
+ * @brief Bat che do RX luon chay (always-on): moi byte den UART duoc DMA/ISR day vao ring buffer cua Port
+ *
+ * @details
+ * Thay cho kieu "kick 1 transaction RX dai roi abort" cua `zw111_port_uart_rx()`,
+ * RX duoc arm 1 lan duy nhat luc init va khong bao gio dung giua cac transaction
+ * nen byte den trong khoang gap giua 2 lenh khong bi mat
+ * LowLevel lay byte ra bang `zw111_port_uart_rx_read()` va tu parse frame
+ *
+ * @note Khi stream dang bat, API kick RX cu (`zw111_port_uart_rx()`) se tra ve false
+ *
+ * @return true neu bat thanh cong (hoac da bat tu truoc)
+ */
+bool zw111_port_uart_rx_stream_start(zw111_port_t *port);
+
+/**
+ * @brief Tat che do RX always-on (dung truoc khi deinit hoac khi can dung lai API kick RX cu)
+ */
+void zw111_port_uart_rx_stream_stop(zw111_port_t *port);
+
+/**
+ * @brief Doc non-blocking toi da `max` byte dang co trong ring buffer RX
+ *
+ * @param buf Buffer luu byte doc ra
+ * @param max So byte toi da
+ * @return So byte da doc (0 neu chua co du lieu)
+ */
+uint16_t zw111_port_uart_rx_read(zw111_port_t *port, uint8_t *buf, uint16_t max);
+
+/**
+ * @brief Cho toi da `wait_ms` cho den khi co it nhat 1 byte moi trong ring RX
+ *
+ * @note Port co the tra ve som (spurious) - LowLevel luon tu kiem tra lai bang `zw111_port_uart_rx_read()`
+ * @return true neu co du lieu
+ */
+bool zw111_port_uart_rx_wait(zw111_port_t *port, uint32_t wait_ms);
+
 
 /* --------------- HELPER FUNCTION --------------- */
 
@@ -287,9 +404,9 @@ zw111_status_t zw111_port_uart_abort_rx_ok(uint32_t timeout_ms);
  * - ZW111_STATUS_ERROR - Neu RX loi (UART_ERROR)
  * - ZW111_STATUS_TIMEOUT - Neu RX timeout (UART_TIMEOUT)
  */
-static inline zw111_status_t wait_tx_done(uint32_t timeout_ms){
+static inline zw111_status_t wait_tx_done(zw111_port_t *port, uint32_t timeout_ms){
   while(1){
-        zw111_port_uart_state_t ret = zw111_port_uart_tx_poll(timeout_ms);
+        zw111_port_uart_state_t ret = zw111_port_uart_tx_poll(port, timeout_ms);
 
         if(ret == UART_DONE) return ZW111_STATUS_OK;
         if(ret == UART_ERROR){
@@ -332,6 +449,11 @@ __attribute__((unused)) static inline uint32_t ticks_to_ms_approx(uint32_t ticks
 #if defined(ESP32_PLATFORM)
   // ...
 #endif // ESP32_PLATFORM
+
+#if defined(LINUX_PLATFORM)
+  /* Port Linux dung CLOCK_MONOTONIC voi don vi tick = 1 ms */
+  return ticks;
+#endif // LINUX_PLATFORM
 }
 
 /* ----------------------------------------------------------- */
@@ -20,6 +20,9 @@
 #elif defined(ESP32_PLATFORM)
 #include "Port/zw111_port_esp32.h"
 
+#elif defined(LINUX_PLATFORM)
+#include "Port/zw111_port_linux.h"
+
 #else
 /* Neu PORT chua duoc define */
 #error "ZW11 port not selected (unknown platform)"
@@ -0,0 +1,161 @@
+/*
+ * @file zw111_presence.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Bo lap lich poll GetImage de phat hien ngon tay (presence detection)
+ * - IDLE  : chu ky tang dan theo cap so nhan (backoff) tu `idle_min_ms` den `idle_max_ms` moi lan NO_FINGER
+ * - BURST : sau anh partial (cam bien tra loi nhung anh loi) hoac trigger ngoai (ngat TOUCH_OUT), poll deu
+ *           `burst_ms` trong `burst_hold_ms` de bat ngon tay ngay khi dat xong
+ * - Thong ke: so lan poll, do tre phat hien (can tren), thoi gian UART/cam bien ban (utilisation)
+ *
+ * @note
+ * Loi cua module chi la lap lich tren RAM (khong goi UART): USER tu gui GetImage (blocking/async/identify)
+ * roi bao ket qua bang `zw111_presence_record()`. `zw111_presence_poll()` (zw111.h) la ban blocking goi san `zw111_get_image()`
+ * Tick tinh bang ms (`zw111_ll_get_ticks()` tren MCU, thoi gian ao trong benchmark `Host/zw111_presence_bench.c`)
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_PRESENCE_H_
+#define ZW111_LIB_INC_ZW111_PRESENCE_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "zw111_types.h"
+
+/* Gia tri mac dinh cua `zw111_presence_default_cfg()` */
+#ifndef ZW111_PRESENCE_IDLE_MIN_MS
+#define ZW111_PRESENCE_IDLE_MIN_MS      50u
+#endif // ZW111_PRESENCE_IDLE_MIN_MS
+
+#ifndef ZW111_PRESENCE_IDLE_MAX_MS
+#define ZW111_PRESENCE_IDLE_MAX_MS      400u
+#endif // ZW111_PRESENCE_IDLE_MAX_MS
+
+#ifndef ZW111_PRESENCE_BURST_MS
+#define ZW111_PRESENCE_BURST_MS         50u
+#endif // ZW111_PRESENCE_BURST_MS
+
+#ifndef ZW111_PRESENCE_BURST_HOLD_MS
+#define ZW111_PRESENCE_BURST_HOLD_MS    1000u
+#endif // ZW111_PRESENCE_BURST_HOLD_MS
+
+/* Chinh sach co san cho `zw111_presence_default_cfg()` */
+typedef enum ZW111_PRESENCE_POLICY {
+  ZW111_PRESENCE_FIXED = 0,       /* Chu ky co dinh `idle_min_ms`, khong burst */
+  ZW111_PRESENCE_BACKOFF,         /* Backoff x2 tu min den max, khong burst */
+  ZW111_PRESENCE_BURST            /* Backoff x2 + burst sau anh partial/trigger ngoai */
+} zw111_presence_policy_t;
+
+/* Cau hinh lap lich */
+typedef struct ZW111_PRESENCE_CFG {
+  uint16_t idle_min_ms;           /* Chu ky idle ban dau (sau khi phat hien/burst het han) */
+  uint16_t idle_max_ms;           /* Tran cua backoff */
+  uint16_t backoff_pct;           /* He so nhan chu ky moi lan NO_FINGER (%), 100 = chu ky co dinh */
+  uint16_t burst_ms;              /* Chu ky poll trong burst, 0 = tat burst */
+  uint16_t burst_hold_ms;         /* Thoi gian giu burst tu anh partial/trigger cuoi cung */
+} zw111_presence_cfg_t;
+
+/* Ket qua 1 lan poll */
+typedef enum ZW111_PRESENCE_EVENT {
+  ZW111_PRESENCE_EV_NONE = 0,     /* Chua den han poll (chi `zw111_presence_poll()`) */
+  ZW111_PRESENCE_EV_IDLE,         /* NO_FINGER */
+  ZW111_PRESENCE_EV_ACTIVITY,     /* Anh partial/loi anh -> vao burst */
+  ZW111_PRESENCE_EV_DETECTED,     /* Co anh (lan dau tu khi nhac ngon tay) */
+  ZW111_PRESENCE_EV_PRESENT,      /* Co anh, ngon tay van dat tu lan truoc */
+  ZW111_PRESENCE_EV_LINK_ERROR    /* Timeout/sai checksum..., giu nguyen chu ky */
+} zw111_presence_event_t;
+
+/* Thong ke tu `zw111_presence_init()`/`zw111_presence_reset_stats()` */
+typedef struct ZW111_PRESENCE_STATS {
+  uint32_t polls;                 /* So lan GetImage */
+  uint32_t detections;            /* So lan chuyen tu khong co -> co ngon tay */
+  uint32_t partials;              /* So anh partial (ZW111_STATUS_ERROR) */
+  uint32_t link_errors;           /* So lan loi duong truyen */
+  uint32_t wakes;                 /* So trigger ngoai (`zw111_presence_wake()`) */
+  uint32_t busy_ms;               /* Tong thoi gian 1 lan poll (gui lenh -> ACK): UART + cam bien chup anh */
+  uint32_t delay_samples;         /* So lan phat hien co moc bat dau (trigger ngoai hoac lan NO_FINGER truoc do) */
+  uint32_t delay_sum_ms;          /* Tong do tre phat hien: tu trigger, hoac tu lan NO_FINGER truoc (can tren) */
+  uint32_t delay_max_ms;
+  uint32_t start_tick;            /* Moc bat dau thong ke (tinh utilisation) */
+} zw111_presence_stats_t;
+
+/* Trang thai bo lap lich (USER cap phat, moi cam bien 1 context) */
+typedef struct ZW111_PRESENCE {
+  zw111_presence_cfg_t cfg;
+  uint32_t next_tick;             /* Lan poll tiep theo */
+  uint32_t interval_ms;           /* Chu ky idle hien tai (min -> max) */
+  uint32_t burst_until;           /* Het burst tai moc nay */
+  uint32_t onset_tick;            /* Moc som nhat ngon tay co the da dat (tinh do tre) */
+  bool onset_valid;
+  bool present;                   /* Lan poll gan nhat co anh */
+  zw111_presence_stats_t stats;
+} zw111_presence_t;
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Cau hinh mac dinh cho 1 chinh sach (ZW111_PRESENCE_IDLE_MIN_MS/MAX_MS/BURST_MS/BURST_HOLD_MS)
+ */
+void zw111_presence_default_cfg(zw111_presence_cfg_t *cfg, zw111_presence_policy_t policy);
+
+/**
+ * @brief Khoi tao: poll ngay tai `now`, xoa thong ke
+ */
+void zw111_presence_init(zw111_presence_t *p, const zw111_presence_cfg_t *cfg, uint32_t now);
+
+/**
+ * @brief Xoa thong ke, bat dau tinh lai tu `now` (khong doi lich poll)
+ */
+void zw111_presence_reset_stats(zw111_presence_t *p, uint32_t now);
+
+/**
+ * @brief Poll ngay va dua chu ky idle ve min (bat dau cho ngon tay moi), khong tinh la trigger ngoai
+ */
+void zw111_presence_kick(zw111_presence_t *p, uint32_t now);
+
+/**
+ * @brief Trigger ngoai (ngat TOUCH_OUT, cam bien tiem can, nut bam): poll ngay roi vao burst
+ * @note Moc `now` dung lam moc bat dau tinh do tre phat hien
+ */
+void zw111_presence_wake(zw111_presence_t *p, uint32_t now);
+
+/**
+ * @brief So ms den lan poll tiep theo (0 = den han)
+ */
+uint32_t zw111_presence_next_ms(const zw111_presence_t *p, uint32_t now);
+
+/**
+ * @brief Bao ket qua 1 lan GetImage va hen lan poll sau
+ *
+ * @param st Ket qua GetImage:
+ *  - ZW111_STATUS_OK: co anh
+ *  - ZW111_STATUS_NO_FINGER: khong co ngon tay
+ *  - ZW111_STATUS_ERROR: cam bien tra loi nhung anh loi (ngon tay dang dat/dat lech) -> burst
+ *  - Cac status khac: loi duong truyen
+ * @param start Moc gui GetImage
+ * @param end Moc nhan ACK (lich poll sau tinh tu day)
+ */
+zw111_presence_event_t zw111_presence_record(zw111_presence_t *p, zw111_status_t st, uint32_t start, uint32_t end);
+
+/**
+ * @brief Ti le thoi gian UART/cam bien ban voi GetImage tu moc bat dau thong ke (0 ~ 1000)
+ */
+uint16_t zw111_presence_uart_permille(const zw111_presence_t *p, uint32_t now);
+
+/**
+ * @brief Do tre phat hien trung binh (ms), 0 neu chua co mau
+ */
+uint32_t zw111_presence_avg_delay_ms(const zw111_presence_t *p);
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_PRESENCE_H_ */
@@ -0,0 +1,121 @@
+/*
+ * @file zw111_ringbuf.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Ring buffer byte don gian 1 producer - 1 consumer (SPSC) cho RX luon bat (always-on)
+ * - Producer: ISR/callback DMA cua Port (ghi byte vao)
+ * - Consumer: LowLevel parser (doc byte ra trong thread chinh)
+ *
+ * @note
+ * Kich thuoc buffer phai la luy thua cua 2 (<= 32768) de dung mask thay cho phep chia
+ * head/tail chay tu do (free-running) 16-bit, so byte = head - tail (tu xu ly wrap-around)
+ * Khong can khoa vi moi ben chi ghi vao 1 chi so cua rieng no
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_RINGBUF_H_
+#define ZW111_LIB_INC_ZW111_RINGBUF_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+
+typedef struct ZW111_RINGBUF {
+  uint8_t *buf;              /* Vung nho luu byte (do USER/Port cap phat tinh) */
+  uint16_t mask;             /* size - 1 */
+  volatile uint16_t head;    /* Chi so ghi (chi producer sua) */
+  volatile uint16_t tail;    /* Chi so doc (chi consumer sua) */
+  volatile uint32_t overflow;/* So byte bi bo do buffer day */
+} zw111_ringbuf_t;
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Khoi tao ring buffer tren vung nho co san
+ * @param size Kich thuoc vung nho (luy thua cua 2)
+ */
+__attribute__((unused)) static inline void zw111_rb_init(zw111_ringbuf_t *rb, uint8_t *storage, uint16_t size){
+  rb->buf = storage;
+  rb->mask = (uint16_t)(size - 1u);
+  rb->head = 0;
+  rb->tail = 0;
+  rb->overflow = 0;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief So byte dang co trong ring buffer
+ */
+__attribute__((unused)) static inline uint16_t zw111_rb_count(const zw111_ringbuf_t *rb){
+  return (uint16_t)(rb->head - rb->tail);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief So byte con trong
+ */
+__attribute__((unused)) static inline uint16_t zw111_rb_free(const zw111_ringbuf_t *rb){
+  return (uint16_t)((rb->mask + 1u) - zw111_rb_count(rb));
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Ghi `len` byte vao ring (phia producer - ISR)
+ * @return So byte da ghi (phan du bi bo va cong vao `overflow`)
+ */
+__attribute__((unused)) static inline uint16_t zw111_rb_write(zw111_ringbuf_t *rb, const uint8_t *data, uint16_t len){
+  uint16_t space = zw111_rb_free(rb);
+  uint16_t n = (len < space) ? len : space;
+  uint16_t h = rb->head;
+
+  for(uint16_t i = 0; i < n; i++){
+      rb->buf[(uint16_t)(h + i) & rb->mask] = data[i];
+  }
+  rb->head = (uint16_t)(h + n); // Cap nhat head sau cung de consumer khong doc byte chua ghi xong
+  rb->overflow += (uint32_t)(len - n);
+  return n;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Doc toi da `max` byte ra khoi ring (phia consumer)
+ * @return So byte da doc
+ */
+__attribute__((unused)) static inline uint16_t zw111_rb_read(zw111_ringbuf_t *rb, uint8_t *out, uint16_t max){
+  uint16_t avail = zw111_rb_count(rb);
+  uint16_t n = (max < avail) ? max : avail;
+  uint16_t t = rb->tail;
+
+  for(uint16_t i = 0; i < n; i++){
+      out[i] = rb->buf[(uint16_t)(t + i) & rb->mask];
+  }
+  rb->tail = (uint16_t)(t + n);
+  return n;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Bo toan bo byte dang co (phia consumer)
+ */
+__attribute__((unused)) static inline void zw111_rb_clear(zw111_ringbuf_t *rb){
+  rb->tail = rb->head;
+}
+
+/* ----------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_RINGBUF_H_ */
@@ -0,0 +1,117 @@
+/*
+ * @file zw111_stats.h
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Do latency cua moi lenh theo 3 pha, cong don vao histogram co dinh (khong heap)
+ * - TX     : kick TX -> TX xong (thoi gian UART gui Command Packet)
+ * - DEVICE : TX xong -> byte dau frame ACK (cam bien xu ly lenh)
+ * - RX     : byte dau frame -> frame day du (thoi gian UART nhan ACK)
+ * - TOTAL  : kick TX -> frame day du
+ *
+ * @note
+ * Bat bang `ZW111_LL_STATS = 1` (mac dinh 0: moi hook trong LowLevel bien mat khi compile)
+ * Moc thoi gian lay tu `zw111_port_get_ticks()` (1 ms) tai thoi diem LowLevel doc byte ra khoi ring,
+ * nen pha DEVICE/RX bi lam tron theo nhip goi `zw111_process()`
+ * Bo nho thong ke do USER cap phat va gan vao instance bang `zw111_ll_stats_attach()`
+ */
+
+#ifndef ZW111_LIB_INC_ZW111_STATS_H_
+#define ZW111_LIB_INC_ZW111_STATS_H_
+
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "stdint.h"
+#include "stdbool.h"
+#include "zw111_types.h"
+
+#ifndef ZW111_LL_STATS
+#define ZW111_LL_STATS          0
+#endif // ZW111_LL_STATS
+
+/* Bucket i (i >= 1) chua latency [2^(i-1), 2^i) ms, bucket 0 = < 1 ms, bucket cuoi = >= 1024 ms */
+#define ZW111_STATS_BUCKETS     12u
+
+typedef enum ZW111_STATS_PHASE {
+  ZW111_PHASE_TX = 0,
+  ZW111_PHASE_DEVICE,
+  ZW111_PHASE_RX,
+  ZW111_PHASE_TOTAL,
+  ZW111_PHASE_COUNT
+} zw111_stats_phase_t;
+
+/* Thong ke cua 1 lenh */
+typedef struct ZW111_CMD_STATS {
+  uint32_t count;                                         /* So lenh co ACK */
+  uint32_t timeouts;                                      /* So lenh bi timeout (khong vao histogram) */
+  uint32_t sum_ms[ZW111_PHASE_COUNT];                     /* Tong latency (tinh trung binh) */
+  uint16_t max_ms[ZW111_PHASE_COUNT];
+  uint16_t bucket[ZW111_PHASE_COUNT][ZW111_STATS_BUCKETS];/* Bao hoa o 0xFFFF */
+} zw111_cmd_stats_t;
+
+/* Thong ke cua 1 instance cam bien (~4 KB) */
+typedef struct ZW111_STATS {
+  zw111_cmd_stats_t cmd[ZW111_CMD_SLOTS];
+} zw111_stats_t;
+
+/* Moc thoi gian cua lenh dang chay (LowLevel dien vao) */
+typedef struct ZW111_STATS_STAMP {
+  zw111_cmd_t cmd;
+  uint32_t tx_kick;
+  uint32_t tx_done;
+  uint32_t rx_first;
+} zw111_stats_stamp_t;
+
+#if ZW111_LL_STATS
+
+// =============== PROTOTYPE FUNCTION ===============
+
+/**
+ * @brief Xoa toan bo thong ke
+ */
+void zw111_stats_reset(zw111_stats_t *stats);
+
+/**
+ * @brief Cong don 1 lenh vao histogram (LowLevel goi khi co ACK hoac timeout)
+ * @param rx_done Thoi diem frame ACK day du
+ * @param timeout true -> chi dem so lan timeout
+ */
+void zw111_stats_record(zw111_stats_t *stats, const zw111_stats_stamp_t *stamp, uint32_t rx_done, bool timeout);
+
+/**
+ * @brief Thong ke cua 1 lenh
+ * @return NULL neu lenh khong co slot
+ */
+const zw111_cmd_stats_t *zw111_stats_get(const zw111_stats_t *stats, zw111_cmd_t cmd);
+
+/**
+ * @brief Percentile xap xi (can tren cua bucket chua percentile, khong vuot max_ms)
+ * @param pct 1 ~ 100
+ * @return ms (0 neu chua co mau)
+ */
+uint16_t zw111_stats_percentile(const zw111_cmd_stats_t *cs, zw111_stats_phase_t phase, uint8_t pct);
+
+#else
+
+__attribute__((unused)) static inline void zw111_stats_reset(zw111_stats_t *stats){ (void)stats; }
+__attribute__((unused)) static inline const zw111_cmd_stats_t *zw111_stats_get(const zw111_stats_t *stats, zw111_cmd_t cmd){
+  (void)stats; (void)cmd;
+  return NULL;
+}
+__attribute__((unused)) static inline uint16_t zw111_stats_percentile(const zw111_cmd_stats_t *cs, zw111_stats_phase_t phase, uint8_t pct){
+  (void)cs; (void)phase; (void)pct;
+  return 0;
+}
+
+#endif // ZW111_LL_STATS
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
+
+#endif /* ZW111_LIB_INC_ZW111_STATS_H_ */
@@ -21,6 +21,7 @@ extern "C" {
 
 #include "stdio.h"
 #include "stdint.h"
+#include "stdbool.h"
 
 /* Status API driver */
 typedef enum ZW111_STATUS{
@@ -35,9 +36,19 @@ typedef enum ZW111_STATUS{
   ZW111_STATUS_PASSWORD_ERR = 0x06,
   ZW111_STATUS_DB_FULL      = 0x07,
   ZW111_STATUS_FLASH_ERR    = 0x08,
-  ZW111_STATUS_PROTOCOL_ERR = 0x09
+  ZW111_STATUS_PROTOCOL_ERR = 0x09,
+  ZW111_STATUS_CANCELLED    = 0x0A   /* Thao tac bi huy boi `zw111_cancel()` */
 } zw111_status_t;
 
+/**
+ * @brief Loi duong truyen (mat/hong frame, het thoi gian cho ACK, lenh bi huy giua chung): khong biet cam bien da lam gi
+ * -> dung ca chuoi lenh (backup/restore/sync, dam phan baudrate). Status khac la cam bien tu choi rieng 1 lenh
+ */
+__attribute__((unused)) static inline bool zw111_status_is_link_error(zw111_status_t st){
+  return st == ZW111_STATUS_TIMEOUT || st == ZW111_STATUS_PACKET_ERR ||
+         st == ZW111_STATUS_PROTOCOL_ERR || st == ZW111_STATUS_CANCELLED;
+}
+
 /* Instruction Set/Command ID  (trang 10-12 datasheet) */
 typedef enum ZW111_INSTRUCTION_SET {
   ZW111_CMD_GET_IMAGE           = 0x01,  /* Doc Images tu cam bien va luu no vao Image Buffer */
@@ -67,6 +78,22 @@ typedef enum ZW111_INSTRUCTION_SET {
   ZW111_CMD_CANCEL              = 0x30   /* Huy lenh (command) */
 } zw111_cmd_t;
 
+/* So slot cua cac bang tra theo lenh (profile, thong ke): Instruction Code 0x00 ~ 0x1F, rieng CANCEL (0x30) o slot cuoi */
+#define ZW111_CMD_SLOTS   0x21u
+
+/* Ban hang so cua `zw111_cmd_slot()` (dung trong designated initializer cua bang tinh) */
+#define ZW111_CMD_SLOT_OF(cmd)  (((cmd) == ZW111_CMD_CANCEL) ? (ZW111_CMD_SLOTS - 1u) : (uint32_t)(cmd))
+
+/**
+ * @brief Map Instruction Code -> slot cua bang tra theo lenh
+ * @return ZW111_CMD_SLOTS neu lenh khong co slot
+ */
+__attribute__((unused)) static inline uint8_t zw111_cmd_slot(zw111_cmd_t cmd){
+  if(cmd == ZW111_CMD_CANCEL) return (uint8_t)(ZW111_CMD_SLOTS - 1u);
+  if((uint32_t)cmd < ZW111_CMD_SLOTS - 1u) return (uint8_t)cmd;
+  return (uint8_t)ZW111_CMD_SLOTS;
+}
+
 /* ACK/Confirm Code (trang 14-16 datasheet) */
 typedef enum ZW111_INSTRUCTION_ACK {
   ZW111_ACK_OK                     = 0x00,  /* Bieu thi thuc thi ket thuc hoac OK */
@@ -147,6 +174,12 @@ typedef struct {
   uint16_t match_score;  /* Do tuong dong van tay */
 } zw111_match_result_t;
 
+/* Anh goc trong ImageBuffer qua UART: 4 bit/pixel, 2 pixel/byte (pixel trai o nibble cao), quet tung hang */
+#ifndef ZW111_IMAGE_WIDTH
+#define ZW111_IMAGE_WIDTH           192u   /* So pixel 1 hang cua sensor (hang so hien thuc, cam bien khong bao qua ACK) */
+#endif // ZW111_IMAGE_WIDTH
+#define ZW111_IMAGE_BITS_PER_PIXEL  4u
+
 /* Thong tin image cho ImageBuffer*/
 typedef struct {
   uint32_t size_bytes;
@@ -13,6 +13,10 @@ extern "C" {
 
 #if defined(EFR32_PLATFORM)
 #include "../../Inc/Port/zw111_port_efr32.h"
+#include "../../Inc/zw111_ringbuf.h"
+
+/* Thoi gian cho abort transaction RX kieu cu truoc khi chuyen sang stream */
+#define ZW111_RX_STREAM_ARM_TIMEOUT_MS   20
 
 /* Bien dam nhiem handle cac thong so du lieu cua gia thuc UART sau khi da khoi tao */
 #ifdef USER_PORT_UART_INIT
@@ -20,31 +24,60 @@ static UARTDRV_HandleData_t s_uart_handle_data;
 static UARTDRV_Handle_t s_uart_handle = &s_uart_handle_data;
 #endif // USER_PORT_UART_INIT
 
-/* Khoi tao UART_Handle_t truoc roi gan bien nay cho no */
-static UARTDRV_Handle_t uart_efr32_handle = NULL;
-
 #if !defined(UART_NON_BLOCKING_MODE) && !defined(UART_BLOCKING_MODE)
 #define UART_NON_BLOCKING_MODE
 #endif
 
+/* So instance (cam bien) toi da dung chung 1 firmware */
+#ifndef ZW111_PORT_EFR32_MAX_INSTANCES
+#define ZW111_PORT_EFR32_MAX_INSTANCES   2u
+#endif // ZW111_PORT_EFR32_MAX_INSTANCES
+
+/**
+ * Bang anh xa handle UARTDRV -> instance port
+ * Callback cua UARTDRV chi tra ve handle nen can bang nay de biet callback thuoc cam bien nao
+ */
+static zw111_port_t *s_port_registry[ZW111_PORT_EFR32_MAX_INSTANCES];
+
 /* ----------------------------------------------------------- */
 
-/* Co trang thai de biet TX/RX da xong hay chua */
-static volatile zw111_port_uart_state_t s_tx_state = UART_IDLE;
-static volatile zw111_port_uart_state_t s_rx_state = UART_IDLE;
+/**
+ * @brief Tim instance port tu handle UARTDRV (dung trong callback)
+ * @return NULL neu handle chua duoc dang ky
+ */
+static zw111_port_t *uart_efr32_port_from_handle(UARTDRV_Handle_t handle){
+  for(uint8_t i = 0; i < ZW111_PORT_EFR32_MAX_INSTANCES; i++){
+      if(s_port_registry[i] != NULL && s_port_registry[i]->handle == handle) return s_port_registry[i];
+  }
+  return NULL;
+}
+
+/* ----------------------------------------------------------- */
 
-/* Luu trang thai tra ve tu Callback */
-static volatile Ecode_t s_tx_status = ECODE_OK;
-static volatile Ecode_t s_rx_status = ECODE_OK;
+/**
+ * @brief Dang ky instance vao bang anh xa (idempotent)
+ * @return false neu bang day
+ */
+static bool uart_efr32_register(zw111_port_t *port){
+  int8_t free_slot = -1;
+  for(uint8_t i = 0; i < ZW111_PORT_EFR32_MAX_INSTANCES; i++){
+      if(s_port_registry[i] == port) return true;
+      if(s_port_registry[i] == NULL && free_slot < 0) free_slot = (int8_t)i;
+  }
+  if(free_slot < 0) return false;
+  s_port_registry[free_slot] = port;
+  return true;
+}
 
-#ifdef UART_NON_BLOCKING_MODE
+/* ----------------------------------------------------------- */
 
-/* Phuc vu cho viec Poll timeout done hay chua (danh dau thoi diem bat dau transaction) */
-static volatile uint32_t s_rx_start_kick = 0;
-static volatile uint32_t s_tx_start_kick = 0;
+static void uart_efr32_unregister(zw111_port_t *port){
+  for(uint8_t i = 0; i < ZW111_PORT_EFR32_MAX_INSTANCES; i++){
+      if(s_port_registry[i] == port) s_port_registry[i] = NULL;
+  }
+}
 
-/* Bien bao neu rx nhan du N bytes thi DONE som (0 = disable early-done) */
-static volatile uint16_t s_rx_need_bytes = 0;
+#ifdef UART_NON_BLOCKING_MODE
 
 /* ----------------------------------------------------------- */
 
@@ -58,23 +91,24 @@ static void uart_efr32_tx_callback(UARTDRV_HandleData_t *handle,
                                    Ecode_t transferStatus,
                                    uint8_t *data,
                                    UARTDRV_Count_t transferCount){
-  (void)(handle);
   (void)(data);
-  s_tx_status = transferStatus;
+  zw111_port_t *port = uart_efr32_port_from_handle(handle);
+  if(port == NULL) return;
+  port->tx_status = transferStatus;
 
   /* Neu truyen di du len byte yeu cau tu UARTDRV_Transmit() */
   if(transferStatus == ECODE_OK || transferStatus == ECODE_EMDRV_DMADRV_OK){
-      s_tx_state = UART_DONE;  // Gan ngay state la DONE
+      port->tx_state = UART_DONE;  // Gan ngay state la DONE
       DEBUG_LOG(3, "[PORT][TX_CB] DONE cnt=%lu st=0x%lx\r\n", (unsigned long)transferCount, (unsigned long)transferStatus);
 
   }else{ /* Neu chua du len byte tu UARTDRV_Transmit() */
 
-      if(s_tx_state == UART_TIMEOUT){ // Neu bi set la TIMEOUT
+      if(port->tx_state == UART_TIMEOUT){ // Neu bi set la TIMEOUT
           DEBUG_LOG(2, "[PORT][TX_CB] POST-TIMEOUT cnt=%lu st=0x%lx\r\n", (unsigned long)transferCount, (unsigned long)transferStatus);
           return;
       }
 
-      s_tx_state = UART_ERROR; // Gan ngay state la ERROR
+      port->tx_state = UART_ERROR; // Gan ngay state la ERROR
       DEBUG_LOG(1, "[PORT][TX_CB] ERROR cnt=%lu st=0x%lx\r\n", (unsigned long)transferCount, (unsigned long)transferStatus);
   }
 }
@@ -85,34 +119,85 @@ static void uart_efr32_rx_callback(UARTDRV_HandleData_t *handle,
                                    Ecode_t transferStatus,
                                    uint8_t *data,
                                    UARTDRV_Count_t transferCount){
-  (void)(handle);
   (void)(data);
-  s_rx_status = transferStatus;
+  zw111_port_t *port = uart_efr32_port_from_handle(handle);
+  if(port == NULL) return;
+  port->rx_status = transferStatus;
 
   /* NEW: Abort 1 transaction co chu dich (sau khi nhan du byte yeu cau) -> coi nhu DONE toan bo */
-  if(s_rx_state == UART_ABORT_OK){ // Neu duoc set la ABORT_OK
-      s_rx_state = UART_DONE;
+  if(port->rx_state == UART_ABORT_OK){ // Neu duoc set la ABORT_OK
+      port->rx_state = UART_DONE;
       DEBUG_LOG(2, "[PORT][RX_CB] ABORT-OK cnt=%lu\r\n", (unsigned long)transferCount);
       return;
   }
 
   /* Neu nhan du len byte yeu cau tu UARTDRV_Receive() */
   if(transferStatus == ECODE_OK || transferStatus == ECODE_EMDRV_DMADRV_OK){
-      s_rx_state = UART_DONE; // Gan ngay state la DONE
+      port->rx_state = UART_DONE; // Gan ngay state la DONE
       DEBUG_LOG(3, "[PORT][RX_CB] DONE cnt=%lu st=0x%lx\r\n", (unsigned long)transferCount, (unsigned long)transferStatus);
 
   }else{ /* Neu chua du len byte yeu cau tu UARTDRV_Receive() */
 
-      if(s_rx_state == UART_TIMEOUT){ // Neu bi set la TIMEOUT
+      if(port->rx_state == UART_TIMEOUT){ // Neu bi set la TIMEOUT
           DEBUG_LOG(2, "[PORT][RX_CB] POST-TIMEOUT cnt=%lu st=0x%lx\r\n", (unsigned long)transferCount, (unsigned long)transferStatus);
           return;
       }
 
-      s_rx_state = UART_ERROR; // Gan ngay state la ERROR
+      port->rx_state = UART_ERROR; // Gan ngay state la ERROR
       DEBUG_LOG(1, "[PORT][RX_CB] ERROR cnt=%lu st=0x%lx\r\n", (unsigned long)transferCount, (unsigned long)transferStatus);
   }
 }
 
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Callback khi 1 chunk RX day (hoac bi abort)
+ * Day phan byte chua lay cua chunk vao ring roi arm lai chinh chunk do vao cuoi queue UARTDRV
+ */
+static void uart_efr32_rx_stream_callback(UARTDRV_HandleData_t *handle,
+                                          Ecode_t transferStatus,
+                                          uint8_t *data,
+                                          UARTDRV_Count_t transferCount){
+  (void)(transferStatus);
+  zw111_port_t *port = uart_efr32_port_from_handle(handle);
+  if(port == NULL) return;
+  uint8_t idx = (data == port->rx_chunk[0]) ? 0 : 1;
+
+  if(transferCount > port->rx_chunk_taken[idx]){
+      (void)zw111_rb_write(&port->rx_ring, &data[port->rx_chunk_taken[idx]], (uint16_t)(transferCount - port->rx_chunk_taken[idx]));
+  }
+  port->rx_chunk_taken[idx] = 0;
+
+  if(port->rx_stream_on){
+      if(UARTDRV_Receive(handle, data, ZW111_PORT_RX_CHUNK_SIZE, uart_efr32_rx_stream_callback) != ECODE_EMDRV_UARTDRV_OK){
+          DEBUG_LOG(1, "[PORT][RX_STREAM] Re-arm chunk %u failed\r\n", idx);
+      }
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Lay cac byte da nam trong chunk dang duoc DMA fill (chua day) vao ring
+ * @note Goi trong vung atomic de khong tranh chap voi callback
+ */
+static void uart_efr32_rx_stream_harvest(zw111_port_t *port){
+  UARTDRV_Count_t rxCount = 0, rxRemaining = 0;
+  uint8_t *p = NULL;
+
+  CORE_DECLARE_IRQ_STATE;
+  CORE_ENTER_ATOMIC();
+  (void)UARTDRV_GetReceiveStatus(port->handle, &p, &rxCount, &rxRemaining);
+  if(p == port->rx_chunk[0] || p == port->rx_chunk[1]){
+      uint8_t idx = (p == port->rx_chunk[0]) ? 0 : 1;
+      if(rxCount > port->rx_chunk_taken[idx]){
+          (void)zw111_rb_write(&port->rx_ring, &p[port->rx_chunk_taken[idx]], (uint16_t)(rxCount - port->rx_chunk_taken[idx]));
+          port->rx_chunk_taken[idx] = (uint16_t)rxCount;
+      }
+  }
+  CORE_EXIT_ATOMIC();
+}
+
 #endif // UART_NON_BLOCKING_MODE
 
 /* ----------------------------------------------------------- */
@@ -129,7 +214,16 @@ static void uart_efr32_rx_callback(UARTDRV_HandleData_t *handle,
  *  - (Tuy chon) set baudrate seu SDK ho tro
  *  - Flush RX de sach buffer truoc khi giao tiep
  */
-bool zw111_port_uart_init(uint32_t baudrate, const void *port_cfg, uint32_t port_cfg_size){
+bool zw111_port_uart_init(zw111_port_t *port, uint32_t baudrate, const void *port_cfg, uint32_t port_cfg_size){
+  if(port == NULL) return false;
+
+  /* Dua instance ve trang thai ban dau */
+  port->tx_state = UART_IDLE;
+  port->rx_state = UART_IDLE;
+  port->tx_status = ECODE_OK;
+  port->rx_status = ECODE_OK;
+  port->rx_need_bytes = 0;
+  port->rx_stream_on = false;
 
 /* Neu thich tu cau hinh */
 #ifdef USER_PORT_UART_INIT
@@ -159,22 +253,25 @@ bool zw111_port_uart_init(uint32_t baudrate, const void *port_cfg, uint32_t port
   cfg->isUART_init = true;
 
   // Copy Handle da duoc khoi tao tu USER
-  zw111_port_efr32_set_handle(cfg->handle);
+  if(zw111_port_efr32_set_handle(port, cfg->handle) != true) return false;
 
 /* Dung luon API da san cua SliconLabs */
 #elif defined(SL_PORT_UART_INIT)
 
   (void)(baudrate);
-  (void)(port_cfg);
-  (void)(port_cfg_size);
 
   /* Dam bao USARTDRV da duoc Init boi he thong */
+  /* Nhieu cam bien: USER truyen handle cua instance UARTDRV (sl_uartdrv_usart_xxx_handle) qua port_cfg */
   UARTDRV_Handle_t sl_handle = sl_uartdrv_get_default();
+  if(port_cfg != NULL && port_cfg_size == sizeof(zw111_port_efr32_cfg_t)){
+      const zw111_port_efr32_cfg_t *cfg = (const zw111_port_efr32_cfg_t *)port_cfg;
+      if(cfg->handle != NULL) sl_handle = cfg->handle;
+  }
   if(sl_handle == NULL){
       return false;
   }
   /* NOTE: Ham khoi tao Driver da duoc lam trong ham sl_system_init() cua main.c */
-  if(zw111_port_efr32_set_handle(sl_handle) != true) return false;
+  if(zw111_port_efr32_set_handle(port, sl_handle) != true) return false;
 
 #endif
   return true;
@@ -182,11 +279,14 @@ bool zw111_port_uart_init(uint32_t baudrate, const void *port_cfg, uint32_t port
 
 /* ----------------------------------------------------------- */
 
-bool zw111_port_uart_deinit(void){
-  if(uart_efr32_handle == NULL) return false;
+bool zw111_port_uart_deinit(zw111_port_t *port){
+  if(port == NULL || port->handle == NULL) return false;
+
+  zw111_port_uart_rx_stream_stop(port);
 
-  if(UARTDRV_DeInit(uart_efr32_handle) == ECODE_EMDRV_UARTDRV_OK){
-      uart_efr32_handle = NULL;
+  if(UARTDRV_DeInit(port->handle) == ECODE_EMDRV_UARTDRV_OK){
+      uart_efr32_unregister(port);
+      port->handle = NULL;
       return true;
   }
   return false;
@@ -194,12 +294,30 @@ bool zw111_port_uart_deinit(void){
 
 /* ----------------------------------------------------------- */
 
-EFR32_PLATFORM_TAG bool zw111_port_efr32_set_handle(UARTDRV_Handle_t uart_handle){
-  if(uart_handle != NULL){
-      uart_efr32_handle = uart_handle;
-      return true;
+/**
+ * @note UARTDRV khong co API doi baudrate -> ghi thang bo chia cua USART ma handle dang dung
+ * (refFreq = 0: lay clock hien tai cua peripheral, oversampling 16 giong UARTDRV_InitUart())
+ */
+bool zw111_port_uart_set_baud(zw111_port_t *port, uint32_t baudrate){
+  if(port == NULL || port->handle == NULL || baudrate == 0) return false;
+  if(port->tx_state == UART_BUSY) return false;
+
+  USART_BaudrateAsyncSet(port->handle->peripheral.uart, 0, baudrate, usartOVS16);
+  return USART_BaudrateGet(port->handle->peripheral.uart) != 0;
+}
+
+/* ----------------------------------------------------------- */
+
+EFR32_PLATFORM_TAG bool zw111_port_efr32_set_handle(zw111_port_t *port, UARTDRV_Handle_t uart_handle){
+  if(port == NULL || uart_handle == NULL) return false;
+  if(uart_efr32_port_from_handle(uart_handle) != NULL && uart_efr32_port_from_handle(uart_handle) != port) return false; // Handle da thuoc ve cam bien khac
+
+  port->handle = uart_handle;
+  if(!uart_efr32_register(port)){
+      port->handle = NULL;
+      return false;
   }
-  return false;
+  return true;
 }
 
 /* ----------------------------------------------------------- */
@@ -229,32 +347,32 @@ EFR32_PLATFORM_TAG void zw111_port_efr32_default_cfg(zw111_port_efr32_cfg_t *cfg
 
 /* ----------------------------------------------------------- */
 
-bool zw111_port_uart_tx(const uint8_t *buf, uint16_t len){
-  if(uart_efr32_handle == NULL || buf == NULL || len == 0) return false;
-  if(s_tx_state == UART_BUSY) return false;
+bool zw111_port_uart_tx(zw111_port_t *port, const uint8_t *buf, uint16_t len){
+  if(port == NULL || port->handle == NULL || buf == NULL || len == 0) return false;
+  if(port->tx_state == UART_BUSY) return false;
 
-  s_tx_state = UART_BUSY; // state == BUSY khi bat dau 1 transaction
-  s_tx_status = ECODE_OK;
+  port->tx_state = UART_BUSY; // state == BUSY khi bat dau 1 transaction
+  port->tx_status = ECODE_OK;
 
 #if defined(UART_BLOCKING_MODE)
 
-  Ecode_t ret = UARTDRV_TransmitB(uart_efr32_handle, (uint8_t*)buf, (UARTDRV_Count_t)len);
+  Ecode_t ret = UARTDRV_TransmitB(port->handle, (uint8_t*)buf, (UARTDRV_Count_t)len);
   if(ret != ECODE_OK && ret != ECODE_EMDRV_UARTDRV_OK){
-      s_tx_state = UART_ERROR;
-      s_tx_status = ret;
+      port->tx_state = UART_ERROR;
+      port->tx_status = ret;
       return false;
   }
-  s_tx_state = UART_DONE; // Chi blocking mode moi set duoc
+  port->tx_state = UART_DONE; // Chi blocking mode moi set duoc
   return true;
 
 #elif defined(UART_NON_BLOCKING_MODE)
 
-  s_tx_start_kick = zw111_port_get_ticks();
-  Ecode_t ret = UARTDRV_Transmit(uart_efr32_handle, (uint8_t*)buf, (UARTDRV_Count_t)len, uart_efr32_tx_callback);
+  port->tx_start_kick = zw111_port_get_ticks();
+  Ecode_t ret = UARTDRV_Transmit(port->handle, (uint8_t*)buf, (UARTDRV_Count_t)len, uart_efr32_tx_callback);
 
   if(ret != ECODE_OK && ret != ECODE_EMDRV_UARTDRV_OK){
-      s_tx_state = UART_ERROR;
-      s_tx_status = ret;
+      port->tx_state = UART_ERROR;
+      port->tx_status = ret;
       return false;
   }
   return true;
@@ -263,34 +381,35 @@ bool zw111_port_uart_tx(const uint8_t *buf, uint16_t len){
 
 /* ----------------------------------------------------------- */
 
-bool zw111_port_uart_rx(uint8_t *buf, uint16_t len, uint32_t timeout_ms){
-  if(uart_efr32_handle == NULL || buf == NULL || len == 0) return false;
-  if(s_rx_state == UART_BUSY) return false;
+bool zw111_port_uart_rx(zw111_port_t *port, uint8_t *buf, uint16_t len, uint32_t timeout_ms){
+  if(port == NULL || port->handle == NULL || buf == NULL || len == 0) return false;
+  if(port->rx_state == UART_BUSY) return false;
+  if(port->rx_stream_on) return false; // RX dang thuoc ve stream always-on
   (void)timeout_ms; // Ham nay chi kick RX, khong xu ly timeout
 
-  s_rx_state = UART_BUSY; // state == BUSY khi bat dau 1 transaction
-  s_rx_status = ECODE_OK; // Default ban dau la OK
+  port->rx_state = UART_BUSY; // state == BUSY khi bat dau 1 transaction
+  port->rx_status = ECODE_OK; // Default ban dau la OK
 
 #if defined(UART_BLOCKING_MODE)
 
-  Ecode_t ret = UARTDRV_ReceiveB(uart_efr32_handle, buf, (UARTDRV_Count_t)len);
+  Ecode_t ret = UARTDRV_ReceiveB(port->handle, buf, (UARTDRV_Count_t)len);
   if(ret != ECODE_OK && ret != ECODE_EMDRV_UARTDRV_OK){
-      s_rx_state = UART_ERROR;
-      s_rx_status = ret;
+      port->rx_state = UART_ERROR;
+      port->rx_status = ret;
       return false;
   }
-  s_rx_state = UART_DONE; // Chi blocking mode moi set duoc (vi khong co ham callback)
+  port->rx_state = UART_DONE; // Chi blocking mode moi set duoc (vi khong co ham callback)
   return true;
 
 #elif defined(UART_NON_BLOCKING_MODE)
 
-  s_rx_start_kick = zw111_port_get_ticks();
-  s_rx_need_bytes = 0;
-  Ecode_t ret = UARTDRV_Receive(uart_efr32_handle, buf, (uint32_t)len, uart_efr32_rx_callback);
+  port->rx_start_kick = zw111_port_get_ticks();
+  port->rx_need_bytes = 0;
+  Ecode_t ret = UARTDRV_Receive(port->handle, buf, (uint32_t)len, uart_efr32_rx_callback);
 
   if(ret != ECODE_OK && ret != ECODE_EMDRV_UARTDRV_OK){
-      s_rx_state = UART_ERROR;
-      s_rx_status = ret;
+      port->rx_state = UART_ERROR;
+      port->rx_status = ret;
       return false;
   }
   return true;
@@ -301,12 +420,12 @@ bool zw111_port_uart_rx(uint8_t *buf, uint16_t len, uint32_t timeout_ms){
 
 #if defined(UART_NON_BLOCKING_MODE)
 
-zw111_port_uart_state_t zw111_port_uart_tx_poll(uint32_t timeout_ms){
-  if(s_tx_state != UART_BUSY) return s_tx_state;
+zw111_port_uart_state_t zw111_port_uart_tx_poll(zw111_port_t *port, uint32_t timeout_ms){
+  if(port->tx_state != UART_BUSY) return port->tx_state;
 
   if(timeout_ms > 0){
       uint32_t now = zw111_port_get_ticks(); // Ticks
-      uint32_t dt = elapsed_ticks(s_tx_start_kick, now);
+      uint32_t dt = elapsed_ticks(port->tx_start_kick, now);
 
       /* Chuyen tu ms -> ticks */
       uint32_t timeout_ticks = sl_sleeptimer_ms_to_tick(timeout_ms);
@@ -318,7 +437,7 @@ zw111_port_uart_state_t zw111_port_uart_tx_poll(uint32_t timeout_ms){
           /* DEBUG START */
           UARTDRV_Count_t txCount = 0, txRemaining = 0;
           uint8_t *p = NULL;
-          UARTDRV_Status_t ret = UARTDRV_GetTransmitStatus(uart_efr32_handle, &p, &txCount, &txRemaining);
+          UARTDRV_Status_t ret = UARTDRV_GetTransmitStatus(port->handle, &p, &txCount, &txRemaining);
           DEBUG_LOG(2, "[PORT][TX_POLL] GetTransmitStatus status=0x%lx p=%p count=%lu rem=%lu dt_ticks=%lu timeout_ticks=%lu\r\n",
                                                          (unsigned long)ret,
                                                          (void*)p,
@@ -327,33 +446,33 @@ zw111_port_uart_state_t zw111_port_uart_tx_poll(uint32_t timeout_ms){
                                                          (unsigned long)dt,
                                                          (unsigned long)timeout_ticks);
           /* DEBUG END */
-          s_tx_state = UART_TIMEOUT; // TX Callback tra ve timeout
-          UARTDRV_Abort(uart_efr32_handle, uartdrvAbortTransmit); // End transaction
+          port->tx_state = UART_TIMEOUT; // TX Callback tra ve timeout
+          UARTDRV_Abort(port->handle, uartdrvAbortTransmit); // End transaction
       }
   }
-  return s_tx_state;
+  return port->tx_state;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_port_uart_state_t zw111_port_uart_rx_poll(uint32_t timeout_ms){
-  if(s_rx_state != UART_BUSY) return s_rx_state;
+zw111_port_uart_state_t zw111_port_uart_rx_poll(zw111_port_t *port, uint32_t timeout_ms){
+  if(port->rx_state != UART_BUSY) return port->rx_state;
 
   // NEW: Neu co yeu cau "du N bytes" thi kiem tra rxCount
-  if(s_rx_need_bytes > 0){
+  if(port->rx_need_bytes > 0){
       UARTDRV_Count_t rxCount = 0, rxRemaining = 0;
       uint8_t *p = NULL;
-      UARTDRV_GetReceiveStatus(uart_efr32_handle, &p, &rxCount, &rxRemaining);
+      UARTDRV_GetReceiveStatus(port->handle, &p, &rxCount, &rxRemaining);
 
       // DONE logic khi du N bytes (khong Abort transaction, khong doi state)
-      if(rxCount >= s_rx_need_bytes){
+      if(rxCount >= port->rx_need_bytes){
           return UART_DONE; // DONE ao coi nhu da doc xong N bytes de thoat wait_rx_done()
       }
   }
 
   if(timeout_ms > 0){
       uint32_t now = zw111_port_get_ticks(); // Ticks
-      uint32_t dt = elapsed_ticks(s_rx_start_kick, now);
+      uint32_t dt = elapsed_ticks(port->rx_start_kick, now);
 
       /* Chuyen tu ms -> ticks */
       uint32_t timeout_ticks = sl_sleeptimer_ms_to_tick(timeout_ms);
@@ -378,7 +497,7 @@ zw111_port_uart_state_t zw111_port_uart_rx_poll(uint32_t timeout_ms){
            */
           UARTDRV_Count_t rxCount = 0, rxRemaining = 0;
           uint8_t *p = NULL;
-          UARTDRV_Status_t ret = UARTDRV_GetReceiveStatus(uart_efr32_handle, &p, &rxCount, &rxRemaining);
+          UARTDRV_Status_t ret = UARTDRV_GetReceiveStatus(port->handle, &p, &rxCount, &rxRemaining);
           DEBUG_LOG(2, "[PORT][RX_POLL] GetReceiveStatus status=0x%lx p=%p count=%lu rem=%lu dt_ticks=%lu timeout_ticks=%lu\r\n",
                                                          (unsigned long)ret,
                                                          (void*)p,
@@ -387,11 +506,11 @@ zw111_port_uart_state_t zw111_port_uart_rx_poll(uint32_t timeout_ms){
                                                          (unsigned long)dt,
                                                          (unsigned long)timeout_ticks);
           /* DEBUG END */
-          s_rx_state = UART_TIMEOUT; // RX Callback tra ve timeout
-          UARTDRV_Abort(uart_efr32_handle, uartdrvAbortReceive); // End transaction
+          port->rx_state = UART_TIMEOUT; // RX Callback tra ve timeout
+          UARTDRV_Abort(port->handle, uartdrvAbortReceive); // End transaction
       }
   }
-  return s_rx_state; // Khi nay van la UART_BUSY
+  return port->rx_state; // Khi nay van la UART_BUSY
 }
 #endif // UART_NON_BLOCKING_MODE
 
@@ -412,9 +531,9 @@ zw111_port_uart_state_t zw111_port_uart_rx_poll(uint32_t timeout_ms){
  * - ZW111_STATUS_ERROR - Neu RX loi (UART_ERROR)
  * - ZW111_STATUS_TIMEOUT - Neu RX timeout (UART_TIMEOUT)
  */
-static inline zw111_status_t wait_rx_done(uint32_t timeout_ms){
+static inline zw111_status_t wait_rx_done(zw111_port_t *port, uint32_t timeout_ms){
   while(1){
-      zw111_port_uart_state_t ret = zw111_port_uart_rx_poll(timeout_ms);
+      zw111_port_uart_state_t ret = zw111_port_uart_rx_poll(port, timeout_ms);
 
       if(ret == UART_DONE) return ZW111_STATUS_OK;
       if(ret == UART_ERROR){
@@ -431,20 +550,20 @@ static inline zw111_status_t wait_rx_done(uint32_t timeout_ms){
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_port_uart_wait_rx_reach(uint16_t need_bytes, uint32_t timeout_ms){
-  s_rx_need_bytes = need_bytes;
-  zw111_status_t ret = wait_rx_done(timeout_ms);
-  s_rx_need_bytes = 0; // Clear ngay sau khi return
+zw111_status_t zw111_port_uart_wait_rx_reach(zw111_port_t *port, uint16_t need_bytes, uint32_t timeout_ms){
+  port->rx_need_bytes = need_bytes;
+  zw111_status_t ret = wait_rx_done(port, timeout_ms);
+  port->rx_need_bytes = 0; // Clear ngay sau khi return
   return ret;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_port_uart_abort_rx_ok(uint32_t timeout_ms){
-  if(s_rx_state != UART_BUSY) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_port_uart_abort_rx_ok(zw111_port_t *port, uint32_t timeout_ms){
+  if(port->rx_state != UART_BUSY) return ZW111_STATUS_ERROR;
 
-  s_rx_state = UART_ABORT_OK; // Chuyen tu BUSY -> ABORT_OK de hoan thanh transaction
-  UARTDRV_Abort(uart_efr32_handle, uartdrvAbortReceive);
+  port->rx_state = UART_ABORT_OK; // Chuyen tu BUSY -> ABORT_OK de hoan thanh transaction
+  UARTDRV_Abort(port->handle, uartdrvAbortReceive);
 
   // cho callback doi sang UART_DONE (callback da co xu ly UART_ABORT_OK)
   uint32_t start = zw111_port_get_ticks();
@@ -452,8 +571,8 @@ zw111_status_t zw111_port_uart_abort_rx_ok(uint32_t timeout_ms){
   if(timeout_ticks == 0) timeout_ticks = 1;
 
   while(1){
-      if(s_rx_state == UART_DONE) return ZW111_STATUS_OK; // Neu RX callback tra ve ngay DONE sau khi set ABORT_OK
-      if(s_rx_state == UART_ERROR) return ZW111_STATUS_ERROR;
+      if(port->rx_state == UART_DONE) return ZW111_STATUS_OK; // Neu RX callback tra ve ngay DONE sau khi set ABORT_OK
+      if(port->rx_state == UART_ERROR) return ZW111_STATUS_ERROR;
 
       uint32_t now = zw111_port_get_ticks();
       if(elapsed_ticks(start, now) > timeout_ticks) return ZW111_STATUS_TIMEOUT;
@@ -462,27 +581,93 @@ zw111_status_t zw111_port_uart_abort_rx_ok(uint32_t timeout_ms){
 
 /* ----------------------------------------------------------- */
 
-bool zw111_port_uart_flush(void){
-  if(uart_efr32_handle == NULL) return false;
+bool zw111_port_uart_flush(zw111_port_t *port){
+  if(port == NULL || port->handle == NULL) return false;
+
+  /* Che do always-on: khong abort DMA, chi bo byte dang co (ke ca phan da nam trong chunk) */
+  if(port->rx_stream_on){
+      uart_efr32_rx_stream_harvest(port);
+      zw111_rb_clear(&port->rx_ring);
+      return true;
+  }
 
   /* Hoi trang thai RX truoc de tranh Abort mu */
   UARTDRV_Count_t rxCount = 0, rxRemaining = 0;
   uint8_t *p = NULL;
-  UARTDRV_GetReceiveStatus(uart_efr32_handle, &p, &rxCount, &rxRemaining);
+  UARTDRV_GetReceiveStatus(port->handle, &p, &rxCount, &rxRemaining);
 
   // Neu co byte ton tai
   if(rxRemaining > 0){
 
       /* Abort la viec dung 1 Transaction dang chay, neu khong co transaction (UART dang idle), Abort fail khong phai loi */
-      if(UARTDRV_Abort(uart_efr32_handle, uartdrvAbortReceive) == ECODE_EMDRV_UARTDRV_OK) return true;
+      if(UARTDRV_Abort(port->handle, uartdrvAbortReceive) == ECODE_EMDRV_UARTDRV_OK) return true;
   }
   return true;
 }
 
 /* ----------------------------------------------------------- */
 
-bool zw111_port_uart_ready(void){
-  return (uart_efr32_handle != NULL);
+bool zw111_port_uart_rx_stream_start(zw111_port_t *port){
+  if(port == NULL || port->handle == NULL) return false;
+  if(port->rx_stream_on) return true;
+
+  /* Khong duoc co transaction RX kieu cu dang chay */
+  if(port->rx_state == UART_BUSY) (void)zw111_port_uart_abort_rx_ok(port, ZW111_RX_STREAM_ARM_TIMEOUT_MS);
+
+  zw111_rb_init(&port->rx_ring, port->rx_ring_storage, (uint16_t)sizeof(port->rx_ring_storage));
+  port->rx_chunk_taken[0] = 0;
+  port->rx_chunk_taken[1] = 0;
+  port->rx_stream_on = true;
+
+  /* Queue ca 2 chunk (can rxQueue depth >= 2 trong cau hinh UARTDRV) */
+  for(uint8_t i = 0; i < 2; i++){
+      Ecode_t ret = UARTDRV_Receive(port->handle, port->rx_chunk[i], ZW111_PORT_RX_CHUNK_SIZE, uart_efr32_rx_stream_callback);
+      if(ret != ECODE_OK && ret != ECODE_EMDRV_UARTDRV_OK){
+          DEBUG_LOG(1, "[PORT][RX_STREAM] Arm chunk %u failed ret=0x%lx\r\n", i, (unsigned long)ret);
+          zw111_port_uart_rx_stream_stop(port);
+          return false;
+      }
+  }
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_port_uart_rx_stream_stop(zw111_port_t *port){
+  if(port == NULL || !port->rx_stream_on) return;
+  port->rx_stream_on = false; // Callback se khong arm lai chunk nua
+  if(port->handle != NULL) (void)UARTDRV_Abort(port->handle, uartdrvAbortReceive);
+  port->rx_state = UART_IDLE;
+}
+
+/* ----------------------------------------------------------- */
+
+uint16_t zw111_port_uart_rx_read(zw111_port_t *port, uint8_t *buf, uint16_t max){
+  if(port == NULL || !port->rx_stream_on || buf == NULL || max == 0) return 0;
+
+  if(zw111_rb_count(&port->rx_ring) < max) uart_efr32_rx_stream_harvest(port);
+  return zw111_rb_read(&port->rx_ring, buf, max);
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_rx_wait(zw111_port_t *port, uint32_t wait_ms){
+  if(port == NULL || !port->rx_stream_on) return false;
+
+  uint32_t start = zw111_port_get_ticks();
+  uint32_t timeout_ticks = sl_sleeptimer_ms_to_tick(wait_ms);
+
+  while(1){
+      uart_efr32_rx_stream_harvest(port);
+      if(zw111_rb_count(&port->rx_ring) > 0) return true;
+      if(elapsed_ticks(start, zw111_port_get_ticks()) >= timeout_ticks) return false;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_ready(const zw111_port_t *port){
+  return (port != NULL && port->handle != NULL);
 }
 
 /* ----------------------------------------------------------- */
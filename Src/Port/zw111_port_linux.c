@@ -0,0 +1,494 @@
+/*
+ * @file zw111_port_linux.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * File dinh nghia thao tac Transmit va Receive co ban cua UART cho Linux/POSIX (termios)
+ * Dung cho gateway Linux voi USB-Serial adapter hoac pty cua emulator de do/tune latency tren host
+ *
+ * @note
+ * Build tren host: them `-DLINUX_PLATFORM` va cac file Src/, Src/Port/zw111_port_linux.c
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#if defined(LINUX_PLATFORM)
+#include "../../Inc/Port/zw111_port_linux.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @brief Chuyen baudrate (so nguyen) sang hang so speed_t cua termios
+ * @return Gia tri speed_t tuong ung, B0 neu khong ho tro
+ */
+static speed_t linux_baud_to_speed(uint32_t baud){
+  switch(baud){
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    case 230400: return B230400;
+#ifdef B460800
+    case 460800: return B460800;
+#endif
+#ifdef B921600
+    case 921600: return B921600;
+#endif
+    default:     return B0;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Cau hinh tty o che do raw 8N1, khong flow control, read non-blocking
+ *
+ * @note Neu fd khong phai tty (vi du pipe/socketpair khi test) thi bo qua cau hinh termios
+ */
+static bool linux_configure_tty(int fd, uint32_t baudrate){
+  struct termios tio;
+  if(tcgetattr(fd, &tio) != 0){
+      return (errno == ENOTTY || errno == EINVAL); // Khong phai tty -> van dung duoc nhu byte stream
+  }
+
+  cfmakeraw(&tio);
+  tio.c_cflag |= (CLOCAL | CREAD);
+  tio.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+  tio.c_cc[VMIN] = 0;
+  tio.c_cc[VTIME] = 0;
+
+  if(baudrate != 0){
+      speed_t sp = linux_baud_to_speed(baudrate);
+      if(sp == B0){
+          DEBUG_LOG(1, "[PORT][LINUX] Unsupported baudrate=%lu\r\n", (unsigned long)baudrate);
+          return false;
+      }
+      cfsetispeed(&tio, sp);
+      cfsetospeed(&tio, sp);
+  }
+
+  if(tcsetattr(fd, TCSANOW, &tio) != 0) return false;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Doc non-blocking toi da `max` bytes tu fd vao buf
+ * @return So byte doc duoc (0 neu chua co du lieu), -1 neu fd loi
+ */
+static int linux_read_nonblock(int fd, uint8_t *buf, uint16_t max){
+  if(max == 0) return 0;
+  ssize_t n = read(fd, buf, max);
+  if(n > 0) return (int)n;
+  if(n == 0) return 0; // pty/tty khong co du lieu (VMIN = 0)
+  if(errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) return 0;
+  return -1;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Block toi da `wait_ms` cho den khi fd co du lieu de doc
+ * @note Tranh spin 100% CPU trong cac vong wait cua port
+ */
+static void linux_wait_readable(int fd, uint32_t wait_ms){
+  struct pollfd pfd = { .fd = fd, .events = POLLIN, .revents = 0 };
+  (void)poll(&pfd, 1, (int)wait_ms);
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_init(zw111_port_t *port, uint32_t baudrate, const void *port_cfg, uint32_t port_cfg_size){
+  if(port == NULL) return false;
+
+  zw111_port_linux_cfg_t cfg;
+  zw111_port_linux_default_cfg(&cfg);
+
+  if(port_cfg != NULL){
+      if(port_cfg_size != sizeof(zw111_port_linux_cfg_t)) return false;
+      memcpy(&cfg, port_cfg, sizeof(cfg));
+  }
+
+  /* Instance moi (memset 0) co fd = 0 nen dua vao fd_owned de biet co fd cu can dong hay khong */
+  if(port->fd_owned) (void)zw111_port_uart_deinit(port); // Init lai thi dong fd cu
+  port->fd = -1;
+  port->fd_owned = false;
+  port->rx_buf = NULL;
+  port->rx_need_bytes = 0;
+  port->rx_stream_on = false;
+
+  if(cfg.fd >= 0){
+      port->fd = cfg.fd;
+      port->fd_owned = false;
+  }else{
+      if(cfg.device == NULL) return false;
+      port->fd = open(cfg.device, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+      if(port->fd < 0){
+          DEBUG_LOG(1, "[PORT][LINUX] open(%s) failed errno=%d\r\n", cfg.device, errno);
+          return false;
+      }
+      port->fd_owned = true;
+  }
+
+  /* Dam bao fd o che do non-blocking ke ca khi USER truyen fd vao */
+  int fl = fcntl(port->fd, F_GETFL, 0);
+  if(fl < 0 || fcntl(port->fd, F_SETFL, fl | O_NONBLOCK) != 0){
+      (void)zw111_port_uart_deinit(port);
+      return false;
+  }
+
+  if(!linux_configure_tty(port->fd, baudrate)){
+      (void)zw111_port_uart_deinit(port);
+      return false;
+  }
+
+  port->tx_state = UART_IDLE;
+  port->rx_state = UART_IDLE;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_deinit(zw111_port_t *port){
+  if(port == NULL || port->fd < 0) return false;
+
+  port->rx_stream_on = false;
+  if(port->fd_owned) (void)close(port->fd);
+  port->fd = -1;
+  port->fd_owned = false;
+  port->rx_buf = NULL;
+  port->tx_state = UART_IDLE;
+  port->rx_state = UART_IDLE;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @note Chi baudrate chuan cua termios (9600 * 1/2/4/6/12, 230400), con lai tra false truoc khi dong cham vao fd
+ */
+bool zw111_port_uart_set_baud(zw111_port_t *port, uint32_t baudrate){
+  if(port == NULL || port->fd < 0) return false;
+  if(port->tx_state == UART_BUSY) return false;
+  if(linux_baud_to_speed(baudrate) == B0) return false;
+
+  (void)tcdrain(port->fd); // Byte cuoi o baud cu phai ra het truoc khi doi
+  return linux_configure_tty(port->fd, baudrate);
+}
+
+/* ----------------------------------------------------------- */
+
+LINUX_PLATFORM_TAG void zw111_port_linux_default_cfg(zw111_port_linux_cfg_t *cfg){
+  if(cfg == NULL) return;
+  cfg->device = ZW111_PORT_LINUX_DEFAULT_DEVICE;
+  cfg->fd = -1;
+}
+
+/* ----------------------------------------------------------- */
+
+LINUX_PLATFORM_TAG int zw111_port_linux_get_fd(const zw111_port_t *port){
+  return (port != NULL) ? port->fd : -1;
+}
+
+/* ----------------------------------------------------------- */
+
+LINUX_PLATFORM_TAG bool zw111_port_linux_mmap_open(zw111_port_linux_mmap_t *m, const char *path, uint32_t cap){
+  if(m == NULL || path == NULL || cap == 0) return false;
+  m->fd = -1;
+  m->map = NULL;
+  m->cap = 0;
+  m->len = 0;
+
+  int fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if(fd < 0) return false;
+
+  /* File rong thi mmap khong co page nao de ghi -> noi rong truoc, cat lai luc close */
+  if(ftruncate(fd, (off_t)cap) != 0){
+      int err = errno;
+      (void)close(fd);
+      errno = err;
+      return false;
+  }
+
+  void *map = mmap(NULL, cap, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if(map == MAP_FAILED){
+      int err = errno;
+      (void)close(fd);
+      errno = err;
+      return false;
+  }
+
+  m->fd = fd;
+  m->map = (uint8_t *)map;
+  m->cap = cap;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+LINUX_PLATFORM_TAG bool zw111_port_linux_mmap_sink(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  (void)last;
+  zw111_port_linux_mmap_t *m = (zw111_port_linux_mmap_t *)ctx;
+  if(m == NULL || m->map == NULL || len > m->cap - m->len) return false;
+
+  memcpy(&m->map[m->len], data, len);
+  m->len += len;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+LINUX_PLATFORM_TAG bool zw111_port_linux_mmap_close(zw111_port_linux_mmap_t *m){
+  if(m == NULL || m->fd < 0) return false;
+
+  bool ok = true;
+  if(m->map != NULL){
+      if(msync(m->map, m->cap, MS_SYNC) != 0) ok = false;
+      if(munmap(m->map, m->cap) != 0) ok = false;
+  }
+  if(ftruncate(m->fd, (off_t)m->len) != 0) ok = false; // Bo phan noi rong chua ghi
+  if(close(m->fd) != 0) ok = false;
+
+  m->fd = -1;
+  m->map = NULL;
+  m->cap = 0;
+  return ok;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @details
+ * fd la non-blocking nen write() co the chi ghi duoc 1 phan (EAGAIN khi buffer kernel day)
+ * Ham ghi lan luot cho den het, cho POLLOUT giua cac lan, sau do `tcdrain()` de dam bao
+ * byte cuoi cung da ra khoi UART truoc khi bao DONE (giong callback TX cua UARTDRV)
+ */
+bool zw111_port_uart_tx(zw111_port_t *port, const uint8_t *buf, uint16_t len){
+  if(port == NULL || port->fd < 0 || buf == NULL || len == 0) return false;
+  if(port->tx_state == UART_BUSY) return false;
+
+  port->tx_state = UART_BUSY; // state == BUSY khi bat dau 1 transaction
+
+  uint16_t sent = 0;
+  while(sent < len){
+      ssize_t n = write(port->fd, &buf[sent], (size_t)(len - sent));
+      if(n > 0){
+          sent += (uint16_t)n;
+          continue;
+      }
+      if(n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)){
+          struct pollfd pfd = { .fd = port->fd, .events = POLLOUT, .revents = 0 };
+          (void)poll(&pfd, 1, 10);
+          continue;
+      }
+      DEBUG_LOG(1, "[PORT][LINUX][TX] write failed errno=%d\r\n", errno);
+      port->tx_state = UART_ERROR;
+      return false;
+  }
+
+  /* tcdrain() loi ENOTTY voi pipe/socketpair -> bo qua */
+  (void)tcdrain(port->fd);
+  port->tx_state = UART_DONE;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_rx(zw111_port_t *port, uint8_t *buf, uint16_t len, uint32_t timeout_ms){
+  if(port == NULL || port->fd < 0 || buf == NULL || len == 0) return false;
+  if(port->rx_state == UART_BUSY) return false;
+  if(port->rx_stream_on) return false; // RX dang thuoc ve stream always-on
+  (void)timeout_ms; // Ham nay chi kick RX, khong xu ly timeout
+
+  port->rx_state = UART_BUSY; // state == BUSY khi bat dau 1 transaction
+  port->rx_buf = buf;
+  port->rx_len = len;
+  port->rx_count = 0;
+  port->rx_need_bytes = 0;
+  port->rx_start_kick = zw111_port_get_ticks();
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_port_uart_state_t zw111_port_uart_tx_poll(zw111_port_t *port, uint32_t timeout_ms){
+  (void)timeout_ms; // TX tren Linux hoan tat ngay trong zw111_port_uart_tx()
+  return port->tx_state;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @details
+ * Chi doc toi da den `rx_need_bytes` (neu co) thay vi ca buffer da kick
+ * de khong "an" mat byte cua frame ke tiep con nam trong kernel buffer
+ */
+zw111_port_uart_state_t zw111_port_uart_rx_poll(zw111_port_t *port, uint32_t timeout_ms){
+  if(port->rx_state != UART_BUSY) return port->rx_state;
+
+  uint16_t limit = (port->rx_need_bytes > 0 && port->rx_need_bytes < port->rx_len) ? port->rx_need_bytes : port->rx_len;
+  if(port->rx_count < limit){
+      int n = linux_read_nonblock(port->fd, &port->rx_buf[port->rx_count], (uint16_t)(limit - port->rx_count));
+      if(n < 0){
+          DEBUG_LOG(1, "[PORT][LINUX][RX_POLL] read failed errno=%d\r\n", errno);
+          port->rx_state = UART_ERROR;
+          return port->rx_state;
+      }
+      port->rx_count += (uint16_t)n;
+  }
+
+  if(port->rx_count >= port->rx_len){
+      port->rx_state = UART_DONE;
+      return port->rx_state;
+  }
+
+  // Neu co yeu cau "du N bytes" thi DONE ao (khong doi state)
+  if(port->rx_need_bytes > 0 && port->rx_count >= port->rx_need_bytes) return UART_DONE;
+
+  if(timeout_ms > 0){
+      uint32_t dt = elapsed_ticks(port->rx_start_kick, zw111_port_get_ticks());
+      if(dt > timeout_ms){
+          DEBUG_LOG(2, "[PORT][LINUX][RX_POLL] timeout count=%u need=%u len=%u dt=%lu\r\n",
+                    port->rx_count, port->rx_need_bytes, port->rx_len, (unsigned long)dt);
+          port->rx_state = UART_TIMEOUT;
+      }
+  }
+  return port->rx_state; // Khi nay van la UART_BUSY
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Chi xu ly trang thai Poll RX tra ve (giong port EFR32)
+ * @note Giua cac lan poll, block tren `poll()` thay vi spin de khong chiem CPU cua host
+ */
+static inline zw111_status_t wait_rx_done(zw111_port_t *port, uint32_t timeout_ms){
+  while(1){
+      zw111_port_uart_state_t ret = zw111_port_uart_rx_poll(port, timeout_ms);
+
+      if(ret == UART_DONE) return ZW111_STATUS_OK;
+      if(ret == UART_ERROR){
+          DEBUG_LOG(1, "[PORT] RX done Error...\r\n"); // Debug
+          return ZW111_STATUS_ERROR;
+      }
+
+      if(ret == UART_TIMEOUT){
+          DEBUG_LOG(1, "[PORT] RX done Timeout...\r\n"); // Debug
+          return ZW111_STATUS_TIMEOUT;
+      }
+      linux_wait_readable(port->fd, 1);
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_port_uart_wait_rx_reach(zw111_port_t *port, uint16_t need_bytes, uint32_t timeout_ms){
+  port->rx_need_bytes = need_bytes;
+  zw111_status_t ret = wait_rx_done(port, timeout_ms);
+  port->rx_need_bytes = 0; // Clear ngay sau khi return
+  return ret;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_port_uart_abort_rx_ok(zw111_port_t *port, uint32_t timeout_ms){
+  (void)timeout_ms; // Khong co callback bat dong bo nen abort hoan tat ngay
+  if(port->rx_state != UART_BUSY) return ZW111_STATUS_ERROR;
+
+  port->rx_buf = NULL;
+  port->rx_state = UART_DONE;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_flush(zw111_port_t *port){
+  if(port == NULL || port->fd < 0) return false;
+
+  (void)tcflush(port->fd, TCIFLUSH);
+
+  /* Voi pty/pipe, tcflush co the khong co tac dung -> doc bo toi khi rong */
+  uint8_t junk[64];
+  while(linux_read_nonblock(port->fd, junk, sizeof(junk)) > 0){}
+
+  port->rx_buf = NULL;
+  port->rx_state = UART_IDLE;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_rx_stream_start(zw111_port_t *port){
+  if(port == NULL || port->fd < 0) return false;
+  if(port->rx_state == UART_BUSY) (void)zw111_port_uart_abort_rx_ok(port, 0);
+  port->rx_stream_on = true;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_port_uart_rx_stream_stop(zw111_port_t *port){
+  if(port == NULL) return;
+  port->rx_stream_on = false;
+}
+
+/* ----------------------------------------------------------- */
+
+uint16_t zw111_port_uart_rx_read(zw111_port_t *port, uint8_t *buf, uint16_t max){
+  if(port == NULL || !port->rx_stream_on || port->fd < 0 || buf == NULL) return 0;
+  int n = linux_read_nonblock(port->fd, buf, max);
+  return (n > 0) ? (uint16_t)n : 0;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_rx_wait(zw111_port_t *port, uint32_t wait_ms){
+  if(port == NULL || !port->rx_stream_on || port->fd < 0) return false;
+  struct pollfd pfd = { .fd = port->fd, .events = POLLIN, .revents = 0 };
+  return poll(&pfd, 1, (int)wait_ms) > 0;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_port_uart_ready(const zw111_port_t *port){
+  return (port != NULL && port->fd >= 0);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_port_delay_ms(uint32_t ms){
+  struct timespec ts = { .tv_sec = (time_t)(ms / 1000u), .tv_nsec = (long)(ms % 1000u) * 1000000L };
+  while(nanosleep(&ts, &ts) != 0 && errno == EINTR){}
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @note Tick = 1 ms tu CLOCK_MONOTONIC (khong bi anh huong khi doi gio he thong)
+ * Gia tri 32-bit wrap sau ~49 ngay, cac ham elapsed_*() da xu ly wrap-around
+ */
+uint32_t zw111_port_get_ticks(void){
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+}
+
+/* ----------------------------------------------------------- */
+
+#endif // LINUX_PLATFORM
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -14,25 +14,362 @@ extern "C" {
 #include "zw111.h"
 #include "string.h"
 
-/* Default enroll state */
-static uint16_t s_enroll_page_id_local = 0xFFFF;
+static void zw_op_on_txn_done(zw111_ll_txn_t *txn);
+
+/**
+ * @brief Chuan bi completion object truoc khi xep hang transaction dau tien
+ */
+static void zw_op_begin(zw111_dev_t *dev, zw111_op_t *op, zw111_op_kind_t kind, zw111_op_cb_t cb, void *user){
+  op->dev = dev;
+  op->kind = kind;
+  op->step = 0;
+  op->done = false;
+  op->status = ZW111_STATUS_ERROR;
+  op->cb = cb;
+  op->user = user;
+  op->out = NULL;
+  op->out_len = 0;
+  op->arg = 0;
+  op->out2 = NULL;
+  op->tick = zw111_ll_get_ticks();
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Xep hang 1 lenh cua thao tac
+ * @param params Params da encode (thuong la `op->txn.params` do `zw111_cmd_enc_<cmd>()` ghi thang vao, khong copy lai)
+ * @param next true -> chen ngay sau transaction dang chay (buoc tiep theo cua cung 1 thao tac)
+ */
+static zw111_status_t zw_op_submit(zw111_op_t *op, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len, bool next){
+  zw111_status_t ret = zw111_ll_txn_init(&op->txn, cmd, params, param_len, zw_op_on_txn_done, op);
+  if(ret != ZW111_STATUS_OK) return ret;
+  return next ? zw111_ll_txn_submit_next(op->dev, &op->txn) : zw111_ll_txn_submit(op->dev, &op->txn);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Danh dau thao tac da xong va bao cho USER
+ */
+static void zw_op_finish(zw111_op_t *op, zw111_status_t status){
+  op->status = status;
+  op->done = true;
+  if(op->cb) op->cb(op, status, op->user);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Decode Basic parameter table (16 bytes) cua PS_ReadSysPara
+ * @return false neu ACK ngan hon bo cuc cua lenh
+ */
+static bool zw_decode_sysinfo(const zw111_ll_txn_t *txn, zw111_sysinfo_t *info){
+  uint16_t security, packet_size;
+  if(!zw111_cmd_dec_read_sys_para(txn->ret_params, txn->ret_len, &info->system_state, &info->sensor_type,
+                                  &info->database_capacity, &security, &info->device_address,
+                                  &packet_size, &info->baudrate_multipler)){
+      return false;
+  }
+  info->security = (zw111_match_threshold_t)security;
+  info->packet_size = (zw111_packet_size_t)packet_size;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Thong ke chuoi Data Packet LowLevel da dem trong transaction (upload/download)
+ */
+static void zw_fill_xfer_stats(const zw111_ll_txn_t *txn, zw111_xfer_stats_t *st){
+  if(st == NULL) return;
+  st->bytes = txn->xfer_bytes;
+  st->packets = txn->xfer_packets;
+  st->elapsed_ms = txn->xfer_end_tick - txn->xfer_start_tick;
+  st->bytes_per_sec = (st->elapsed_ms != 0) ? (uint32_t)(((uint64_t)st->bytes * 1000u) / st->elapsed_ms) : 0;
+}
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_uart_init(const zw111_cfg_t *cfg){
-  if(!cfg) return ZW111_STATUS_ERROR;
+/**
+ * @brief Callback cua LowLevel khi 1 transaction cua thao tac xong
+ *
+ * @details
+ * Decode Return Params theo loai thao tac, va voi thao tac nhieu lenh (enroll, index table)
+ * thi xep hang lenh tiep theo ngay sau (khong de thao tac khac chen vao giua)
+ */
+static void zw_op_on_txn_done(zw111_ll_txn_t *txn){
+  zw111_op_t *op = (zw111_op_t *)txn->user;
+
+  if(txn->status != ZW111_STATUS_OK){
+      zw_op_finish(op, txn->status);
+      return;
+  }
+
+  zw111_status_t ret = zw_map_ack_to_status(txn->ack);
+  uint8_t step = op->step++;
+
+  switch(op->kind){
+    case ZW111_OP_SIMPLE:
+      break;
+
+    case ZW111_OP_SEARCH:{
+      /* Return tu ACK Packet: PageID (2 bytes) + Score (2 bytes) */
+      zw111_match_result_t *result = (zw111_match_result_t *)op->out;
+      if(!zw111_cmd_dec_search(txn->ret_params, txn->ret_len, &result->page_id, &result->match_score)){
+          ret = ZW111_STATUS_ERROR;
+      }
+    }
+    break;
+
+    case ZW111_OP_MATCH:
+      // Gia tri Score tra ve (Sau Confirm code)
+      if(ret == ZW111_STATUS_OK && op->out != NULL){
+          if(!zw111_cmd_dec_match(txn->ret_params, txn->ret_len, (uint16_t *)op->out)) ret = ZW111_STATUS_ERROR;
+      }
+      break;
+
+    case ZW111_OP_IDENTIFY:{
+      zw111_identify_result_t *id = (zw111_identify_result_t *)op->out;
+      uint32_t now = zw111_ll_get_ticks();
+      id->stage_ms[step] = now - op->tick;
+      id->total_ms += id->stage_ms[step];
+      op->tick = now;
+      if(ret != ZW111_STATUS_OK) break;
+
+      if(step == ZW111_ID_STAGE_GET_IMAGE){
+          if((uint16_t)op->arg == 0){
+              ret = ZW111_STATUS_MATCH_FAIL; // Database rong -> khong can GenChar/Search
+              break;
+          }
+          uint8_t len = zw111_cmd_enc_gen_char(txn->params, (uint8_t)ZW111_CHARBUFFER_1);
+          id->stage = ZW111_ID_STAGE_GEN_CHAR;
+          ret = zw_op_submit(op, ZW111_CMD_GEN_CHAR, txn->params, len, true);
+          if(ret == ZW111_STATUS_OK) return;
+      }else if(step == ZW111_ID_STAGE_GEN_CHAR){
+          uint8_t len = zw111_cmd_enc_search(txn->params, (uint8_t)ZW111_CHARBUFFER_1, (uint16_t)(op->arg >> 16), (uint16_t)op->arg);
+          id->stage = ZW111_ID_STAGE_SEARCH;
+          ret = zw_op_submit(op, ZW111_CMD_SEARCH, txn->params, len, true);
+          if(ret == ZW111_STATUS_OK) return;
+      }else if(!zw111_cmd_dec_search(txn->ret_params, txn->ret_len, &id->page_id, &id->match_score)){
+          ret = ZW111_STATUS_ERROR;
+      }
+    }
+    break;
+
+    case ZW111_OP_ENROLL_STEP1:
+      /* Buoc 1: GetImage + GenChar (CharBuffer1) */
+      if(ret == ZW111_STATUS_OK && step == 0){
+          uint8_t len = zw111_cmd_enc_gen_char(txn->params, (uint8_t)ZW111_CHARBUFFER_1);
+          ret = zw_op_submit(op, ZW111_CMD_GEN_CHAR, txn->params, len, true);
+          if(ret == ZW111_STATUS_OK) return;
+      }
+      break;
+
+    case ZW111_OP_ENROLL_STEP2:
+      /* Buoc 2: GetImage + GenChar (CharBuffer2) + RegModel (merge) */
+      /* Sau khi co duoc feature file qua GenChar trong CharBuffer1 va CharBuffer2 thi thuc hien
+       * merge cac feature file voi nhau de tao ra Template file, ket qua lai duoc luu trong CB1 va CB2 */
+      if(ret == ZW111_STATUS_OK && step == 0){
+          uint8_t len = zw111_cmd_enc_gen_char(txn->params, (uint8_t)ZW111_CHARBUFFER_2);
+          ret = zw_op_submit(op, ZW111_CMD_GEN_CHAR, txn->params, len, true);
+          if(ret == ZW111_STATUS_OK) return;
+      }else if(ret == ZW111_STATUS_OK && step == 1){
+          // Command RegModel khong co Param gui di
+          // ACK phan hoi cung khong co return param
+          ret = zw_op_submit(op, ZW111_CMD_REG_MODEL, NULL, 0, true);
+          if(ret == ZW111_STATUS_OK) return;
+      }
+      break;
+
+    case ZW111_OP_ENROLL_STORE:
+      /* PageID vua ghi da co template */
+      if(ret == ZW111_STATUS_OK) zw111_index_set(&op->dev->index, op->dev->enroll_page_id, true);
+
+      /* Reset enroll context sau khi da store xong */
+      op->dev->enroll_page_id = 0xFFFF;
+      break;
+
+    case ZW111_OP_DELETE:
+      /* arg = start | (count << 16) */
+      if(ret == ZW111_STATUS_OK) zw111_index_set_range(&op->dev->index, (uint16_t)op->arg, (uint16_t)(op->arg >> 16), false);
+      break;
+
+    case ZW111_OP_EMPTY:
+      if(ret == ZW111_STATUS_OK) zw111_index_clear_all(&op->dev->index);
+      break;
+
+    case ZW111_OP_INDEX_SYNC:{
+      if(ret != ZW111_STATUS_OK) break;
+      zw111_index_t *idx = &op->dev->index;
+
+      if(step == 0){
+          /* Buoc 0: database_capacity (word thu 3 cua Basic parameter table) */
+          zw111_sysinfo_t info;
+          if(!zw_decode_sysinfo(txn, &info)){
+              ret = ZW111_STATUS_ERROR;
+              break;
+          }
+          zw111_ll_set_packet_size(op->dev, info.packet_size);
+          zw111_index_reset(idx, info.database_capacity);
+          if(idx->capacity == 0){
+              ret = ZW111_STATUS_ERROR;
+              break;
+          }
+          if(op->arg != 0) break; // `zw111_index_open()`: trang Index Table doc lazy
+      }else{
+          /* Buoc 1..n: trang Index Table (step - 1) */
+          const uint8_t *table;
+          if(!zw111_cmd_dec_read_index_table(txn->ret_params, txn->ret_len, &table)){
+              ret = ZW111_STATUS_ERROR;
+              break;
+          }
+          zw111_index_load_page(idx, (uint8_t)(step - 1u), table);
+      }
+
+      /* Con trang chua doc -> xep hang ngay sau */
+      if(step < zw111_index_page_count(idx)){
+          uint8_t len = zw111_cmd_enc_read_index_table(txn->params, step);
+          ret = zw_op_submit(op, ZW111_CMD_READ_INDEX_TABLE, txn->params, len, true);
+          if(ret == ZW111_STATUS_OK) return;
+          break;
+      }
+      idx->valid = true;
+    }
+    break;
+
+    case ZW111_OP_INDEX_PAGE:{
+      if(ret != ZW111_STATUS_OK) break;
+      zw111_index_t *idx = &op->dev->index;
+      const uint8_t *table;
+      if(!zw111_cmd_dec_read_index_table(txn->ret_params, txn->ret_len, &table)){
+          ret = ZW111_STATUS_ERROR;
+          break;
+      }
+      zw111_index_load_page(idx, (uint8_t)op->arg, table);
+
+      /* Moi trang da nap -> bitmap day du nhu sau `zw111_sync_index()` */
+      uint8_t pages = zw111_index_page_count(idx);
+      uint32_t all = (pages >= 32u) ? 0xFFFFFFFFu : ((1u << pages) - 1u);
+      if((idx->loaded & all) == all) idx->valid = true;
+    }
+    break;
+
+    case ZW111_OP_INDEX_TABLE:{
+      if(ret != ZW111_STATUS_OK) break;
+      const uint8_t *page;
+      if(!zw111_cmd_dec_read_index_table(txn->ret_params, txn->ret_len, &page)){
+          ret = ZW111_STATUS_ERROR;
+          break;
+      }
+      uint8_t *table = (uint8_t *)op->out;
+      memcpy(&table[ZW111_INDEX_PAGE_BYTES * step], page, ZW111_INDEX_PAGE_BYTES); // Copy qua table
+
+      /* Page 1 (Optional) (256 ~ 511) */
+      if(step == 0 && op->out_len >= 2u * ZW111_INDEX_PAGE_BYTES){
+          uint8_t len = zw111_cmd_enc_read_index_table(txn->params, 1);
+          ret = zw_op_submit(op, ZW111_CMD_READ_INDEX_TABLE, txn->params, len, true);
+          if(ret == ZW111_STATUS_OK) return;
+      }
+    }
+    break;
+
+    case ZW111_OP_NOTEPAD_READ:{
+      if(ret != ZW111_STATUS_OK) break;
+      const uint8_t *content;
+      if(!zw111_cmd_dec_read_note_pad(txn->ret_params, txn->ret_len, &content)){
+          ret = ZW111_STATUS_ERROR;
+          break;
+      }
+      memcpy(op->out, content, ZW111_META_PAGE_SIZE);
+    }
+    break;
+
+    case ZW111_OP_TEMPLATE_COUNT:
+      if(!zw111_cmd_dec_valid_template(txn->ret_params, txn->ret_len, (uint16_t *)op->out)) ret = ZW111_STATUS_ERROR;
+      break;
+
+    case ZW111_OP_SYSINFO:
+      if(ret != ZW111_STATUS_OK) break;
+      if(!zw_decode_sysinfo(txn, (zw111_sysinfo_t *)op->out)){
+          ret = ZW111_STATUS_ERROR;
+          break;
+      }
+      zw111_ll_set_packet_size(op->dev, ((zw111_sysinfo_t *)op->out)->packet_size); // Kich thuoc Data Packet cho upload/download
+      break;
+
+    case ZW111_OP_UPLOAD:
+    case ZW111_OP_DOWNLOAD:
+      /* Chuoi DATA...END da di het qua sink/source (LowLevel), chi con tinh thong luong */
+      zw_fill_xfer_stats(txn, (zw111_xfer_stats_t *)op->out);
+      break;
+
+    case ZW111_OP_UPLOAD_IMAGE:
+      /* Cam bien khong bao kich thuoc anh: so hang suy ra tu so byte da nhan (4 bit/pixel) */
+      zw_fill_xfer_stats(txn, (zw111_xfer_stats_t *)op->out2);
+      if(ret == ZW111_STATUS_OK && op->out != NULL){
+          zw111_image_info_t *info = (zw111_image_info_t *)op->out;
+          info->size_bytes = txn->xfer_bytes;
+          info->width = ZW111_IMAGE_WIDTH;
+          info->height = (uint16_t)((txn->xfer_bytes * (8u / ZW111_IMAGE_BITS_PER_PIXEL)) / ZW111_IMAGE_WIDTH);
+      }
+      break;
+
+    case ZW111_OP_SET_CHIP_ADDR:
+      // Set lai dia chi moi cho instance dang dung
+      zw111_ll_set_chip_address(op->dev, op->arg);
+      break;
+
+    case ZW111_OP_SET_PKT_SIZE:
+      // Data Packet tu lenh sau da theo kich thuoc moi
+      if(ret == ZW111_STATUS_OK) zw111_ll_set_packet_size(op->dev, (zw111_packet_size_t)op->arg);
+      break;
+
+    default:
+      ret = ZW111_STATUS_ERROR;
+      break;
+  }
+
+  zw_op_finish(op, ret);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Chay 1 thao tac async den khi xong (dung cho cac API blocking)
+ * @param submit_ret Ket qua xep hang cua API async
+ */
+static zw111_status_t zw_op_run(zw111_op_t *op, zw111_status_t submit_ret){
+  if(submit_ret != ZW111_STATUS_OK) return submit_ret;
+  return zw111_op_wait(op);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_uart_init(zw111_dev_t *dev, const zw111_cfg_t *cfg){
+  if(!dev || !cfg) return ZW111_STATUS_ERROR;
+
+  /* 0. Trang thai LowLevel cua instance (parser, hang doi, dia chi chip) */
+  zw111_ll_dev_init(dev);
 
   /* 1. Binding Init UART hardware qua Port layer */
-  if(zw111_port_uart_init(cfg->baud, cfg->port_cfg, cfg->port_cfg_size) != true){
+  if(zw111_port_uart_init(&dev->port, cfg->baud, cfg->port_cfg, cfg->port_cfg_size) != true){
+      return ZW111_STATUS_ERROR;
+  }
+  dev->baud = cfg->baud; // Thoi gian TX cua Packet tinh theo baud nay
+
+  /* 2. Bat RX always-on (ring buffer) cho parser cua LowLevel */
+  if(zw111_port_uart_rx_stream_start(&dev->port) != true){
+      (void)zw111_port_uart_deinit(&dev->port);
       return ZW111_STATUS_ERROR;
   }
 
-  /* 2. Flush UART RX (tranh rac sau Reset) */
-  if(zw111_ll_flush_uart() != ZW111_STATUS_OK) return ZW111_STATUS_ERROR;
+  /* 3. Flush UART RX (tranh rac sau Reset) */
+  if(zw111_ll_flush_uart(dev) != ZW111_STATUS_OK) return ZW111_STATUS_ERROR;
 
-  /* 3. Verify password neu can */
+  /* 4. Verify password neu can */
   if(cfg->password != 0){
-      if(zw111_verify_password(cfg->password) != ZW111_STATUS_OK){
+      if(zw111_verify_password(dev, cfg->password) != ZW111_STATUS_OK){
           return ZW111_STATUS_ERROR;
       }
   }
@@ -41,403 +378,1083 @@ zw111_status_t zw111_uart_init(const zw111_cfg_t *cfg){
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_uart_deinit(const zw111_cfg_t *cfg){
+zw111_status_t zw111_uart_deinit(zw111_dev_t *dev, const zw111_cfg_t *cfg){
   /* TODO: Hien tai voi EFR32 chua can dung (Sau nay mo rong cho cac Platform khac) */
   (void)(cfg);
 
-  if(zw111_port_uart_deinit() != true) return ZW111_STATUS_ERROR;
+  if(!dev) return ZW111_STATUS_ERROR;
+  if(zw111_port_uart_deinit(&dev->port) != true) return ZW111_STATUS_ERROR;
   return ZW111_STATUS_OK;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_set_password(uint32_t new_pwd){
-  uint8_t params[4]; // 4 bytes password dau vao can thay doi
-  write_u32_be(params, new_pwd);
+zw111_status_t zw111_set_password(zw111_dev_t *dev, uint32_t new_pwd){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_set_password_async(dev, &op, new_pwd, NULL, NULL));
+}
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_SET_PWD, params, (uint8_t)sizeof(params), &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-  return zw_map_ack_to_status(ack);
+zw111_status_t zw111_verify_password(zw111_dev_t *dev, uint32_t pwd){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_verify_password_async(dev, &op, pwd, NULL, NULL));
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_verify_password(uint32_t pwd){
-  uint8_t p[4]; // Buffer chua password dau vao can xac thuc (4 bytes)
-  write_u32_be(p, pwd);
+zw111_status_t zw111_get_image(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_get_image_async(dev, &op, NULL, NULL));
+}
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_VERIFY_PWD, p, (uint8_t)sizeof(p), &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-  return zw_map_ack_to_status(ack);
+zw111_presence_event_t zw111_presence_poll(zw111_dev_t *dev, zw111_presence_t *p){
+  if(dev == NULL || p == NULL) return ZW111_PRESENCE_EV_NONE;
+
+  uint32_t start = zw111_ll_get_ticks();
+  if(zw111_presence_next_ms(p, start) != 0) return ZW111_PRESENCE_EV_NONE;
+
+  zw111_status_t st = zw111_get_image(dev);
+  return zw111_presence_record(p, st, start, zw111_ll_get_ticks());
 }
 
+/* --------- MATCH FLOW ---------  */
+
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_get_image(void){
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_GET_IMAGE, NULL, 0, &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_gen_char(zw111_dev_t *dev, zw111_charbuffer_t buf){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_gen_char_async(dev, &op, buf, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
 
-  return zw_map_ack_to_status(ack);
+zw111_status_t zw111_search(zw111_dev_t *dev, zw111_charbuffer_t buf, uint16_t start, uint16_t count, zw111_match_result_t *result){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_search_async(dev, &op, buf, start, count, result, NULL, NULL));
 }
 
-/* --------- MATCH FLOW ---------  */
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_load_char(zw111_dev_t *dev, zw111_charbuffer_t buf, uint16_t page_id){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_load_char_async(dev, &op, buf, page_id, NULL, NULL));
+}
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_gen_char(zw111_charbuffer_t buf){
-  uint8_t p[1] = {(uint8_t)buf}; // Buffer dua tham so cho lenh (TX) la BufferID
+zw111_status_t zw111_match(zw111_dev_t *dev, uint16_t *score){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_match_async(dev, &op, score, NULL, NULL));
+}
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_GEN_CHAR, p, 1, &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-  return zw_map_ack_to_status(ack);
+zw111_status_t zw111_identify(zw111_dev_t *dev, uint16_t start, uint16_t count, zw111_identify_result_t *result){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_identify_async(dev, &op, start, count, result, NULL, NULL));
 }
 
+/* --------- ENROLL FLOW ---------  */
+
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_search(zw111_charbuffer_t buf, uint16_t start, uint16_t count, zw111_match_result_t *result){
-  if(result == NULL) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_enroll_start(zw111_dev_t *dev, uint16_t page_id){
+  if(!dev) return ZW111_STATUS_ERROR;
+  dev->enroll_page_id = page_id;
+  return ZW111_STATUS_OK;
+}
 
-  /* Params cua lenh Search can gui di: BufferID (1 bytes) + Param StartPage (2 bytes) + Param PageNum (2 bytes) = 5 bytes */
-  uint8_t p[5];
-  p[0] = (uint8_t)buf;
-  write_u16_be(&p[1], start);
-  write_u16_be(&p[3], count);
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Ham lay pageID de phuc vu cho qua trinh enroll van tay
+ * @note De la static de App Layer khong nhin thay, chi dung noi bo
+ *
+ * @return pageID muon Enroll
+ */
+static uint16_t zw111_get_enroll_pageid(const zw111_dev_t *dev){
+  return dev->enroll_page_id;
+}
 
-  zw111_ack_t ack = 0; // Luu gia tri ACK tra ve
-  uint8_t ret_params[16] = {0}; // Luu tham so tra ve tu ACK
-  uint16_t ret_len = 0; // Chieu dai params
+/* ----------------------------------------------------------- */
 
-  zw111_status_t ret = zw111_ll_send_command_packet(ZW111_CMD_SEARCH, p, (uint8_t)sizeof(p));
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_enroll_step1(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_enroll_step1_async(dev, &op, NULL, NULL));
+}
 
-  ret = zw111_ll_receive_ack_packet_ver2(&ack, ret_params, &ret_len);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-  /* Return tu ACK Packet: PageID (2 bytes) + Score (2 bytes) */
-  if(ret_len < 4) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_enroll_step2(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_enroll_step2_async(dev, &op, NULL, NULL));
+}
 
-  result->match_score = read_u16_be(&ret_params[0]);
-  result->page_id = read_u16_be(&ret_params[2]);
+/* ----------------------------------------------------------- */
 
-  return zw_map_ack_to_status(ack);
+zw111_status_t zw111_enroll_store(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_enroll_store_async(dev, &op, NULL, NULL));
+}
+
+/* --------- DATABASE MANAGEMENT ---------  */
+
+zw111_status_t zw111_delete_template(zw111_dev_t *dev, uint16_t page_id){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_delete_template_async(dev, &op, page_id, NULL, NULL));
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_load_char(zw111_charbuffer_t buf, uint16_t page_id){
-  if(page_id == 0xFFFF) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_delete_range(zw111_dev_t *dev, uint16_t start, uint16_t count){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_delete_range_async(dev, &op, start, count, NULL, NULL));
+}
 
-  /* Params Cmd Packet: BufferID (1) + PageID (2) = 3 bytes */
-  uint8_t p[3];
-  p[0] = (uint8_t)buf; // BufferID
-  write_u16_be(&p[1], page_id); // PageID
+/* ----------------------------------------------------------- */
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_LOAD_CHAR, p, (uint8_t)sizeof(p), &ack); // Khong co Return params
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_delete_set(zw111_dev_t *dev, const uint16_t *pages, uint16_t n, uint16_t *runs){
+  if(runs != NULL) *runs = 0;
+  if(dev == NULL || (pages == NULL && n > 0)) return ZW111_STATUS_ERROR;
+
+  /* Tap PageID -> bitmap cung bo cuc voi bitmap index */
+  uint32_t req[ZW111_INDEX_WORDS];
+  uint16_t limit = dev->index.capacity ? dev->index.capacity : (uint16_t)ZW111_INDEX_MAX_CAPACITY;
+  memset(req, 0, sizeof(req));
+  for(uint16_t i = 0; i < n; i++){
+      if(pages[i] >= limit) return ZW111_STATUS_ERROR;
+      req[pages[i] >> 5] |= 1u << (pages[i] & 31u);
+  }
 
-  return zw_map_ack_to_status(ack);
+  uint16_t cur = 0, start, count;
+  while(zw111_index_next_delete_run(&dev->index, req, &cur, &start, &count)){
+      zw111_status_t ret = zw111_delete_range(dev, start, count);
+      if(ret != ZW111_STATUS_OK) return ret;
+      if(runs != NULL) (*runs)++;
+  }
+  return ZW111_STATUS_OK;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_match(uint16_t *score){
-  /* PS_Match: ACK co the tra ve score (2 bytes) - theo datasheet */
-  zw111_ack_t ack = 0;
-  uint8_t ret_params[8] = {0}; // Buffer chua gia tri tham so tra ve
-  uint16_t ret_len = 0;
+zw111_status_t zw111_clear_database(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_clear_database_async(dev, &op, NULL, NULL));
+}
 
-  // Command MATCH khong co Parameter gui di
-  zw111_status_t ret = zw111_ll_send_command_packet(ZW111_CMD_MATCH, NULL, 0);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_read_index_table(zw111_dev_t *dev, uint8_t *table, uint8_t len){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_read_index_table_async(dev, &op, table, len, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_sync_index(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_sync_index_async(dev, &op, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_index_open(zw111_dev_t *dev){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_index_open_async(dev, &op, NULL, NULL));
+}
 
-  // Nhan lai ACK phan hoi sau khi gui Command
-  ret = zw111_ll_receive_ack_packet_ver2(&ack, ret_params, &ret_len);
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_index_fetch(zw111_dev_t *dev, uint8_t page_no){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_index_fetch_async(dev, &op, page_no, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Nap cac trang Index Table first..last chua co trong bitmap
+ */
+static zw111_status_t zw_index_ensure(zw111_dev_t *dev, uint8_t first, uint8_t last){
+  if(dev->index.capacity == 0) return ZW111_STATUS_ERROR; // Chua `zw111_index_open()`/`zw111_sync_index()`
+  for(uint8_t pg = first; pg <= last; pg++){
+      if(zw111_index_page_loaded(&dev->index, pg)) continue;
+      zw111_status_t ret = zw111_index_fetch(dev, pg);
+      if(ret != ZW111_STATUS_OK) return ret;
+  }
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_index_test_lazy(zw111_dev_t *dev, uint16_t page_id, bool *used){
+  if(dev == NULL || used == NULL || page_id >= dev->index.capacity) return ZW111_STATUS_ERROR;
+
+  uint8_t pg = (uint8_t)(page_id / ZW111_INDEX_PAGE_BITS);
+  zw111_status_t ret = zw_index_ensure(dev, pg, pg);
+  if(ret == ZW111_STATUS_OK) *used = zw111_index_test(&dev->index, page_id);
+  return ret;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_index_rank_lazy(zw111_dev_t *dev, uint16_t page_id, uint16_t *rank){
+  if(dev == NULL || rank == NULL || dev->index.capacity == 0) return ZW111_STATUS_ERROR;
+  if(page_id > dev->index.capacity) page_id = dev->index.capacity;
+
+  /* Trang chua PageID `page_id - 1` la trang cuoi can biet */
+  if(page_id > 0){
+      zw111_status_t ret = zw_index_ensure(dev, 0, (uint8_t)((page_id - 1u) / ZW111_INDEX_PAGE_BITS));
+      if(ret != ZW111_STATUS_OK) return ret;
+  }
+  *rank = zw111_index_rank(&dev->index, page_id);
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_index_select_lazy(zw111_dev_t *dev, uint16_t k, uint16_t *page_id){
+  if(dev == NULL || page_id == NULL || dev->index.capacity == 0) return ZW111_STATUS_ERROR;
+
+  /* Nap tung trang tu dau cho den khi cac trang da nap lien tiep chua du k + 1 template */
+  uint32_t seen = 0;
+  uint8_t pages = zw111_index_page_count(&dev->index);
+  for(uint8_t pg = 0; pg < pages; pg++){
+      zw111_status_t ret = zw_index_ensure(dev, pg, pg);
+      if(ret != ZW111_STATUS_OK) return ret;
+      seen += dev->index.page_used[pg];
+      if(seen > k) break;
+  }
+  if(seen <= k) return ZW111_STATUS_ERROR;
+  return zw111_index_select(&dev->index, k, page_id) ? ZW111_STATUS_OK : ZW111_STATUS_ERROR;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_read_notepad(zw111_dev_t *dev, uint8_t page_no, uint8_t *content){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_read_notepad_async(dev, &op, page_no, content, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_write_notepad(zw111_dev_t *dev, uint8_t page_no, const uint8_t *content){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_write_notepad_async(dev, &op, page_no, content, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_meta_load(zw111_dev_t *dev, zw111_meta_t *m){
+  if(dev == NULL || m == NULL) return ZW111_STATUS_ERROR;
+
+  zw111_meta_init(m);
+  zw111_status_t ret = zw111_read_notepad(dev, 0, m->shadow[0]);
   if(ret != ZW111_STATUS_OK) return ret;
+  m->shadow_valid = 1u;
+
+  uint8_t pages;
+  uint32_t crc_rec;
+  if(!zw111_meta_decode_header(m, m->shadow[0], &pages, &crc_rec)) return ZW111_STATUS_ERROR; // NotePad trong/du lieu khac
+
+  zw111_index_t *idx = &dev->index;
+  zw111_index_reset(idx, m->capacity);
+
+  uint32_t crc = 0;
+  for(uint8_t pg = 1; pg < pages; pg++){
+      ret = zw111_read_notepad(dev, pg, m->shadow[pg]);
+      if(ret != ZW111_STATUS_OK) break;
+      m->shadow_valid |= (uint16_t)(1u << pg);
+      crc = zw111_crc32(crc, m->shadow[pg], ZW111_META_PAGE_SIZE);
+      zw111_meta_decode_page(m, idx, pg, m->shadow[pg]);
+  }
+  if(ret == ZW111_STATUS_OK &&
+     (zw111_meta_header_crc(crc, m->shadow[0]) != crc_rec || idx->count != m->template_count)) ret = ZW111_STATUS_ERROR;
+
+  if(ret != ZW111_STATUS_OK){
+      /* Record hong (vd mat nguon giua flush) -> khong dung bitmap/bang hit nua doi */
+      zw111_index_reset(idx, m->capacity);
+      m->hot_count = 0;
+      return ret;
+  }
+
+  idx->valid = true;
+  if(m->packet_size <= ZW111_PKT_SIZE_256) zw111_ll_set_packet_size(dev, (zw111_packet_size_t)m->packet_size);
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
 
-  // Anh xa lai ket qua ACK
-  ret = zw_map_ack_to_status(ack);
+zw111_status_t zw111_meta_flush(zw111_dev_t *dev, zw111_meta_t *m, bool force){
+  if(dev == NULL || m == NULL) return ZW111_STATUS_ERROR;
+  if(!force && zw111_meta_next_flush_ms(m, zw111_ll_get_ticks()) != 0) return ZW111_STATUS_OK;
+
+  const zw111_index_t *idx = &dev->index;
+  if(!idx->valid) return ZW111_STATUS_ERROR;
+
+  /* Anh chup trang thai hien tai cua driver */
+  uint16_t pkt_bytes = (dev->pkt_bytes != 0) ? dev->pkt_bytes : 128u; // 128 bytes: packet size mac dinh cua module
+  uint8_t pkt = 0;
+  while(pkt < ZW111_PKT_SIZE_256 && ZW111_PKT_SIZE_BYTES(pkt) < pkt_bytes) pkt++;
+  m->capacity = idx->capacity;
+  m->template_count = idx->count;
+  m->occupancy_digest = zw111_meta_occupancy_digest(idx);
+  m->baud_mult = (uint8_t)(dev->baud / 9600u);
+  m->packet_size = pkt;
+  zw111_meta_prune_hot(m, idx);
+
+  uint8_t pages = zw111_meta_page_count(m, idx);
+  uint8_t buf[ZW111_META_PAGE_SIZE];
+  uint32_t crc = 0;
+  bool changed = false;
+
+  for(uint8_t pg = 1; pg < pages; pg++){
+      zw111_meta_encode_page(m, idx, pg, buf);
+      crc = zw111_crc32(crc, buf, ZW111_META_PAGE_SIZE);
+      if((m->shadow_valid & (1u << pg)) && memcmp(m->shadow[pg], buf, ZW111_META_PAGE_SIZE) == 0){
+          m->stats.pages_skipped++;
+          continue;
+      }
+
+      /* Trang dang ghi khong con khop cho den khi ACK OK */
+      m->shadow_valid &= (uint16_t)~(1u << pg);
+      zw111_status_t ret = zw111_write_notepad(dev, pg, buf);
+      if(ret != ZW111_STATUS_OK) return ret;
+      memcpy(m->shadow[pg], buf, ZW111_META_PAGE_SIZE);
+      m->shadow_valid |= (uint16_t)(1u << pg);
+      m->stats.pages_written++;
+      changed = true;
+  }
+
+  /* Header cung noi dung (ke ca seq) -> record tren cam bien da dung, khong ghi */
+  zw111_meta_encode_header(m, pages, crc, buf);
+  if(!changed && (m->shadow_valid & 1u) && memcmp(m->shadow[0], buf, ZW111_META_PAGE_SIZE) == 0){
+      m->stats.pages_skipped++;
+      m->dirty = 0;
+      return ZW111_STATUS_OK;
+  }
+
+  m->seq++;
+  zw111_meta_encode_header(m, pages, crc, buf);
+  m->shadow_valid &= (uint16_t)~1u;
+  zw111_status_t ret = zw111_write_notepad(dev, 0, buf);
   if(ret != ZW111_STATUS_OK) return ret;
+  memcpy(m->shadow[0], buf, ZW111_META_PAGE_SIZE);
+  m->shadow_valid |= 1u;
+  m->stats.pages_written++;
+  m->stats.flushes++;
+  m->dirty = 0;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_get_valid_template_count(zw111_dev_t *dev, uint16_t *count){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_get_valid_template_count_async(dev, &op, count, NULL, NULL));
+}
+
+/* --------- TEMPLATE TRANSFER ---------  */
+
+zw111_status_t zw111_upload_char(zw111_dev_t *dev, zw111_charbuffer_t buf, zw111_data_sink_t sink, void *ctx, zw111_xfer_stats_t *stats){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_upload_char_async(dev, &op, buf, sink, ctx, stats, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_upload_image(zw111_dev_t *dev, zw111_data_sink_t sink, void *ctx, zw111_image_info_t *info, zw111_xfer_stats_t *stats){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_upload_image_async(dev, &op, sink, ctx, info, stats, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_sink_ringbuf(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  (void)last;
+  zw111_ringbuf_t *rb = (zw111_ringbuf_t *)ctx;
+  if(rb == NULL || zw111_rb_free(rb) < len) return false; // Khong ghi nua Packet
+  return zw111_rb_write(rb, data, len) == len;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_download_char(zw111_dev_t *dev, zw111_charbuffer_t buf, zw111_data_source_t source, void *ctx, zw111_xfer_stats_t *stats){
+  zw111_op_t op;
+  zw111_status_t ret = zw_op_run(&op, zw111_download_char_async(dev, &op, buf, source, ctx, stats, NULL, NULL));
+
+  /* Source/UART loi giua chung (cam bien khong tu choi) -> cam bien van cho Data Packet, dua ve idle */
+  if(zw111_op_needs_cancel(&op)) (void)zw111_cancel(dev);
+  return ret;
+}
+
+/* ----------------------------------------------------------- */
 
-  // Gia tri Score tra ve (Sau Confirm code)
-  if(score){
-      if(ret_len < 2) return ZW111_STATUS_ERROR;
-      *score = read_u16_be(&ret_params[0]);
+uint16_t zw111_source_mem(void *ctx, uint8_t *buf, uint16_t max, bool *last){
+  zw111_mem_source_t *src = (zw111_mem_source_t *)ctx;
+  if(src == NULL || src->off > src->len){
+      *last = true;
+      return 0;
   }
-  return zw_map_ack_to_status(ack);
+
+  uint32_t remain = src->len - src->off;
+  uint16_t n = (remain > max) ? max : (uint16_t)remain;
+  memcpy(buf, &src->data[src->off], n);
+  src->off += n;
+  *last = (src->off == src->len);
+  return n;
 }
 
-/* --------- ENROLL FLOW ---------  */
+/* --------- SYSTEM & CONFIG ---------  */
+
+zw111_status_t zw111_read_sysinfo(zw111_dev_t *dev, zw111_sysinfo_t *info){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_read_sysinfo_async(dev, &op, info, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_set_new_chip_addr(zw111_dev_t *dev, uint32_t newAddr){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_set_new_chip_addr_async(dev, &op, newAddr, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_write_reg_1byte(zw111_dev_t *dev, zw111_reg_t reg_no, uint8_t content){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_write_reg_1byte_async(dev, &op, reg_no, content, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_set_baudrate(zw111_dev_t *dev, uint16_t multiplier){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_set_baudrate_async(dev, &op, multiplier, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_set_packet_size(zw111_dev_t *dev, zw111_packet_size_t size){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_set_packet_size_async(dev, &op, size, NULL, NULL));
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_set_security_level(zw111_dev_t *dev, zw111_match_threshold_t level){
+  zw111_op_t op;
+  return zw_op_run(&op, zw111_set_security_level_async(dev, &op, level, NULL, NULL));
+}
+
+/* --------- LINK TUNING ---------  */
+
+static const uint8_t s_baud_ladder[] = ZW111_BAUD_LADDER;
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Doi UART cua HOST sang 9600 * mult, cho on dinh roi xoa byte rac luc chuyen
+ */
+static zw111_status_t zw_link_switch(zw111_dev_t *dev, uint8_t mult){
+  uint32_t baud = 9600u * mult;
+  if(!zw111_port_uart_set_baud(&dev->port, baud)) return ZW111_STATUS_ERROR;
+  dev->baud = baud; // Timeout TX/Data Packet cua LowLevel tinh theo baud nay
+  zw111_port_delay_ms(ZW111_BAUD_SETTLE_MS);
+  return zw111_ll_flush_uart(dev);
+}
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_enroll_start(uint16_t page_id){
-  s_enroll_page_id_local = page_id;
+/**
+ * @brief 1 lan READ_SYS_PARA, he so baudrate cam bien bao ve phai khop `mult`
+ */
+static zw111_status_t zw_link_check(zw111_dev_t *dev, uint8_t mult){
+  zw111_sysinfo_t info;
+  zw111_status_t st = zw111_read_sysinfo(dev, &info);
+  if(st != ZW111_STATUS_OK) return st;
+  return (info.baudrate_multipler == mult) ? ZW111_STATUS_OK : ZW111_STATUS_PROTOCOL_ERR;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Burst kiem tra duong truyen: READ_SYS_PARA + ReadIndexTable + UpChar (nhieu byte co Checksum)
+ */
+static zw111_status_t zw_link_verify(zw111_dev_t *dev, uint8_t mult){
+  uint8_t table[ZW111_INDEX_PAGE_BYTES];
+
+  for(uint8_t r = 0; r < ZW111_BAUD_VERIFY_ROUNDS; r++){
+      zw111_status_t st = zw_link_check(dev, mult);
+      if(st != ZW111_STATUS_OK) return st;
+
+      st = zw111_read_index_table(dev, table, sizeof(table));
+      if(st != ZW111_STATUS_OK) return st;
+
+      st = zw111_upload_char(dev, ZW111_CHARBUFFER_1, NULL, NULL, NULL);
+      if(zw111_status_is_link_error(st)) return st;
+  }
   return ZW111_STATUS_OK;
 }
 
 /* ----------------------------------------------------------- */
 
 /**
- * @brief Ham lay pageID de phuc vu cho qua trinh enroll van tay
- * @note De la static de App Layer khong nhin thay, chi dung noi bo
- *
- * @return pageID muon Enroll
+ * @brief Duong truyen o `bad` khong on dinh: ra lenh quay ve `good` ngay tren duong truyen kem roi kiem tra o `good`
+ * @note Lenh co the da toi cam bien du ACK bi hong, nen luon kiem tra lai o `good` truoc khi thu tiep
  */
-static uint16_t zw111_get_enroll_pageid(void){
-  return s_enroll_page_id_local;
+static zw111_status_t zw_baud_fallback(zw111_dev_t *dev, uint8_t bad, uint8_t good){
+  zw111_status_t st = ZW111_STATUS_ERROR;
+
+  for(uint8_t i = 0; i < ZW111_BAUD_VERIFY_ROUNDS; i++){
+      if(zw_link_switch(dev, bad) != ZW111_STATUS_OK) return ZW111_STATUS_ERROR;
+      (void)zw111_set_baudrate(dev, good);
+
+      if(zw_link_switch(dev, good) != ZW111_STATUS_OK) return ZW111_STATUS_ERROR;
+      st = zw_link_check(dev, good);
+      if(st == ZW111_STATUS_OK) return st;
+  }
+  DEBUG_LOG(1, "[ZW111][BAUD] Fallback x%u -> x%u failed st=%d\r\n", bad, good, (int)st);
+  return st;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_enroll_step1(void){
-  /* Buoc 1: GetImage + GenChar (CharBuffer1) */
-  zw111_status_t ret = zw111_get_image();
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_negotiate_baud(zw111_dev_t *dev, uint8_t max_mult, uint8_t *best_mult){
+  if(dev == NULL || zw111_ll_txn_busy(dev)) return ZW111_STATUS_ERROR;
+  if(max_mult == 0 || max_mult > ZW111_BAUD_MULT_MAX) max_mult = ZW111_BAUD_MULT_MAX;
+
+  uint8_t good = (uint8_t)(dev->baud / 9600u);
+  zw111_status_t st = zw_link_verify(dev, good); // Baud ban dau phai on dinh moi dam phan
+  if(st != ZW111_STATUS_OK) return st;
+
+  for(uint8_t i = 0; i < sizeof(s_baud_ladder); i++){
+      uint8_t m = s_baud_ladder[i];
+      if(m <= good || m > max_mult) continue;
 
-  return zw111_gen_char(ZW111_CHARBUFFER_1);
+      /* HOST khong chay duoc baud nay -> bo qua truoc khi ra lenh cho cam bien */
+      if(!zw111_port_uart_set_baud(&dev->port, 9600u * m)) continue;
+      if(!zw111_port_uart_set_baud(&dev->port, 9600u * good)) return ZW111_STATUS_ERROR;
+
+      st = zw111_set_baudrate(dev, m);
+      if(st != ZW111_STATUS_OK){
+          /* ACK hong o baud cu: khong biet cam bien da doi hay chua -> dam bao dang o `good` */
+          if(zw111_status_is_link_error(st) && zw_baud_fallback(dev, m, good) != ZW111_STATUS_OK) return st;
+          break;
+      }
+
+      st = zw_link_switch(dev, m);
+      if(st == ZW111_STATUS_OK) st = zw_link_verify(dev, m);
+      if(st != ZW111_STATUS_OK){
+          DEBUG_LOG(1, "[ZW111][BAUD] x%u unstable (st=%d), fall back to x%u\r\n", m, (int)st, good);
+          st = zw_baud_fallback(dev, m, good);
+          if(st != ZW111_STATUS_OK) return st;
+          break;
+      }
+      good = m;
+  }
+
+  if(best_mult) *best_mult = good;
+  return ZW111_STATUS_OK;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_enroll_step2(void){
-  /* Buoc 2: GetImage + GenChar (CharBuffer2) + RegModel (merge) */
-  /* Sau khi co duoc feature file qua GenChar trong CharBuffer1 va CharBuffer2 thi thuc hien
-   * merge cac feature file voi nhau de tao ra Template file, ket qua lai duoc luu trong CB1 va CB2 */
-  zw111_status_t ret = zw111_get_image();
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_probe_baud(zw111_dev_t *dev, uint8_t *mult){
+  if(dev == NULL || zw111_ll_txn_busy(dev)) return ZW111_STATUS_ERROR;
 
-  ret = zw111_gen_char(ZW111_CHARBUFFER_2);
-  if(ret != ZW111_STATUS_OK) return ret;
+  for(uint8_t i = sizeof(s_baud_ladder); i > 0; i--){
+      uint8_t m = s_baud_ladder[i - 1u];
+      if(zw_link_switch(dev, m) != ZW111_STATUS_OK) continue;
+      if(zw_link_check(dev, m) == ZW111_STATUS_OK){
+          if(mult) *mult = m;
+          return ZW111_STATUS_OK;
+      }
+  }
+  return ZW111_STATUS_TIMEOUT;
+}
 
-  zw111_ack_t ack = 0;
+/* ----------------------------------------------------------- */
 
-  // Command RegModel khong co Param gui di
-  // ACK phan hoi cung khong co return param
-  ret = zw111_ll_cmd_with_ack(ZW111_CMD_REG_MODEL, NULL, 0, &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* Context cua sink so sanh du lieu UpChar voi template da DownChar */
+typedef struct {
+  const uint8_t *ref;
+  uint32_t len;
+  uint32_t off;
+} zw_tune_cmp_t;
+
+/* ----------------------------------------------------------- */
+
+static bool zw_tune_cmp_sink(void *ctx, const uint8_t *data, uint16_t len, bool last){
+  zw_tune_cmp_t *c = (zw_tune_cmp_t *)ctx;
+  if(len > c->len - c->off || memcmp(&c->ref[c->off], data, len) != 0) return false; // Doc lai sai -> huy upload
+  c->off += len;
+  return !last || c->off == c->len;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief 1 vong DownChar + UpChar o packet size hien tai
+ * @param[out] ms Thoi gian ca vong
+ */
+static zw111_status_t zw_tune_round(zw111_dev_t *dev, const uint8_t *tpl, uint16_t tpl_len, uint32_t *ms){
+  zw111_mem_source_t src = { .data = tpl, .len = tpl_len, .off = 0 };
+  zw_tune_cmp_t cmp = { .ref = tpl, .len = tpl_len, .off = 0 };
+  uint32_t t0 = zw111_ll_get_ticks();
+
+  zw111_status_t st = zw111_download_char(dev, ZW111_CHARBUFFER_1, zw111_source_mem, &src, NULL);
+  if(st == ZW111_STATUS_OK) st = zw111_upload_char(dev, ZW111_CHARBUFFER_1, zw_tune_cmp_sink, &cmp, NULL);
+  if(st == ZW111_STATUS_OK && cmp.off != tpl_len) st = ZW111_STATUS_PROTOCOL_ERR;
+
+  *ms = zw111_ll_get_ticks() - t0;
+  return st;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_tune_packet_size(zw111_dev_t *dev, const uint8_t *tpl, uint16_t tpl_len, zw111_pkt_tune_t *result){
+  if(dev == NULL || tpl == NULL || tpl_len == 0 || zw111_ll_txn_busy(dev)) return ZW111_STATUS_ERROR;
+
+  zw111_pkt_tune_t res;
+  memset(&res, 0, sizeof(res));
+
+  zw111_sysinfo_t info;
+  zw111_status_t st = zw111_read_sysinfo(dev, &info); // Packet size ban dau (tra lai neu khong size nao sach)
+  if(st != ZW111_STATUS_OK) return st;
+
+  uint32_t best_bps = 0;
+  res.best = info.packet_size;
+
+  for(uint8_t s = ZW111_PKT_SIZE_32; s <= ZW111_PKT_SIZE_256; s++){
+      if(ZW111_PKT_SIZE_BYTES(s) > ZW111_MAX_DATA_LEN) break;
+
+      if(zw111_set_packet_size(dev, (zw111_packet_size_t)s) != ZW111_STATUS_OK){
+          res.errors[s]++;
+          continue;
+      }
+
+      uint32_t total_ms = 0;
+      for(uint8_t r = 0; r < ZW111_PKT_TUNE_ROUNDS; r++){
+          uint32_t ms;
+          if(zw_tune_round(dev, tpl, tpl_len, &ms) != ZW111_STATUS_OK) res.errors[s]++;
+          total_ms += ms;
+      }
+      if(res.errors[s] != 0) continue;
+
+      if(total_ms == 0) total_ms = 1;
+      res.bytes_per_sec[s] = (uint32_t)(((uint64_t)tpl_len * 2u * ZW111_PKT_TUNE_ROUNDS * 1000u) / total_ms);
+      DEBUG_LOG(1, "[ZW111][PKT] %u bytes: %lu B/s\r\n", (unsigned)ZW111_PKT_SIZE_BYTES(s), (unsigned long)res.bytes_per_sec[s]);
+
+      if(res.bytes_per_sec[s] > best_bps){
+          best_bps = res.bytes_per_sec[s];
+          res.best = (zw111_packet_size_t)s;
+      }
+  }
+
+  /* Chot packet size tot nhat (hoac tra lai ban dau), xac nhan bang ReadSysPara */
+  uint32_t ms;
+  st = zw111_set_packet_size(dev, res.best);
+  if(st == ZW111_STATUS_OK) st = zw111_read_sysinfo(dev, &info);
+  if(st == ZW111_STATUS_OK && info.packet_size != res.best) st = ZW111_STATUS_PROTOCOL_ERR;
+  if(st == ZW111_STATUS_OK) st = zw_tune_round(dev, tpl, tpl_len, &ms); // CharBuffer1 = tpl
+  if(st == ZW111_STATUS_OK && best_bps == 0) st = ZW111_STATUS_PROTOCOL_ERR;
+
+  if(result) *result = res;
+  return st;
+}
+
+/* --------- ASYNC API ---------  */
+
+bool zw111_process(zw111_dev_t *dev){
+  return zw111_ll_txn_process(dev);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_cancel(zw111_dev_t *dev){
+  return zw111_ll_cancel(dev);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_op_wait(zw111_op_t *op){
+  if(op == NULL || op->dev == NULL) return ZW111_STATUS_ERROR;
+
+  while(!op->done){
+      bool busy = zw111_process(op->dev);
+      if(op->done) break;
+      if(!busy) return ZW111_STATUS_ERROR; // Hang doi rong ma op chua xong -> chua tung duoc submit
+      (void)zw111_port_uart_rx_wait(&op->dev->port, 1); // Nhuong CPU thay vi spin
+  }
+  return op->status;
+}
 
-  return zw_map_ack_to_status(ack);
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_set_password_async(zw111_dev_t *dev, zw111_op_t *op, uint32_t new_pwd, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  uint8_t len = zw111_cmd_enc_set_pwd(op->txn.params, new_pwd); // 4 bytes password dau vao can thay doi
+
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user);
+  return zw_op_submit(op, ZW111_CMD_SET_PWD, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_verify_password_async(zw111_dev_t *dev, zw111_op_t *op, uint32_t pwd, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  uint8_t len = zw111_cmd_enc_verify_pwd(op->txn.params, pwd); // Password dau vao can xac thuc (4 bytes)
+
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user);
+  return zw_op_submit(op, ZW111_CMD_VERIFY_PWD, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_get_image_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user);
+  return zw_op_submit(op, ZW111_CMD_GET_IMAGE, NULL, 0, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_gen_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  uint8_t len = zw111_cmd_enc_gen_char(op->txn.params, (uint8_t)buf); // Tham so cho lenh (TX) la BufferID
+
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user);
+  return zw_op_submit(op, ZW111_CMD_GEN_CHAR, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_search_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, uint16_t start, uint16_t count,
+                                  zw111_match_result_t *result, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || result == NULL) return ZW111_STATUS_ERROR;
+
+  /* Params cua lenh Search can gui di: BufferID (1 bytes) + Param StartPage (2 bytes) + Param PageNum (2 bytes) = 5 bytes */
+  uint8_t len = zw111_cmd_enc_search(op->txn.params, (uint8_t)buf, start, count);
+
+  zw_op_begin(dev, op, ZW111_OP_SEARCH, cb, user);
+  op->out = result;
+  return zw_op_submit(op, ZW111_CMD_SEARCH, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_load_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, uint16_t page_id, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || page_id == 0xFFFF) return ZW111_STATUS_ERROR;
+
+  /* Params Cmd Packet: BufferID (1) + PageID (2) = 3 bytes */
+  uint8_t len = zw111_cmd_enc_load_char(op->txn.params, (uint8_t)buf, page_id);
+
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user); // Khong co Return params
+  return zw_op_submit(op, ZW111_CMD_LOAD_CHAR, op->txn.params, len, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_enroll_store(void){
-  uint16_t page_id = zw111_get_enroll_pageid();
+zw111_status_t zw111_match_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t *score, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  /* PS_Match: ACK co the tra ve score (2 bytes) - theo datasheet */
+  zw_op_begin(dev, op, ZW111_OP_MATCH, cb, user);
+  op->out = score;
+
+  // Command MATCH khong co Parameter gui di
+  return zw_op_submit(op, ZW111_CMD_MATCH, NULL, 0, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_identify_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t start, uint16_t count,
+                                    zw111_identify_result_t *result, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || result == NULL) return ZW111_STATUS_ERROR;
+
+  /* Khoi tao truoc moi return som -> caller doc `stage`/`page_id` khong bao gio gap rac */
+  memset(result, 0, sizeof(*result));
+  result->stage = ZW111_ID_STAGE_GET_IMAGE;
+
+  /* Khoang Search lay tu bitmap index (span rong -> count = 0 -> dung sau GetImage) */
+  if(count == 0){
+      if(!dev->index.valid) return ZW111_STATUS_ERROR;
+      if(!zw111_index_span(&dev->index, &start, &count)) count = 0;
+  }
+
+  zw_op_begin(dev, op, ZW111_OP_IDENTIFY, cb, user);
+  op->out = result;
+  op->arg = ((uint32_t)start << 16) | count;
+  return zw_op_submit(op, ZW111_CMD_GET_IMAGE, NULL, 0, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_enroll_step1_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  zw_op_begin(dev, op, ZW111_OP_ENROLL_STEP1, cb, user);
+  return zw_op_submit(op, ZW111_CMD_GET_IMAGE, NULL, 0, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_enroll_step2_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  zw_op_begin(dev, op, ZW111_OP_ENROLL_STEP2, cb, user);
+  return zw_op_submit(op, ZW111_CMD_GET_IMAGE, NULL, 0, false);
+}
 
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_enroll_store_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+
+  uint16_t page_id = zw111_get_enroll_pageid(dev);
   if(page_id == 0xFFFF) return ZW111_STATUS_ERROR;
 
   /* StoreChar (Store Templates) luu template file trong CharBuffer1 vao PageID tai FLASH */
   /* Params Command: BufferID (1 byte) + LocationNum (2 bytes) = 3 bytes */
-  uint8_t p[3];
-  p[0] = (uint8_t)ZW111_CHARBUFFER_1;
-  write_u16_be(&p[1], page_id);
+  uint8_t len = zw111_cmd_enc_store_char(op->txn.params, (uint8_t)ZW111_CHARBUFFER_1, page_id);
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_STORE_CHAR, p, (uint8_t)sizeof(p), &ack); // Khong co Return Param
-  if(ret != ZW111_STATUS_OK) return ret;
+  zw_op_begin(dev, op, ZW111_OP_ENROLL_STORE, cb, user); // Khong co Return Param
+  return zw_op_submit(op, ZW111_CMD_STORE_CHAR, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
 
-  /* Reset enroll context sau khi da store xong */
-  s_enroll_page_id_local = 0xFFFF;
-  return zw_map_ack_to_status(ack);
+zw111_status_t zw111_delete_template_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t page_id, zw111_op_cb_t cb, void *user){
+  return zw111_delete_range_async(dev, op, page_id, 1, cb, user); /* Xoa 1 temaplate */
 }
 
+/* ----------------------------------------------------------- */
 
-/* --------- DATABASE MANAGEMENT ---------  */
+zw111_status_t zw111_delete_range_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t start, uint16_t count, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || count == 0) return ZW111_STATUS_ERROR;
 
-zw111_status_t zw111_delete_template(uint16_t page_id){
   /* PS_DeleteChar Params: PageID (2 bytes) + DeleteNum (2 bytes) = 4 bytes */
-  uint8_t p[4];
-  write_u16_be(&p[0], page_id);
-  write_u16_be(&p[2], 1); /* Xoa 1 temaplate */
-
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_DELETE_CHAR, p, (uint8_t)sizeof(p), &ack); // Khong co Return Param
-  if(ret != ZW111_STATUS_OK) return ret;
+  uint8_t len = zw111_cmd_enc_delete_char(op->txn.params, start, count);
 
-  return zw_map_ack_to_status(ack);
+  zw_op_begin(dev, op, ZW111_OP_DELETE, cb, user); // Khong co Return Param
+  op->arg = (uint32_t)start | ((uint32_t)count << 16);
+  return zw_op_submit(op, ZW111_CMD_DELETE_CHAR, op->txn.params, len, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_clear_database(void){
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_EMPTY, NULL, 0, &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_clear_database_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-  return zw_map_ack_to_status(ack);
+  zw_op_begin(dev, op, ZW111_OP_EMPTY, cb, user);
+  return zw_op_submit(op, ZW111_CMD_EMPTY, NULL, 0, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_read_index_table(uint8_t *table, uint8_t len){
-  if(table == NULL) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_read_index_table_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t *table, uint8_t len, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || table == NULL) return ZW111_STATUS_ERROR;
 
   /* PS_ReadIndexTable params: IndexPage (1 byte): Page 0/ Page 1
    * ACK tra ve 32 bytes index info
-   * Neu muon doc 2 page thi => len >= 64 va goi 2 lan */
+   * Neu muon doc 2 page thi => len >= 64 (page 1 duoc xep hang ngay sau page 0) */
+  if(len < ZW111_INDEX_PAGE_BYTES) return ZW111_STATUS_ERROR;
 
-  zw111_ack_t ack = 0;
-  uint16_t ret_len = 0;
+  zw_op_begin(dev, op, ZW111_OP_INDEX_TABLE, cb, user);
+  op->out = table;
+  op->out_len = len;
 
-  if(len < 32) return ZW111_STATUS_ERROR;
+  /* Page 0 (0 ~ 255) */
+  uint8_t plen = zw111_cmd_enc_read_index_table(op->txn.params, 0);
+  return zw_op_submit(op, ZW111_CMD_READ_INDEX_TABLE, op->txn.params, plen, false);
+}
 
-  {
-      /* Page 0 (0 ~ 255) */
-      uint8_t p[1] = {0};
-      uint8_t ret_param[32] = {0};
+/* ----------------------------------------------------------- */
 
-      // Gui command
-      zw111_status_t ret = zw111_ll_send_command_packet(ZW111_CMD_READ_INDEX_TABLE, p, 1);
-      if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_sync_index_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-      // Nhan ACK phan hoi + Return Param (Index Info) 32 bytes
-      ret = zw111_ll_receive_ack_packet_ver2(&ack, ret_param, &ret_len);
-      if(ret != ZW111_STATUS_OK) return ret;
+  /* Bitmap khong con dung cho den khi dong bo xong */
+  dev->index.valid = false;
 
-      ret = zw_map_ack_to_status(ack);
-      if(ret != ZW111_STATUS_OK) return ret;
+  zw_op_begin(dev, op, ZW111_OP_INDEX_SYNC, cb, user);
+  return zw_op_submit(op, ZW111_CMD_READ_SYS_PARA, NULL, 0, false);
+}
 
-      if(ret_len < 32) return ZW111_STATUS_ERROR;
-      memcpy(&table[0], ret_param, 32); // Copy qua table
-  }
+/* ----------------------------------------------------------- */
 
-  {
-    /* Page 1 (Optional) (256 ~ 511) */
-    if(len >= 64){
-        uint8_t p[1] = {1};
-        uint8_t ret_param[32] = {0};
+zw111_status_t zw111_index_open_async(zw111_dev_t *dev, zw111_op_t *op, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-        // Gui command
-        zw111_status_t ret = zw111_ll_send_command_packet(ZW111_CMD_READ_INDEX_TABLE, p, 1);
-        if(ret != ZW111_STATUS_OK) return ret;
+  dev->index.valid = false;
 
-        // Nhan ACK phan hoi + Return Param (Index Info) 32 bytes
-        ret = zw111_ll_receive_ack_packet_ver2(&ack, ret_param, &ret_len);
-        if(ret != ZW111_STATUS_OK) return ret;
+  /* Cung buoc 0 voi ZW111_OP_INDEX_SYNC, arg != 0 -> dung sau ReadSysPara */
+  zw_op_begin(dev, op, ZW111_OP_INDEX_SYNC, cb, user);
+  op->arg = 1;
+  return zw_op_submit(op, ZW111_CMD_READ_SYS_PARA, NULL, 0, false);
+}
 
-        ret = zw_map_ack_to_status(ack);
-        if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-        if(ret_len < 32) return ZW111_STATUS_ERROR;
-        memcpy(&table[32], ret_param, 32); // Copy qua table
-    }
-  }
+zw111_status_t zw111_index_fetch_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t page_no, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || page_no >= zw111_index_page_count(&dev->index)) return ZW111_STATUS_ERROR;
 
-  return ZW111_STATUS_OK;
+  zw_op_begin(dev, op, ZW111_OP_INDEX_PAGE, cb, user);
+  op->arg = page_no;
+  uint8_t len = zw111_cmd_enc_read_index_table(op->txn.params, page_no);
+  return zw_op_submit(op, ZW111_CMD_READ_INDEX_TABLE, op->txn.params, len, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_get_valid_template_count(uint16_t *count){
-  if(count == NULL) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_read_notepad_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t page_no, uint8_t *content, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || content == NULL || page_no >= ZW111_META_PAGES) return ZW111_STATUS_ERROR;
 
-  zw111_ack_t ack = 0;
-  uint8_t ret_param[4] = {0};
-  uint16_t ret_len = 0;
+  zw_op_begin(dev, op, ZW111_OP_NOTEPAD_READ, cb, user);
+  op->out = content;
+  op->out_len = ZW111_META_PAGE_SIZE;
+  uint8_t len = zw111_cmd_enc_read_note_pad(op->txn.params, page_no);
+  return zw_op_submit(op, ZW111_CMD_READ_NOTE_PAD, op->txn.params, len, false);
+}
 
-  zw111_status_t ret = zw111_ll_send_command_packet(ZW111_CMD_VALID_TEMPLATE, NULL, 0);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-  ret = zw111_ll_receive_ack_packet_ver2(&ack, ret_param, &ret_len);
-  if(ret != ZW111_STATUS_OK) return ret;
+zw111_status_t zw111_write_notepad_async(zw111_dev_t *dev, zw111_op_t *op, uint8_t page_no, const uint8_t *content, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || content == NULL || page_no >= ZW111_META_PAGES) return ZW111_STATUS_ERROR;
 
-  if(ret_len < 2) return ZW111_STATUS_ERROR;
-  *count = read_u16_be(&ret_param[0]);
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user);
+  uint8_t len = zw111_cmd_enc_write_note_pad(op->txn.params, page_no, content);
+  return zw_op_submit(op, ZW111_CMD_WRITE_NOTE_PAD, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_get_valid_template_count_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t *count, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || count == NULL) return ZW111_STATUS_ERROR;
 
-  return zw_map_ack_to_status(ack);
+  zw_op_begin(dev, op, ZW111_OP_TEMPLATE_COUNT, cb, user);
+  op->out = count;
+  return zw_op_submit(op, ZW111_CMD_VALID_TEMPLATE, NULL, 0, false);
 }
 
-/* --------- SYSTEM & CONFIG ---------  */
+/* ----------------------------------------------------------- */
 
-zw111_status_t zw111_read_sysinfo(zw111_sysinfo_t *info){
-  if(info == NULL) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_upload_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, zw111_data_sink_t sink, void *ctx,
+                                       zw111_xfer_stats_t *stats, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-  zw111_ack_t ack = 0;
-  uint8_t ret_param[32] = {0};
-  uint16_t ret_len = 0;
+  uint8_t len = zw111_cmd_enc_up_char(op->txn.params, (uint8_t)buf);
 
-  zw111_status_t ret = zw111_ll_send_command_packet(ZW111_CMD_READ_SYS_PARA, NULL, 0);
-  if(ret != ZW111_STATUS_OK) return ret;
+  zw_op_begin(dev, op, ZW111_OP_UPLOAD, cb, user);
+  op->out = stats;
 
-  ret = zw111_ll_receive_ack_packet_ver2(&ack, ret_param, &ret_len);
+  zw111_status_t ret = zw111_ll_txn_init(&op->txn, ZW111_CMD_UP_CHAR, op->txn.params, len, zw_op_on_txn_done, op);
   if(ret != ZW111_STATUS_OK) return ret;
+  zw111_ll_txn_set_sink(&op->txn, sink, ctx);
+  return zw111_ll_txn_submit(dev, &op->txn);
+}
 
-  ret = zw_map_ack_to_status(ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+/* ----------------------------------------------------------- */
 
-  /* Basic parameter table: 16 bytes theo datasheet */
-  if(ret_len < 16) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_download_char_async(zw111_dev_t *dev, zw111_op_t *op, zw111_charbuffer_t buf, zw111_data_source_t source, void *ctx,
+                                         zw111_xfer_stats_t *stats, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || source == NULL) return ZW111_STATUS_ERROR;
 
-  info->system_state = read_u16_be(&ret_param[0]); // 2 bytes (1 word)
-  info->sensor_type = read_u16_be(&ret_param[2]); // 2 bytes
-  info->database_capacity = read_u16_be(&ret_param[4]); // 2 bytes
-  info->security = (zw111_match_threshold_t)read_u16_be(&ret_param[6]); // 2 bytes
-  info->device_address = read_u32_be(&ret_param[8]); // 4 bytes (2 word)
-  info->packet_size = (zw111_packet_size_t)read_u16_be(&ret_param[10]); // 2 bytes
-  info->baudrate_multipler = read_u16_be(&ret_param[12]); // 2 bytes
+  uint8_t len = zw111_cmd_enc_down_char(op->txn.params, (uint8_t)buf);
 
-  return ZW111_STATUS_OK;
+  zw_op_begin(dev, op, ZW111_OP_DOWNLOAD, cb, user);
+  op->out = stats;
+
+  zw111_status_t ret = zw111_ll_txn_init(&op->txn, ZW111_CMD_DOWN_CHAR, op->txn.params, len, zw_op_on_txn_done, op);
+  if(ret != ZW111_STATUS_OK) return ret;
+  zw111_ll_txn_set_source(&op->txn, source, ctx);
+  return zw111_ll_txn_submit(dev, &op->txn);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_set_new_chip_addr(uint32_t newAddr){
-  /* Params Command: ChipAddress (4 bytes) */
-  uint8_t p[4];
-  write_u32_be(&p[0], newAddr);
+zw111_status_t zw111_upload_image_async(zw111_dev_t *dev, zw111_op_t *op, zw111_data_sink_t sink, void *ctx,
+                                        zw111_image_info_t *info, zw111_xfer_stats_t *stats, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_SET_CHIP_ADR, p, sizeof(p), &ack);
+  zw_op_begin(dev, op, ZW111_OP_UPLOAD_IMAGE, cb, user);
+  op->out = info;
+  op->out2 = stats;
+
+  zw111_status_t ret = zw111_ll_txn_init(&op->txn, ZW111_CMD_UP_IMAGE, NULL, 0, zw_op_on_txn_done, op);
   if(ret != ZW111_STATUS_OK) return ret;
+  zw111_ll_txn_set_sink(&op->txn, sink, ctx);
+  return zw111_ll_txn_submit(dev, &op->txn);
+}
+
+/* ----------------------------------------------------------- */
 
-  // Set lai dia chi moi vao bien static dang dung
-  zw111_ll_set_chip_address(newAddr);
+zw111_status_t zw111_read_sysinfo_async(zw111_dev_t *dev, zw111_op_t *op, zw111_sysinfo_t *info, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL || info == NULL) return ZW111_STATUS_ERROR;
 
-  return zw_map_ack_to_status(ack);
+  zw_op_begin(dev, op, ZW111_OP_SYSINFO, cb, user);
+  op->out = info;
+  return zw_op_submit(op, ZW111_CMD_READ_SYS_PARA, NULL, 0, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_write_reg_1byte(zw111_reg_t reg_no, uint8_t content){
-  uint8_t p[2];
-  p[0] = (uint8_t)reg_no;
-  p[1] = content;
+zw111_status_t zw111_set_new_chip_addr_async(zw111_dev_t *dev, zw111_op_t *op, uint32_t newAddr, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-  zw111_ack_t ack = 0;
-  zw111_status_t ret = zw111_ll_cmd_with_ack(ZW111_CMD_WRITE_REG, p, 2, &ack);
-  if(ret != ZW111_STATUS_OK) return ret;
+  /* Params Command: ChipAddress (4 bytes) */
+  uint8_t len = zw111_cmd_enc_set_chip_adr(op->txn.params, newAddr);
+
+  zw_op_begin(dev, op, ZW111_OP_SET_CHIP_ADDR, cb, user);
+  op->arg = newAddr;
+  return zw_op_submit(op, ZW111_CMD_SET_CHIP_ADR, op->txn.params, len, false);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_write_reg_1byte_async(zw111_dev_t *dev, zw111_op_t *op, zw111_reg_t reg_no, uint8_t content, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
 
-  return zw_map_ack_to_status(ack);
+  uint8_t len = zw111_cmd_enc_write_reg(op->txn.params, (uint8_t)reg_no, content);
+
+  zw_op_begin(dev, op, ZW111_OP_SIMPLE, cb, user);
+  return zw_op_submit(op, ZW111_CMD_WRITE_REG, op->txn.params, len, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_set_baudrate(uint16_t multiplier){
+zw111_status_t zw111_set_baudrate_async(zw111_dev_t *dev, zw111_op_t *op, uint16_t multiplier, zw111_op_cb_t cb, void *user){
   /* Datasheet: baud = 9600 * N, N la 1 byte */
   if(multiplier == 0 || multiplier > 255) return ZW111_STATUS_ERROR;
-  return zw111_write_reg_1byte(ZW111_REG_BAUDRATE, (uint8_t)multiplier);
+  return zw111_write_reg_1byte_async(dev, op, ZW111_REG_BAUDRATE, (uint8_t)multiplier, cb, user);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_set_packet_size(zw111_packet_size_t size){
-  if(size > ZW111_PKT_SIZE_256) return ZW111_STATUS_ERROR;
-  return zw111_write_reg_1byte(ZW111_REG_PKT_SIZE, (uint8_t)size);
+zw111_status_t zw111_set_packet_size_async(zw111_dev_t *dev, zw111_op_t *op, zw111_packet_size_t size, zw111_op_cb_t cb, void *user){
+  if(dev == NULL || op == NULL) return ZW111_STATUS_ERROR;
+  if(size > ZW111_PKT_SIZE_256 || ZW111_PKT_SIZE_BYTES(size) > ZW111_MAX_DATA_LEN) return ZW111_STATUS_ERROR;
+
+  uint8_t len = zw111_cmd_enc_write_reg(op->txn.params, (uint8_t)ZW111_REG_PKT_SIZE, (uint8_t)size);
+
+  zw_op_begin(dev, op, ZW111_OP_SET_PKT_SIZE, cb, user);
+  op->arg = (uint32_t)size;
+  return zw_op_submit(op, ZW111_CMD_WRITE_REG, op->txn.params, len, false);
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_set_security_level(zw111_match_threshold_t level){
+zw111_status_t zw111_set_security_level_async(zw111_dev_t *dev, zw111_op_t *op, zw111_match_threshold_t level, zw111_op_cb_t cb, void *user){
   if(level < ZW111_MATCH_LEVEL_1 || level > ZW111_MATCH_LEVEL_5) return ZW111_STATUS_ERROR;
-  return zw111_write_reg_1byte(ZW111_REG_MATCH_THRESHOLD, (uint8_t)level);
+  return zw111_write_reg_1byte_async(dev, op, ZW111_REG_MATCH_THRESHOLD, (uint8_t)level, cb, user);
 }
 
 /* ----------------------------------------------------------- */
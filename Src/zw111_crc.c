@@ -0,0 +1,31 @@
+/*
+ * @file zw111_crc.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * CRC-32 (da thuc dao 0xEDB88320, init/xorout 0xFFFFFFFF)
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_crc.h"
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_crc32(uint32_t crc, const uint8_t *data, uint32_t len){
+  crc = ~crc;
+  for(uint32_t i = 0; i < len; i++){
+      crc ^= data[i];
+      for(uint8_t b = 0; b < 8u; b++) crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+  }
+  return ~crc;
+}
+
+/* ----------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
@@ -0,0 +1,319 @@
+/*
+ * @file zw111_index.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Bitmap chiem dung Template Database (cache tai MCU)
+ * Moi thao tac tim kiem chay theo tu 32-bit: bo qua ca tu rong/day bang 1 phep so sanh,
+ * vi tri bit dau tien lay bang `__builtin_ctz`, so template dem bang `__builtin_popcount`
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_index.h"
+#include "string.h"
+
+/**
+ * @brief Mask cac bit hop le (< capacity) cua tu thu `w`
+ */
+static uint32_t zw_index_valid_mask(const zw111_index_t *idx, uint16_t w){
+  uint32_t first = (uint32_t)w * 32u;
+  if(first + 32u <= idx->capacity) return 0xFFFFFFFFu;
+  if(first >= idx->capacity) return 0u;
+  return (1u << (idx->capacity - first)) - 1u;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Tim bit co gia tri `value` dau tien tu vi tri `from` (gioi han boi capacity)
+ * @return PageID, hoac idx->capacity neu khong tim thay
+ */
+static uint16_t zw_index_scan(const zw111_index_t *idx, uint16_t from, bool value){
+  if(from >= idx->capacity) return idx->capacity;
+
+  uint16_t w = (uint16_t)(from >> 5);
+  uint16_t w_end = (uint16_t)((idx->capacity + 31u) >> 5);
+  uint32_t word = value ? idx->words[w] : ~idx->words[w];
+  word &= zw_index_valid_mask(idx, w) & (0xFFFFFFFFu << (from & 31u)); // Bo bit truoc `from`
+
+  while(word == 0){
+      if(++w >= w_end) return idx->capacity;
+      word = (value ? idx->words[w] : ~idx->words[w]) & zw_index_valid_mask(idx, w);
+  }
+  return (uint16_t)(((uint32_t)w << 5) + (uint32_t)__builtin_ctz(word));
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_index_reset(zw111_index_t *idx, uint16_t capacity){
+  if(idx == NULL) return;
+
+  memset(idx->words, 0, sizeof(idx->words));
+  memset(idx->page_used, 0, sizeof(idx->page_used));
+  idx->capacity = (capacity > ZW111_INDEX_MAX_CAPACITY) ? (uint16_t)ZW111_INDEX_MAX_CAPACITY : capacity;
+  idx->count = 0;
+  idx->loaded = 0;
+  idx->valid = false;
+}
+
+/* ----------------------------------------------------------- */
+
+uint8_t zw111_index_page_count(const zw111_index_t *idx){
+  if(idx == NULL) return 0;
+  return (uint8_t)((idx->capacity + ZW111_INDEX_PAGE_BITS - 1u) / ZW111_INDEX_PAGE_BITS);
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_index_page_loaded(const zw111_index_t *idx, uint8_t page_no){
+  if(idx == NULL || page_no >= ZW111_INDEX_PAGES) return false;
+  return (idx->loaded >> page_no) & 1u;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Thay tu `w` bang `word`, cap nhat count + page_used
+ */
+static void zw_index_put_word(zw111_index_t *idx, uint16_t w, uint32_t word){
+  int16_t diff = (int16_t)((int16_t)__builtin_popcount(word) - (int16_t)__builtin_popcount(idx->words[w]));
+  idx->count = (uint16_t)(idx->count + diff);
+  idx->page_used[w / ZW111_INDEX_PAGE_WORDS] = (uint16_t)(idx->page_used[w / ZW111_INDEX_PAGE_WORDS] + diff);
+  idx->words[w] = word;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_index_load_page(zw111_index_t *idx, uint8_t page_no, const uint8_t *table){
+  if(idx == NULL || table == NULL || page_no >= ZW111_INDEX_PAGES) return;
+
+  /* 32 bytes (LSB truoc) -> 8 tu 32-bit little-endian */
+  uint16_t w0 = (uint16_t)((uint32_t)page_no * ZW111_INDEX_PAGE_WORDS);
+  for(uint16_t i = 0; i < ZW111_INDEX_PAGE_BYTES / 4u; i++){
+      uint16_t w = (uint16_t)(w0 + i);
+      if(w >= ZW111_INDEX_WORDS) break;
+
+      uint32_t word = (uint32_t)table[i * 4u]
+                    | ((uint32_t)table[i * 4u + 1u] << 8)
+                    | ((uint32_t)table[i * 4u + 2u] << 16)
+                    | ((uint32_t)table[i * 4u + 3u] << 24);
+      word &= zw_index_valid_mask(idx, w); // Bo bit ngoai capacity (trang cuoi)
+      zw_index_put_word(idx, w, word);
+  }
+  idx->loaded |= 1u << page_no;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_index_set(zw111_index_t *idx, uint16_t page_id, bool used){
+  if(idx == NULL || page_id >= idx->capacity) return;
+
+  uint32_t bit = 1u << (page_id & 31u);
+  uint16_t w = (uint16_t)(page_id >> 5);
+  zw_index_put_word(idx, w, used ? (idx->words[w] | bit) : (idx->words[w] & ~bit));
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_index_set_range(zw111_index_t *idx, uint16_t start, uint16_t count, bool used){
+  if(idx == NULL || start >= idx->capacity || count == 0) return;
+
+  uint32_t end = (uint32_t)start + count;
+  if(end > idx->capacity) end = idx->capacity;
+
+  for(uint32_t p = start; p < end; ){
+      uint16_t w = (uint16_t)(p >> 5);
+      uint32_t n = 32u - (p & 31u);
+      if(n > end - p) n = end - p;
+      uint32_t mask = ((n == 32u) ? 0xFFFFFFFFu : ((1u << n) - 1u)) << (p & 31u);
+
+      zw_index_put_word(idx, w, used ? (idx->words[w] | mask) : (idx->words[w] & ~mask));
+      p += n;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_index_test(const zw111_index_t *idx, uint16_t page_id){
+  if(idx == NULL || page_id >= idx->capacity) return false;
+  return (idx->words[page_id >> 5] >> (page_id & 31u)) & 1u;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_index_clear_all(zw111_index_t *idx){
+  if(idx == NULL) return;
+  memset(idx->words, 0, sizeof(idx->words));
+  memset(idx->page_used, 0, sizeof(idx->page_used));
+  idx->count = 0;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_index_find_first_free(const zw111_index_t *idx, uint16_t from, uint16_t *page_id){
+  if(idx == NULL || page_id == NULL || !idx->valid) return ZW111_STATUS_ERROR;
+  if(idx->count >= idx->capacity) return ZW111_STATUS_DB_FULL;
+
+  uint16_t p = zw_index_scan(idx, from, false);
+  if(p >= idx->capacity) return ZW111_STATUS_DB_FULL;
+
+  *page_id = p;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_index_next_range(const zw111_index_t *idx, uint16_t *cursor, uint16_t *start, uint16_t *count){
+  if(idx == NULL || cursor == NULL || start == NULL || count == NULL || !idx->valid) return false;
+
+  uint16_t s = zw_index_scan(idx, *cursor, true);   // Bit 1 dau tien = dau khoang
+  if(s >= idx->capacity){
+      *cursor = idx->capacity;
+      return false;
+  }
+  uint16_t e = zw_index_scan(idx, s, false);        // Bit 0 dau tien sau do = het khoang
+
+  *start = s;
+  *count = (uint16_t)(e - s);
+  *cursor = e;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/* Loai bit khi gop DeleteChar */
+enum {
+  ZW_INDEX_DEL_TARGET = 0,  /* Can xoa va (neu bitmap valid) dang co template */
+  ZW_INDEX_DEL_SKIP,        /* Khong phai TARGET */
+  ZW_INDEX_DEL_BLOCK        /* Co template nhung khong nam trong tap -> khong duoc xoa qua */
+};
+
+/**
+ * @brief Tim bit loai `kind` dau tien tu `from` (gioi han boi `limit`)
+ * @return PageID, hoac `limit` neu khong tim thay
+ */
+static uint16_t zw_index_del_scan(const zw111_index_t *idx, const uint32_t *req, uint16_t limit, uint16_t from, uint8_t kind){
+  if(from >= limit) return limit;
+
+  uint16_t w = (uint16_t)(from >> 5);
+  uint16_t w_end = (uint16_t)((limit + 31u) >> 5);
+  uint32_t keep = 0xFFFFFFFFu << (from & 31u);
+
+  for(;;){
+      uint32_t occ = idx->valid ? idx->words[w] : 0xFFFFFFFFu; // Chua valid -> coi moi PageID deu co template
+      uint32_t word = (kind == ZW_INDEX_DEL_BLOCK) ? (occ & ~req[w]) : (occ & req[w]);
+      if(kind == ZW_INDEX_DEL_SKIP) word = ~word;
+
+      uint32_t first = (uint32_t)w * 32u;
+      if(first + 32u > limit) word &= (1u << (limit - first)) - 1u;
+      word &= keep;
+      if(word != 0) return (uint16_t)(first + (uint32_t)__builtin_ctz(word));
+
+      if(++w >= w_end) return limit;
+      keep = 0xFFFFFFFFu;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_index_next_delete_run(const zw111_index_t *idx, const uint32_t *req, uint16_t *cursor, uint16_t *start, uint16_t *count){
+  if(idx == NULL || req == NULL || cursor == NULL || start == NULL || count == NULL) return false;
+
+  uint16_t limit = idx->capacity ? idx->capacity : (uint16_t)ZW111_INDEX_MAX_CAPACITY;
+  uint16_t s = zw_index_del_scan(idx, req, limit, *cursor, ZW_INDEX_DEL_TARGET);
+  if(s >= limit){
+      *cursor = limit;
+      return false;
+  }
+
+  /* Khong duoc vuot qua PageID co template ngoai tap */
+  uint16_t block = zw_index_del_scan(idx, req, limit, s, ZW_INDEX_DEL_BLOCK);
+  uint16_t end = s; // PageID sau TARGET cuoi cua lan xoa
+
+  for(;;){
+      end = zw_index_del_scan(idx, req, block, end, ZW_INDEX_DEL_SKIP);       // Het doan TARGET lien tiep
+      uint16_t next = zw_index_del_scan(idx, req, block, end, ZW_INDEX_DEL_TARGET);
+      if(next >= block || (uint16_t)(next - end) > ZW111_INDEX_DELETE_MAX_GAP) break;
+      end = next;                                                              // Noi qua khoang trong
+  }
+
+  *start = s;
+  *count = (uint16_t)(end - s);
+  *cursor = end;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_index_span(const zw111_index_t *idx, uint16_t *start, uint16_t *count){
+  if(idx == NULL || start == NULL || count == NULL || !idx->valid || idx->count == 0) return false;
+
+  uint16_t first = zw_index_scan(idx, 0, true);
+
+  /* Tu cuoi co bit 1 -> bit cao nhat bang clz */
+  uint16_t w = (uint16_t)((idx->capacity + 31u) >> 5);
+  while(w > 0 && idx->words[w - 1u] == 0) w--;
+  if(w == 0) return false;
+  uint16_t last = (uint16_t)(((uint32_t)(w - 1u) << 5) + 31u - (uint32_t)__builtin_clz(idx->words[w - 1u]));
+
+  *start = first;
+  *count = (uint16_t)(last - first + 1u);
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+uint16_t zw111_index_rank(const zw111_index_t *idx, uint16_t page_id){
+  if(idx == NULL) return 0;
+  if(page_id >= idx->capacity) return idx->count;
+
+  uint16_t rank = 0;
+  uint16_t pg = (uint16_t)(page_id / ZW111_INDEX_PAGE_BITS);
+  for(uint16_t i = 0; i < pg; i++) rank = (uint16_t)(rank + idx->page_used[i]);  // Ca trang Index Table
+
+  uint16_t w_end = (uint16_t)(page_id >> 5);
+  for(uint16_t w = (uint16_t)(pg * ZW111_INDEX_PAGE_WORDS); w < w_end; w++){       // Ca tu 32-bit
+      rank = (uint16_t)(rank + (uint16_t)__builtin_popcount(idx->words[w]));
+  }
+  if(page_id & 31u){                                                              // Phan tu cuoi
+      rank = (uint16_t)(rank + (uint16_t)__builtin_popcount(idx->words[w_end] & ((1u << (page_id & 31u)) - 1u)));
+  }
+  return rank;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_index_select(const zw111_index_t *idx, uint16_t k, uint16_t *page_id){
+  if(idx == NULL || page_id == NULL || k >= idx->count) return false;
+
+  /* Nhay theo trang Index Table, roi theo tu 32-bit */
+  uint16_t pg = 0;
+  while(pg < ZW111_INDEX_PAGES && k >= idx->page_used[pg]){
+      k = (uint16_t)(k - idx->page_used[pg]);
+      pg++;
+  }
+  if(pg >= ZW111_INDEX_PAGES) return false;
+
+  for(uint16_t w = (uint16_t)(pg * ZW111_INDEX_PAGE_WORDS); w < (pg + 1u) * ZW111_INDEX_PAGE_WORDS; w++){
+      uint32_t word = idx->words[w];
+      uint16_t n = (uint16_t)__builtin_popcount(word);
+      if(k >= n){
+          k = (uint16_t)(k - n);
+          continue;
+      }
+      while(k-- > 0) word &= word - 1u;  // Bo k bit 1 thap nhat
+      *page_id = (uint16_t)(((uint32_t)w << 5) + (uint32_t)__builtin_ctz(word));
+      return true;
+  }
+  return false;
+}
+
+/* ----------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
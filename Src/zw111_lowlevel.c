@@ -10,8 +10,18 @@ extern "C" {
 #endif // __cplusplus
 
 #include "zw111_lowlevel.h"
-
-static uint32_t s_chip_default_addr = ZW111_DEFAULT_ADDRESS;
+#include "string.h"
+
+/* Hook thong ke latency: bien mat hoan toan khi ZW111_LL_STATS = 0 */
+#if ZW111_LL_STATS
+#define LL_STATS_BEGIN(dev, c)    do { (dev)->stamp.cmd = (c); (dev)->stamp.tx_kick = zw111_ll_get_ticks(); } while(0)
+#define LL_STATS_STAMP(dev, fld)  do { (dev)->stamp.fld = zw111_ll_get_ticks(); } while(0)
+#define LL_STATS_END(dev, to)     zw111_stats_record((dev)->stats, &(dev)->stamp, zw111_ll_get_ticks(), (to))
+#else
+#define LL_STATS_BEGIN(dev, c)    ((void)0)
+#define LL_STATS_STAMP(dev, fld)  ((void)0)
+#define LL_STATS_END(dev, to)     ((void)0)
+#endif // ZW111_LL_STATS
 
 // =============== STATIC INLINE HELPER FUNCTION DEFINITION ===============
 
@@ -64,18 +74,22 @@ static inline uint16_t read_checksum_tail_be(const uint8_t *payload, uint16_t pa
  * @brief Tra ve dia chi hien tai dang dung cua module cam bien
  * @return Dia chi hien tai (32-bit) dang su dung (mac dinh hoac sau khi gan cai moi)
  */
-static inline uint32_t zw111_ll_get_chip_address(void){
-  return s_chip_default_addr;
+static inline uint32_t zw111_ll_get_chip_address(const zw111_dev_t *dev){
+  return dev->chip_addr;
 }
 
-// =============== PROTOTYPE FUNCTION DEFINITION ===============
-
-/* ==================== PACKET TRANSMIT ==================== */
-
-zw111_status_t zw111_ll_send_command_packet(zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len){
-  if(!cmd) return ZW111_STATUS_ERROR;
+/* ----------------------------------------------------------- */
 
-  uint8_t tx_buf[64]; // Buffer chua Command Packet can gui (theo byte)
+/**
+ * @brief Dong goi Command Packet vao buffer (khong gui)
+ *
+ * @remark Packet Format:
+ *   [Header][Address][PID][Length][Instruction][Params...][Checksum]
+ *
+ * @param tx_buf Buffer dich (du cho ZW111_HDR_LEN + 1 + param_len + 2 bytes)
+ * @return So byte cua Packet
+ */
+static uint16_t ll_build_command_packet(const zw111_dev_t *dev, uint8_t *tx_buf, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len){
   uint16_t idx = 0;
 
   /* Header */
@@ -83,7 +97,7 @@ zw111_status_t zw111_ll_send_command_packet(zw111_cmd_t cmd, const uint8_t *para
   idx += 2; // Cong 2 byte
 
   /* Chip Address */
-  write_u32_be(&tx_buf[idx], zw111_ll_get_chip_address());
+  write_u32_be(&tx_buf[idx], zw111_ll_get_chip_address(dev));
   idx += 4;     // Cong 4 byte
 
   /* Packet Flag (PID) */
@@ -111,52 +125,368 @@ zw111_status_t zw111_ll_send_command_packet(zw111_cmd_t cmd, const uint8_t *para
   write_u16_be(&tx_buf[idx], checksum_len);
   idx += 2; // Cong 2 bytes checksum vao cuoi Packet
 
-  /* Gui Command Packet vao UART */
-  if(!zw111_port_uart_tx(tx_buf, idx)) return ZW111_STATUS_ERROR;
+  return idx;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Dong goi Data/End Packet quanh Data da nam san tai `frame[ZW111_HDR_LEN]` (khong copy Data)
+ *
+ * @remark Packet Format:
+ *   [Header][Address][PID][Length][Data...][Checksum]
+ *
+ * @param frame Buffer du cho ZW111_HDR_LEN + data_len + 2 bytes
+ * @return So byte cua Packet
+ */
+static uint16_t ll_build_data_packet(const zw111_dev_t *dev, uint8_t *frame, uint16_t data_len, bool last){
+  write_u16_be(&frame[0], ZW111_PKT_HEADER);
+  write_u32_be(&frame[2], zw111_ll_get_chip_address(dev));
+  frame[6] = last ? ZW111_PID_END : ZW111_PID_DATA;
 
-  /* Cho TX xong (timeout ngan) */
-  return wait_tx_done(200);
+  /* Gia tri Packet Length = Data + Checksum (2) (khong tinh byte cua Packet Length) */
+  uint16_t payload_len = data_len + ZW111_CHECKSUM_SIZE_BYTES;
+  write_u16_be(&frame[7], payload_len);
+
+  /* Gia tri Checksum = Tu Packet Flag -> last payload byte (Packet Flag (1) + Packet Length (2) + Data) (khong tinh Checksum) */
+  uint16_t checksum_len = zw111_ll_calc_checksum(&frame[6], payload_len + ZW111_PACKET_FLAG_BYTES);
+  write_u16_be(&frame[ZW111_HDR_LEN + data_len], checksum_len);
+
+  return ZW111_HDR_LEN + data_len + ZW111_CHECKSUM_SIZE_BYTES;
 }
 
 /* ----------------------------------------------------------- */
 
-__attribute__((unused)) zw111_status_t zw111_ll_send_data_packet(const uint8_t *data, uint16_t data_len, uint8_t is_last){
-  uint8_t tx_buf[300];  // Buffer chua Data Packet can gui(thep Bytes)
-  uint16_t idx = 0;
+/**
+ * @brief Lay frame tiep theo tu byte RX dang co san (khong block)
+ * @return true neu co frame hop le (`*frame` tro vao parser noi bo)
+ */
+static bool ll_poll_frame(zw111_dev_t *dev, const zw111_ll_frame_t **frame){
+  for(;;){
+      /* Feed cac byte con ton trong buffer trung gian truoc */
+      while(dev->rx_stage_pos < dev->rx_stage_len){
+#if ZW111_LL_STATS
+          /* Byte 0xEF dau Header -> moc byte dau tien cua frame */
+          if(dev->parser.state == ZW111_PARSER_WAIT_HDR_HI && dev->rx_stage[dev->rx_stage_pos] == (uint8_t)(ZW111_PKT_HEADER >> 8)){
+              LL_STATS_STAMP(dev, rx_first);
+          }
+#endif // ZW111_LL_STATS
+          zw111_parse_result_t r = zw111_ll_parser_feed(&dev->parser, dev->rx_stage[dev->rx_stage_pos++]);
+          if(r == ZW111_PARSE_FRAME){
+              *frame = &dev->parser.frame;
+              return true;
+          }
+          if(r == ZW111_PARSE_ERROR){
+              DEBUG_LOG(1, "[LOWLEVEL] Drop bad frame (bad_sum=%lu bad_len=%lu)\r\n",
+                        (unsigned long)dev->parser.bad_checksum, (unsigned long)dev->parser.bad_length);
+          }
+      }
 
-  /* Header */
-  write_u16_be(&tx_buf[idx], ZW111_PKT_HEADER);
-  idx += 2; // Cong 2 byte
+      /* Lay them byte tu ring buffer cua Port */
+      dev->rx_stage_pos = 0;
+      dev->rx_stage_len = zw111_port_uart_rx_read(&dev->port, dev->rx_stage, (uint16_t)sizeof(dev->rx_stage));
+      if(dev->rx_stage_len == 0) return false;
+  }
+}
 
-  /* Chip Address */
-  write_u32_be(&tx_buf[idx], zw111_ll_get_chip_address());
-  idx += 4;     // Cong 4 byte
+/* ----------------------------------------------------------- */
 
-  /* Packet Flag (PID) */
-  tx_buf[idx++] = is_last ? ZW111_PID_END : ZW111_PID_DATA; // Cong vao 1 byte
+/**
+ * @brief Bang descriptor theo lenh, sinh tu ZW111_CMD_TABLE (slot = Instruction Code, CANCEL o slot cuoi)
+ * @note Slot khong co lenh de {0} -> zw111_ll_cmd_desc() tra ve NULL
+ */
+#define LL_CMD_DESC_ENTRY(CMD, name, xfer_, exp_ms, tmo_ms, page_us) \
+  [ZW111_CMD_SLOT_OF(ZW111_CMD_##CMD)] = { \
+    .param_len = (uint8_t)ZW111_CMD_PARAM_LEN_##CMD, \
+    .ret_len = (uint8_t)ZW111_CMD_RET_LEN_##CMD, \
+    .xfer = (xfer_), \
+    .profile = { (exp_ms), (tmo_ms), (page_us) } \
+  },
 
-  /* Gia tri Packet Length = Data + Checksum (2) (khong tinh byte cua Packet Length) */
-  uint16_t payload_len = data_len + ZW111_CHECKSUM_SIZE_BYTES; // Gia tri bieu dien
-  write_u16_be(&tx_buf[idx], payload_len);
-  idx += 2; // Cong vao 2 bytes
+static const zw111_cmd_desc_t s_cmd_desc[ZW111_CMD_SLOTS] = {
+  ZW111_CMD_TABLE(LL_CMD_DESC_ENTRY)
+};
+
+/* Bo cuc cua moi lenh phai vua buffer cua transaction */
+#define LL_CMD_LEN_CHECK(CMD, name, xfer_, exp_ms, tmo_ms, page_us) \
+  _Static_assert(ZW111_CMD_PARAM_LEN_##CMD <= ZW111_TXN_MAX_PARAMS, "Params cua ZW111_CMD_" #CMD " vuot ZW111_TXN_MAX_PARAMS"); \
+  _Static_assert(ZW111_CMD_RET_LEN_##CMD <= ZW111_TXN_MAX_RET, "Return Params cua ZW111_CMD_" #CMD " vuot ZW111_TXN_MAX_RET");
+
+ZW111_CMD_TABLE(LL_CMD_LEN_CHECK)
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Thoi gian toi da de TX xong 1 Packet `len` bytes (10 bit/byte) theo baud hien tai
+ */
+static inline uint32_t ll_tx_timeout_ms(const zw111_dev_t *dev, uint16_t len){
+  uint32_t baud = (dev->baud != 0) ? dev->baud : 9600u;
+  return ((uint32_t)len * 10000u + baud - 1u) / baud + ZW111_TX_GUARD_MS;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Thoi gian cho toi da 1 Data Packet: truyen 1 Packet day (theo packet size da biet) + khoang lang
+ */
+static inline uint32_t ll_data_timeout_ms(const zw111_dev_t *dev){
+  uint16_t data = (dev->pkt_bytes != 0) ? dev->pkt_bytes : (uint16_t)ZW111_MAX_DATA_LEN;
+  return ll_tx_timeout_ms(dev, (uint16_t)(ZW111_HDR_LEN + data + ZW111_CHECKSUM_SIZE_BYTES)) + ZW111_DATA_GAP_MS;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Transaction con dang nam trong hang doi (chua DONE)
+ */
+static inline bool ll_txn_in_flight(const zw111_ll_txn_t *txn){
+  return txn->state == ZW111_TXN_QUEUED || txn->state == ZW111_TXN_TX
+      || txn->state == ZW111_TXN_WAIT_ACK || txn->state == ZW111_TXN_DATA_RX
+      || txn->state == ZW111_TXN_DATA_TX;
+}
+
+/* ----------------------------------------------------------- */
 
-  /* Data */
-  if((data != NULL) && data_len > 0){
-      for(uint16_t i = 0; i < data_len; i++){
-          tx_buf[idx++] = data[i];
+#if ZW111_ADAPTIVE_TIMEOUT
+/**
+ * @brief Lenh bi timeout: noi rong do lech de lan sau co them thoi gian (giong backoff RTO)
+ * @note Khong co ACK nen khong co mau latency, neu khong noi rong thi timeout hoc duoc khong bao gio tang
+ */
+static void ll_lat_on_timeout(zw111_dev_t *dev, zw111_cmd_t cmd){
+  uint8_t slot = zw111_cmd_slot(cmd);
+  if(slot >= ZW111_CMD_SLOTS) return;
+
+  zw111_ll_lat_est_t *e = &dev->lat[slot];
+  uint32_t var = (uint32_t)e->rttvar_x4 * 2u + 4u;
+  e->rttvar_x4 = (var > 0x7FFFu) ? 0x7FFFu : (uint16_t)var;
+}
+#endif // ZW111_ADAPTIVE_TIMEOUT
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Ket thuc transaction dau hang doi: lay ra khoi queue roi moi goi callback
+ * (callback co the submit transaction moi, ke ca chinh no)
+ */
+static void ll_txn_finish(zw111_dev_t *dev, zw111_ll_txn_t *txn, zw111_status_t status){
+  dev->txn_head = txn->next;
+  if(dev->txn_head == NULL) dev->txn_tail = NULL;
+  txn->next = NULL;
+
+  txn->status = status;
+  txn->state = ZW111_TXN_DONE;
+  if(txn->cb) txn->cb(txn);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Pull 1 khuc tu source thang vao slot `slot` cua double buffer roi dong goi thanh Data/End Packet
+ * @return false neu source tra ve sai kich thuoc (da danh dau huy, `txn->status` = ZW111_STATUS_ERROR)
+ */
+static bool ll_dl_fill(zw111_dev_t *dev, zw111_ll_txn_t *txn, uint8_t slot){
+  uint16_t max = (dev->pkt_bytes != 0) ? dev->pkt_bytes : 128u; // 128 bytes: packet size mac dinh cua module
+  if(max > ZW111_MAX_DATA_LEN) max = ZW111_MAX_DATA_LEN;         // Build nho hon packet size cua cam bien -> can doc sysinfo truoc
+  bool last = false;
+  uint16_t n = txn->source(txn->source_ctx, &dev->dl_frame[slot][ZW111_HDR_LEN], max, &last);
+
+  if(n > max || (!last && n != max)){
+      DEBUG_LOG(1, "[LOWLEVEL][TXN] Source returned %u/%u bytes (last=%d), abort download\r\n", n, max, (int)last);
+      txn->xfer_abort = true;
+      txn->xfer_need_cancel = true;
+      txn->status = ZW111_STATUS_ERROR;
+      return false;
+  }
+
+  dev->dl_len[slot] = ll_build_data_packet(dev, dev->dl_frame[slot], n, last);
+  dev->dl_end_built = last;
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Cam bien da nhan lenh ZW111_XFER_DOWN: build Packet 0, kick DMA, build Packet 1 trong luc DMA chay
+ * @return false neu khong bat dau duoc (chua gan source, source loi, UART loi)
+ */
+static bool ll_dl_start(zw111_dev_t *dev, zw111_ll_txn_t *txn){
+  if(txn->source == NULL) return false;
+
+  dev->dl_len[0] = 0;
+  dev->dl_len[1] = 0;
+  dev->dl_cur = 0;
+  dev->dl_end_built = false;
+  txn->status = ZW111_STATUS_OK;
+
+  if(!ll_dl_fill(dev, txn, 0)) return false;
+  if(!zw111_port_uart_tx(&dev->port, dev->dl_frame[0], dev->dl_len[0])) return false;
+  txn->state = ZW111_TXN_DATA_TX;
+  txn->start_tick = zw111_ll_get_ticks();
+  txn->xfer_start_tick = txn->start_tick;
+
+  if(!dev->dl_end_built) (void)ll_dl_fill(dev, txn, 1); // Loi -> xfer_abort, ket thuc khi DMA gui xong Packet 0
+  return true;
+}
+
+// =============== PROTOTYPE FUNCTION DEFINITION ===============
+
+void zw111_ll_dev_init(zw111_dev_t *dev){
+  if(dev == NULL) return;
+
+  dev->chip_addr = ZW111_DEFAULT_ADDRESS;
+  dev->baud = 57600u;
+  dev->rx_timeout_ms = ZW111_RX_TIMEOUT_MS;
+  dev->pkt_bytes = 0; // Chua biet cho den khi doc sysinfo
+#if ZW111_ADAPTIVE_TIMEOUT
+  memset(dev->lat, 0, sizeof(dev->lat));
+#endif // ZW111_ADAPTIVE_TIMEOUT
+  memset(&dev->parser, 0, sizeof(dev->parser));
+  zw111_ll_parser_reset(&dev->parser);
+  dev->rx_stage_pos = 0;
+  dev->rx_stage_len = 0;
+  dev->txn_head = NULL;
+  dev->txn_tail = NULL;
+  dev->dl_len[0] = 0;
+  dev->dl_len[1] = 0;
+  dev->dl_cur = 0;
+  dev->dl_end_built = false;
+  dev->enroll_page_id = 0xFFFF;
+#if ZW111_LL_STATS
+  dev->stats = NULL;
+  memset(&dev->stamp, 0, sizeof(dev->stamp));
+#endif // ZW111_LL_STATS
+  zw111_index_reset(&dev->index, 0); // Chua valid cho den khi dong bo voi cam bien
+}
+
+/* ----------------------------------------------------------- */
+
+#if ZW111_LL_STATS
+void zw111_ll_stats_attach(zw111_dev_t *dev, zw111_stats_t *stats){
+  if(dev == NULL) return;
+  zw111_stats_reset(stats);
+  dev->stats = stats;
+}
+
+/* ----------------------------------------------------------- */
+#endif // ZW111_LL_STATS
+
+/* ==================== COMMAND PROFILE ==================== */
+
+const zw111_cmd_desc_t *zw111_ll_cmd_desc(zw111_cmd_t cmd){
+  uint8_t slot = zw111_cmd_slot(cmd);
+  if(slot >= ZW111_CMD_SLOTS || s_cmd_desc[slot].profile.timeout_ms == 0) return NULL;
+  return &s_cmd_desc[slot];
+}
+
+/* ----------------------------------------------------------- */
+
+const zw111_cmd_profile_t *zw111_ll_cmd_profile(zw111_cmd_t cmd){
+  const zw111_cmd_desc_t *desc = zw111_ll_cmd_desc(cmd);
+  return (desc != NULL) ? &desc->profile : NULL;
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_ll_cmd_timeout(const zw111_dev_t *dev, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len){
+  const zw111_cmd_profile_t *prof = zw111_ll_cmd_profile(cmd);
+  if(prof == NULL) return ZW111_RX_TIMEOUT_MS;
+
+  /* Lenh co latency ti le voi so PageID phai duyet */
+  if(prof->per_page_us != 0){
+      uint32_t pages = 0;
+      if(cmd == ZW111_CMD_SEARCH && params != NULL && param_len >= ZW111_CMD_PARAM_LEN_SEARCH){
+          pages = read_u16_be(&params[3]);          // BufferID + StartPage + PageNum
+      }else if(cmd == ZW111_CMD_DELETE_CHAR && params != NULL && param_len >= ZW111_CMD_PARAM_LEN_DELETE_CHAR){
+          pages = read_u16_be(&params[2]);          // PageID + DeleteNum
+      }else if(cmd == ZW111_CMD_EMPTY){
+          pages = (dev != NULL && dev->index.capacity != 0) ? dev->index.capacity : ZW111_INDEX_MAX_CAPACITY;
       }
+      return prof->timeout_ms + (pages * prof->per_page_us + 999u) / 1000u;
   }
 
-  /* Gia tri Checksum = Tu Packet Flag -> last payload byte (Packet Flag (1) + Packet Length (2) + Data) (khong tinh Checksum) */
-  uint16_t checksum_len = zw111_ll_calc_checksum(&tx_buf[6], payload_len + ZW111_PACKET_FLAG_BYTES);
-  write_u16_be(&tx_buf[idx], checksum_len);
-  idx += 2; // Cong vao 2 byte
+#if ZW111_ADAPTIVE_TIMEOUT
+  /* Da hoc du mau -> srtt + 4 * rttvar (+ du phong), khong vuot timeout co dinh cua bang */
+  if(dev != NULL){
+      const zw111_ll_lat_est_t *e = &dev->lat[zw111_cmd_slot(cmd)];
+      if(e->samples >= ZW111_ADAPT_MIN_SAMPLES){
+          uint32_t t = (uint32_t)(e->srtt_x8 >> 3) + e->rttvar_x4 + ZW111_TX_GUARD_MS;
+          if(t < ZW111_ADAPT_MIN_TIMEOUT_MS) t = ZW111_ADAPT_MIN_TIMEOUT_MS;
+          if(t > prof->timeout_ms) t = prof->timeout_ms;
+          return t;
+      }
+  }
+#endif // ZW111_ADAPTIVE_TIMEOUT
+
+  return prof->timeout_ms;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_ll_cmd_latency_sample(zw111_dev_t *dev, zw111_cmd_t cmd, uint32_t latency_ms){
+#if ZW111_ADAPTIVE_TIMEOUT
+  uint8_t slot = zw111_cmd_slot(cmd);
+  if(dev == NULL || slot >= ZW111_CMD_SLOTS) return;
+
+  zw111_ll_lat_est_t *e = &dev->lat[slot];
+  int32_t sample = (latency_ms > 8000u) ? 8000 : (int32_t)latency_ms; // Tranh tran fixed-point 16-bit
+
+  if(e->samples == 0){
+      e->srtt_x8 = (uint16_t)(sample << 3);
+      e->rttvar_x4 = (uint16_t)(sample << 1);     // rttvar = sample / 2
+  }else{
+      int32_t err = sample - (int32_t)(e->srtt_x8 >> 3);
+      e->srtt_x8 = (uint16_t)((int32_t)e->srtt_x8 + err);               // srtt += err / 8
+      if(err < 0) err = -err;
+      e->rttvar_x4 = (uint16_t)((int32_t)e->rttvar_x4 + err - (int32_t)(e->rttvar_x4 >> 2)); // rttvar += (|err| - rttvar) / 4
+  }
+  if(e->samples < 0xFFFFu) e->samples++;
+#else
+  (void)dev; (void)cmd; (void)latency_ms;
+#endif // ZW111_ADAPTIVE_TIMEOUT
+}
+
+/* ----------------------------------------------------------- */
+
+/* ==================== PACKET TRANSMIT ==================== */
+
+zw111_status_t zw111_ll_send_command_packet(zw111_dev_t *dev, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len){
+  if(dev == NULL || !cmd) return ZW111_STATUS_ERROR;
+
+  uint8_t tx_buf[64]; // Buffer chua Command Packet can gui (theo byte)
+  if(param_len > (sizeof(tx_buf) - ZW111_HDR_LEN - ZW111_INSTRUCTION_BYTES - ZW111_CHECKSUM_SIZE_BYTES)) return ZW111_STATUS_ERROR;
+
+  uint16_t idx = ll_build_command_packet(dev, tx_buf, cmd, params, param_len);
+
+  /* Timeout cho ACK cua lenh nay (cac ham receive dung lai) */
+  dev->rx_timeout_ms = zw111_ll_cmd_timeout(dev, cmd, params, param_len);
 
   /* Gui Command Packet vao UART */
-  if(!zw111_port_uart_tx(tx_buf, idx)) return ZW111_STATUS_ERROR;
+  LL_STATS_BEGIN(dev, cmd);
+  if(!zw111_port_uart_tx(&dev->port, tx_buf, idx)) return ZW111_STATUS_ERROR;
 
-  /* Cho TX xong (timeout ngan) */
-  return wait_tx_done(200);
+  /* Cho TX xong (thoi gian truyen theo baud) */
+  zw111_status_t ret = wait_tx_done(&dev->port, ll_tx_timeout_ms(dev, idx));
+  LL_STATS_STAMP(dev, tx_done);
+  return ret;
+}
+
+/* ----------------------------------------------------------- */
+
+__attribute__((unused)) zw111_status_t zw111_ll_send_data_packet(zw111_dev_t *dev, const uint8_t *data, uint16_t data_len, uint8_t is_last){
+  if(dev == NULL || data_len > ZW111_MAX_DATA_LEN) return ZW111_STATUS_ERROR;
+  if(data_len > 0 && data == NULL) return ZW111_STATUS_ERROR;
+
+  uint8_t tx_buf[ZW111_DATA_FRAME_MAX];  // Buffer chua Data Packet can gui (theo Bytes)
+
+  /* Data dat truoc vao vi tri cua no trong Packet, header + checksum dong goi xung quanh */
+  if(data_len > 0) memcpy(&tx_buf[ZW111_HDR_LEN], data, data_len);
+  uint16_t idx = ll_build_data_packet(dev, tx_buf, data_len, is_last != 0);
+
+  /* Gui Command Packet vao UART */
+  if(!zw111_port_uart_tx(&dev->port, tx_buf, idx)) return ZW111_STATUS_ERROR;
+
+  /* Cho TX xong (thoi gian truyen theo baud) */
+  return wait_tx_done(&dev->port, ll_tx_timeout_ms(dev, idx));
 }
 
 /* ----------------------------------------------------------- */
@@ -164,16 +494,16 @@ __attribute__((unused)) zw111_status_t zw111_ll_send_data_packet(const uint8_t *
 /* ==================== PACKET RECEIVE ==================== */
 
 // FIXME: Ham nay hien tai khong dung den do loi gap giua 2 lan transaction khien khong nhan duoc bytes
-__attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len){
-  if(ack == NULL) return ZW111_STATUS_ERROR;
+__attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_dev_t *dev, zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len){
+  if(dev == NULL || ack == NULL) return ZW111_STATUS_ERROR;
 
   uint8_t hdr[ZW111_HDR_LEN]; // Tong byte header + addr + packet flag + packet length
 
   /* TRANSACTION 1: Receive Header co dinh tu ACK Packet */
-  if(!zw111_port_uart_rx(hdr, 9, ZW111_RX_TIMEOUT_MS)) return ZW111_STATUS_ERROR;
+  if(!zw111_port_uart_rx(&dev->port, hdr, 9, dev->rx_timeout_ms)) return ZW111_STATUS_ERROR;
 
   /* Poll rx header　done */
-  zw111_status_t ret = zw111_port_uart_wait_rx_reach(ZW111_HDR_LEN, ZW111_RX_TIMEOUT_MS);
+  zw111_status_t ret = zw111_port_uart_wait_rx_reach(&dev->port, ZW111_HDR_LEN, dev->rx_timeout_ms);
   if(ret != ZW111_STATUS_OK){
       DEBUG_LOG(1, "[LOWLEVEL] Poll for RX header in ack packet failed...\r\n");
       return ret;
@@ -189,14 +519,14 @@ __attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_ac
   /* Gia tri Packet Length toi thieu cua ACK Packet la 3 bytes, khong tinh bytes cua Packet Length */
   if(payload_len_receive < ZW111_ACK_PAYLOAD_LENGTH_MIN) return ZW111_STATUS_ERROR;
 
-  uint8_t payload[256]; // Buffer luu payload nhan duoc
+  uint8_t payload[ZW111_MAX_DATA_LEN + ZW111_CHECKSUM_SIZE_BYTES]; // Buffer luu payload nhan duoc
   if(payload_len_receive > sizeof(payload)) return ZW111_STATUS_ERROR; // Dieu kien bao ve (optional)
 
   /* TRANSACTION 2: Receive Payload tu ACK Packet voi tham so dau vao bang do dai payload_len_receive */
-  if(!zw111_port_uart_rx(payload, payload_len_receive, ZW111_RX_TIMEOUT_MS)) return ZW111_STATUS_ERROR;
+  if(!zw111_port_uart_rx(&dev->port, payload, payload_len_receive, dev->rx_timeout_ms)) return ZW111_STATUS_ERROR;
 
   /* Poll RX payload done */
-  ret = zw111_port_uart_wait_rx_reach(payload_len_receive, ZW111_RX_TIMEOUT_MS);
+  ret = zw111_port_uart_wait_rx_reach(&dev->port, payload_len_receive, dev->rx_timeout_ms);
   if(ret != ZW111_STATUS_OK){
       DEBUG_LOG(1, "[LOWLEVEL] Poll for RX payload in ack packet failed...payload_len_receive=%u\r\n", payload_len_receive);
       DEBUG_LOG(1, "[LOWLEVEL][HDR] %02X %02X %02X %02X %02X %02X %02X %02X %02X\r\n",
@@ -224,20 +554,21 @@ __attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver1(zw111_ac
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len){
-  if(ack == NULL) return ZW111_STATUS_ERROR;
+// NOTE: Ham nay duoc giu lai de tham khao, da duoc thay the boi ver3 (RX always-on + parser)
+__attribute__((unused)) zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_dev_t *dev, zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len){
+  if(dev == NULL || ack == NULL) return ZW111_STATUS_ERROR;
 
   zw111_status_t ret = ZW111_STATUS_ERROR;
 
-  // Thuc hien luon 1 transaction cho header + chip addr + packet flag + packet length (9 bytes) + payload (256)
-  uint8_t frame[ZW111_HDR_LEN + 256];
+  // Thuc hien luon 1 transaction cho header + chip addr + packet flag + packet length (9 bytes) + payload
+  uint8_t frame[ZW111_DATA_FRAME_MAX];
   const uint16_t max_rx_len = (uint16_t)sizeof(frame);
 
   /* Kick 1 lan RX transaction dai (khong bi gap giua header va payload) */
-  if(!zw111_port_uart_rx(frame, max_rx_len, ZW111_RX_TIMEOUT_MS)) return ZW111_STATUS_ERROR;
+  if(!zw111_port_uart_rx(&dev->port, frame, max_rx_len, dev->rx_timeout_ms)) return ZW111_STATUS_ERROR;
 
   /* Doc du 9 bytes header */
-  ret = zw111_port_uart_wait_rx_reach(ZW111_HDR_LEN, ZW111_RX_TIMEOUT_MS);
+  ret = zw111_port_uart_wait_rx_reach(&dev->port, ZW111_HDR_LEN, dev->rx_timeout_ms);
   if(ret != ZW111_STATUS_OK){
       DEBUG_LOG(1, "[LOWLEVEL] Waiting for RX header reach enough bytes in ack packet failed...\r\n");
       goto cleanup_abort;
@@ -264,7 +595,7 @@ zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_p
       ret =  ZW111_STATUS_PACKET_ERR;
       goto cleanup_abort;
   }
-  if(payload_len_receive > 256){
+  if(payload_len_receive > (ZW111_MAX_DATA_LEN + ZW111_CHECKSUM_SIZE_BYTES)){
       ret =  ZW111_STATUS_PACKET_ERR;
       goto cleanup_abort;
   }
@@ -272,7 +603,7 @@ zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_p
   /* Doc du toan bo frame can thiet: 9 bytes hdr dau + payload_len */
   uint16_t need_total = (uint16_t)(ZW111_HDR_LEN + payload_len_receive);
 
-  ret = zw111_port_uart_wait_rx_reach(need_total, ZW111_RX_TIMEOUT_MS);
+  ret = zw111_port_uart_wait_rx_reach(&dev->port, need_total, dev->rx_timeout_ms);
   if(ret != ZW111_STATUS_OK){
       DEBUG_LOG(1, "[LOWLEVEL] Waiting for RX payload reach enough bytes in ack packet failed...need_total=%u\r\n", need_total);
       DEBUG_LOG(1, "[LOWLEVEL][HDR] %02X %02X %02X %02X %02X %02X %02X %02X %02X\r\n",
@@ -308,64 +639,194 @@ zw111_status_t zw111_ll_receive_ack_packet_ver2(zw111_ack_t *ack, uint8_t *ret_p
      * @note Transaction RX van dang BUSY. Abort chu dich de tranh tu no TIMEOUT ve sau
      * va de driver quay ve trang thai sach truoc lan transacton tiep theo
      */
-    (void)zw111_port_uart_abort_rx_ok(ZW111_RX_TIMEOUT_MS);
+    (void)zw111_port_uart_abort_rx_ok(&dev->port, dev->rx_timeout_ms);
 
   return ret;
 }
 
 /* ----------------------------------------------------------- */
 
-__attribute__((unused)) zw111_status_t zw111_ll_receive_data_packet(uint8_t *buf, uint16_t buf_len, uint16_t *recv_len){
-  uint8_t hdr[ZW111_HDR_LEN]; // Tong byte header + addr + packet flag + packet length
+zw111_status_t zw111_ll_receive_ack_packet_ver3(zw111_dev_t *dev, zw111_ack_t *ack, uint8_t *ret_params, uint16_t *ret_param_len){
+  if(dev == NULL || ack == NULL) return ZW111_STATUS_ERROR;
 
-  /* Transaction 1: Receive Header co dinh tu ACK Packet */
-  if(!zw111_port_uart_rx(hdr, 9, ZW111_RX_TIMEOUT_MS)) return ZW111_STATUS_ERROR;
+  uint32_t start = zw111_ll_get_ticks();
 
-  /* Poll rx header done */
-  zw111_status_t ret = zw111_port_uart_wait_rx_reach(ZW111_HDR_LEN, ZW111_RX_TIMEOUT_MS);
-  if(ret != ZW111_STATUS_OK){
-      DEBUG_LOG(1, "[LOWLEVEL] Poll for RX header in data packet failed...\r\n");
-      return ret;
+  for(;;){
+      uint32_t el = elapsed_ms(start, zw111_ll_get_ticks());
+      if(el >= dev->rx_timeout_ms){
+          LL_STATS_END(dev, true);
+          return ZW111_STATUS_TIMEOUT;
+      }
+
+      const zw111_ll_frame_t *frame = NULL;
+      zw111_status_t ret = zw111_ll_receive_frame(dev, &frame, dev->rx_timeout_ms - el);
+      if(ret != ZW111_STATUS_OK){
+          if(ret == ZW111_STATUS_TIMEOUT) LL_STATS_END(dev, true);
+          return ret;
+      }
+
+      /* Chi nhan ACK Packet co it nhat Confirm Code, frame khac bo qua */
+      if(frame->pid != ZW111_PID_ACK || frame->data_len < ZW111_CONFIRM_CODE_BYTES){
+          DEBUG_LOG(1, "[LOWLEVEL] Skip frame pid=0x%02X len=%u while waiting ACK\r\n", frame->pid, frame->data_len);
+          continue;
+      }
+
+      /* Gia tri ACK tra ve (Confirm code) nam o byte dau tien cua payload */
+      *ack = (zw111_ack_t)(frame->data[0]);
+      LL_STATS_END(dev, false);
+
+      if(ret_params && ret_param_len){
+          *ret_param_len = frame->data_len - ZW111_CONFIRM_CODE_BYTES; // Gia tri chieu dai cua Return Parameters
+          if(*ret_param_len > ZW111_TXN_MAX_RET) *ret_param_len = ZW111_TXN_MAX_RET; // ACK nhieu (checksum van dung) khong tran buffer
+          memcpy(ret_params, &frame->data[1], *ret_param_len);
+      }
+      return ZW111_STATUS_OK;
   }
+}
 
-  if(read_u16_be(&hdr[0]) !=  ZW111_PKT_HEADER) return ZW111_STATUS_ERROR;
+/* ----------------------------------------------------------- */
 
-  uint8_t pid = hdr[6];
-  if(pid != ZW111_PID_DATA && pid != ZW111_PID_END) return ZW111_STATUS_ERROR;
+zw111_status_t zw111_ll_receive_frame(zw111_dev_t *dev, const zw111_ll_frame_t **frame, uint32_t timeout_ms){
+  if(dev == NULL || frame == NULL) return ZW111_STATUS_ERROR;
 
-  // Boc tach 2 bytes gia tri nhan duoc tai truong Packet Length
-  uint16_t payload_len_receive = read_u16_be(&hdr[7]);
+  uint32_t start = zw111_ll_get_ticks();
 
-  // Neu gia tri nhan duoc be hon chieu dai 2 bytes (chieu dai cua truong Packet Length)
-  if(payload_len_receive < ZW111_DATA_PAYLOAD_LENGTH_MIN) return ZW111_STATUS_ERROR;
+  for(;;){
+      if(ll_poll_frame(dev, frame)) return ZW111_STATUS_OK;
+      if(elapsed_ms(start, zw111_ll_get_ticks()) >= timeout_ms) return ZW111_STATUS_TIMEOUT;
+      (void)zw111_port_uart_rx_wait(&dev->port, 1);
+  }
+}
 
-  // Neu gia tri chieu dai nhan duoc lon hon ca chieu dai buffer truyen vao
-  if(payload_len_receive - ZW111_DATA_PAYLOAD_LENGTH_MIN > buf_len) return ZW111_STATUS_ERROR;
+/* ----------------------------------------------------------- */
 
-  uint8_t payload[300];
-  if(payload_len_receive > sizeof(payload)) return ZW111_STATUS_ERROR;
+void zw111_ll_parser_reset(zw111_ll_parser_t *p){
+  if(p == NULL) return;
+  p->state = ZW111_PARSER_WAIT_HDR_HI;
+  p->idx = 0;
+  p->len_field = 0;
+  p->sum = 0;
+  p->sum_rx = 0;
+}
 
-  /* Transaction 2: Receive Payload tu ACK Packet voi tham so dau vao bang do dai payload_len_receive */
-  if(!zw111_port_uart_rx(payload, payload_len_receive, ZW111_RX_TIMEOUT_MS)) return ZW111_STATUS_ERROR;
+/* ----------------------------------------------------------- */
 
-  /* Poll RX payload done */
-  ret = zw111_port_uart_wait_rx_reach(payload_len_receive, ZW111_RX_TIMEOUT_MS);
+/**
+ * @details
+ * Checksum duoc cong don ngay khi nhan byte (PID -> Payload) nen khi nhan du
+ * 2 bytes Checksum chi can so sanh, khong phai duyet lai Payload
+ * Khi frame loi, parser quay ve cho Header. Neu byte gay loi la 0xEF thi coi nhu
+ * byte dau cua Header tiep theo (resync ngay khong mat frame)
+ */
+zw111_parse_result_t zw111_ll_parser_feed(zw111_ll_parser_t *p, uint8_t byte){
+  switch(p->state){
+    case ZW111_PARSER_WAIT_HDR_HI:
+      if(byte == (uint8_t)(ZW111_PKT_HEADER >> 8)){
+          p->state = ZW111_PARSER_WAIT_HDR_LO;
+      }else{
+          p->resync_bytes++;
+      }
+      return ZW111_PARSE_NEED_MORE;
+
+    case ZW111_PARSER_WAIT_HDR_LO:
+      if(byte == (uint8_t)(ZW111_PKT_HEADER & 0x00FF)){
+          p->state = ZW111_PARSER_ADDR;
+          p->idx = 0;
+          p->frame.addr = 0;
+      }else if(byte != (uint8_t)(ZW111_PKT_HEADER >> 8)){
+          p->resync_bytes += 2;
+          p->state = ZW111_PARSER_WAIT_HDR_HI;
+      }else{
+          p->resync_bytes++; // 0xEF 0xEF -> byte thu 2 co the la Header that
+      }
+      return ZW111_PARSE_NEED_MORE;
+
+    case ZW111_PARSER_ADDR:
+      p->frame.addr = (p->frame.addr << 8) | byte;
+      if(++p->idx == 4) p->state = ZW111_PARSER_PID;
+      return ZW111_PARSE_NEED_MORE;
+
+    case ZW111_PARSER_PID:
+      if(byte != ZW111_PID_ACK && byte != ZW111_PID_DATA && byte != ZW111_PID_END && byte != ZW111_PID_COMMAND){
+          p->bad_length++;
+          zw111_ll_parser_reset(p);
+          if(byte == (uint8_t)(ZW111_PKT_HEADER >> 8)) p->state = ZW111_PARSER_WAIT_HDR_LO;
+          return ZW111_PARSE_ERROR;
+      }
+      p->frame.pid = byte;
+      p->sum = byte;
+      p->len_field = 0;
+      p->idx = 0;
+      p->state = ZW111_PARSER_LEN;
+      return ZW111_PARSE_NEED_MORE;
+
+    case ZW111_PARSER_LEN:
+      p->len_field = (uint16_t)((p->len_field << 8) | byte);
+      p->sum = (uint16_t)(p->sum + byte);
+      if(++p->idx < 2) return ZW111_PARSE_NEED_MORE;
+
+      if(p->len_field < ZW111_CHECKSUM_SIZE_BYTES || p->len_field > (ZW111_MAX_DATA_LEN + ZW111_CHECKSUM_SIZE_BYTES)){
+          p->bad_length++;
+          zw111_ll_parser_reset(p);
+          if(byte == (uint8_t)(ZW111_PKT_HEADER >> 8)) p->state = ZW111_PARSER_WAIT_HDR_LO;
+          return ZW111_PARSE_ERROR;
+      }
+      p->frame.data_len = (uint16_t)(p->len_field - ZW111_CHECKSUM_SIZE_BYTES);
+      p->idx = 0;
+      p->sum_rx = 0;
+      p->state = (p->frame.data_len > 0) ? ZW111_PARSER_DATA : ZW111_PARSER_SUM;
+      return ZW111_PARSE_NEED_MORE;
+
+    case ZW111_PARSER_DATA:
+      p->frame.data[p->idx++] = byte;
+      p->sum = (uint16_t)(p->sum + byte);
+      if(p->idx == p->frame.data_len){
+          p->idx = 0;
+          p->state = ZW111_PARSER_SUM;
+      }
+      return ZW111_PARSE_NEED_MORE;
+
+    case ZW111_PARSER_SUM:
+      p->sum_rx = (uint16_t)((p->sum_rx << 8) | byte);
+      if(++p->idx < 2) return ZW111_PARSE_NEED_MORE;
+      {
+        bool ok = (p->sum_rx == p->sum);
+        zw111_ll_parser_reset(p);
+        if(!ok){
+            p->bad_checksum++;
+            return ZW111_PARSE_ERROR;
+        }
+      }
+      return ZW111_PARSE_FRAME;
+
+    default:
+      zw111_ll_parser_reset(p);
+      return ZW111_PARSE_NEED_MORE;
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+__attribute__((unused)) zw111_status_t zw111_ll_receive_data_packet(zw111_dev_t *dev, uint8_t *buf, uint16_t buf_len, uint16_t *recv_len){
+  if(dev == NULL) return ZW111_STATUS_ERROR;
+
+  /* Frame tach boi parser (Checksum da verify), copy 1 lan tu parser sang buffer cua USER */
+  const zw111_ll_frame_t *frame = NULL;
+  zw111_status_t ret = zw111_ll_receive_frame(dev, &frame, dev->rx_timeout_ms);
   if(ret != ZW111_STATUS_OK){
-      DEBUG_LOG(1, "[LOWLEVEL] Poll for RX payload in data packet failed...\r\n");
+      DEBUG_LOG(1, "[LOWLEVEL] Waiting for data packet failed...\r\n");
       return ret;
   }
 
-  // Verify gia tri chieu dai tra ve cua Checksum
-  uint16_t expect = calc_checksum_rx(pid, payload_len_receive, payload, payload_len_receive); // Ky vong
-  uint16_t got = read_checksum_tail_be(payload, payload_len_receive); // Doc duoc thuc te
-  if(expect != got) return ZW111_STATUS_ERROR;
+  if(frame->pid != ZW111_PID_DATA && frame->pid != ZW111_PID_END) return ZW111_STATUS_ERROR;
+
+  // Neu gia tri chieu dai nhan duoc lon hon ca chieu dai buffer truyen vao
+  if(frame->data_len > buf_len) return ZW111_STATUS_ERROR;
 
   /* Copy Payload nhan duoc qua buffer truyen vao */
   if((buf != NULL) && buf_len > 0){
-      *recv_len = payload_len_receive - ZW111_CHECKSUM_SIZE_BYTES;
-      for(uint8_t i = 0; i < *recv_len; i++){
-          buf[i] = payload[i];
-      }
+      memcpy(buf, frame->data, frame->data_len);
+      if(recv_len) *recv_len = frame->data_len;
   }
   return ZW111_STATUS_OK;
 }
@@ -382,12 +843,12 @@ uint16_t zw111_ll_calc_checksum(const uint8_t *buf, uint16_t len){
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_ll_wait_ack(zw111_ack_t *ack, uint32_t timeout){
+zw111_status_t zw111_ll_wait_ack(zw111_dev_t *dev, zw111_ack_t *ack, uint32_t timeout){
   uint32_t start = zw111_ll_get_ticks();
 
   while(elapsed_ms(start, zw111_ll_get_ticks()) < timeout){
       zw111_ack_t local_ack = 0;
-      zw111_status_t ret = zw111_ll_receive_ack_packet_ver2(&local_ack, NULL, NULL);
+      zw111_status_t ret = zw111_ll_receive_ack_packet_ver3(dev, &local_ack, NULL, NULL);
 
       if(ret == ZW111_STATUS_OK){
           if(ack) *ack = local_ack;
@@ -400,17 +861,450 @@ zw111_status_t zw111_ll_wait_ack(zw111_ack_t *ack, uint32_t timeout){
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_ll_cmd_with_ack(zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len, zw111_ack_t *ack){
-  if(zw111_ll_send_command_packet(cmd, params, param_len) == ZW111_STATUS_OK){
-      return zw111_ll_receive_ack_packet_ver2(ack, NULL, NULL);
+zw111_status_t zw111_ll_cmd_with_ack(zw111_dev_t *dev, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len, zw111_ack_t *ack){
+  /* Di qua hang doi async de khong chen ngang transaction dang chay */
+  zw111_ll_txn_t txn;
+  zw111_status_t ret = zw111_ll_txn_init(&txn, cmd, params, param_len, NULL, NULL);
+  if(ret != ZW111_STATUS_OK) return ret;
+
+  ret = zw111_ll_txn_submit(dev, &txn);
+  if(ret != ZW111_STATUS_OK) return ret;
+
+  ret = zw111_ll_txn_wait(&txn);
+  if(ret == ZW111_STATUS_OK && ack) *ack = txn.ack;
+  return ret;
+}
+
+/* ==================== ASYNC TRANSACTION ==================== */
+
+zw111_status_t zw111_ll_txn_init(zw111_ll_txn_t *txn, zw111_cmd_t cmd, const uint8_t *params, uint8_t param_len,
+                                 zw111_ll_txn_cb_t cb, void *user){
+  if(txn == NULL || !cmd) return ZW111_STATUS_ERROR;
+  if(param_len > ZW111_TXN_MAX_PARAMS) return ZW111_STATUS_ERROR;
+  if(param_len > 0 && params == NULL) return ZW111_STATUS_ERROR;
+
+  txn->cmd = cmd;
+  if(param_len > 0 && params != txn->params) memcpy(txn->params, params, param_len); // Encoder co the ghi thang vao txn->params
+  txn->param_len = param_len;
+  txn->timeout_ms = 0;
+  txn->cb = cb;
+  txn->user = user;
+
+  txn->state = ZW111_TXN_IDLE;
+  txn->status = ZW111_STATUS_ERROR;
+  txn->ack = ZW111_ACK_OK;
+  txn->ret_len = 0;
+  txn->sink = NULL;
+  txn->sink_ctx = NULL;
+  txn->source = NULL;
+  txn->source_ctx = NULL;
+  txn->xfer_stream_ack = false;
+  txn->xfer_bytes = 0;
+  txn->xfer_packets = 0;
+  txn->xfer_start_tick = 0;
+  txn->xfer_end_tick = 0;
+  txn->xfer_abort = false;
+  txn->xfer_final_ack = false;
+  txn->xfer_need_cancel = false;
+  txn->tx_len = 0;
+  txn->start_tick = 0;
+  txn->dev = NULL;
+  txn->next = NULL;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_ll_txn_set_sink(zw111_ll_txn_t *txn, zw111_ll_data_sink_t sink, void *ctx){
+  if(txn == NULL) return;
+  txn->sink = sink;
+  txn->sink_ctx = ctx;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_ll_txn_set_source(zw111_ll_txn_t *txn, zw111_ll_data_source_t source, void *ctx){
+  if(txn == NULL) return;
+  txn->source = source;
+  txn->source_ctx = ctx;
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @note Packet duoc dong goi ngay luc submit (dung dia chi chip tai thoi diem do)
+ * va luu trong txn nen DMA TX van doc duoc sau khi ham cua USER da return
+ */
+zw111_status_t zw111_ll_txn_submit(zw111_dev_t *dev, zw111_ll_txn_t *txn){
+  if(dev == NULL || txn == NULL || !txn->cmd) return ZW111_STATUS_ERROR;
+  if(ll_txn_in_flight(txn)) return ZW111_STATUS_ERROR;
+
+  txn->tx_len = ll_build_command_packet(dev, txn->tx_frame, txn->cmd, txn->params, txn->param_len);
+  if(txn->timeout_ms == 0) txn->timeout_ms = zw111_ll_cmd_timeout(dev, txn->cmd, txn->params, txn->param_len);
+  txn->state = ZW111_TXN_QUEUED;
+  txn->dev = dev;
+  txn->next = NULL;
+
+  if(dev->txn_tail == NULL){
+      dev->txn_head = txn;
+  }else{
+      dev->txn_tail->next = txn;
+  }
+  dev->txn_tail = txn;
+  return ZW111_STATUS_OK;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_ll_txn_submit_next(zw111_dev_t *dev, zw111_ll_txn_t *txn){
+  if(dev == NULL) return ZW111_STATUS_ERROR;
+  if(dev->txn_head == NULL) return zw111_ll_txn_submit(dev, txn);
+  if(txn == NULL || !txn->cmd) return ZW111_STATUS_ERROR;
+  if(ll_txn_in_flight(txn)) return ZW111_STATUS_ERROR;
+
+  txn->tx_len = ll_build_command_packet(dev, txn->tx_frame, txn->cmd, txn->params, txn->param_len);
+  if(txn->timeout_ms == 0) txn->timeout_ms = zw111_ll_cmd_timeout(dev, txn->cmd, txn->params, txn->param_len);
+  txn->state = ZW111_TXN_QUEUED;
+  txn->dev = dev;
+
+  /* Transaction dau hang doi dang chay (TX/WAIT_ACK) thi chen ngay sau no, con khong thi chen len dau */
+  if(dev->txn_head->state == ZW111_TXN_QUEUED){
+      txn->next = dev->txn_head;
+      dev->txn_head = txn;
+  }else{
+      txn->next = dev->txn_head->next;
+      dev->txn_head->next = txn;
+      if(dev->txn_tail == dev->txn_head) dev->txn_tail = txn;
   }
-  return ZW111_STATUS_ERROR;
+  return ZW111_STATUS_OK;
 }
 
 /* ----------------------------------------------------------- */
 
-zw111_status_t zw111_ll_flush_uart(void){
-  if(zw111_port_uart_flush() != true){
+/**
+ * @brief Day state machine cua transaction dau hang doi 1 lan
+ *
+ * @details
+ * Moi lan goi chi day state machine cua transaction dau hang doi:
+ *  - QUEUED   -> kick TX (DMA), chuyen sang TX
+ *  - TX       -> poll TX, xong thi chuyen sang WAIT_ACK va bat dau tinh timeout
+ *  - WAIT_ACK -> feed byte RX dang co vao parser, co ACK thi DONE, het thoi gian thi TIMEOUT
+ *  - DATA_RX  -> (lenh ZW111_XFER_UP, sau ACK OK) dua tung Data Packet cho sink, End Packet thi DONE,
+ *                khoang lang giua 2 Packet qua ll_data_timeout_ms() thi TIMEOUT
+ *  - DATA_TX  -> (lenh ZW111_XFER_DOWN, sau ACK OK/0xF1) double buffer: DMA gui slot nay, slot kia build Packet ke tiep
+ *                tu source; End Packet gui xong thi DONE (hoac quay lai WAIT_ACK cho ACK cuoi neu cam bien tra 0xF1)
+ * Data/End Packet den trong luc cho ACK bi bo qua (giong ver3)
+ */
+static bool ll_txn_step(zw111_dev_t *dev){
+  zw111_ll_txn_t *txn = dev->txn_head;
+  if(txn == NULL) return false;
+
+  const zw111_ll_frame_t *frame = NULL;
+
+  if(txn->state == ZW111_TXN_QUEUED){
+      /* Frame den khi khong co lenh nao dang cho (ACK tre cua lenh da timeout) -> bo, khong de lenh moi nhan nham */
+      while(ll_poll_frame(dev, &frame)){
+          DEBUG_LOG(1, "[LOWLEVEL][TXN] Drop stale frame pid=0x%02X before cmd=0x%02X\r\n", frame->pid, (unsigned)txn->cmd);
+      }
+
+      LL_STATS_BEGIN(dev, txn->cmd);
+      if(!zw111_port_uart_tx(&dev->port, txn->tx_frame, txn->tx_len)){
+          ll_txn_finish(dev, txn, ZW111_STATUS_ERROR);
+          return (dev->txn_head != NULL);
+      }
+      txn->state = ZW111_TXN_TX;
+  }
+
+  if(txn->state == ZW111_TXN_TX){
+      zw111_port_uart_state_t st = zw111_port_uart_tx_poll(&dev->port, ll_tx_timeout_ms(dev, txn->tx_len));
+      if(st == UART_BUSY) return true;
+      if(st != UART_DONE){
+          DEBUG_LOG(1, "[LOWLEVEL][TXN] cmd=0x%02X TX failed state=%d\r\n", (unsigned)txn->cmd, (int)st);
+          ll_txn_finish(dev, txn, (st == UART_TIMEOUT) ? ZW111_STATUS_TIMEOUT : ZW111_STATUS_ERROR);
+          return (dev->txn_head != NULL);
+      }
+      txn->state = ZW111_TXN_WAIT_ACK;
+      txn->start_tick = zw111_ll_get_ticks();
+      LL_STATS_STAMP(dev, tx_done);
+  }
+
+  if(txn->state == ZW111_TXN_WAIT_ACK){
+      while(ll_poll_frame(dev, &frame)){
+          if(frame->pid != ZW111_PID_ACK || frame->data_len < ZW111_CONFIRM_CODE_BYTES){
+              DEBUG_LOG(1, "[LOWLEVEL][TXN] Skip frame pid=0x%02X len=%u while waiting ACK\r\n", frame->pid, frame->data_len);
+              continue;
+          }
+          if(frame->data[0] == ZW111_ACK_STREAM_DATA_OK) continue; // ACK tre cua Data Packet (stream) truoc ACK cuoi
+
+          txn->ack = (zw111_ack_t)frame->data[0];
+          txn->ret_len = frame->data_len - ZW111_CONFIRM_CODE_BYTES;
+          if(txn->ret_len > ZW111_TXN_MAX_RET) txn->ret_len = ZW111_TXN_MAX_RET; // Cat bot, API cap cao tu kiem tra ret_len
+          memcpy(txn->ret_params, &frame->data[1], txn->ret_len);
+
+          /* ACK cuoi sau End Packet (DownChar stream) -> khong phai mau latency cua lenh */
+          if(txn->xfer_packets != 0){
+              ll_txn_finish(dev, txn, ZW111_STATUS_OK);
+              return (dev->txn_head != NULL);
+          }
+          zw111_ll_cmd_latency_sample(dev, txn->cmd, elapsed_ms(txn->start_tick, zw111_ll_get_ticks()));
+          LL_STATS_END(dev, false);
+
+          /* ACK OK cua lenh co Data Packet gui len -> chua xong, nhan tiep chuoi DATA...END */
+          const zw111_cmd_desc_t *desc = zw111_ll_cmd_desc(txn->cmd);
+          if(txn->ack == ZW111_ACK_OK && desc != NULL && desc->xfer == ZW111_XFER_UP){
+              txn->state = ZW111_TXN_DATA_RX;
+              txn->start_tick = zw111_ll_get_ticks();
+              txn->xfer_start_tick = txn->start_tick;
+              break;
+          }
+
+          /* Lenh co Data Packet gui xuong: 0xF1 -> cam bien ACK tung Packet, OK -> khong ACK cho den het */
+          if((txn->ack == ZW111_ACK_OK || txn->ack == ZW111_ACK_STREAM_CMD_ACCEPTED)
+             && desc != NULL && desc->xfer == ZW111_XFER_DOWN){
+              txn->xfer_stream_ack = (txn->ack == ZW111_ACK_STREAM_CMD_ACCEPTED);
+              txn->ack = ZW111_ACK_OK;
+              if(!ll_dl_start(dev, txn)){
+                  txn->xfer_need_cancel = true; // Cam bien da nhan lenh, dang cho Packet dau tien
+                  ll_txn_finish(dev, txn, ZW111_STATUS_ERROR);
+              }
+              return (dev->txn_head != NULL);
+          }
+          ll_txn_finish(dev, txn, ZW111_STATUS_OK);
+          return (dev->txn_head != NULL);
+      }
+
+      if(txn->state == ZW111_TXN_WAIT_ACK){
+          uint32_t timeout_ms = (txn->timeout_ms != 0) ? txn->timeout_ms : ZW111_RX_TIMEOUT_MS;
+          if(elapsed_ms(txn->start_tick, zw111_ll_get_ticks()) >= timeout_ms){
+              DEBUG_LOG(1, "[LOWLEVEL][TXN] cmd=0x%02X ACK timeout (%lu ms)\r\n", (unsigned)txn->cmd, (unsigned long)timeout_ms);
+              if(txn->xfer_packets == 0){
+#if ZW111_ADAPTIVE_TIMEOUT
+                  ll_lat_on_timeout(dev, txn->cmd);
+#endif // ZW111_ADAPTIVE_TIMEOUT
+                  LL_STATS_END(dev, true);
+              }
+              ll_txn_finish(dev, txn, ZW111_STATUS_TIMEOUT);
+          }
+          return (dev->txn_head != NULL);
+      }
+  }
+
+  if(txn->state == ZW111_TXN_DATA_TX){
+      /* Stream: ACK 0xF0 cua tung Packet bo qua, ACK loi -> dung gui sau Packet dang chay tren DMA */
+      while(ll_poll_frame(dev, &frame)){
+          if(frame->pid != ZW111_PID_ACK || frame->data_len < ZW111_CONFIRM_CODE_BYTES) continue;
+          if(frame->data[0] == ZW111_ACK_STREAM_DATA_OK || txn->xfer_abort || txn->xfer_final_ack) continue;
+
+          /* ACK cuoi cua ca chuoi den truoc khi poll thay End Packet TX xong -> ket thuc OK khi DMA xong */
+          if(dev->dl_end_built && frame->data[0] == ZW111_ACK_OK){
+              txn->ack = ZW111_ACK_OK;
+              txn->ret_len = frame->data_len - ZW111_CONFIRM_CODE_BYTES;
+              if(txn->ret_len > ZW111_TXN_MAX_RET) txn->ret_len = ZW111_TXN_MAX_RET;
+              memcpy(txn->ret_params, &frame->data[1], txn->ret_len);
+              txn->xfer_final_ack = true;
+              continue;
+          }
+          DEBUG_LOG(1, "[LOWLEVEL][TXN] cmd=0x%02X rejected at packet %u ack=0x%02X\r\n", (unsigned)txn->cmd, txn->xfer_packets, frame->data[0]);
+          txn->ack = (zw111_ack_t)frame->data[0];
+          txn->xfer_abort = true;
+          txn->status = ZW111_STATUS_OK; // Loi nam o txn->ack, API cap cao map sang status
+      }
+
+      uint8_t cur = dev->dl_cur;
+      uint8_t nxt = cur ^ 1u;
+      zw111_port_uart_state_t st = zw111_port_uart_tx_poll(&dev->port, ll_tx_timeout_ms(dev, dev->dl_len[cur]));
+      if(st == UART_BUSY){
+          /* Source cham hon 1 Packet (slot kia chua build duoc luc kick) -> build bu trong luc cho */
+          if(!txn->xfer_abort && !dev->dl_end_built && dev->dl_len[nxt] == 0) (void)ll_dl_fill(dev, txn, nxt);
+          return true;
+      }
+
+      uint32_t now = zw111_ll_get_ticks();
+      if(st != UART_DONE){
+          DEBUG_LOG(1, "[LOWLEVEL][TXN] cmd=0x%02X data TX failed state=%d\r\n", (unsigned)txn->cmd, (int)st);
+          txn->xfer_end_tick = now;
+          txn->xfer_need_cancel = true;
+          ll_txn_finish(dev, txn, (st == UART_TIMEOUT) ? ZW111_STATUS_TIMEOUT : ZW111_STATUS_ERROR);
+          return (dev->txn_head != NULL);
+      }
+
+      /* Packet trong slot `cur` da gui xong -> slot trong */
+      bool was_end = (dev->dl_frame[cur][6] == ZW111_PID_END);
+      txn->xfer_packets++;
+      txn->xfer_bytes += dev->dl_len[cur] - ZW111_HDR_LEN - ZW111_CHECKSUM_SIZE_BYTES;
+      dev->dl_len[cur] = 0;
+
+      if(txn->xfer_abort || was_end){
+          txn->xfer_end_tick = now;
+          if(!txn->xfer_abort && txn->xfer_stream_ack && !txn->xfer_final_ack){
+              txn->state = ZW111_TXN_WAIT_ACK; // Cho ACK cuoi cua ca chuoi
+              txn->start_tick = now;
+              return true;
+          }
+          ll_txn_finish(dev, txn, txn->xfer_abort ? txn->status : ZW111_STATUS_OK);
+          return (dev->txn_head != NULL);
+      }
+
+      /* Kick ngay Packet ke tiep (da build san), roi moi build lai slot vua trong */
+      if(dev->dl_len[nxt] == 0 && !ll_dl_fill(dev, txn, nxt)){
+          ll_txn_finish(dev, txn, txn->status);
+          return (dev->txn_head != NULL);
+      }
+      if(!zw111_port_uart_tx(&dev->port, dev->dl_frame[nxt], dev->dl_len[nxt])){
+          txn->xfer_need_cancel = true;
+          ll_txn_finish(dev, txn, ZW111_STATUS_ERROR);
+          return (dev->txn_head != NULL);
+      }
+      dev->dl_cur = nxt;
+      txn->start_tick = now;
+      if(!dev->dl_end_built) (void)ll_dl_fill(dev, txn, cur);
+      return true;
+  }
+
+  /* ZW111_TXN_DATA_RX: moi Data Packet da verify duoc dua thang tu parser sang sink (khong copy) */
+  while(ll_poll_frame(dev, &frame)){
+      if(frame->pid != ZW111_PID_DATA && frame->pid != ZW111_PID_END){
+          DEBUG_LOG(1, "[LOWLEVEL][TXN] Skip frame pid=0x%02X while receiving data\r\n", frame->pid);
+          continue;
+      }
+
+      bool last = (frame->pid == ZW111_PID_END);
+      txn->start_tick = zw111_ll_get_ticks();
+      txn->xfer_packets++;
+      txn->xfer_bytes += frame->data_len;
+
+      if(!txn->xfer_abort){
+          if(dev->pkt_bytes != 0 && frame->data_len > dev->pkt_bytes){
+              DEBUG_LOG(1, "[LOWLEVEL][TXN] Data packet %u bytes > packet size %u\r\n", frame->data_len, dev->pkt_bytes);
+              txn->xfer_abort = true;
+              txn->status = ZW111_STATUS_PROTOCOL_ERR;
+          }else if(txn->sink != NULL && !txn->sink(txn->sink_ctx, frame->data, frame->data_len, last)){
+              txn->xfer_abort = true;
+              txn->status = ZW111_STATUS_ERROR;
+          }
+      }
+
+      if(last){
+          txn->xfer_end_tick = txn->start_tick;
+          ll_txn_finish(dev, txn, txn->xfer_abort ? txn->status : ZW111_STATUS_OK);
+          return (dev->txn_head != NULL);
+      }
+  }
+
+  if(elapsed_ms(txn->start_tick, zw111_ll_get_ticks()) >= ll_data_timeout_ms(dev)){
+      DEBUG_LOG(1, "[LOWLEVEL][TXN] cmd=0x%02X data timeout after %u packets\r\n", (unsigned)txn->cmd, txn->xfer_packets);
+      txn->xfer_end_tick = zw111_ll_get_ticks();
+      ll_txn_finish(dev, txn, ZW111_STATUS_TIMEOUT);
+  }
+  return (dev->txn_head != NULL);
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_ll_txn_process(zw111_dev_t *dev){
+  if(dev == NULL) return false;
+
+  bool busy;
+  zw111_ll_txn_t *head;
+  do{
+      head = dev->txn_head;
+      busy = ll_txn_step(dev);
+      /* Transaction vua xong va lenh ke tiep (buoc noi cua thao tac nhieu lenh) dang cho -> kick ngay trong lan goi nay */
+  }while(busy && dev->txn_head != head && dev->txn_head->state == ZW111_TXN_QUEUED);
+
+  return busy;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_ll_txn_wait(zw111_ll_txn_t *txn){
+  if(txn == NULL) return ZW111_STATUS_ERROR;
+
+  while(txn->state != ZW111_TXN_DONE){
+      if(txn->state == ZW111_TXN_IDLE || txn->dev == NULL) return ZW111_STATUS_ERROR; // Chua submit
+      zw111_dev_t *dev = txn->dev;
+      (void)zw111_ll_txn_process(dev);
+      if(txn->state != ZW111_TXN_DONE) (void)zw111_port_uart_rx_wait(&dev->port, 1); // Nhuong CPU thay vi spin
+  }
+  return txn->status;
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_ll_txn_busy(const zw111_dev_t *dev){
+  return (dev != NULL) && (dev->txn_head != NULL);
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_ll_cancel(zw111_dev_t *dev){
+  if(dev == NULL) return ZW111_STATUS_ERROR;
+
+  zw111_ll_txn_t *aborted = dev->txn_head;
+  bool stale_ack = false;
+
+  if(aborted != NULL){
+      if(aborted->state == ZW111_TXN_TX){
+          (void)wait_tx_done(&dev->port, ll_tx_timeout_ms(dev, aborted->tx_len));
+      }else if(aborted->state == ZW111_TXN_DATA_TX){
+          (void)wait_tx_done(&dev->port, ll_tx_timeout_ms(dev, dev->dl_len[dev->dl_cur]));
+      }
+
+      /* Cam bien da nhan lenh nhung chua ACK (DownChar stream: ACK cuoi sau End Packet) */
+      stale_ack = aborted->state == ZW111_TXN_TX || aborted->state == ZW111_TXN_WAIT_ACK
+               || (aborted->state == ZW111_TXN_DATA_TX && aborted->xfer_stream_ack);
+  }
+
+  dev->txn_head = NULL;
+  dev->txn_tail = NULL;
+  dev->dl_len[0] = 0;
+  dev->dl_len[1] = 0;
+
+  zw111_ll_txn_t cancel;
+  memset(&cancel, 0, sizeof(cancel));
+  zw111_status_t ret = zw111_ll_txn_init(&cancel, ZW111_CMD_CANCEL, NULL, 0, NULL, NULL);
+  if(ret == ZW111_STATUS_OK) ret = zw111_ll_txn_submit(dev, &cancel);
+  if(ret == ZW111_STATUS_OK) ret = zw111_ll_txn_wait(&cancel);
+
+  if(ret == ZW111_STATUS_OK && stale_ack){
+      /* ACK vua nhan co the cua lenh bi huy -> ACK cua CANCEL den ngay sau */
+      const zw111_ll_frame_t *frame = NULL;
+      uint32_t drain_start = zw111_ll_get_ticks();
+      while(elapsed_ms(drain_start, zw111_ll_get_ticks()) < ZW111_CANCEL_DRAIN_MS){
+          if(ll_poll_frame(dev, &frame)){
+              if(frame->pid == ZW111_PID_ACK) break;
+              continue;
+          }
+          (void)zw111_port_uart_rx_wait(&dev->port, 1);
+      }
+  }
+  (void)zw111_ll_flush_uart(dev);
+
+  /* Ket thuc cac transaction bi huy theo thu tu trong hang doi */
+  while(aborted != NULL){
+      zw111_ll_txn_t *next = aborted->next;
+      aborted->next = NULL;
+      aborted->status = ZW111_STATUS_CANCELLED;
+      aborted->state = ZW111_TXN_DONE;
+      if(aborted->cb) aborted->cb(aborted);
+      aborted = next;
+  }
+
+  DEBUG_LOG(1, "[LOWLEVEL][TXN] Cancel done st=%d\r\n", (int)ret);
+  return ret;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_status_t zw111_ll_flush_uart(zw111_dev_t *dev){
+  if(dev == NULL) return ZW111_STATUS_ERROR;
+
+  /* Bo ca frame dang parse do va byte con trong buffer trung gian */
+  zw111_ll_parser_reset(&dev->parser);
+  dev->rx_stage_pos = 0;
+  dev->rx_stage_len = 0;
+
+  if(zw111_port_uart_flush(&dev->port) != true){
       return ZW111_STATUS_ERROR;
   }
   return ZW111_STATUS_OK;
@@ -418,8 +1312,16 @@ zw111_status_t zw111_ll_flush_uart(void){
 
 /* ----------------------------------------------------------- */
 
-void zw111_ll_set_chip_address(uint32_t addr){
-  s_chip_default_addr = addr;
+void zw111_ll_set_chip_address(zw111_dev_t *dev, uint32_t addr){
+  if(dev == NULL) return;
+  dev->chip_addr = addr;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_ll_set_packet_size(zw111_dev_t *dev, zw111_packet_size_t size){
+  if(dev == NULL || size > ZW111_PKT_SIZE_256) return;
+  dev->pkt_bytes = (uint16_t)ZW111_PKT_SIZE_BYTES(size); // 32/64/128/256 bytes
 }
 
 /* ----------------------------------------------------------- */
@@ -0,0 +1,276 @@
+/*
+ * @file zw111_meta.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Encode/decode record metadata trong NotePad + bo dem hit + lich ghi gop
+ * Moi so nhieu byte trong record la little-endian
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_meta.h"
+#include "string.h"
+
+/* Vi tri cac truong trong header */
+#define ZW_META_OFF_MAGIC       0u
+#define ZW_META_OFF_VERSION     4u
+#define ZW_META_OFF_PAGES       5u
+#define ZW_META_OFF_SEQ         6u
+#define ZW_META_OFF_CRC         8u
+#define ZW_META_OFF_CAPACITY    12u   /* CRC cua record gom header tu day */
+#define ZW_META_OFF_COUNT       14u
+#define ZW_META_OFF_DIGEST      16u
+#define ZW_META_OFF_BAUD        20u
+#define ZW_META_OFF_PKT         21u
+#define ZW_META_OFF_ALLOC       22u
+#define ZW_META_OFF_HOT         24u
+
+static void zw_meta_put16(uint8_t *p, uint16_t v){
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+/* ----------------------------------------------------------- */
+
+static void zw_meta_put32(uint8_t *p, uint32_t v){
+  zw_meta_put16(p, (uint16_t)v);
+  zw_meta_put16(&p[2], (uint16_t)(v >> 16));
+}
+
+/* ----------------------------------------------------------- */
+
+static uint16_t zw_meta_get16(const uint8_t *p){
+  return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+/* ----------------------------------------------------------- */
+
+static uint32_t zw_meta_get32(const uint8_t *p){
+  return (uint32_t)zw_meta_get16(p) | ((uint32_t)zw_meta_get16(&p[2]) << 16);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief So trang bitmap (= so trang Index Table cua capacity)
+ */
+static uint8_t zw_meta_bitmap_pages(uint16_t capacity){
+  uint16_t cap = (capacity > ZW111_INDEX_MAX_CAPACITY) ? (uint16_t)ZW111_INDEX_MAX_CAPACITY : capacity;
+  return (uint8_t)((cap + ZW111_INDEX_PAGE_BITS - 1u) / ZW111_INDEX_PAGE_BITS);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_init(zw111_meta_t *m){
+  if(m == NULL) return;
+  memset(m, 0, sizeof(*m));
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_meta_occupancy_digest(const zw111_index_t *idx){
+  if(idx == NULL) return 0;
+
+  uint32_t crc = 0;
+  uint8_t le[4];
+  for(uint16_t w = 0; w < (idx->capacity + 31u) / 32u; w++){
+      zw_meta_put32(le, idx->words[w]);
+      crc = zw111_crc32(crc, le, sizeof(le));
+  }
+  return crc;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_touch(zw111_meta_t *m, uint32_t now){
+  if(m == NULL) return;
+  if(!(m->dirty & ZW111_META_DIRTY_STATE)) m->state_tick = now; // Han tinh tu thay doi dau tien -> gop cac thay doi sau
+  m->dirty |= ZW111_META_DIRTY_STATE;
+  m->stats.changes++;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_defer(zw111_meta_t *m, uint32_t now){
+  if(m == NULL || m->dirty == 0) return;
+  m->dirty = ZW111_META_DIRTY_STATE; // Lan ghi sau van gom ca bo dem hit
+  m->state_tick = now;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_hit(zw111_meta_t *m, uint16_t page_id, uint32_t now){
+  if(m == NULL) return;
+
+  uint8_t min_i = 0;
+  uint8_t i;
+  for(i = 0; i < m->hot_count; i++){
+      if(m->hot[i].page_id == page_id) break;
+      if(m->hot[i].hits < m->hot[min_i].hits) min_i = i;
+  }
+
+  if(i < m->hot_count){
+      if(m->hot[i].hits != 0xFFFFu) m->hot[i].hits++;
+  }else if(m->hot_count < ZW111_META_HOT_MAX){
+      m->hot[m->hot_count].page_id = page_id;
+      m->hot[m->hot_count].hits = 1;
+      m->hot_count++;
+  }else{
+      /* Space-saving: thay dong it hit nhat, ke thua so dem (dem du, khong bo sot PageID nong) */
+      m->hot[min_i].page_id = page_id;
+      if(m->hot[min_i].hits != 0xFFFFu) m->hot[min_i].hits++;
+  }
+
+  if(!(m->dirty & ZW111_META_DIRTY_HITS)) m->hits_tick = now;
+  m->dirty |= ZW111_META_DIRTY_HITS;
+  m->stats.changes++;
+}
+
+/* ----------------------------------------------------------- */
+
+uint16_t zw111_meta_hits(const zw111_meta_t *m, uint16_t page_id){
+  if(m == NULL) return 0;
+  for(uint8_t i = 0; i < m->hot_count; i++){
+      if(m->hot[i].page_id == page_id) return m->hot[i].hits;
+  }
+  return 0;
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_meta_next_flush_ms(const zw111_meta_t *m, uint32_t now){
+  if(m == NULL || m->dirty == 0) return ZW111_META_NEVER;
+
+  uint32_t next = ZW111_META_NEVER;
+  if(m->dirty & ZW111_META_DIRTY_STATE){
+      int32_t left = (int32_t)(m->state_tick + ZW111_META_FLUSH_DELAY_MS - now);
+      next = (left > 0) ? (uint32_t)left : 0u;
+  }
+  if(m->dirty & ZW111_META_DIRTY_HITS){
+      int32_t left = (int32_t)(m->hits_tick + ZW111_META_HITS_FLUSH_MS - now);
+      uint32_t h = (left > 0) ? (uint32_t)left : 0u;
+      if(h < next) next = h;
+  }
+  return next;
+}
+
+/* ----------------------------------------------------------- */
+
+uint8_t zw111_meta_page_count(const zw111_meta_t *m, const zw111_index_t *idx){
+  if(m == NULL || idx == NULL) return 0;
+  return (uint8_t)(1u + zw_meta_bitmap_pages(idx->capacity) + (m->hot_count + ZW111_META_HOT_PER_PAGE - 1u) / ZW111_META_HOT_PER_PAGE);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_encode_page(const zw111_meta_t *m, const zw111_index_t *idx, uint8_t page_no, uint8_t out[ZW111_META_PAGE_SIZE]){
+  memset(out, 0, ZW111_META_PAGE_SIZE);
+  if(m == NULL || idx == NULL || page_no == 0) return;
+
+  uint8_t bmp = zw_meta_bitmap_pages(idx->capacity);
+  if(page_no <= bmp){
+      /* Cung bo cuc voi 32 bytes PS_ReadIndexTable (LSB truoc) */
+      uint16_t w0 = (uint16_t)((page_no - 1u) * ZW111_INDEX_PAGE_WORDS);
+      for(uint16_t i = 0; i < ZW111_INDEX_PAGE_WORDS; i++) zw_meta_put32(&out[i * 4u], idx->words[w0 + i]);
+      return;
+  }
+
+  uint16_t first = (uint16_t)((page_no - 1u - bmp) * ZW111_META_HOT_PER_PAGE);
+  for(uint16_t i = 0; i < ZW111_META_HOT_PER_PAGE && first + i < m->hot_count; i++){
+      zw_meta_put16(&out[i * 4u], m->hot[first + i].page_id);
+      zw_meta_put16(&out[i * 4u + 2u], m->hot[first + i].hits);
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_meta_header_crc(uint32_t crc, const uint8_t header[ZW111_META_PAGE_SIZE]){
+  return zw111_crc32(crc, &header[ZW_META_OFF_CAPACITY], ZW111_META_PAGE_SIZE - ZW_META_OFF_CAPACITY);
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_encode_header(const zw111_meta_t *m, uint8_t page_count, uint32_t crc, uint8_t out[ZW111_META_PAGE_SIZE]){
+  memset(out, 0, ZW111_META_PAGE_SIZE);
+  if(m == NULL) return;
+
+  memcpy(&out[ZW_META_OFF_MAGIC], ZW111_META_MAGIC, 4);
+  out[ZW_META_OFF_VERSION] = ZW111_META_VERSION;
+  out[ZW_META_OFF_PAGES] = page_count;
+  zw_meta_put16(&out[ZW_META_OFF_SEQ], m->seq);
+  zw_meta_put16(&out[ZW_META_OFF_CAPACITY], m->capacity);
+  zw_meta_put16(&out[ZW_META_OFF_COUNT], m->template_count);
+  zw_meta_put32(&out[ZW_META_OFF_DIGEST], m->occupancy_digest);
+  out[ZW_META_OFF_BAUD] = m->baud_mult;
+  out[ZW_META_OFF_PKT] = m->packet_size;
+  zw_meta_put16(&out[ZW_META_OFF_ALLOC], m->alloc_next);
+  out[ZW_META_OFF_HOT] = m->hot_count;
+  zw_meta_put32(&out[ZW_META_OFF_CRC], zw111_meta_header_crc(crc, out));
+}
+
+/* ----------------------------------------------------------- */
+
+bool zw111_meta_decode_header(zw111_meta_t *m, const uint8_t in[ZW111_META_PAGE_SIZE], uint8_t *page_count, uint32_t *crc){
+  if(m == NULL || in == NULL || page_count == NULL || crc == NULL) return false;
+  if(memcmp(&in[ZW_META_OFF_MAGIC], ZW111_META_MAGIC, 4) != 0 || in[ZW_META_OFF_VERSION] != ZW111_META_VERSION) return false;
+
+  uint16_t capacity = zw_meta_get16(&in[ZW_META_OFF_CAPACITY]);
+  uint8_t hot_count = in[ZW_META_OFF_HOT];
+  if(capacity == 0 || capacity > ZW111_INDEX_MAX_CAPACITY || hot_count > ZW111_META_HOT_MAX) return false;
+
+  uint8_t pages = (uint8_t)(1u + zw_meta_bitmap_pages(capacity) + (hot_count + ZW111_META_HOT_PER_PAGE - 1u) / ZW111_META_HOT_PER_PAGE);
+  if(in[ZW_META_OFF_PAGES] != pages) return false;
+
+  m->seq = zw_meta_get16(&in[ZW_META_OFF_SEQ]);
+  m->capacity = capacity;
+  m->template_count = zw_meta_get16(&in[ZW_META_OFF_COUNT]);
+  m->occupancy_digest = zw_meta_get32(&in[ZW_META_OFF_DIGEST]);
+  m->baud_mult = in[ZW_META_OFF_BAUD];
+  m->packet_size = in[ZW_META_OFF_PKT];
+  m->alloc_next = zw_meta_get16(&in[ZW_META_OFF_ALLOC]);
+  m->hot_count = hot_count;
+
+  *page_count = pages;
+  *crc = zw_meta_get32(&in[ZW_META_OFF_CRC]);
+  return true;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_decode_page(zw111_meta_t *m, zw111_index_t *idx, uint8_t page_no, const uint8_t in[ZW111_META_PAGE_SIZE]){
+  if(m == NULL || idx == NULL || in == NULL || page_no == 0) return;
+
+  uint8_t bmp = zw_meta_bitmap_pages(m->capacity);
+  if(page_no <= bmp){
+      zw111_index_load_page(idx, (uint8_t)(page_no - 1u), in);
+      return;
+  }
+
+  uint16_t first = (uint16_t)((page_no - 1u - bmp) * ZW111_META_HOT_PER_PAGE);
+  for(uint16_t i = 0; i < ZW111_META_HOT_PER_PAGE && first + i < m->hot_count; i++){
+      m->hot[first + i].page_id = zw_meta_get16(&in[i * 4u]);
+      m->hot[first + i].hits = zw_meta_get16(&in[i * 4u + 2u]);
+  }
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_meta_prune_hot(zw111_meta_t *m, const zw111_index_t *idx){
+  if(m == NULL || idx == NULL) return;
+
+  uint8_t n = 0;
+  for(uint8_t i = 0; i < m->hot_count; i++){
+      if(zw111_index_test(idx, m->hot[i].page_id)) m->hot[n++] = m->hot[i];
+  }
+  m->hot_count = n;
+}
+
+/* ----------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
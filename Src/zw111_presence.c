@@ -0,0 +1,193 @@
+/*
+ * @file zw111_presence.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Lap lich poll GetImage: backoff khi khong co ngon tay, burst sau anh partial/trigger ngoai
+ * Moi moc thoi gian so sanh bang hieu so co dau (chiu duoc tick 32-bit tran vong)
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_presence.h"
+#include "string.h"
+
+/**
+ * @brief Dang trong burst tai `now`
+ */
+static bool zw_presence_in_burst(const zw111_presence_t *p, uint32_t now){
+  return (p->cfg.burst_ms != 0) && ((int32_t)(p->burst_until - now) > 0);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Chu ky poll nhanh nhat cua cau hinh (burst neu bat, nguoc lai idle_min)
+ */
+static uint32_t zw_presence_fast_ms(const zw111_presence_t *p){
+  return (p->cfg.burst_ms != 0) ? p->cfg.burst_ms : p->cfg.idle_min_ms;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_presence_default_cfg(zw111_presence_cfg_t *cfg, zw111_presence_policy_t policy){
+  if(cfg == NULL) return;
+  cfg->idle_min_ms = ZW111_PRESENCE_IDLE_MIN_MS;
+  cfg->idle_max_ms = ZW111_PRESENCE_IDLE_MAX_MS;
+  cfg->backoff_pct = 200u;
+  cfg->burst_ms = ZW111_PRESENCE_BURST_MS;
+  cfg->burst_hold_ms = ZW111_PRESENCE_BURST_HOLD_MS;
+
+  if(policy == ZW111_PRESENCE_FIXED){
+      cfg->idle_max_ms = cfg->idle_min_ms;
+      cfg->backoff_pct = 100u;
+  }
+  if(policy != ZW111_PRESENCE_BURST) cfg->burst_ms = 0;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_presence_init(zw111_presence_t *p, const zw111_presence_cfg_t *cfg, uint32_t now){
+  if(p == NULL || cfg == NULL) return;
+  memset(p, 0, sizeof(*p));
+  p->cfg = *cfg;
+  if(p->cfg.idle_min_ms == 0) p->cfg.idle_min_ms = 1u;
+  if(p->cfg.idle_max_ms < p->cfg.idle_min_ms) p->cfg.idle_max_ms = p->cfg.idle_min_ms;
+  if(p->cfg.backoff_pct < 100u) p->cfg.backoff_pct = 100u;
+
+  p->interval_ms = p->cfg.idle_min_ms;
+  p->next_tick = now;
+  p->burst_until = now;
+  p->stats.start_tick = now;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_presence_reset_stats(zw111_presence_t *p, uint32_t now){
+  if(p == NULL) return;
+  memset(&p->stats, 0, sizeof(p->stats));
+  p->stats.start_tick = now;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_presence_kick(zw111_presence_t *p, uint32_t now){
+  if(p == NULL) return;
+  p->interval_ms = p->cfg.idle_min_ms;
+  p->next_tick = now;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_presence_wake(zw111_presence_t *p, uint32_t now){
+  if(p == NULL) return;
+  p->stats.wakes++;
+  p->onset_tick = now; // Trigger do ngon tay gay ra -> moc chinh xac hon lan NO_FINGER truoc
+  p->onset_valid = true;
+  p->interval_ms = p->cfg.idle_min_ms;
+  p->next_tick = now;
+  if(p->cfg.burst_ms != 0) p->burst_until = now + p->cfg.burst_hold_ms;
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_presence_next_ms(const zw111_presence_t *p, uint32_t now){
+  if(p == NULL) return 0;
+  int32_t left = (int32_t)(p->next_tick - now);
+  return (left > 0) ? (uint32_t)left : 0;
+}
+
+/* ----------------------------------------------------------- */
+
+zw111_presence_event_t zw111_presence_record(zw111_presence_t *p, zw111_status_t st, uint32_t start, uint32_t end){
+  if(p == NULL) return ZW111_PRESENCE_EV_NONE;
+
+  zw111_presence_event_t ev;
+  p->stats.polls++;
+  p->stats.busy_ms += end - start;
+
+  switch(st){
+    case ZW111_STATUS_OK:
+      if(p->present){
+          ev = ZW111_PRESENCE_EV_PRESENT;
+      }else{
+          ev = ZW111_PRESENCE_EV_DETECTED;
+          p->present = true;
+          p->stats.detections++;
+          if(p->onset_valid){
+              uint32_t delay = end - p->onset_tick;
+              p->stats.delay_samples++;
+              p->stats.delay_sum_ms += delay;
+              if(delay > p->stats.delay_max_ms) p->stats.delay_max_ms = delay;
+              p->onset_valid = false;
+          }
+      }
+      /* USER thuong lay anh tiep (GenChar/Enroll) hoac cho nhac tay -> poll nhanh */
+      p->interval_ms = p->cfg.idle_min_ms;
+      p->next_tick = end + zw_presence_fast_ms(p);
+    break;
+
+    case ZW111_STATUS_NO_FINGER:
+      ev = ZW111_PRESENCE_EV_IDLE;
+      p->present = false;
+      if(zw_presence_in_burst(p, end)){
+          if(!p->onset_valid){ // Giu moc cua trigger/lan NO_FINGER truoc burst
+              p->onset_tick = start;
+              p->onset_valid = true;
+          }
+          p->next_tick = end + p->cfg.burst_ms;
+      }else{
+          p->onset_tick = start; // Ngon tay (neu co) dat sau lan chup nay
+          p->onset_valid = true;
+          p->next_tick = end + p->interval_ms;
+
+          uint32_t next = p->interval_ms * p->cfg.backoff_pct / 100u;
+          p->interval_ms = (next > p->cfg.idle_max_ms) ? p->cfg.idle_max_ms : next;
+      }
+    break;
+
+    case ZW111_STATUS_ERROR:
+      /* Cam bien tra loi nhung anh loi: ngon tay dang dat xuong/dat lech -> poll day de bat anh tot dau tien */
+      ev = ZW111_PRESENCE_EV_ACTIVITY;
+      p->present = false;
+      p->stats.partials++;
+      p->interval_ms = p->cfg.idle_min_ms;
+      if(p->cfg.burst_ms != 0) p->burst_until = end + p->cfg.burst_hold_ms;
+      p->next_tick = end + zw_presence_fast_ms(p);
+    break;
+
+    default:
+      /* Loi duong truyen khong noi gi ve ngon tay: giu chu ky, khong backoff them */
+      ev = ZW111_PRESENCE_EV_LINK_ERROR;
+      p->stats.link_errors++;
+      p->next_tick = end + (zw_presence_in_burst(p, end) ? p->cfg.burst_ms : p->interval_ms);
+    break;
+  }
+  return ev;
+}
+
+/* ----------------------------------------------------------- */
+
+uint16_t zw111_presence_uart_permille(const zw111_presence_t *p, uint32_t now){
+  if(p == NULL) return 0;
+  uint32_t elapsed = now - p->stats.start_tick;
+  if(elapsed == 0) return 0;
+  uint64_t pm = (uint64_t)p->stats.busy_ms * 1000u / elapsed;
+  return (uint16_t)((pm > 1000u) ? 1000u : pm);
+}
+
+/* ----------------------------------------------------------- */
+
+uint32_t zw111_presence_avg_delay_ms(const zw111_presence_t *p){
+  if(p == NULL || p->stats.delay_samples == 0) return 0;
+  return p->stats.delay_sum_ms / p->stats.delay_samples;
+}
+
+/* ----------------------------------------------------------- */
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus
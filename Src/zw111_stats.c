@@ -0,0 +1,106 @@
+/*
+ * @file zw111_stats.c
+ *
+ * @date 17 thg 10, 2026
+ * @author LuongHuuPhuc
+ *
+ * Histogram latency theo lenh (chi compile khi ZW111_LL_STATS = 1)
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif // __cplusplus
+
+#include "zw111_stats.h"
+#include "string.h"
+
+#if ZW111_LL_STATS
+
+/**
+ * @brief Bucket cua 1 gia tri latency: 0 -> 0, [2^(i-1), 2^i) -> i (bao hoa o bucket cuoi)
+ */
+static inline uint8_t zw_stats_bucket(uint32_t ms){
+  if(ms == 0) return 0;
+  uint32_t b = 32u - (uint32_t)__builtin_clz(ms);
+  return (uint8_t)((b >= ZW111_STATS_BUCKETS) ? (ZW111_STATS_BUCKETS - 1u) : b);
+}
+
+/* ----------------------------------------------------------- */
+
+/**
+ * @brief Cong 1 mau vao 1 pha
+ */
+static void zw_stats_add(zw111_cmd_stats_t *cs, zw111_stats_phase_t phase, uint32_t ms){
+  uint8_t b = zw_stats_bucket(ms);
+  if(cs->bucket[phase][b] != 0xFFFFu) cs->bucket[phase][b]++;
+  cs->sum_ms[phase] += ms;
+  if(ms > cs->max_ms[phase]) cs->max_ms[phase] = (ms > 0xFFFFu) ? 0xFFFFu : (uint16_t)ms;
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_stats_reset(zw111_stats_t *stats){
+  if(stats == NULL) return;
+  memset(stats, 0, sizeof(*stats));
+}
+
+/* ----------------------------------------------------------- */
+
+void zw111_stats_record(zw111_stats_t *stats, const zw111_stats_stamp_t *stamp, uint32_t rx_done, bool timeout){
+  if(stats == NULL || stamp == NULL) return;
+
+  uint8_t slot = zw111_cmd_slot(stamp->cmd);
+  if(slot >= ZW111_CMD_SLOTS) return;
+  zw111_cmd_stats_t *cs = &stats->cmd[slot];
+
+  if(timeout){
+      cs->timeouts++;
+      return;
+  }
+
+  /* Byte dau frame doc truoc luc TX xong (poll tre) -> coi nhu den ngay luc TX xong */
+  uint32_t rx_first = stamp->rx_first;
+  if((int32_t)(rx_first - stamp->tx_done) < 0) rx_first = stamp->tx_done;
+
+  cs->count++;
+  zw_stats_add(cs, ZW111_PHASE_TX, stamp->tx_done - stamp->tx_kick);
+  zw_stats_add(cs, ZW111_PHASE_DEVICE, rx_first - stamp->tx_done);
+  zw_stats_add(cs, ZW111_PHASE_RX, rx_done - rx_first);
+  zw_stats_add(cs, ZW111_PHASE_TOTAL, rx_done - stamp->tx_kick);
+}
+
+/* ----------------------------------------------------------- */
+
+const zw111_cmd_stats_t *zw111_stats_get(const zw111_stats_t *stats, zw111_cmd_t cmd){
+  uint8_t slot = zw111_cmd_slot(cmd);
+  if(stats == NULL || slot >= ZW111_CMD_SLOTS) return NULL;
+  return &stats->cmd[slot];
+}
+
+/* ----------------------------------------------------------- */
+
+uint16_t zw111_stats_percentile(const zw111_cmd_stats_t *cs, zw111_stats_phase_t phase, uint8_t pct){
+  if(cs == NULL || phase >= ZW111_PHASE_COUNT || pct == 0) return 0;
+
+  uint32_t total = 0;
+  for(uint8_t i = 0; i < ZW111_STATS_BUCKETS; i++) total += cs->bucket[phase][i];
+  if(total == 0) return 0;
+
+  uint32_t target = (total * (pct > 100 ? 100u : pct) + 99u) / 100u; // So mau can vuot qua
+  uint32_t acc = 0;
+  for(uint8_t i = 0; i < ZW111_STATS_BUCKETS; i++){
+      acc += cs->bucket[phase][i];
+      if(acc >= target){
+          if(i == ZW111_STATS_BUCKETS - 1u) return cs->max_ms[phase];
+          uint16_t upper = (uint16_t)((1u << i) - 1u); // Can tren cua bucket i: 2^i - 1 ms
+          return (upper < cs->max_ms[phase]) ? upper : cs->max_ms[phase];
+      }
+  }
+  return 0xFFFFu;
+}
+
+#endif // ZW111_LL_STATS
+
+#ifdef __cplusplus
+}
+#endif // __cplusplus